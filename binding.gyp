@@ -23,10 +23,27 @@
     'target_name' : 'nodejs_gl_binding',
     'sources' : [
       'binding/binding.cc',
+      'binding/egl_blob_cache.cc',
       'binding/egl_context_wrapper.cc',
+      'binding/instance_data.cc',
+      'binding/webgl_buffer_mappings.cc',
+      'binding/webgl_command_buffer.cc',
+      'binding/webgl_command_thread.cc',
       'binding/webgl_extensions.cc',
+      'binding/webgl_fence_poller.cc',
+      'binding/webgl_memory_tracker.cc',
+      'binding/webgl_object_registry.cc',
+      'binding/webgl_parameters.cc',
+      'binding/webgl_program_binary_cache.cc',
+      'binding/webgl_program_cache.cc',
+      'binding/webgl_readback_pool.cc',
       'binding/webgl_rendering_context.cc',
-      'binding/webgl_sync.cc'
+      'binding/webgl_scratch_arena.cc',
+      'binding/webgl_share_group.cc',
+      'binding/webgl_state_cache.cc',
+      'binding/webgl_stream_buffer.cc',
+      'binding/webgl_sync.cc',
+      'binding/webgl_texture_pool.cc'
     ],
     'include_dirs' : [
       '..',
@@ -17,6 +17,7 @@
 
 #include <node_api.h>
 
+#include "instance_data.h"
 #include "utils.h"
 #include "webgl_extensions.h"
 #include "webgl_rendering_context.h"
@@ -34,6 +35,11 @@ static napi_value CreateWebGLRenderingContext(napi_env env,
 }
 
 static napi_value InitBinding(napi_env env, napi_value exports) {
+  // Runs once per environment (the main thread and every worker thread).
+  // Constructors are kept in the instance data of each environment.
+  napi_status nstatus = InstanceData::Init(env);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
   ANGLEInstancedArraysExtension::Register(env, exports);
   EXTBlendMinmaxExtension::Register(env, exports);
   EXTColorBufferFloatExtension::Register(env, exports);
@@ -42,6 +48,7 @@ static napi_value InitBinding(napi_env env, napi_value exports) {
   EXTShaderTextureLodExtension::Register(env, exports);
   EXTSRGBExtension::Register(env, exports);
   EXTTextureFilterAnisotropicExtension::Register(env, exports);
+  KHRParallelShaderCompileExtension::Register(env, exports);
   OESElementIndexUintExtension::Register(env, exports);
   OESStandardDerivativesExtension::Register(env, exports);
   OESTextureFloatExtension::Register(env, exports);
@@ -58,8 +65,8 @@ static napi_value InitBinding(napi_env env, napi_value exports) {
                          CreateWebGLRenderingContext),
   };
 
-  napi_status nstatus =
-      napi_define_properties(env, exports, ARRAY_SIZE(properties), properties);
+  nstatus = napi_define_properties(env, exports, ARRAY_SIZE(properties),
+                                   properties);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   return exports;
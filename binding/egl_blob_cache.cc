@@ -0,0 +1,378 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "egl_blob_cache.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifndef COMPILER_MSVC
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nodejsgl {
+
+namespace {
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t size;          // Bytes of the file.
+  uint64_t end;           // Offset where the next record is appended.
+  uint64_t bucket_count;  // Followed by as many offsets of the newest record
+                          // of each bucket, 0 for empty buckets.
+};
+
+struct Record {
+  uint64_t hash;
+  uint64_t previous;  // Offset of the previous record of the bucket, or 0.
+  uint32_t key_size;
+  uint32_t value_size;
+  // Followed by the key and the value.
+};
+
+const uint32_t kFileMagic = 0x4342474e;  // "NGBC"
+const uint32_t kFileVersion = 1;
+
+// Smallest file that is worth mapping.
+const size_t kMinBytes = 256 * 1024;
+const size_t kMinBuckets = 256;
+// Expected average size of a record, sets the number of buckets.
+const size_t kBytesPerBucket = 16 * 1024;
+
+size_t Align(size_t size) { return (size + 7) & ~static_cast<size_t>(7); }
+
+uint64_t* Buckets(void* header) {
+  return reinterpret_cast<uint64_t*>(static_cast<uint8_t*>(header) +
+                                     Align(sizeof(FileHeader)));
+}
+
+size_t DataStart(uint64_t bucket_count) {
+  return Align(sizeof(FileHeader)) +
+         static_cast<size_t>(bucket_count) * sizeof(uint64_t);
+}
+
+// 64-bit FNV-1a.
+uint64_t Hash(const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * 1099511628211ull;
+  }
+  return hash;
+}
+
+// Initializes an empty cache in the first |size| bytes of |data|.
+void Reset(void* data, size_t size) {
+  uint64_t bucket_count = std::max(kMinBuckets, size / kBytesPerBucket);
+  memset(data, 0, DataStart(bucket_count));
+
+  FileHeader* header = static_cast<FileHeader*>(data);
+  header->magic = kFileMagic;
+  header->version = kFileVersion;
+  header->size = size;
+  header->end = DataStart(bucket_count);
+  header->bucket_count = bucket_count;
+}
+
+// Returns false if |header| doesn't describe a mapping of |size| bytes, e.g.
+// after another process replaced a damaged file.
+bool IsValid(const FileHeader* header, size_t size) {
+  return header->magic == kFileMagic && header->version == kFileVersion &&
+         header->size == size && header->bucket_count > 0 &&
+         header->bucket_count <= size / sizeof(uint64_t) &&
+         header->end >= DataStart(header->bucket_count) &&
+         header->end <= size;
+}
+
+// Returns the newest record of |key| in a valid cache, or nullptr. The file
+// must be locked.
+const Record* Find(uint8_t* data, uint64_t hash, const void* key,
+                   size_t key_size) {
+  FileHeader* header = reinterpret_cast<FileHeader*>(data);
+  uint64_t data_start = DataStart(header->bucket_count);
+  uint64_t offset = Buckets(header)[hash % header->bucket_count];
+
+  // Offsets are checked against |end| so that a damaged file can't make
+  // reads go out of bounds.
+  while (offset >= data_start && offset + sizeof(Record) <= header->end) {
+    const Record* record = reinterpret_cast<const Record*>(data + offset);
+    uint64_t record_end =
+        offset + sizeof(Record) + record->key_size + record->value_size;
+    if (record_end <= header->end && record->hash == hash &&
+        record->key_size == key_size &&
+        memcmp(record + 1, key, key_size) == 0) {
+      return record;
+    }
+    // Records only link to older records, which also ends damaged chains.
+    if (record->previous >= offset) {
+      break;
+    }
+    offset = record->previous;
+  }
+  return nullptr;
+}
+
+// Advisory lock on the whole file, held for the lifetime of the object.
+class FileLock {
+ public:
+  FileLock(int fd, bool exclusive) : fd_(fd), locked_(false) {
+#ifndef COMPILER_MSVC
+    int result;
+    do {
+      result = flock(fd_, exclusive ? LOCK_EX : LOCK_SH);
+    } while (result != 0 && errno == EINTR);
+    locked_ = result == 0;
+#endif
+  }
+
+  ~FileLock() {
+#ifndef COMPILER_MSVC
+    if (locked_) {
+      flock(fd_, LOCK_UN);
+    }
+#endif
+  }
+
+  bool locked() const { return locked_; }
+
+ private:
+  int fd_;
+  bool locked_;
+};
+
+}  // namespace
+
+/* static */
+EGLBlobCache* EGLBlobCache::Get() {
+  // Never destroyed: EGL may call the blob functions during shutdown.
+  static EGLBlobCache* cache = new EGLBlobCache();
+  return cache;
+}
+
+EGLBlobCache::EGLBlobCache() : fd_(-1), data_(nullptr), size_(0) {}
+
+bool EGLBlobCache::Open(const std::string& path, size_t max_bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (data_) {
+    return path == path_;
+  }
+
+#ifdef COMPILER_MSVC
+  return false;
+#else
+  if (max_bytes == 0) {
+    max_bytes = kDefaultMaxBytes;
+  }
+  max_bytes = Align(std::max(max_bytes, kMinBytes));
+
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return false;
+  }
+
+  // Creating or replacing the file must not race with other processes.
+  FileLock file_lock(fd, true);
+  struct stat stat;
+  if (!file_lock.locked() || fstat(fd, &stat) != 0) {
+    close(fd);
+    return false;
+  }
+
+  // A valid file keeps the size it was created with, since other processes
+  // may have it mapped.
+  size_t size = static_cast<size_t>(stat.st_size);
+  FileHeader header;
+  bool valid = size >= sizeof(header) &&
+               pread(fd, &header, sizeof(header), 0) == sizeof(header) &&
+               IsValid(&header, size);
+  if (!valid) {
+    size = max_bytes;
+    if (ftruncate(fd, size) != 0) {
+      close(fd);
+      return false;
+    }
+#ifdef __linux__
+    // Reserves the blocks, so that stores into the mapping can't fault once
+    // the disk is full.
+    if (posix_fallocate(fd, 0, size) != 0) {
+      close(fd);
+      return false;
+    }
+#endif
+  }
+
+  void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    close(fd);
+    return false;
+  }
+  if (!valid) {
+    Reset(data, size);
+  }
+
+  fd_ = fd;
+  data_ = static_cast<uint8_t*>(data);
+  size_ = size;
+  path_ = path;
+  return true;
+#endif
+}
+
+std::string EGLBlobCache::path() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return path_;
+}
+
+void EGLBlobCache::Register(EGLDisplay display) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!data_ || std::find(displays_.begin(), displays_.end(), display) !=
+                      displays_.end()) {
+      return;
+    }
+    displays_.push_back(display);
+  }
+
+  // Called without holding |mutex_|, in case EGL queries the cache right
+  // away.
+  PFNEGLSETBLOBCACHEFUNCSANDROIDPROC set_blob_cache_funcs =
+      reinterpret_cast<PFNEGLSETBLOBCACHEFUNCSANDROIDPROC>(
+          eglGetProcAddress("eglSetBlobCacheFuncsANDROID"));
+  if (set_blob_cache_funcs) {
+    set_blob_cache_funcs(display, SetBlob, GetBlob);
+  }
+}
+
+bool EGLBlobCache::CanRegister(EGLDisplay display) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return std::find(displays_.begin(), displays_.end(), display) !=
+             displays_.end() ||
+         std::find(displays_with_contexts_.begin(),
+                   displays_with_contexts_.end(),
+                   display) == displays_with_contexts_.end();
+}
+
+void EGLBlobCache::OnCreateContext(EGLDisplay display) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (std::find(displays_with_contexts_.begin(), displays_with_contexts_.end(),
+                display) == displays_with_contexts_.end()) {
+    displays_with_contexts_.push_back(display);
+  }
+}
+
+/* static */
+void EGLBlobCache::SetBlob(const void* key, EGLsizeiANDROID key_size,
+                           const void* value, EGLsizeiANDROID value_size) {
+  if (key_size <= 0 || value_size <= 0 || key_size > UINT32_MAX ||
+      value_size > UINT32_MAX) {
+    return;
+  }
+  Get()->Set(key, static_cast<size_t>(key_size), value,
+             static_cast<size_t>(value_size));
+}
+
+/* static */
+EGLsizeiANDROID EGLBlobCache::GetBlob(const void* key,
+                                      EGLsizeiANDROID key_size, void* value,
+                                      EGLsizeiANDROID value_size) {
+  if (key_size <= 0 || value_size < 0) {
+    return 0;
+  }
+  return static_cast<EGLsizeiANDROID>(
+      Get()->Lookup(key, static_cast<size_t>(key_size), value,
+                    static_cast<size_t>(value_size)));
+}
+
+void EGLBlobCache::Set(const void* key, size_t key_size, const void* value,
+                       size_t value_size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!data_) {
+    return;
+  }
+
+  FileLock file_lock(fd_, true);
+  FileHeader* header = reinterpret_cast<FileHeader*>(data_);
+  if (!file_lock.locked() || !IsValid(header, size_)) {
+    return;
+  }
+
+  size_t record_bytes = Align(sizeof(Record) + key_size + value_size);
+  if (record_bytes > size_ - DataStart(header->bucket_count)) {
+    return;
+  }
+
+  uint64_t hash = Hash(key, key_size);
+  const Record* existing = Find(data_, hash, key, key_size);
+  if (existing && existing->value_size == value_size &&
+      memcmp(reinterpret_cast<const uint8_t*>(existing + 1) + key_size, value,
+             value_size) == 0) {
+    return;
+  }
+
+  if (header->end + record_bytes > size_) {
+    // Full: starting over keeps the blobs of the current run.
+    Reset(data_, size_);
+  }
+
+  uint64_t offset = header->end;
+  uint64_t* bucket = &Buckets(header)[hash % header->bucket_count];
+  Record* record = reinterpret_cast<Record*>(data_ + offset);
+  record->hash = hash;
+  record->previous = *bucket;
+  record->key_size = static_cast<uint32_t>(key_size);
+  record->value_size = static_cast<uint32_t>(value_size);
+  uint8_t* record_data = reinterpret_cast<uint8_t*>(record + 1);
+  memcpy(record_data, key, key_size);
+  memcpy(record_data + key_size, value, value_size);
+
+  // Published last, so a crash while copying leaves the index intact.
+  *bucket = offset;
+  header->end = offset + record_bytes;
+}
+
+size_t EGLBlobCache::Lookup(const void* key, size_t key_size, void* value,
+                            size_t value_size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!data_) {
+    return 0;
+  }
+
+  FileLock file_lock(fd_, false);
+  if (!file_lock.locked() ||
+      !IsValid(reinterpret_cast<FileHeader*>(data_), size_)) {
+    return 0;
+  }
+
+  const Record* record = Find(data_, Hash(key, key_size), key, key_size);
+  if (!record) {
+    return 0;
+  }
+  // EGL asks for the size first when |value_size| is too small.
+  if (value && value_size >= record->value_size) {
+    memcpy(value, reinterpret_cast<const uint8_t*>(record + 1) + key_size,
+           record->value_size);
+  }
+  return record->value_size;
+}
+
+}  // namespace nodejsgl
@@ -0,0 +1,99 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef NODEJS_GL_EGL_BLOB_CACHE_H_
+#define NODEJS_GL_EGL_BLOB_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "angle/include/EGL/egl.h"
+#include "angle/include/EGL/eglext.h"
+
+namespace nodejsgl {
+
+// Persists the blobs ANGLE hands to EGL_ANDROID_blob_cache (translated
+// shaders, program and pipeline caches) in a memory-mapped file, so that
+// later runs skip that work. The cache is shared by all contexts and threads
+// of the process, since EGL calls the blob functions without a user pointer.
+//
+// The file has a fixed size, set when it is created, and holds an index of
+// chained buckets followed by append-only records. A newer record of a key
+// shadows the older ones. Once the file is full, the index is cleared and
+// appending starts over. Several processes can share the file: every access
+// takes an advisory lock on it.
+//
+// Not supported on Windows.
+class EGLBlobCache {
+ public:
+  static const size_t kDefaultMaxBytes = 64 * 1024 * 1024;
+
+  static EGLBlobCache* Get();
+
+  // Maps the file at |path|, creating it with a size of |max_bytes| (or
+  // kDefaultMaxBytes if 0) if it doesn't exist or isn't a valid cache file.
+  // Returns false if the file can't be used or another file is already open.
+  bool Open(const std::string& path, size_t max_bytes);
+
+  // Path of the open file, empty if none is.
+  std::string path();
+
+  // Registers the blob functions on |display|. EGL only accepts them before
+  // the first context of |display| is created and only once per display, so
+  // later calls for the same display do nothing.
+  void Register(EGLDisplay display);
+
+  // Returns false if Register() comes too late for |display|: it already
+  // created a context without the blob functions.
+  bool CanRegister(EGLDisplay display);
+
+  // Records that |display| created a context.
+  void OnCreateContext(EGLDisplay display);
+
+ private:
+  EGLBlobCache();
+
+  static void SetBlob(const void* key, EGLsizeiANDROID key_size,
+                      const void* value, EGLsizeiANDROID value_size);
+  static EGLsizeiANDROID GetBlob(const void* key, EGLsizeiANDROID key_size,
+                                 void* value, EGLsizeiANDROID value_size);
+
+  // Appends a record, unless the newest record of |key| holds |value|.
+  void Set(const void* key, size_t key_size, const void* value,
+           size_t value_size);
+  // Returns the size of the value of |key|, or 0. Copies the value into
+  // |value| if it fits in |value_size| bytes.
+  size_t Lookup(const void* key, size_t key_size, void* value,
+                size_t value_size);
+
+  // Serializes the threads of this process; the file lock serializes
+  // processes.
+  std::mutex mutex_;
+  std::string path_;
+  int fd_;
+  uint8_t* data_;
+  size_t size_;
+  std::vector<EGLDisplay> displays_;
+  std::vector<EGLDisplay> displays_with_contexts_;
+};
+
+}  // namespace nodejsgl
+
+#endif  // NODEJS_GL_EGL_BLOB_CACHE_H_
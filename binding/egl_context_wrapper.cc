@@ -17,6 +17,8 @@
 
 #include "egl_context_wrapper.h"
 
+#include "egl_blob_cache.h"
+#include "instance_data.h"
 #include "utils.h"
 
 #include "angle/include/EGL/egl.h"
@@ -26,25 +28,10 @@
 
 namespace nodejsgl {
 
-EGLContextWrapper::EGLContextWrapper(napi_env env,
-                                     const GLContextOptions& context_options) {
-  InitEGL(env, context_options);
-  BindProcAddresses();
-  RefreshGLExtensions();
-
-#if DEBUG
-  std::cerr << "** GL_EXTENSIONS:" << std::endl;
-  gl_extensions->LogExtensions();
-  std::cerr << std::endl;
+thread_local EGLContextWrapper* EGLContextWrapper::current_ = nullptr;
 
-  std::cerr << "** REQUESTABLE_EXTENSIONS:" << std::endl;
-  angle_requestable_extensions->LogExtensions();
-  std::cerr << std::endl;
-#endif
-}
-
-void EGLContextWrapper::InitEGL(napi_env env,
-                                const GLContextOptions& context_options) {
+// Returns the initialized ANGLE display, or EGL_NO_DISPLAY after throwing.
+static EGLDisplay InitDisplay(napi_env env) {
   std::vector<EGLAttrib> display_attributes;
   display_attributes.push_back(EGL_PLATFORM_ANGLE_TYPE_ANGLE);
   // Most NVIDIA drivers will not work properly with
@@ -58,15 +45,15 @@ void EGLContextWrapper::InitEGL(napi_env env,
 
   display_attributes.push_back(EGL_NONE);
 
-  display = eglGetPlatformDisplay(EGL_PLATFORM_ANGLE_ANGLE, nullptr,
-                                  &display_attributes[0]);
+  EGLDisplay display = eglGetPlatformDisplay(EGL_PLATFORM_ANGLE_ANGLE, nullptr,
+                                             &display_attributes[0]);
   if (display == EGL_NO_DISPLAY) {
     // TODO(kreeger): This is the default path for Mac OS. Determine why egl has
     // to be initialized this way on Mac OS.
     display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
     if (display == EGL_NO_DISPLAY) {
       NAPI_THROW_ERROR(env, "No display");
-      return;
+      return EGL_NO_DISPLAY;
     }
   }
 
@@ -74,7 +61,44 @@ void EGLContextWrapper::InitEGL(napi_env env,
   EGLint minor;
   if (!eglInitialize(display, &major, &minor)) {
     NAPI_THROW_ERROR(env, "Could not initialize display");
-    return;
+    return EGL_NO_DISPLAY;
+  }
+  return display;
+}
+
+EGLContextWrapper::EGLContextWrapper(napi_env env,
+                                     const GLContextOptions& context_options)
+    : context(EGL_NO_CONTEXT), display(EGL_NO_DISPLAY),
+      surface(EGL_NO_SURFACE) {
+  InitEGL(env, context_options);
+  BindProcAddresses();
+  RefreshGLExtensions();
+
+#if DEBUG
+  std::cerr << "** GL_EXTENSIONS:" << std::endl;
+  gl_extensions->LogExtensions();
+  std::cerr << std::endl;
+
+  std::cerr << "** REQUESTABLE_EXTENSIONS:" << std::endl;
+  angle_requestable_extensions->LogExtensions();
+  std::cerr << std::endl;
+#endif
+}
+
+void EGLContextWrapper::InitEGL(napi_env env,
+                                const GLContextOptions& context_options) {
+  // Contexts of one environment share its display, so the display is only
+  // initialized once per environment.
+  InstanceData* instance_data = InstanceData::Get(env);
+  display = instance_data ? instance_data->display() : EGL_NO_DISPLAY;
+  if (display == EGL_NO_DISPLAY) {
+    display = InitDisplay(env);
+    if (display == EGL_NO_DISPLAY) {
+      return;
+    }
+    if (instance_data) {
+      instance_data->set_display(display);
+    }
   }
 
   egl_extensions = std::unique_ptr<GLExtensionsWrapper>(
@@ -85,6 +109,33 @@ void EGLContextWrapper::InitEGL(napi_env env,
   std::cerr << std::endl;
 #endif
 
+  // Must happen before the display creates its first context. Checked before
+  // Open(), which creates the file at its full size.
+  if (!context_options.blob_cache_file.empty()) {
+    if (!egl_extensions->HasExtension("EGL_ANDROID_blob_cache")) {
+      NAPI_THROW_ERROR(env, "blobCacheFile requires EGL_ANDROID_blob_cache");
+      return;
+    }
+    EGLBlobCache* blob_cache = EGLBlobCache::Get();
+    if (!blob_cache->CanRegister(display)) {
+      NAPI_THROW_ERROR(
+          env, "blobCacheFile must be passed to the first context created");
+      return;
+    }
+    std::string blob_cache_file = blob_cache->path();
+    if (!blob_cache_file.empty() &&
+        blob_cache_file != context_options.blob_cache_file) {
+      NAPI_THROW_ERROR(env, "Only one blobCacheFile can be used per process");
+      return;
+    }
+    if (!blob_cache->Open(context_options.blob_cache_file,
+                          context_options.blob_cache_max_bytes)) {
+      NAPI_THROW_ERROR(env, "Could not open blobCacheFile");
+      return;
+    }
+    blob_cache->Register(display);
+  }
+
   EGLint attrib_list[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
                           EGL_RED_SIZE,     8,
                           EGL_GREEN_SIZE,   8,
@@ -144,26 +195,36 @@ void EGLContextWrapper::InitEGL(napi_env env,
 
   context_attributes.push_back(EGL_NONE);
 
-  context = eglCreateContext(display, config, EGL_NO_CONTEXT,
+  context = eglCreateContext(display, config, context_options.share_context,
                              context_attributes.data());
   if (context == EGL_NO_CONTEXT) {
     NAPI_THROW_ERROR(env, "Could not create context");
     return;
   }
-
-  EGLint surface_attribs[] = {EGL_WIDTH, (EGLint)context_options.width,
-                              EGL_HEIGHT, (EGLint)context_options.height,
-                              EGL_NONE};
-  surface = eglCreatePbufferSurface(display, config, surface_attribs);
-  if (surface == EGL_NO_SURFACE) {
-    NAPI_THROW_ERROR(env, "Could not create surface");
-    return;
+  // Too late for blob cache functions on |display| from now on.
+  EGLBlobCache::Get()->OnCreateContext(display);
+
+  // Contexts that only render to framebuffer objects don't need a default
+  // framebuffer. Without a surface, framebuffer 0 is incomplete.
+  bool surfaceless = context_options.surfaceless;
+  if (!surfaceless ||
+      !egl_extensions->HasExtension("EGL_KHR_surfaceless_context")) {
+    EGLint width = surfaceless ? 1 : (EGLint)context_options.width;
+    EGLint height = surfaceless ? 1 : (EGLint)context_options.height;
+    EGLint surface_attribs[] = {EGL_WIDTH, width, EGL_HEIGHT, height,
+                                EGL_NONE};
+    surface = eglCreatePbufferSurface(display, config, surface_attribs);
+    if (surface == EGL_NO_SURFACE) {
+      NAPI_THROW_ERROR(env, "Could not create surface");
+      return;
+    }
   }
 
   if (!eglMakeCurrent(display, surface, surface, context)) {
     NAPI_THROW_ERROR(env, "Could not make context current");
     return;
   }
+  current_ = this;
 }
 
 void EGLContextWrapper::BindProcAddresses() {
@@ -282,13 +343,19 @@ void EGLContextWrapper::BindProcAddresses() {
       eglGetProcAddress("glGenRenderbuffers"));
   glGetAttribLocation = reinterpret_cast<PFNGLGETATTRIBLOCATIONPROC>(
       eglGetProcAddress("glGetAttribLocation"));
+  glGetBooleanv = reinterpret_cast<PFNGLGETBOOLEANVPROC>(
+      eglGetProcAddress("glGetBooleanv"));
   glGetBufferParameteriv = reinterpret_cast<PFNGLGETBUFFERPARAMETERIVPROC>(
       eglGetProcAddress("glGetBufferParameteriv"));
   glGetError =
       reinterpret_cast<PFNGLGETERRORPROC>(eglGetProcAddress("glGetError"));
+  glGetFloatv =
+      reinterpret_cast<PFNGLGETFLOATVPROC>(eglGetProcAddress("glGetFloatv"));
   glGetFramebufferAttachmentParameteriv =
       reinterpret_cast<PFNGLGETFRAMEBUFFERATTACHMENTPARAMETERIVPROC>(
           eglGetProcAddress("glGetFramebufferAttachmentParameteriv"));
+  glGetInteger64v = reinterpret_cast<PFNGLGETINTEGER64VPROC>(
+      eglGetProcAddress("glGetInteger64v"));
   glGetIntegerv = reinterpret_cast<PFNGLGETINTEGERVPROC>(
       eglGetProcAddress("glGetIntegerv"));
   glGenTextures = reinterpret_cast<PFNGLGENTEXTURESPROC>(
@@ -299,6 +366,8 @@ void EGLContextWrapper::BindProcAddresses() {
       eglGetProcAddress("glGetActiveUniform"));
   glGetAttachedShaders = reinterpret_cast<PFNGLGETATTACHEDSHADERSPROC>(
       eglGetProcAddress("glGetAttachedShaders"));
+  glGetProgramBinaryOES = reinterpret_cast<PFNGLGETPROGRAMBINARYOESPROC>(
+      eglGetProcAddress("glGetProgramBinaryOES"));
   glGetProgramiv = reinterpret_cast<PFNGLGETPROGRAMIVPROC>(
       eglGetProcAddress("glGetProgramiv"));
   glGetProgramInfoLog = reinterpret_cast<PFNGLGETPROGRAMINFOLOGPROC>(
@@ -313,6 +382,8 @@ void EGLContextWrapper::BindProcAddresses() {
   glGetShaderPrecisionFormat =
       reinterpret_cast<PFNGLGETSHADERPRECISIONFORMATPROC>(
           eglGetProcAddress("glGetShaderPrecisionFormat"));
+  glGetShaderSource = reinterpret_cast<PFNGLGETSHADERSOURCEPROC>(
+      eglGetProcAddress("glGetShaderSource"));
   glGetString =
       reinterpret_cast<PFNGLGETSTRINGPROC>(eglGetProcAddress("glGetString"));
   glGetTexParameterfv = reinterpret_cast<PFNGLGETTEXPARAMETERFVPROC>(
@@ -334,6 +405,7 @@ void EGLContextWrapper::BindProcAddresses() {
       eglGetProcAddress("glIsRenderbuffer"));
   glIsShader =
       reinterpret_cast<PFNGLISSHADERPROC>(eglGetProcAddress("glIsShader"));
+  glIsSync = reinterpret_cast<PFNGLISSYNCPROC>(eglGetProcAddress("glIsSync"));
   glIsTexture =
       reinterpret_cast<PFNGLISTEXTUREPROC>(eglGetProcAddress("glIsTexture"));
   glLineWidth =
@@ -342,10 +414,15 @@ void EGLContextWrapper::BindProcAddresses() {
       eglGetProcAddress("glLinkProgram"));
   glMapBufferRange = reinterpret_cast<PFNGLMAPBUFFERRANGEPROC>(
       eglGetProcAddress("glMapBufferRange"));
+  glMaxShaderCompilerThreadsKHR =
+      reinterpret_cast<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC>(
+          eglGetProcAddress("glMaxShaderCompilerThreadsKHR"));
   glPixelStorei = reinterpret_cast<PFNGLPIXELSTOREIPROC>(
       eglGetProcAddress("glPixelStorei"));
   glPolygonOffset = reinterpret_cast<PFNGLPOLYGONOFFSETPROC>(
       eglGetProcAddress("glPolygonOffset"));
+  glProgramBinaryOES = reinterpret_cast<PFNGLPROGRAMBINARYOESPROC>(
+      eglGetProcAddress("glProgramBinaryOES"));
   glReadPixels =
       reinterpret_cast<PFNGLREADPIXELSPROC>(eglGetProcAddress("glReadPixels"));
   glRenderbufferStorage = reinterpret_cast<PFNGLRENDERBUFFERSTORAGEPROC>(
@@ -440,6 +517,8 @@ void EGLContextWrapper::BindProcAddresses() {
       eglGetProcAddress("glVertexAttribPointer"));
   glViewport =
       reinterpret_cast<PFNGLVIEWPORTPROC>(eglGetProcAddress("glViewport"));
+  glWaitSync =
+      reinterpret_cast<PFNGLWAITSYNCPROC>(eglGetProcAddress("glWaitSync"));
 
   // ANGLE specific
   glRequestExtensionANGLE = reinterpret_cast<PFNGLREQUESTEXTENSIONANGLEPROC>(
@@ -456,12 +535,19 @@ void EGLContextWrapper::RefreshGLExtensions() {
 }
 
 EGLContextWrapper::~EGLContextWrapper() {
+  ReleaseCurrent();
   if (context) {
     if (!eglDestroyContext(display, context)) {
       std::cerr << "Failed to delete EGL context: " << std::endl;
     }
     context = nullptr;
   }
+  // Contexts are also created and destroyed with worker threads, don't leak
+  // their surfaces. The display is shared and stays initialized.
+  if (surface != EGL_NO_SURFACE) {
+    eglDestroySurface(display, surface);
+    surface = EGL_NO_SURFACE;
+  }
 
   // TODO(kreeger): Close context attributes.
   // TODO(kreeger): Cleanup global objects.
@@ -472,4 +558,38 @@ EGLContextWrapper* EGLContextWrapper::Create(
   return new EGLContextWrapper(env, context_options);
 }
 
+bool EGLContextWrapper::MakeCurrent() {
+  if (current_ == this) {
+    return true;
+  }
+  if (!eglMakeCurrent(display, surface, surface, context)) {
+    return false;
+  }
+  current_ = this;
+  return true;
+}
+
+void EGLContextWrapper::ReleaseCurrent() {
+  if (current_ != this) {
+    return;
+  }
+  eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  current_ = nullptr;
+}
+
+ScopedMakeCurrent::ScopedMakeCurrent(EGLContextWrapper* egl_context_wrapper)
+    : previous_(EGLContextWrapper::current()) {
+  if (!egl_context_wrapper || previous_ == egl_context_wrapper) {
+    previous_ = nullptr;
+    return;
+  }
+  egl_context_wrapper->MakeCurrent();
+}
+
+ScopedMakeCurrent::~ScopedMakeCurrent() {
+  if (previous_) {
+    previous_->MakeCurrent();
+  }
+}
+
 }  // namespace nodejsgl
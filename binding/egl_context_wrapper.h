@@ -41,6 +41,35 @@ struct GLContextOptions {
   uint32_t client_minor_es_version = 0;
   uint32_t width = 1;
   uint32_t height = 1;
+
+  // Makes the context current without a surface (EGL_KHR_surfaceless_context)
+  // instead of creating a |width| x |height| pbuffer. Falls back to a 1x1
+  // pbuffer if the display doesn't support it.
+  bool surfaceless = false;
+
+  // Context whose share group the new context joins, see the |shareWith|
+  // context option.
+  EGLContext share_context = EGL_NO_CONTEXT;
+
+  // File that persists ANGLE's internal caches (EGL_ANDROID_blob_cache),
+  // empty to keep them in memory only. See EGLBlobCache.
+  std::string blob_cache_file;
+  // Size of the blob cache file when it is created, 0 for the default.
+  size_t blob_cache_max_bytes = 0;
+
+  // Not used by EGL: makes create*() return GC-finalized WebGLObject wrappers.
+  bool wrap_objects = false;
+
+  // Not used by EGL: runs executeCommandsAsync() work on a native thread.
+  bool command_thread = false;
+
+  // Not used by EGL: glMaxShaderCompilerThreadsKHR() value set at creation,
+  // -1 to keep the driver default.
+  int64_t max_shader_compiler_threads = -1;
+
+  // Not used by EGL: directory of the on-disk program binary cache, empty to
+  // disable it.
+  std::string program_binary_cache_dir;
 };
 
 // Provides lookup of EGL/GL extensions.
@@ -153,18 +182,23 @@ class EGLContextWrapper {
   PFNGLGETACTIVEUNIFORMPROC glGetActiveUniform;
   PFNGLGETATTACHEDSHADERSPROC glGetAttachedShaders;
   PFNGLGETATTRIBLOCATIONPROC glGetAttribLocation;
+  PFNGLGETBOOLEANVPROC glGetBooleanv;
   PFNGLGETBUFFERPARAMETERIVPROC glGetBufferParameteriv;
   /* PFNGLGETBUFFERSUBDATAPROC glGetBufferSubData; */
   PFNGLGETERRORPROC glGetError;
+  PFNGLGETFLOATVPROC glGetFloatv;
   PFNGLGETFRAMEBUFFERATTACHMENTPARAMETERIVPROC
   glGetFramebufferAttachmentParameteriv;
+  PFNGLGETINTEGER64VPROC glGetInteger64v;
   PFNGLGETINTEGERVPROC glGetIntegerv;
+  PFNGLGETPROGRAMBINARYOESPROC glGetProgramBinaryOES;
   PFNGLGETPROGRAMIVPROC glGetProgramiv;
   PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog;
   PFNGLGETRENDERBUFFERPARAMETERIVPROC glGetRenderbufferParameteriv;
   PFNGLGETSHADERIVPROC glGetShaderiv;
   PFNGLGETSHADERINFOLOGPROC glGetShaderInfoLog;
   PFNGLGETSHADERPRECISIONFORMATPROC glGetShaderPrecisionFormat;
+  PFNGLGETSHADERSOURCEPROC glGetShaderSource;
   PFNGLGETSTRINGPROC glGetString;
   PFNGLGETTEXPARAMETERFVPROC glGetTexParameterfv;
   PFNGLGETTEXPARAMETERIVPROC glGetTexParameteriv;
@@ -176,12 +210,15 @@ class EGLContextWrapper {
   PFNGLISPROGRAMPROC glIsProgram;
   PFNGLISRENDERBUFFERPROC glIsRenderbuffer;
   PFNGLISSHADERPROC glIsShader;
+  PFNGLISSYNCPROC glIsSync;
   PFNGLISTEXTUREPROC glIsTexture;
   PFNGLLINEWIDTHPROC glLineWidth;
   PFNGLLINKPROGRAMPROC glLinkProgram;
   PFNGLMAPBUFFERRANGEPROC glMapBufferRange;
+  PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glMaxShaderCompilerThreadsKHR;
   PFNGLPIXELSTOREIPROC glPixelStorei;
   PFNGLPOLYGONOFFSETPROC glPolygonOffset;
+  PFNGLPROGRAMBINARYOESPROC glProgramBinaryOES;
   PFNGLREADPIXELSPROC glReadPixels;
   PFNGLRENDERBUFFERSTORAGEPROC glRenderbufferStorage;
   PFNGLSAMPLECOVERAGEPROC glSampleCoverage;
@@ -229,6 +266,7 @@ class EGLContextWrapper {
   PFNGLVERTEXATTRIB4FVPROC glVertexAttrib4fv;
   PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer;
   PFNGLVIEWPORTPROC glViewport;
+  PFNGLWAITSYNCPROC glWaitSync;
 
   // ANGLE specific
   PFNGLREQUESTEXTENSIONANGLEPROC glRequestExtensionANGLE;
@@ -236,13 +274,38 @@ class EGLContextWrapper {
   // Refreshes extensions list:
   void RefreshGLExtensions();
 
+  // Makes the context current on the calling thread. The current context is
+  // tracked per thread, so eglMakeCurrent() is only called when switching
+  // contexts. Returns false if eglMakeCurrent() failed.
+  bool MakeCurrent();
+
+  // Releases the context if it is current on the calling thread.
+  void ReleaseCurrent();
+
+  // Context current on the calling thread, or nullptr.
+  static EGLContextWrapper* current() { return current_; }
+
  private:
   EGLContextWrapper(napi_env env, const GLContextOptions& context_options);
 
+  static thread_local EGLContextWrapper* current_;
+
   void InitEGL(napi_env env, const GLContextOptions& context_options);
   void BindProcAddresses();
 };
 
+// Makes a context current for the lifetime of the scope and switches back to
+// the previously current context afterwards. For GL calls that may run in the
+// middle of another context's calls, e.g. from GC finalizers.
+class ScopedMakeCurrent {
+ public:
+  explicit ScopedMakeCurrent(EGLContextWrapper* egl_context_wrapper);
+  ~ScopedMakeCurrent();
+
+ private:
+  EGLContextWrapper* previous_;
+};
+
 }  // namespace nodejsgl
 
 #endif  // NODEJS_GL_EGL_CONTEXT_H_
@@ -0,0 +1,89 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "instance_data.h"
+
+#include "utils.h"
+
+namespace nodejsgl {
+
+InstanceData::InstanceData(napi_env env)
+    : env_(env), display_(EGL_NO_DISPLAY) {}
+
+InstanceData::~InstanceData() {
+  // The display is shared with other environments of the process and stays
+  // initialized.
+  for (auto& entry : constructors_) {
+    napi_delete_reference(env_, entry.second);
+  }
+}
+
+/* static */
+napi_status InstanceData::Init(napi_env env) {
+  InstanceData* instance_data = new InstanceData(env);
+  napi_status nstatus =
+      napi_set_instance_data(env, instance_data, Finalize, nullptr);
+  if (nstatus != napi_ok) {
+    delete instance_data;
+  }
+  return nstatus;
+}
+
+/* static */
+InstanceData* InstanceData::Get(napi_env env) {
+  void* data = nullptr;
+  napi_status nstatus = napi_get_instance_data(env, &data);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  return static_cast<InstanceData*>(data);
+}
+
+/* static */
+napi_status InstanceData::SetConstructor(napi_env env, const void* key,
+                                         napi_value ctor_value) {
+  InstanceData* instance_data = Get(env);
+  if (!instance_data) {
+    return napi_generic_failure;
+  }
+
+  napi_ref& ref = instance_data->constructors_[key];
+  if (ref) {
+    napi_delete_reference(env, ref);
+  }
+  return napi_create_reference(env, ctor_value, 1, &ref);
+}
+
+/* static */
+napi_status InstanceData::GetConstructor(napi_env env, const void* key,
+                                         napi_value* ctor_value) {
+  InstanceData* instance_data = Get(env);
+  if (!instance_data) {
+    return napi_generic_failure;
+  }
+
+  auto it = instance_data->constructors_.find(key);
+  if (it == instance_data->constructors_.end()) {
+    return napi_generic_failure;
+  }
+  return napi_get_reference_value(env, it->second, ctor_value);
+}
+
+/* static */
+void InstanceData::Finalize(napi_env env, void* data, void* hint) {
+  delete static_cast<InstanceData*>(data);
+}
+
+}  // namespace nodejsgl
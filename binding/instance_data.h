@@ -0,0 +1,67 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef NODEJS_GL_INSTANCE_DATA_H_
+#define NODEJS_GL_INSTANCE_DATA_H_
+
+#include <node_api.h>
+
+#include <unordered_map>
+
+#include "angle/include/EGL/egl.h"
+
+namespace nodejsgl {
+
+// Per-environment state of the addon, stored with napi_set_instance_data().
+// Every environment that loads the addon (the main thread and each
+// worker_threads Worker) gets its own, so no napi_ref is shared between
+// environments. Contexts of one environment share its EGL display.
+class InstanceData {
+ public:
+  // Creates the instance data of |env|. Called once when the addon is loaded
+  // into an environment.
+  static napi_status Init(napi_env env);
+
+  // Returns the instance data of |env|, or nullptr if Init() failed.
+  static InstanceData* Get(napi_env env);
+
+  // Stores the constructor of a class defined by the addon in the instance
+  // data of |env|. |key| is the address of a static variable unique to the
+  // class.
+  static napi_status SetConstructor(napi_env env, const void* key,
+                                    napi_value ctor_value);
+  static napi_status GetConstructor(napi_env env, const void* key,
+                                    napi_value* ctor_value);
+
+  // Initialized display, or EGL_NO_DISPLAY before the first context.
+  EGLDisplay display() const { return display_; }
+  void set_display(EGLDisplay display) { display_ = display; }
+
+ private:
+  explicit InstanceData(napi_env env);
+  ~InstanceData();
+
+  static void Finalize(napi_env env, void* data, void* hint);
+
+  napi_env env_;
+  std::unordered_map<const void*, napi_ref> constructors_;
+  EGLDisplay display_;
+};
+
+}  // namespace nodejsgl
+
+#endif  // NODEJS_GL_INSTANCE_DATA_H_
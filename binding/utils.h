@@ -193,6 +193,13 @@ inline bool EnsureValueIsArrayLike(napi_env env, napi_value value,
     return true;
   }
 
+  bool is_dataview;
+  nstatus = napi_is_dataview(env, value, &is_dataview);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, false);
+  if (is_dataview) {
+    return true;
+  }
+
   return false;
 }
 
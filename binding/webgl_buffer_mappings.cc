@@ -0,0 +1,95 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "webgl_buffer_mappings.h"
+
+#include "utils.h"
+
+namespace nodejsgl {
+
+GLBufferMappings::GLBufferMappings(napi_env env,
+                                   EGLContextWrapper* egl_context_wrapper,
+                                   GLStateCache* state_cache)
+    : env_(env), egl_(egl_context_wrapper), state_cache_(state_cache) {}
+
+GLBufferMappings::~GLBufferMappings() {
+  // The buffers go away with the context.
+  while (!arraybuffers_.empty()) {
+    Detach(arraybuffers_.begin()->first);
+  }
+}
+
+napi_status GLBufferMappings::Map(GLenum target, GLintptr offset,
+                                  GLsizeiptr length, GLbitfield access,
+                                  napi_value* result) {
+#if NAPI_VERSION >= 7
+  GLuint buffer = state_cache_->buffer_binding(target);
+  void* mapped = egl_->glMapBufferRange(target, offset, length, access);
+  if (!mapped || buffer == 0) {
+    return napi_get_null(env_, result);
+  }
+
+  // GL owns the memory, so the ArrayBuffer has nothing to free.
+  napi_status nstatus = napi_create_external_arraybuffer(
+      env_, mapped, length, nullptr, nullptr, result);
+  if (nstatus == napi_ok) {
+    napi_ref ref;
+    nstatus = napi_create_reference(env_, *result, 0, &ref);
+    if (nstatus == napi_ok) {
+      arraybuffers_[buffer] = ref;
+    }
+  }
+  if (nstatus != napi_ok) {
+    egl_->glUnmapBuffer(target);
+  }
+  return nstatus;
+#else
+  NAPI_THROW_ERROR(env_, "mapBufferRange() requires N-API version 7");
+  return napi_generic_failure;
+#endif
+}
+
+GLboolean GLBufferMappings::Unmap(GLenum target) {
+  Detach(state_cache_->buffer_binding(target));
+  return egl_->glUnmapBuffer(target);
+}
+
+void GLBufferMappings::OnBufferData(GLenum target) {
+  Detach(state_cache_->buffer_binding(target));
+}
+
+void GLBufferMappings::OnDeleteBuffer(GLuint buffer) { Detach(buffer); }
+
+void GLBufferMappings::Detach(GLuint buffer) {
+  auto it = arraybuffers_.find(buffer);
+  if (it == arraybuffers_.end()) {
+    return;
+  }
+
+#if NAPI_VERSION >= 7
+  // The ArrayBuffer may already have been collected.
+  napi_value arraybuffer_value = nullptr;
+  napi_get_reference_value(env_, it->second, &arraybuffer_value);
+  if (arraybuffer_value) {
+    napi_detach_arraybuffer(env_, arraybuffer_value);
+  }
+#endif
+  napi_delete_reference(env_, it->second);
+  arraybuffers_.erase(it);
+}
+
+}  // namespace nodejsgl
@@ -0,0 +1,71 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef NODEJS_GL_WEBGL_BUFFER_MAPPINGS_H_
+#define NODEJS_GL_WEBGL_BUFFER_MAPPINGS_H_
+
+#include <node_api.h>
+
+#include <unordered_map>
+
+#include "egl_context_wrapper.h"
+#include "webgl_state_cache.h"
+
+namespace nodejsgl {
+
+// Exposes mapped buffer ranges to JS as external ArrayBuffers that alias the
+// mapped memory. The ArrayBuffer of a mapping is detached as soon as the
+// mapping ends, whether through unmapBuffer() or because GL implicitly
+// unmapped the buffer (deleteBuffer(), bufferData()), so JS never sees a
+// dangling pointer.
+//
+// Detaching needs N-API 7. Older Node versions can't map buffers from JS.
+class GLBufferMappings {
+ public:
+  GLBufferMappings(napi_env env, EGLContextWrapper* egl_context_wrapper,
+                   GLStateCache* state_cache);
+  ~GLBufferMappings();
+
+  // Maps |length| bytes at |offset| of the buffer bound to |target| and
+  // returns an ArrayBuffer aliasing them, or null if GL could not map the
+  // range (GL reports the error).
+  napi_status Map(GLenum target, GLintptr offset, GLsizeiptr length,
+                  GLbitfield access, napi_value* result);
+
+  // Unmaps the buffer bound to |target| and detaches its ArrayBuffer. Returns
+  // the result of glUnmapBuffer().
+  GLboolean Unmap(GLenum target);
+
+  // GL implicitly unmaps buffers that are deleted or re-specified.
+  void OnBufferData(GLenum target);
+  void OnDeleteBuffer(GLuint buffer);
+
+ private:
+  // Detaches the ArrayBuffer of |buffer|, if it is mapped.
+  void Detach(GLuint buffer);
+
+  napi_env env_;
+  EGLContextWrapper* egl_;
+  GLStateCache* state_cache_;
+
+  // Weak references to the ArrayBuffers of mapped buffers, by buffer.
+  std::unordered_map<GLuint, napi_ref> arraybuffers_;
+};
+
+}  // namespace nodejsgl
+
+#endif  // NODEJS_GL_WEBGL_BUFFER_MAPPINGS_H_
@@ -0,0 +1,327 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "webgl_command_buffer.h"
+
+#include <cstring>
+
+namespace nodejsgl {
+
+// Number of argument words that follow each opcode in the command stream.
+static const uint8_t kCommandArgCounts[kCommandOpcodeCount] = {
+    1,  // kCommandActiveTexture
+    2,  // kCommandBindBuffer
+    2,  // kCommandBindFramebuffer
+    2,  // kCommandBindRenderbuffer
+    2,  // kCommandBindTexture
+    4,  // kCommandBlendColor
+    1,  // kCommandBlendEquation
+    2,  // kCommandBlendFunc
+    1,  // kCommandClear
+    4,  // kCommandClearColor
+    4,  // kCommandColorMask
+    1,  // kCommandCullFace
+    1,  // kCommandDepthFunc
+    1,  // kCommandDepthMask
+    1,  // kCommandDisable
+    1,  // kCommandDisableVertexAttribArray
+    3,  // kCommandDrawArrays
+    4,  // kCommandDrawElements
+    1,  // kCommandEnable
+    1,  // kCommandEnableVertexAttribArray
+    0,  // kCommandFlush
+    4,  // kCommandFramebufferRenderbuffer
+    5,  // kCommandFramebufferTexture2D
+    2,  // kCommandPixelStorei
+    4,  // kCommandScissor
+    3,  // kCommandTexParameterf
+    3,  // kCommandTexParameteri
+    2,  // kCommandUniform1f
+    2,  // kCommandUniform1i
+    3,  // kCommandUniform2f
+    3,  // kCommandUniform2i
+    4,  // kCommandUniform3f
+    4,  // kCommandUniform3i
+    5,  // kCommandUniform4f
+    5,  // kCommandUniform4i
+    1,  // kCommandUseProgram
+    6,  // kCommandVertexAttribPointer
+    4,  // kCommandViewport
+};
+
+// Sequential reader over the argument words of a single command.
+class CommandArgs {
+ public:
+  explicit CommandArgs(const uint32_t* words) : words_(words) {}
+
+  GLuint U() { return *words_++; }
+
+  GLint I() {
+    GLint value;
+    memcpy(&value, words_++, sizeof(value));
+    return value;
+  }
+
+  GLfloat F() {
+    GLfloat value;
+    memcpy(&value, words_++, sizeof(value));
+    return value;
+  }
+
+  GLboolean B() { return *words_++ != 0 ? GL_TRUE : GL_FALSE; }
+
+ private:
+  const uint32_t* words_;
+};
+
+bool ExecuteCommandBuffer(GLStateCache* state_cache,
+                          GLProgramCache* program_cache, const uint32_t* words,
+                          size_t word_count, uint32_t command_count,
+                          uint32_t* error_index) {
+  EGLContextWrapper* egl = state_cache->egl_context_wrapper();
+  size_t pos = 0;
+  for (uint32_t i = 0; i < command_count; ++i) {
+    if (pos >= word_count || words[pos] >= kCommandOpcodeCount ||
+        word_count - pos - 1 < kCommandArgCounts[words[pos]]) {
+      *error_index = i;
+      return false;
+    }
+
+    const uint32_t opcode = words[pos];
+    CommandArgs a(words + pos + 1);
+    pos += 1 + kCommandArgCounts[opcode];
+
+    // NOTE: Arguments are read into locals before calling through so the
+    // evaluation order of the reads is well defined.
+    switch (opcode) {
+      case kCommandActiveTexture:
+        state_cache->ActiveTexture(a.U());
+        break;
+      case kCommandBindBuffer: {
+        GLenum target = a.U();
+        state_cache->BindBuffer(target, a.U());
+        break;
+      }
+      case kCommandBindFramebuffer: {
+        GLenum target = a.U();
+        state_cache->BindFramebuffer(target, a.U());
+        break;
+      }
+      case kCommandBindRenderbuffer: {
+        GLenum target = a.U();
+        state_cache->BindRenderbuffer(target, a.U());
+        break;
+      }
+      case kCommandBindTexture: {
+        GLenum target = a.U();
+        state_cache->BindTexture(target, a.U());
+        break;
+      }
+      case kCommandBlendColor: {
+        GLfloat r = a.F();
+        GLfloat g = a.F();
+        GLfloat b = a.F();
+        state_cache->BlendColor(r, g, b, a.F());
+        break;
+      }
+      case kCommandBlendEquation:
+        state_cache->BlendEquation(a.U());
+        break;
+      case kCommandBlendFunc: {
+        GLenum sfactor = a.U();
+        state_cache->BlendFunc(sfactor, a.U());
+        break;
+      }
+      case kCommandClear:
+        egl->glClear(a.U());
+        break;
+      case kCommandClearColor: {
+        GLfloat r = a.F();
+        GLfloat g = a.F();
+        GLfloat b = a.F();
+        state_cache->ClearColor(r, g, b, a.F());
+        break;
+      }
+      case kCommandColorMask: {
+        GLboolean r = a.B();
+        GLboolean g = a.B();
+        GLboolean b = a.B();
+        state_cache->ColorMask(r, g, b, a.B());
+        break;
+      }
+      case kCommandCullFace:
+        state_cache->CullFace(a.U());
+        break;
+      case kCommandDepthFunc:
+        state_cache->DepthFunc(a.U());
+        break;
+      case kCommandDepthMask:
+        state_cache->DepthMask(a.B());
+        break;
+      case kCommandDisable:
+        state_cache->Disable(a.U());
+        break;
+      case kCommandDisableVertexAttribArray:
+        egl->glDisableVertexAttribArray(a.U());
+        break;
+      case kCommandDrawArrays: {
+        GLenum mode = a.U();
+        GLint first = a.I();
+        egl->glDrawArrays(mode, first, a.I());
+        break;
+      }
+      case kCommandDrawElements: {
+        GLenum mode = a.U();
+        GLsizei count = a.I();
+        GLenum type = a.U();
+        egl->glDrawElements(mode, count, type,
+                            reinterpret_cast<const void*>(
+                                static_cast<uintptr_t>(a.U())));
+        break;
+      }
+      case kCommandEnable:
+        state_cache->Enable(a.U());
+        break;
+      case kCommandEnableVertexAttribArray:
+        egl->glEnableVertexAttribArray(a.U());
+        break;
+      case kCommandFlush:
+        egl->glFlush();
+        break;
+      case kCommandFramebufferRenderbuffer: {
+        GLenum target = a.U();
+        GLenum attachment = a.U();
+        GLenum renderbuffer_target = a.U();
+        egl->glFramebufferRenderbuffer(target, attachment, renderbuffer_target,
+                                       a.U());
+        break;
+      }
+      case kCommandFramebufferTexture2D: {
+        GLenum target = a.U();
+        GLenum attachment = a.U();
+        GLenum tex_target = a.U();
+        GLuint texture = a.U();
+        egl->glFramebufferTexture2D(target, attachment, tex_target, texture,
+                                    a.I());
+        break;
+      }
+      case kCommandPixelStorei: {
+        GLenum pname = a.U();
+        state_cache->PixelStorei(pname, a.I());
+        break;
+      }
+      case kCommandScissor: {
+        GLint x = a.I();
+        GLint y = a.I();
+        GLsizei width = a.I();
+        state_cache->Scissor(x, y, width, a.I());
+        break;
+      }
+      case kCommandTexParameterf: {
+        GLenum target = a.U();
+        GLenum pname = a.U();
+        egl->glTexParameterf(target, pname, a.F());
+        break;
+      }
+      case kCommandTexParameteri: {
+        GLenum target = a.U();
+        GLenum pname = a.U();
+        egl->glTexParameteri(target, pname, a.I());
+        break;
+      }
+      case kCommandUniform1f: {
+        GLint location = a.I();
+        program_cache->Uniform1f(location, a.F());
+        break;
+      }
+      case kCommandUniform1i: {
+        GLint location = a.I();
+        program_cache->Uniform1i(location, a.I());
+        break;
+      }
+      case kCommandUniform2f: {
+        GLint location = a.I();
+        GLfloat v0 = a.F();
+        program_cache->Uniform2f(location, v0, a.F());
+        break;
+      }
+      case kCommandUniform2i: {
+        GLint location = a.I();
+        GLint v0 = a.I();
+        program_cache->Uniform2i(location, v0, a.I());
+        break;
+      }
+      case kCommandUniform3f: {
+        GLint location = a.I();
+        GLfloat v0 = a.F();
+        GLfloat v1 = a.F();
+        program_cache->Uniform3f(location, v0, v1, a.F());
+        break;
+      }
+      case kCommandUniform3i: {
+        GLint location = a.I();
+        GLint v0 = a.I();
+        GLint v1 = a.I();
+        program_cache->Uniform3i(location, v0, v1, a.I());
+        break;
+      }
+      case kCommandUniform4f: {
+        GLint location = a.I();
+        GLfloat v0 = a.F();
+        GLfloat v1 = a.F();
+        GLfloat v2 = a.F();
+        program_cache->Uniform4f(location, v0, v1, v2, a.F());
+        break;
+      }
+      case kCommandUniform4i: {
+        GLint location = a.I();
+        GLint v0 = a.I();
+        GLint v1 = a.I();
+        GLint v2 = a.I();
+        program_cache->Uniform4i(location, v0, v1, v2, a.I());
+        break;
+      }
+      case kCommandUseProgram:
+        state_cache->UseProgram(a.U());
+        break;
+      case kCommandVertexAttribPointer: {
+        GLuint index = a.U();
+        GLint size = a.I();
+        GLenum type = a.U();
+        GLboolean normalized = a.B();
+        GLsizei stride = a.I();
+        egl->glVertexAttribPointer(index, size, type, normalized, stride,
+                                   reinterpret_cast<const void*>(
+                                       static_cast<uintptr_t>(a.U())));
+        break;
+      }
+      case kCommandViewport: {
+        GLint x = a.I();
+        GLint y = a.I();
+        GLsizei width = a.I();
+        state_cache->Viewport(x, y, width, a.I());
+        break;
+      }
+      default:
+        *error_index = i;
+        return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace nodejsgl
@@ -0,0 +1,94 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef NODEJS_GL_WEBGL_COMMAND_BUFFER_H_
+#define NODEJS_GL_WEBGL_COMMAND_BUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "egl_context_wrapper.h"
+#include "webgl_program_cache.h"
+#include "webgl_state_cache.h"
+
+namespace nodejsgl {
+
+// Opcodes for the packed command stream consumed by executeCommands(). A
+// command is a single 32-bit opcode word followed by a fixed number of 32-bit
+// argument words (see kCommandArgCounts). Integer arguments are stored as
+// int32/uint32, float arguments as IEEE-754 float32 bit patterns and booleans
+// as 0/1.
+//
+// NOTE: This list must be kept in sync with the JS encoder in
+// src/command_buffer.ts. Only append new opcodes to the end.
+enum CommandOpcode : uint32_t {
+  kCommandActiveTexture = 0,
+  kCommandBindBuffer = 1,
+  kCommandBindFramebuffer = 2,
+  kCommandBindRenderbuffer = 3,
+  kCommandBindTexture = 4,
+  kCommandBlendColor = 5,
+  kCommandBlendEquation = 6,
+  kCommandBlendFunc = 7,
+  kCommandClear = 8,
+  kCommandClearColor = 9,
+  kCommandColorMask = 10,
+  kCommandCullFace = 11,
+  kCommandDepthFunc = 12,
+  kCommandDepthMask = 13,
+  kCommandDisable = 14,
+  kCommandDisableVertexAttribArray = 15,
+  kCommandDrawArrays = 16,
+  kCommandDrawElements = 17,
+  kCommandEnable = 18,
+  kCommandEnableVertexAttribArray = 19,
+  kCommandFlush = 20,
+  kCommandFramebufferRenderbuffer = 21,
+  kCommandFramebufferTexture2D = 22,
+  kCommandPixelStorei = 23,
+  kCommandScissor = 24,
+  kCommandTexParameterf = 25,
+  kCommandTexParameteri = 26,
+  kCommandUniform1f = 27,
+  kCommandUniform1i = 28,
+  kCommandUniform2f = 29,
+  kCommandUniform2i = 30,
+  kCommandUniform3f = 31,
+  kCommandUniform3i = 32,
+  kCommandUniform4f = 33,
+  kCommandUniform4i = 34,
+  kCommandUseProgram = 35,
+  kCommandVertexAttribPointer = 36,
+  kCommandViewport = 37,
+
+  kCommandOpcodeCount
+};
+
+// Decodes and executes |command_count| commands from the packed stream in
+// |words| (|word_count| 32-bit words long). Returns false if the stream is
+// malformed (unknown opcode or truncated arguments) and sets |error_index| to
+// the index of the offending command. Commands before the offending command
+// have already been executed. State changes go through |state_cache| and
+// uniform uploads through |program_cache|.
+bool ExecuteCommandBuffer(GLStateCache* state_cache,
+                          GLProgramCache* program_cache, const uint32_t* words,
+                          size_t word_count, uint32_t command_count,
+                          uint32_t* error_index);
+
+}  // namespace nodejsgl
+
+#endif  // NODEJS_GL_WEBGL_COMMAND_BUFFER_H_
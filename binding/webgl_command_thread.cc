@@ -0,0 +1,290 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "webgl_command_thread.h"
+
+#include <cstring>
+
+#include "utils.h"
+#include "webgl_command_buffer.h"
+
+namespace nodejsgl {
+
+GLCommandThread::GLCommandThread(napi_env env,
+                                 EGLContextWrapper* egl_context_wrapper,
+                                 GLStateCache* state_cache,
+                                 GLProgramCache* program_cache)
+    : env_(env),
+      egl_(egl_context_wrapper),
+      state_cache_(state_cache),
+      program_cache_(program_cache),
+      context_ref_(nullptr),
+      async_context_(nullptr),
+      async_(nullptr),
+      referenced_(false),
+      js_thread_current_(true),
+      ring_(kInitialRingWords),
+      head_(0),
+      tail_(0),
+      worker_sleeping_(false),
+      idle_(true),
+      stop_(false) {
+  napi_value resource_name;
+  napi_status nstatus = napi_create_string_utf8(
+      env, "nodejsgl.GLCommandThread", NAPI_AUTO_LENGTH, &resource_name);
+  ENSURE_NAPI_OK(env, nstatus);
+
+  nstatus = napi_async_init(env, nullptr, resource_name, &async_context_);
+  ENSURE_NAPI_OK(env, nstatus);
+
+  uv_loop_t* loop = nullptr;
+  nstatus = napi_get_uv_event_loop(env, &loop);
+  ENSURE_NAPI_OK(env, nstatus);
+
+  async_ = new uv_async_t;
+  uv_async_init(loop, async_, OnAsync);
+  async_->data = this;
+  // Only keeps the loop alive while work is queued.
+  uv_unref(reinterpret_cast<uv_handle_t*>(async_));
+
+  thread_ = std::thread(&GLCommandThread::Run, this);
+}
+
+GLCommandThread::~GLCommandThread() {
+  // Queued work still runs. Callbacks that did not run yet are dropped.
+  if (thread_.joinable()) {
+    Synchronize();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    work_cv_.notify_one();
+    thread_.join();
+  }
+  if (async_) {
+    async_->data = nullptr;
+    uv_close(reinterpret_cast<uv_handle_t*>(async_), OnClose);
+  }
+  if (async_context_) {
+    napi_async_destroy(env_, async_context_);
+  }
+}
+
+napi_status GLCommandThread::Submit(const uint32_t* words, size_t word_count,
+                                    uint32_t command_count,
+                                    Callback callback) {
+  PacketHeader header = {kPacketCommands, static_cast<uint32_t>(word_count),
+                         command_count};
+  return Push(header, words, std::move(callback));
+}
+
+napi_status GLCommandThread::Finish(Callback callback) {
+  PacketHeader header = {kPacketFinish, 0, 0};
+  return Push(header, nullptr, std::move(callback));
+}
+
+void GLCommandThread::Synchronize() {
+  if (js_thread_current_) {
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this]() { return idle_ && head_ == tail_; });
+  }
+  egl_->MakeCurrent();
+  js_thread_current_ = true;
+}
+
+napi_status GLCommandThread::Push(const PacketHeader& header,
+                                  const uint32_t* words, Callback callback) {
+  if (!async_) {
+    return napi_generic_failure;
+  }
+
+  size_t needed = kHeaderWords + header.word_count;
+  uint64_t head = head_.load(std::memory_order_relaxed);
+  if (ring_.size() - (head - tail_.load(std::memory_order_acquire)) < needed) {
+    // Back pressure: wait for the worker to catch up. The ring is empty
+    // afterwards and can be resized safely.
+    Synchronize();
+    if (needed > ring_.size()) {
+      size_t size = ring_.size();
+      while (size < needed) {
+        size *= 2;
+      }
+      ring_.resize(size);
+    }
+  }
+
+  if (!referenced_) {
+    // Keep the context alive until the last callback ran.
+    uint32_t ref_count;
+    napi_status nstatus = napi_reference_ref(env_, context_ref_, &ref_count);
+    ENSURE_NAPI_OK_RETVAL(env_, nstatus, nstatus);
+    uv_ref(reinterpret_cast<uv_handle_t*>(async_));
+    referenced_ = true;
+  }
+  callbacks_.push_back(std::move(callback));
+
+  // Hand the context over to the worker.
+  if (js_thread_current_) {
+    egl_->ReleaseCurrent();
+    js_thread_current_ = false;
+  }
+
+  WriteWords(head, reinterpret_cast<const uint32_t*>(&header), kHeaderWords);
+  if (header.word_count > 0) {
+    WriteWords(head + kHeaderWords, words, header.word_count);
+  }
+  head_.store(head + needed);
+
+  if (worker_sleeping_) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    work_cv_.notify_one();
+  }
+  return napi_ok;
+}
+
+void GLCommandThread::WriteWords(uint64_t position, const uint32_t* words,
+                                 size_t count) {
+  size_t start = position & (ring_.size() - 1);
+  size_t first = std::min(count, ring_.size() - start);
+  memcpy(&ring_[start], words, first * sizeof(uint32_t));
+  memcpy(&ring_[0], words + first, (count - first) * sizeof(uint32_t));
+}
+
+void GLCommandThread::ReadWords(uint64_t position, uint32_t* words,
+                                size_t count) {
+  size_t start = position & (ring_.size() - 1);
+  size_t first = std::min(count, ring_.size() - start);
+  memcpy(words, &ring_[start], first * sizeof(uint32_t));
+  memcpy(words + first, &ring_[0], (count - first) * sizeof(uint32_t));
+}
+
+void GLCommandThread::Run() {
+  // Holds packets that wrap around the end of the ring.
+  std::vector<uint32_t> wrapped;
+
+  while (true) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (head_ == tail) {
+      egl_->ReleaseCurrent();
+
+      std::unique_lock<std::mutex> lock(mutex_);
+      idle_ = true;
+      idle_cv_.notify_all();
+      worker_sleeping_ = true;
+      work_cv_.wait(lock, [this, tail]() { return stop_ || head_ != tail; });
+      worker_sleeping_ = false;
+      if (head_ == tail) {
+        break;
+      }
+      idle_ = false;
+      continue;
+    }
+
+    egl_->MakeCurrent();
+
+    PacketHeader header;
+    ReadWords(tail, reinterpret_cast<uint32_t*>(&header), kHeaderWords);
+
+    Result result = {true, 0};
+    if (header.type == kPacketFinish) {
+      egl_->glFinish();
+    } else {
+      const uint32_t* words;
+      size_t start = (tail + kHeaderWords) & (ring_.size() - 1);
+      if (start + header.word_count <= ring_.size()) {
+        words = &ring_[start];
+      } else {
+        wrapped.resize(header.word_count);
+        ReadWords(tail + kHeaderWords, wrapped.data(), header.word_count);
+        words = wrapped.data();
+      }
+      result.ok = ExecuteCommandBuffer(state_cache_, program_cache_, words,
+                                       header.word_count, header.command_count,
+                                       &result.error_index);
+    }
+    tail_.store(tail + kHeaderWords + header.word_count);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      results_.push_back(result);
+    }
+    uv_async_send(async_);
+  }
+}
+
+/* static */
+void GLCommandThread::OnAsync(uv_async_t* async) {
+  GLCommandThread* command_thread = static_cast<GLCommandThread*>(async->data);
+  if (command_thread) {
+    command_thread->RunCallbacks();
+  }
+}
+
+/* static */
+void GLCommandThread::OnClose(uv_handle_t* handle) {
+  delete reinterpret_cast<uv_async_t*>(handle);
+}
+
+void GLCommandThread::RunCallbacks() {
+  std::vector<Result> results;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    results.swap(results_);
+  }
+  if (results.empty()) {
+    return;
+  }
+
+  napi_handle_scope handle_scope;
+  napi_status nstatus = napi_open_handle_scope(env_, &handle_scope);
+  ENSURE_NAPI_OK(env_, nstatus);
+
+  napi_value resource;
+  nstatus = napi_create_object(env_, &resource);
+  ENSURE_NAPI_OK(env_, nstatus);
+
+  // Promise reactions queued by the callbacks run when the scope closes.
+  napi_callback_scope callback_scope;
+  nstatus = napi_open_callback_scope(env_, resource, async_context_,
+                                     &callback_scope);
+  ENSURE_NAPI_OK(env_, nstatus);
+
+  for (const Result& result : results) {
+    Callback callback = std::move(callbacks_.front());
+    callbacks_.pop_front();
+    callback(env_, result.ok, result.error_index);
+  }
+
+  napi_close_callback_scope(env_, callback_scope);
+  napi_close_handle_scope(env_, handle_scope);
+
+  if (callbacks_.empty() && referenced_) {
+    uv_unref(reinterpret_cast<uv_handle_t*>(async_));
+    referenced_ = false;
+
+    // Must be last: the context may be collected once it is unreferenced.
+    uint32_t ref_count;
+    nstatus = napi_reference_unref(env_, context_ref_, &ref_count);
+    ENSURE_NAPI_OK(env_, nstatus);
+  }
+}
+
+}  // namespace nodejsgl
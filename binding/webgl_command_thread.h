@@ -0,0 +1,156 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef NODEJS_GL_WEBGL_COMMAND_THREAD_H_
+#define NODEJS_GL_WEBGL_COMMAND_THREAD_H_
+
+#include <node_api.h>
+#include <uv.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "egl_context_wrapper.h"
+#include "webgl_program_cache.h"
+#include "webgl_state_cache.h"
+
+namespace nodejsgl {
+
+// Runs command streams (see webgl_command_buffer.h) on a dedicated native
+// thread, so long GPU work doesn't block the event loop. The JS thread copies
+// each stream into a lock-free single-producer/single-consumer ring and
+// returns right away. The worker drains the ring with the context current on
+// its thread, and results are delivered back on the JS thread.
+//
+// The EGL context is current on at most one thread at a time. Submitting work
+// releases it on the JS thread and the worker releases it once the ring runs
+// empty. Every other use of the context from the JS thread must be preceded
+// by Synchronize().
+class GLCommandThread {
+ public:
+  // |ok| is false if the stream was malformed, with |error_index| set to the
+  // offending command. Runs on the JS thread inside a handle and callback
+  // scope.
+  typedef std::function<void(napi_env env, bool ok, uint32_t error_index)>
+      Callback;
+
+  GLCommandThread(napi_env env, EGLContextWrapper* egl_context_wrapper,
+                  GLStateCache* state_cache, GLProgramCache* program_cache);
+  ~GLCommandThread();
+
+  // The context is kept alive through |context_ref| while work is queued.
+  // Must be set before the first Submit().
+  void set_context_ref(napi_ref context_ref) { context_ref_ = context_ref; }
+
+  // Queues |command_count| commands from |words|, which are copied. Runs
+  // |callback| once they were executed.
+  napi_status Submit(const uint32_t* words, size_t word_count,
+                     uint32_t command_count, Callback callback);
+
+  // Queues a glFinish() and runs |callback| once it returned.
+  napi_status Finish(Callback callback);
+
+  // Waits until all queued work ran and makes the context current on the JS
+  // thread again. Cheap if nothing was queued since the last call.
+  void Synchronize();
+
+ private:
+  // Initial ring size in 32-bit words. The ring grows for larger streams.
+  static const size_t kInitialRingWords = 256 * 1024;
+
+  enum PacketType : uint32_t {
+    kPacketCommands,
+    kPacketFinish,
+  };
+
+  // Precedes the command words of each packet in the ring.
+  struct PacketHeader {
+    uint32_t type;
+    uint32_t word_count;
+    uint32_t command_count;
+  };
+  static const size_t kHeaderWords = sizeof(PacketHeader) / sizeof(uint32_t);
+
+  struct Result {
+    bool ok;
+    uint32_t error_index;
+  };
+
+  static void OnAsync(uv_async_t* async);
+  static void OnClose(uv_handle_t* handle);
+
+  napi_status Push(const PacketHeader& header, const uint32_t* words,
+                   Callback callback);
+
+  // Copies |count| words between the ring and |words|, wrapping around the
+  // end of the ring.
+  void WriteWords(uint64_t position, const uint32_t* words, size_t count);
+  void ReadWords(uint64_t position, uint32_t* words, size_t count);
+
+  // Worker thread.
+  void Run();
+
+  // Runs the callbacks of finished packets on the JS thread.
+  void RunCallbacks();
+
+  napi_env env_;
+  EGLContextWrapper* egl_;
+  GLStateCache* state_cache_;
+  GLProgramCache* program_cache_;
+  napi_ref context_ref_;
+  napi_async_context async_context_;
+  uv_async_t* async_;
+  bool referenced_;
+
+  // Whether the worker handed the context back to the JS thread. Only used
+  // there.
+  bool js_thread_current_;
+
+  // Ring of packets. |head_| is only written by the JS thread and |tail_|
+  // only by the worker. Both count words since the start and are masked into
+  // |ring_|, whose size is a power of two.
+  std::vector<uint32_t> ring_;
+  std::atomic<uint64_t> head_;
+  std::atomic<uint64_t> tail_;
+
+  // Callbacks of packets in submission order. Only used on the JS thread.
+  std::deque<Callback> callbacks_;
+
+  // Sleep and wake-up of the two threads. The ring itself is not locked.
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable idle_cv_;
+  std::atomic<bool> worker_sleeping_;
+  bool idle_;  // Ring empty and context released by the worker.
+  bool stop_;
+
+  // Results of finished packets, in order, guarded by |mutex_|.
+  std::vector<Result> results_;
+
+  std::thread thread_;
+};
+
+}  // namespace nodejsgl
+
+#endif  // NODEJS_GL_WEBGL_COMMAND_THREAD_H_
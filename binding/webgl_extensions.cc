@@ -19,6 +19,7 @@
 
 #include "angle/include/GLES2/gl2.h"
 #include "angle/include/GLES2/gl2ext.h"
+#include "instance_data.h"
 
 #include "utils.h"
 
@@ -59,12 +60,12 @@ napi_value GLExtensionBase::InitStubClass(napi_env env,
 
 /* static */
 napi_status GLExtensionBase::NewInstanceBase(napi_env env,
-                                             napi_ref constructor_ref,
+                                             const void* constructor_key,
                                              napi_value* instance) {
   napi_status nstatus;
 
   napi_value ctor_value;
-  nstatus = napi_get_reference_value(env, constructor_ref, &ctor_value);
+  nstatus = InstanceData::GetConstructor(env, constructor_key, &ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   nstatus = napi_new_instance(env, ctor_value, 0, nullptr, instance);
@@ -76,7 +77,7 @@ napi_status GLExtensionBase::NewInstanceBase(napi_env env,
 //==============================================================================
 // ANGLEInstancedArraysExtension
 
-napi_ref ANGLEInstancedArraysExtension::constructor_ref_;
+char ANGLEInstancedArraysExtension::constructor_key_;
 
 ANGLEInstancedArraysExtension::ANGLEInstancedArraysExtension(napi_env env)
     : GLExtensionBase(env) {}
@@ -98,7 +99,7 @@ napi_status ANGLEInstancedArraysExtension::Register(napi_env env,
                               nullptr, 0, nullptr, &ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  nstatus = napi_create_reference(env, ctor_value, 1, &constructor_ref_);
+  nstatus = InstanceData::SetConstructor(env, &constructor_key_, ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   return napi_ok;
@@ -110,7 +111,7 @@ napi_status ANGLEInstancedArraysExtension::NewInstance(
     EGLContextWrapper* egl_context_wrapper) {
   ENSURE_EXTENSION_IS_SUPPORTED
 
-  napi_status nstatus = NewInstanceBase(env, constructor_ref_, instance);
+  napi_status nstatus = NewInstanceBase(env, &constructor_key_, instance);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   egl_context_wrapper->glRequestExtensionANGLE("GL_ANGLE_instanced_arrays");
@@ -122,7 +123,7 @@ napi_status ANGLEInstancedArraysExtension::NewInstance(
 //==============================================================================
 // EXTBlendMinmaxExtension
 
-napi_ref EXTBlendMinmaxExtension::constructor_ref_;
+char EXTBlendMinmaxExtension::constructor_key_;
 
 EXTBlendMinmaxExtension::EXTBlendMinmaxExtension(napi_env env)
     : GLExtensionBase(env) {}
@@ -148,7 +149,7 @@ napi_status EXTBlendMinmaxExtension::Register(napi_env env,
                               ARRAY_SIZE(properties), properties, &ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  nstatus = napi_create_reference(env, ctor_value, 1, &constructor_ref_);
+  nstatus = InstanceData::SetConstructor(env, &constructor_key_, ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   return napi_ok;
@@ -160,7 +161,7 @@ napi_status EXTBlendMinmaxExtension::NewInstance(
     EGLContextWrapper* egl_context_wrapper) {
   ENSURE_EXTENSION_IS_SUPPORTED
 
-  napi_status nstatus = NewInstanceBase(env, constructor_ref_, instance);
+  napi_status nstatus = NewInstanceBase(env, &constructor_key_, instance);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   egl_context_wrapper->glRequestExtensionANGLE("GL_EXT_blend_minmax");
@@ -172,7 +173,7 @@ napi_status EXTBlendMinmaxExtension::NewInstance(
 //==============================================================================
 // EXTColorBufferFloatExtension
 
-napi_ref EXTColorBufferFloatExtension::constructor_ref_;
+char EXTColorBufferFloatExtension::constructor_key_;
 
 EXTColorBufferFloatExtension::EXTColorBufferFloatExtension(napi_env env)
     : GLExtensionBase(env) {}
@@ -194,7 +195,7 @@ napi_status EXTColorBufferFloatExtension::Register(napi_env env,
                               nullptr, &ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  nstatus = napi_create_reference(env, ctor_value, 1, &constructor_ref_);
+  nstatus = InstanceData::SetConstructor(env, &constructor_key_, ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   return napi_ok;
@@ -206,7 +207,7 @@ napi_status EXTColorBufferFloatExtension::NewInstance(
     EGLContextWrapper* egl_context_wrapper) {
   ENSURE_EXTENSION_IS_SUPPORTED
 
-  napi_status nstatus = NewInstanceBase(env, constructor_ref_, instance);
+  napi_status nstatus = NewInstanceBase(env, &constructor_key_, instance);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   egl_context_wrapper->glRequestExtensionANGLE("GL_EXT_color_buffer_float");
@@ -218,7 +219,7 @@ napi_status EXTColorBufferFloatExtension::NewInstance(
 //==============================================================================
 // EXTColorBufferHalfFloatExtension
 
-napi_ref EXTColorBufferHalfFloatExtension::constructor_ref_;
+char EXTColorBufferHalfFloatExtension::constructor_key_;
 
 EXTColorBufferHalfFloatExtension::EXTColorBufferHalfFloatExtension(napi_env env)
     : GLExtensionBase(env) {}
@@ -240,7 +241,7 @@ napi_status EXTColorBufferHalfFloatExtension::Register(napi_env env,
                               nullptr, 0, nullptr, &ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  nstatus = napi_create_reference(env, ctor_value, 1, &constructor_ref_);
+  nstatus = InstanceData::SetConstructor(env, &constructor_key_, ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   return napi_ok;
@@ -252,7 +253,7 @@ napi_status EXTColorBufferHalfFloatExtension::NewInstance(
     EGLContextWrapper* egl_context_wrapper) {
   ENSURE_EXTENSION_IS_SUPPORTED
 
-  napi_status nstatus = NewInstanceBase(env, constructor_ref_, instance);
+  napi_status nstatus = NewInstanceBase(env, &constructor_key_, instance);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   egl_context_wrapper->glRequestExtensionANGLE(
@@ -265,7 +266,7 @@ napi_status EXTColorBufferHalfFloatExtension::NewInstance(
 //==============================================================================
 // EXTFragDepthExtension
 
-napi_ref EXTFragDepthExtension::constructor_ref_;
+char EXTFragDepthExtension::constructor_key_;
 
 EXTFragDepthExtension::EXTFragDepthExtension(napi_env env)
     : GLExtensionBase(env) {}
@@ -286,7 +287,7 @@ napi_status EXTFragDepthExtension::Register(napi_env env, napi_value exports) {
                               nullptr, &ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  nstatus = napi_create_reference(env, ctor_value, 1, &constructor_ref_);
+  nstatus = InstanceData::SetConstructor(env, &constructor_key_, ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   return napi_ok;
@@ -298,7 +299,7 @@ napi_status EXTFragDepthExtension::NewInstance(
     EGLContextWrapper* egl_context_wrapper) {
   ENSURE_EXTENSION_IS_SUPPORTED
 
-  napi_status nstatus = NewInstanceBase(env, constructor_ref_, instance);
+  napi_status nstatus = NewInstanceBase(env, &constructor_key_, instance);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   egl_context_wrapper->glRequestExtensionANGLE("GL_EXT_frag_depth");
@@ -310,7 +311,7 @@ napi_status EXTFragDepthExtension::NewInstance(
 //==============================================================================
 // EXTShaderTextureLodExtension
 
-napi_ref EXTShaderTextureLodExtension::constructor_ref_;
+char EXTShaderTextureLodExtension::constructor_key_;
 
 EXTShaderTextureLodExtension::EXTShaderTextureLodExtension(napi_env env)
     : GLExtensionBase(env) {}
@@ -332,7 +333,7 @@ napi_status EXTShaderTextureLodExtension::Register(napi_env env,
                               nullptr, &ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  nstatus = napi_create_reference(env, ctor_value, 1, &constructor_ref_);
+  nstatus = InstanceData::SetConstructor(env, &constructor_key_, ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   return napi_ok;
@@ -344,7 +345,7 @@ napi_status EXTShaderTextureLodExtension::NewInstance(
     EGLContextWrapper* egl_context_wrapper) {
   ENSURE_EXTENSION_IS_SUPPORTED
 
-  napi_status nstatus = NewInstanceBase(env, constructor_ref_, instance);
+  napi_status nstatus = NewInstanceBase(env, &constructor_key_, instance);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   egl_context_wrapper->glRequestExtensionANGLE("GL_EXT_shader_texture_lod");
@@ -356,7 +357,7 @@ napi_status EXTShaderTextureLodExtension::NewInstance(
 //==============================================================================
 // EXTSRGBExtension
 
-napi_ref EXTSRGBExtension::constructor_ref_;
+char EXTSRGBExtension::constructor_key_;
 
 EXTSRGBExtension::EXTSRGBExtension(napi_env env) : GLExtensionBase(env) {}
 
@@ -383,7 +384,7 @@ napi_status EXTSRGBExtension::Register(napi_env env, napi_value exports) {
                               ARRAY_SIZE(properties), properties, &ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  nstatus = napi_create_reference(env, ctor_value, 1, &constructor_ref_);
+  nstatus = InstanceData::SetConstructor(env, &constructor_key_, ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   return napi_ok;
@@ -395,7 +396,7 @@ napi_status EXTSRGBExtension::NewInstance(
     EGLContextWrapper* egl_context_wrapper) {
   ENSURE_EXTENSION_IS_SUPPORTED
 
-  napi_status nstatus = NewInstanceBase(env, constructor_ref_, instance);
+  napi_status nstatus = NewInstanceBase(env, &constructor_key_, instance);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   egl_context_wrapper->glRequestExtensionANGLE("GL_EXT_sRGB");
@@ -407,7 +408,7 @@ napi_status EXTSRGBExtension::NewInstance(
 //==============================================================================
 // EXTTextureFilterAnisotropicExtension
 
-napi_ref EXTTextureFilterAnisotropicExtension::constructor_ref_;
+char EXTTextureFilterAnisotropicExtension::constructor_key_;
 
 EXTTextureFilterAnisotropicExtension::EXTTextureFilterAnisotropicExtension(
     napi_env env)
@@ -438,7 +439,7 @@ napi_status EXTTextureFilterAnisotropicExtension::Register(napi_env env,
                         ARRAY_SIZE(properties), properties, &ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  nstatus = napi_create_reference(env, ctor_value, 2, &constructor_ref_);
+  nstatus = InstanceData::SetConstructor(env, &constructor_key_, ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   return napi_ok;
@@ -450,7 +451,7 @@ napi_status EXTTextureFilterAnisotropicExtension::NewInstance(
     EGLContextWrapper* egl_context_wrapper) {
   ENSURE_EXTENSION_IS_SUPPORTED
 
-  napi_status nstatus = NewInstanceBase(env, constructor_ref_, instance);
+  napi_status nstatus = NewInstanceBase(env, &constructor_key_, instance);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   egl_context_wrapper->glRequestExtensionANGLE(
@@ -460,10 +461,82 @@ napi_status EXTTextureFilterAnisotropicExtension::NewInstance(
   return napi_ok;
 }
 
+//==============================================================================
+// KHRParallelShaderCompileExtension
+
+char KHRParallelShaderCompileExtension::constructor_key_;
+
+KHRParallelShaderCompileExtension::KHRParallelShaderCompileExtension(
+    napi_env env)
+    : GLExtensionBase(env) {}
+
+/* static */
+bool KHRParallelShaderCompileExtension::IsSupported(
+    EGLContextWrapper* egl_context_wrapper) {
+  IS_EXTENSION_NAME_AVAILABLE("GL_KHR_parallel_shader_compile");
+}
+
+/* static */
+bool KHRParallelShaderCompileExtension::Enable(
+    EGLContextWrapper* egl_context_wrapper) {
+  // Also used by the context itself (maxShaderCompilerThreads,
+  // linkProgramAsync()), so it may already be enabled.
+  if (egl_context_wrapper->gl_extensions->HasExtension(
+          "GL_KHR_parallel_shader_compile")) {
+    return true;
+  }
+  if (!egl_context_wrapper->angle_requestable_extensions->HasExtension(
+          "GL_KHR_parallel_shader_compile")) {
+    return false;
+  }
+
+  egl_context_wrapper->glRequestExtensionANGLE(
+      "GL_KHR_parallel_shader_compile");
+  egl_context_wrapper->RefreshGLExtensions();
+  return true;
+}
+
+/* static */
+napi_status KHRParallelShaderCompileExtension::Register(napi_env env,
+                                                        napi_value exports) {
+  napi_status nstatus;
+
+  napi_property_descriptor properties[] = {
+      NapiDefineIntProperty(env, GL_COMPLETION_STATUS_KHR,
+                            "COMPLETION_STATUS_KHR"),
+  };
+
+  napi_value ctor_value;
+  nstatus =
+      napi_define_class(env, "KHR_parallel_shader_compile", NAPI_AUTO_LENGTH,
+                        GLExtensionBase::InitStubClass, nullptr,
+                        ARRAY_SIZE(properties), properties, &ctor_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+
+  nstatus = InstanceData::SetConstructor(env, &constructor_key_, ctor_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+
+  return napi_ok;
+}
+
+/* static */
+napi_status KHRParallelShaderCompileExtension::NewInstance(
+    napi_env env, napi_value* instance,
+    EGLContextWrapper* egl_context_wrapper) {
+  ENSURE_EXTENSION_IS_SUPPORTED
+
+  napi_status nstatus = NewInstanceBase(env, &constructor_key_, instance);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+
+  Enable(egl_context_wrapper);
+
+  return napi_ok;
+}
+
 //==============================================================================
 // OESElementIndexUintExtension
 
-napi_ref OESElementIndexUintExtension::constructor_ref_;
+char OESElementIndexUintExtension::constructor_key_;
 
 OESElementIndexUintExtension::OESElementIndexUintExtension(napi_env env)
     : GLExtensionBase(env) {}
@@ -485,7 +558,7 @@ napi_status OESElementIndexUintExtension::Register(napi_env env,
                               nullptr, &ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  nstatus = napi_create_reference(env, ctor_value, 2, &constructor_ref_);
+  nstatus = InstanceData::SetConstructor(env, &constructor_key_, ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   return napi_ok;
@@ -497,7 +570,7 @@ napi_status OESElementIndexUintExtension::NewInstance(
     EGLContextWrapper* egl_context_wrapper) {
   ENSURE_EXTENSION_IS_SUPPORTED
 
-  napi_status nstatus = NewInstanceBase(env, constructor_ref_, instance);
+  napi_status nstatus = NewInstanceBase(env, &constructor_key_, instance);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   egl_context_wrapper->glRequestExtensionANGLE("GL_OES_element_index_uint");
@@ -509,7 +582,7 @@ napi_status OESElementIndexUintExtension::NewInstance(
 //==============================================================================
 // OESStandardDerivativesExtension
 
-napi_ref OESStandardDerivativesExtension::constructor_ref_;
+char OESStandardDerivativesExtension::constructor_key_;
 
 OESStandardDerivativesExtension::OESStandardDerivativesExtension(napi_env env)
     : GLExtensionBase(env) {}
@@ -535,7 +608,7 @@ napi_status OESStandardDerivativesExtension::Register(napi_env env,
                               ARRAY_SIZE(properties), properties, &ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  nstatus = napi_create_reference(env, ctor_value, 2, &constructor_ref_);
+  nstatus = InstanceData::SetConstructor(env, &constructor_key_, ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   return napi_ok;
@@ -547,7 +620,7 @@ napi_status OESStandardDerivativesExtension::NewInstance(
     EGLContextWrapper* egl_context_wrapper) {
   ENSURE_EXTENSION_IS_SUPPORTED
 
-  napi_status nstatus = NewInstanceBase(env, constructor_ref_, instance);
+  napi_status nstatus = NewInstanceBase(env, &constructor_key_, instance);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   egl_context_wrapper->glRequestExtensionANGLE("GL_OES_standard_derivatives");
@@ -559,7 +632,7 @@ napi_status OESStandardDerivativesExtension::NewInstance(
 //==============================================================================
 // OESTextureFloatExtension
 
-napi_ref OESTextureFloatExtension::constructor_ref_;
+char OESTextureFloatExtension::constructor_key_;
 
 OESTextureFloatExtension::OESTextureFloatExtension(napi_env env)
     : GLExtensionBase(env) {}
@@ -581,7 +654,7 @@ napi_status OESTextureFloatExtension::Register(napi_env env,
                               nullptr, &ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  nstatus = napi_create_reference(env, ctor_value, 1, &constructor_ref_);
+  nstatus = InstanceData::SetConstructor(env, &constructor_key_, ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   return napi_ok;
@@ -593,7 +666,7 @@ napi_status OESTextureFloatExtension::NewInstance(
     EGLContextWrapper* egl_context_wrapper) {
   ENSURE_EXTENSION_IS_SUPPORTED
 
-  napi_status nstatus = NewInstanceBase(env, constructor_ref_, instance);
+  napi_status nstatus = NewInstanceBase(env, &constructor_key_, instance);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   egl_context_wrapper->glRequestExtensionANGLE("GL_OES_texture_float");
@@ -609,7 +682,7 @@ napi_status OESTextureFloatExtension::NewInstance(
 //==============================================================================
 // OESTextureFloatLinearExtension
 
-napi_ref OESTextureFloatLinearExtension::constructor_ref_;
+char OESTextureFloatLinearExtension::constructor_key_;
 
 OESTextureFloatLinearExtension::OESTextureFloatLinearExtension(napi_env env)
     : GLExtensionBase(env) {}
@@ -631,7 +704,7 @@ napi_status OESTextureFloatLinearExtension::Register(napi_env env,
                               nullptr, &ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  nstatus = napi_create_reference(env, ctor_value, 1, &constructor_ref_);
+  nstatus = InstanceData::SetConstructor(env, &constructor_key_, ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   return napi_ok;
@@ -643,7 +716,7 @@ napi_status OESTextureFloatLinearExtension::NewInstance(
     EGLContextWrapper* egl_context_wrapper) {
   ENSURE_EXTENSION_IS_SUPPORTED
 
-  napi_status nstatus = NewInstanceBase(env, constructor_ref_, instance);
+  napi_status nstatus = NewInstanceBase(env, &constructor_key_, instance);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   egl_context_wrapper->glRequestExtensionANGLE("GL_OES_texture_float_linear");
@@ -654,7 +727,7 @@ napi_status OESTextureFloatLinearExtension::NewInstance(
 //==============================================================================
 // OESTextureHalfFloatExtension
 
-napi_ref OESTextureHalfFloatExtension::constructor_ref_;
+char OESTextureHalfFloatExtension::constructor_key_;
 
 OESTextureHalfFloatExtension::OESTextureHalfFloatExtension(napi_env env)
     : GLExtensionBase(env) {}
@@ -679,7 +752,7 @@ napi_status OESTextureHalfFloatExtension::Register(napi_env env,
                               ARRAY_SIZE(properties), properties, &ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  nstatus = napi_create_reference(env, ctor_value, 1, &constructor_ref_);
+  nstatus = InstanceData::SetConstructor(env, &constructor_key_, ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   return napi_ok;
@@ -691,7 +764,7 @@ napi_status OESTextureHalfFloatExtension::NewInstance(
     EGLContextWrapper* egl_context_wrapper) {
   ENSURE_EXTENSION_IS_SUPPORTED
 
-  napi_status nstatus = NewInstanceBase(env, constructor_ref_, instance);
+  napi_status nstatus = NewInstanceBase(env, &constructor_key_, instance);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   egl_context_wrapper->glRequestExtensionANGLE("GL_OES_texture_half_float");
@@ -709,7 +782,7 @@ napi_status OESTextureHalfFloatExtension::NewInstance(
 //==============================================================================
 // OESTextureHalfFloatLinearExtension
 
-napi_ref OESTextureHalfFloatLinearExtension::constructor_ref_;
+char OESTextureHalfFloatLinearExtension::constructor_key_;
 
 OESTextureHalfFloatLinearExtension::OESTextureHalfFloatLinearExtension(
     napi_env env)
@@ -732,7 +805,7 @@ napi_status OESTextureHalfFloatLinearExtension::Register(napi_env env,
                               nullptr, 0, nullptr, &ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  nstatus = napi_create_reference(env, ctor_value, 1, &constructor_ref_);
+  nstatus = InstanceData::SetConstructor(env, &constructor_key_, ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   return napi_ok;
@@ -744,7 +817,7 @@ napi_status OESTextureHalfFloatLinearExtension::NewInstance(
     EGLContextWrapper* egl_context_wrapper) {
   ENSURE_EXTENSION_IS_SUPPORTED
 
-  napi_status nstatus = NewInstanceBase(env, constructor_ref_, instance);
+  napi_status nstatus = NewInstanceBase(env, &constructor_key_, instance);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   egl_context_wrapper->glRequestExtensionANGLE(
@@ -756,7 +829,7 @@ napi_status OESTextureHalfFloatLinearExtension::NewInstance(
 //==============================================================================
 // WebGLDebugRendererInfoExtension
 
-napi_ref WebGLDebugRendererInfoExtension::constructor_ref_;
+char WebGLDebugRendererInfoExtension::constructor_key_;
 
 WebGLDebugRendererInfoExtension::WebGLDebugRendererInfoExtension(napi_env env)
     : GLExtensionBase(env) {}
@@ -783,7 +856,7 @@ napi_status WebGLDebugRendererInfoExtension::Register(napi_env env,
                         ARRAY_SIZE(properties), properties, &ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  nstatus = napi_create_reference(env, ctor_value, 1, &constructor_ref_);
+  nstatus = InstanceData::SetConstructor(env, &constructor_key_, ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   return napi_ok;
@@ -795,7 +868,7 @@ napi_status WebGLDebugRendererInfoExtension::NewInstance(
     EGLContextWrapper* egl_context_wrapper) {
   ENSURE_EXTENSION_IS_SUPPORTED
 
-  napi_status nstatus = NewInstanceBase(env, constructor_ref_, instance);
+  napi_status nstatus = NewInstanceBase(env, &constructor_key_, instance);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   return napi_ok;
@@ -804,7 +877,7 @@ napi_status WebGLDebugRendererInfoExtension::NewInstance(
 //==============================================================================
 // WebGLDepthTextureExtension
 
-napi_ref WebGLDepthTextureExtension::constructor_ref_;
+char WebGLDepthTextureExtension::constructor_key_;
 
 WebGLDepthTextureExtension::WebGLDepthTextureExtension(napi_env env)
     : GLExtensionBase(env) {}
@@ -830,7 +903,7 @@ napi_status WebGLDepthTextureExtension::Register(napi_env env,
                               ARRAY_SIZE(properties), properties, &ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  nstatus = napi_create_reference(env, ctor_value, 1, &constructor_ref_);
+  nstatus = InstanceData::SetConstructor(env, &constructor_key_, ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   return napi_ok;
@@ -842,7 +915,7 @@ napi_status WebGLDepthTextureExtension::NewInstance(
     EGLContextWrapper* egl_context_wrapper) {
   ENSURE_EXTENSION_IS_SUPPORTED
 
-  napi_status nstatus = NewInstanceBase(env, constructor_ref_, instance);
+  napi_status nstatus = NewInstanceBase(env, &constructor_key_, instance);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   egl_context_wrapper->glRequestExtensionANGLE("GL_ANGLE_depth_texture");
@@ -854,7 +927,7 @@ napi_status WebGLDepthTextureExtension::NewInstance(
 //==============================================================================
 // WebGLLoseContextExtension
 
-napi_ref WebGLLoseContextExtension::constructor_ref_;
+char WebGLLoseContextExtension::constructor_key_;
 
 WebGLLoseContextExtension::WebGLLoseContextExtension(napi_env env)
     : GLExtensionBase(env) {}
@@ -881,7 +954,7 @@ napi_status WebGLLoseContextExtension::Register(napi_env env,
                               WebGLLoseContextExtension::InitInternal, nullptr,
                               ARRAY_SIZE(properties), properties, &ctor_value);
 
-  nstatus = napi_create_reference(env, ctor_value, 1, &constructor_ref_);
+  nstatus = InstanceData::SetConstructor(env, &constructor_key_, ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   return napi_ok;
@@ -891,7 +964,7 @@ napi_status WebGLLoseContextExtension::Register(napi_env env,
 napi_status WebGLLoseContextExtension::NewInstance(
     napi_env env, napi_value* instance,
     EGLContextWrapper* egl_context_wrapper) {
-  return NewInstanceBase(env, constructor_ref_, instance);
+  return NewInstanceBase(env, &constructor_key_, instance);
 }
 
 /* static */
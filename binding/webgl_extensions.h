@@ -31,7 +31,7 @@
                                  EGLContextWrapper* egl_context_wrapper); \
                                                                           \
  private:                                                                 \
-  static napi_ref constructor_ref_;
+  static char constructor_key_;
 #endif
 
 namespace nodejsgl {
@@ -48,8 +48,9 @@ class GLExtensionBase {
   // don't need to expose any methods should use this.
   static napi_value InitStubClass(napi_env env, napi_callback_info info);
 
-  // Creates a new instance from a constructor ref.
-  static napi_status NewInstanceBase(napi_env env, napi_ref constructor_ref,
+  // Creates a new instance from a constructor stored in the instance data.
+  static napi_status NewInstanceBase(napi_env env,
+                                     const void* constructor_key,
                                      napi_value* instance);
 
   napi_env env_;
@@ -141,6 +142,20 @@ class EXTTextureFilterAnisotropicExtension : public GLExtensionBase {
   virtual ~EXTTextureFilterAnisotropicExtension() {}
 };
 
+// Provides 'KHR_parallel_shader_compile':
+// https://www.khronos.org/registry/webgl/extensions/KHR_parallel_shader_compile/
+class KHRParallelShaderCompileExtension : public GLExtensionBase {
+  NAPI_BOOTSTRAP_METHODS
+
+ public:
+  // Enables the GL extension if needed. Returns false if it is not available.
+  static bool Enable(EGLContextWrapper* egl_context_wrapper);
+
+ protected:
+  KHRParallelShaderCompileExtension(napi_env env);
+  virtual ~KHRParallelShaderCompileExtension() {}
+};
+
 // Provides 'OES_element_index_uint':
 // https://www.khronos.org/registry/webgl/extensions/OES_element_index_uint/
 class OESElementIndexUintExtension : public GLExtensionBase {
@@ -0,0 +1,233 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "webgl_fence_poller.h"
+
+#include <cstdint>
+
+#include "utils.h"
+
+namespace nodejsgl {
+
+GLFencePoller::GLFencePoller(napi_env env,
+                             EGLContextWrapper* egl_context_wrapper,
+                             napi_ref context_ref,
+                             GLCommandThread* command_thread)
+    : env_(env),
+      egl_(egl_context_wrapper),
+      context_ref_(context_ref),
+      command_thread_(command_thread),
+      async_context_(nullptr),
+      timer_(nullptr),
+      referenced_(false),
+      poll_interval_ms_(kMinPollIntervalMs) {
+  napi_value resource_name;
+  napi_status nstatus = napi_create_string_utf8(
+      env, "nodejsgl.GLFencePoller", NAPI_AUTO_LENGTH, &resource_name);
+  ENSURE_NAPI_OK(env, nstatus);
+
+  nstatus = napi_async_init(env, nullptr, resource_name, &async_context_);
+  ENSURE_NAPI_OK(env, nstatus);
+
+  uv_loop_t* loop = nullptr;
+  nstatus = napi_get_uv_event_loop(env, &loop);
+  ENSURE_NAPI_OK(env, nstatus);
+
+  timer_ = new uv_timer_t;
+  uv_timer_init(loop, timer_);
+  timer_->data = this;
+}
+
+GLFencePoller::~GLFencePoller() {
+  // Callbacks of fences that are still pending are dropped. Their GL objects
+  // go away with the context.
+  if (timer_) {
+    uv_timer_stop(timer_);
+    timer_->data = nullptr;
+    uv_close(reinterpret_cast<uv_handle_t*>(timer_), OnClose);
+  }
+  if (async_context_) {
+    napi_async_destroy(env_, async_context_);
+  }
+}
+
+napi_status GLFencePoller::Add(GLsync sync, GLuint64 timeout,
+                               Callback callback) {
+  egl_->glFlush();
+
+  uint64_t now = uv_hrtime();
+  uint64_t deadline = UINT64_MAX;
+  if (timeout != GL_TIMEOUT_IGNORED && timeout < UINT64_MAX - now) {
+    deadline = now + timeout;
+  }
+  return AddPending({sync, 0, deadline, std::move(callback)});
+}
+
+napi_status GLFencePoller::AddProgram(GLuint program, Callback callback) {
+  return AddPending({nullptr, program, UINT64_MAX, std::move(callback)});
+}
+
+napi_status GLFencePoller::AddPending(PendingFence pending) {
+  if (!timer_) {
+    return napi_generic_failure;
+  }
+
+  if (!referenced_) {
+    // Keep the context alive until the last callback ran.
+    uint32_t ref_count;
+    napi_status nstatus = napi_reference_ref(env_, context_ref_, &ref_count);
+    ENSURE_NAPI_OK_RETVAL(env_, nstatus, nstatus);
+    referenced_ = true;
+  }
+
+  pending_.push_back(std::move(pending));
+
+  // New work - poll quickly again.
+  poll_interval_ms_ = kMinPollIntervalMs;
+  ScheduleNextPoll();
+  return napi_ok;
+}
+
+void GLFencePoller::Cancel(GLsync sync) {
+  std::vector<PendingFence> cancelled;
+  std::vector<GLenum> statuses;
+  for (size_t i = 0; i < pending_.size();) {
+    if (!pending_[i].sync || pending_[i].sync != sync) {
+      ++i;
+      continue;
+    }
+
+    cancelled.push_back(std::move(pending_[i]));
+    statuses.push_back(GL_WAIT_FAILED);
+    pending_.erase(pending_.begin() + i);
+  }
+
+  if (!cancelled.empty()) {
+    RunCallbacks(&cancelled, statuses);
+  }
+}
+
+GLenum GLFencePoller::GetStatus(const PendingFence& pending) {
+  if (pending.sync) {
+    return egl_->glClientWaitSync(pending.sync, 0, 0);
+  }
+
+  if (!egl_->glIsProgram(pending.program)) {
+    return GL_WAIT_FAILED;
+  }
+  GLint completed = GL_TRUE;
+  egl_->glGetProgramiv(pending.program, GL_COMPLETION_STATUS_KHR, &completed);
+  return completed ? GL_ALREADY_SIGNALED : GL_TIMEOUT_EXPIRED;
+}
+
+/* static */
+void GLFencePoller::OnTimer(uv_timer_t* timer) {
+  GLFencePoller* poller = static_cast<GLFencePoller*>(timer->data);
+  if (poller) {
+    poller->Poll();
+  }
+}
+
+/* static */
+void GLFencePoller::OnClose(uv_handle_t* handle) {
+  delete reinterpret_cast<uv_timer_t*>(handle);
+}
+
+void GLFencePoller::Poll() {
+  // Polls run outside of context calls.
+  if (command_thread_) {
+    command_thread_->Synchronize();
+  }
+  egl_->MakeCurrent();
+
+  // Collect finished fences first; callbacks may add new fences.
+  std::vector<PendingFence> finished;
+  std::vector<GLenum> statuses;
+  uint64_t now = uv_hrtime();
+  for (size_t i = 0; i < pending_.size();) {
+    GLenum status = GetStatus(pending_[i]);
+    if (status == GL_TIMEOUT_EXPIRED && pending_[i].deadline > now) {
+      ++i;
+      continue;
+    }
+
+    finished.push_back(std::move(pending_[i]));
+    statuses.push_back(status);
+    pending_.erase(pending_.begin() + i);
+  }
+
+  if (finished.empty()) {
+    if (poll_interval_ms_ < kMaxPollIntervalMs) {
+      poll_interval_ms_ = poll_interval_ms_ == 0 ? 1 : poll_interval_ms_ * 2;
+      if (poll_interval_ms_ > kMaxPollIntervalMs) {
+        poll_interval_ms_ = kMaxPollIntervalMs;
+      }
+    }
+    ScheduleNextPoll();
+    return;
+  }
+
+  // Fences tend to signal in bursts (e.g. after the same flush).
+  poll_interval_ms_ = kMinPollIntervalMs;
+  ScheduleNextPoll();
+
+  RunCallbacks(&finished, statuses);
+}
+
+void GLFencePoller::RunCallbacks(std::vector<PendingFence>* fences,
+                                 const std::vector<GLenum>& statuses) {
+  napi_handle_scope handle_scope;
+  napi_status nstatus = napi_open_handle_scope(env_, &handle_scope);
+  ENSURE_NAPI_OK(env_, nstatus);
+
+  napi_value resource;
+  nstatus = napi_create_object(env_, &resource);
+  ENSURE_NAPI_OK(env_, nstatus);
+
+  // Promise reactions queued by the callbacks run when the scope closes.
+  napi_callback_scope callback_scope;
+  nstatus = napi_open_callback_scope(env_, resource, async_context_,
+                                     &callback_scope);
+  ENSURE_NAPI_OK(env_, nstatus);
+
+  for (size_t i = 0; i < fences->size(); ++i) {
+    (*fences)[i].callback(env_, statuses[i]);
+  }
+
+  napi_close_callback_scope(env_, callback_scope);
+  napi_close_handle_scope(env_, handle_scope);
+
+  if (pending_.empty() && referenced_) {
+    uv_timer_stop(timer_);
+    referenced_ = false;
+
+    // Must be last: the context may be collected once it is unreferenced.
+    uint32_t ref_count;
+    nstatus = napi_reference_unref(env_, context_ref_, &ref_count);
+    ENSURE_NAPI_OK(env_, nstatus);
+  }
+}
+
+void GLFencePoller::ScheduleNextPoll() {
+  if (pending_.empty()) {
+    uv_timer_stop(timer_);
+  } else {
+    uv_timer_start(timer_, OnTimer, poll_interval_ms_, 0);
+  }
+}
+
+}  // namespace nodejsgl
@@ -0,0 +1,111 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef NODEJS_GL_WEBGL_FENCE_POLLER_H_
+#define NODEJS_GL_WEBGL_FENCE_POLLER_H_
+
+#include <node_api.h>
+#include <uv.h>
+
+#include <functional>
+#include <vector>
+
+#include "egl_context_wrapper.h"
+#include "webgl_command_thread.h"
+
+namespace nodejsgl {
+
+// Polls GL fences from a libuv timer on the JS thread and runs a callback
+// once each fence is signaled, so async APIs never block the event loop in
+// glClientWaitSync(). Programs linked with KHR_parallel_shader_compile are
+// polled the same way. The timer only runs while fences are pending and backs
+// off exponentially while none of them signals. The context is kept alive
+// (through |context_ref|) until all callbacks ran.
+class GLFencePoller {
+ public:
+  // |status| is GL_ALREADY_SIGNALED, GL_CONDITION_SATISFIED,
+  // GL_TIMEOUT_EXPIRED or GL_WAIT_FAILED. Runs inside a handle and callback
+  // scope.
+  typedef std::function<void(napi_env env, GLenum status)> Callback;
+
+  // |command_thread| may be null.
+  GLFencePoller(napi_env env, EGLContextWrapper* egl_context_wrapper,
+                napi_ref context_ref, GLCommandThread* command_thread);
+  ~GLFencePoller();
+
+  // Runs |callback| once |sync| is signaled, or with GL_TIMEOUT_EXPIRED once
+  // |timeout| nanoseconds passed (checked at poll granularity, pass
+  // GL_TIMEOUT_IGNORED to wait forever). Flushes the context so the fence is
+  // submitted. |sync| stays owned by the caller and must outlive the callback.
+  napi_status Add(GLsync sync, GLuint64 timeout, Callback callback);
+
+  // Runs |callback| with GL_ALREADY_SIGNALED once the driver finished linking
+  // |program| (COMPLETION_STATUS_KHR), or with GL_WAIT_FAILED if |program| was
+  // deleted. KHR_parallel_shader_compile must be enabled.
+  napi_status AddProgram(GLuint program, Callback callback);
+
+  // Runs the callbacks of |sync| with GL_WAIT_FAILED, e.g. before the fence
+  // is deleted.
+  void Cancel(GLsync sync);
+
+  size_t pending() const { return pending_.size(); }
+
+ private:
+  // Bounds of the interval between polls in milliseconds. The first poll
+  // happens on the next loop iteration.
+  static const uint64_t kMinPollIntervalMs = 0;
+  static const uint64_t kMaxPollIntervalMs = 16;
+
+  struct PendingFence {
+    GLsync sync;        // nullptr for a program.
+    GLuint program;     // 0 for a fence.
+    uint64_t deadline;  // uv_hrtime() based, UINT64_MAX for no timeout.
+    Callback callback;
+  };
+
+  napi_status AddPending(PendingFence pending);
+
+  // Returns GL_TIMEOUT_EXPIRED while |pending| is not finished.
+  GLenum GetStatus(const PendingFence& pending);
+
+  static void OnTimer(uv_timer_t* timer);
+  static void OnClose(uv_handle_t* handle);
+
+  void Poll();
+
+  // Runs |callbacks| inside a callback scope so that promise reactions run
+  // afterwards, then drops the context reference if nothing is pending.
+  void RunCallbacks(std::vector<PendingFence>* fences,
+                    const std::vector<GLenum>& statuses);
+
+  void ScheduleNextPoll();
+
+  napi_env env_;
+  EGLContextWrapper* egl_;
+  napi_ref context_ref_;
+  GLCommandThread* command_thread_;
+  napi_async_context async_context_;
+  uv_timer_t* timer_;
+  bool referenced_;
+  uint64_t poll_interval_ms_;
+
+  std::vector<PendingFence> pending_;
+};
+
+}  // namespace nodejsgl
+
+#endif  // NODEJS_GL_WEBGL_FENCE_POLLER_H_
@@ -0,0 +1,260 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "webgl_memory_tracker.h"
+
+#include <algorithm>
+
+namespace nodejsgl {
+
+GLMemoryTracker::GLMemoryTracker(napi_env env,
+                                 EGLContextWrapper* egl_context_wrapper,
+                                 GLStateCache* state_cache)
+    : env_(env),
+      egl_(egl_context_wrapper),
+      state_cache_(state_cache),
+      total_bytes_(0) {
+  for (size_t i = 0; i < kObjectTypeCount; i++) {
+    usage_[i].count = 0;
+    usage_[i].bytes = 0;
+  }
+}
+
+GLMemoryTracker::~GLMemoryTracker() {
+  if (total_bytes_ > 0) {
+    int64_t adjusted;
+    napi_adjust_external_memory(env_, -static_cast<int64_t>(total_bytes_),
+                                &adjusted);
+  }
+}
+
+void GLMemoryTracker::OnCreate(ObjectType type, GLuint object) {
+  if (object == 0) {
+    return;
+  }
+  switch (type) {
+    case kBuffer:
+      buffers_[object] = 0;
+      break;
+    case kTexture:
+      textures_[object].bytes = 0;
+      break;
+    case kRenderbuffer:
+      renderbuffers_[object] = 0;
+      break;
+    default:
+      return;
+  }
+  usage_[type].count++;
+}
+
+void GLMemoryTracker::OnDelete(ObjectType type, GLuint object) {
+  switch (type) {
+    case kBuffer: {
+      auto it = buffers_.find(object);
+      if (it == buffers_.end()) {
+        return;
+      }
+      Resize(type, &it->second, 0);
+      buffers_.erase(it);
+      break;
+    }
+    case kTexture: {
+      auto it = textures_.find(object);
+      if (it == textures_.end()) {
+        return;
+      }
+      Resize(type, &it->second.bytes, 0);
+      textures_.erase(it);
+      break;
+    }
+    case kRenderbuffer: {
+      auto it = renderbuffers_.find(object);
+      if (it == renderbuffers_.end()) {
+        return;
+      }
+      Resize(type, &it->second, 0);
+      renderbuffers_.erase(it);
+      break;
+    }
+    default:
+      return;
+  }
+  usage_[type].count--;
+}
+
+void GLMemoryTracker::OnBufferData(GLenum target, GLsizeiptr size) {
+  auto it = buffers_.find(state_cache_->buffer_binding(target));
+  if (it == buffers_.end() || size < 0) {
+    return;
+  }
+  Resize(kBuffer, &it->second, static_cast<size_t>(size));
+}
+
+void GLMemoryTracker::OnTexImage(GLenum target, GLint level, GLsizei width,
+                                 GLsizei height, size_t bytes) {
+  uint32_t face;
+  auto it = textures_.find(BoundTexture(target, &face));
+  if (it == textures_.end() || level < 0 || width < 0 || height < 0) {
+    return;
+  }
+
+  Texture& texture = it->second;
+  TextureLevel& texture_level =
+      texture.levels[face << 16 | static_cast<uint32_t>(level)];
+  size_t texture_bytes = texture.bytes - texture_level.bytes + bytes;
+  texture_level.width = width;
+  texture_level.height = height;
+  texture_level.bytes = bytes;
+  Resize(kTexture, &texture.bytes, texture_bytes);
+}
+
+void GLMemoryTracker::CopyTexImage2D(GLenum target, GLint level,
+                                     GLenum internal_format, GLint x, GLint y,
+                                     GLsizei width, GLsizei height,
+                                     GLint border) {
+  egl_->glCopyTexImage2D(target, level, internal_format, x, y, width, height,
+                         border);
+  OnTexImage(target, level, width, height,
+             static_cast<size_t>(std::max(width, 0)) * std::max(height, 0) *
+                 InternalFormatBytesPerPixel(internal_format));
+}
+
+void GLMemoryTracker::GenerateMipmap(GLenum target) {
+  egl_->glGenerateMipmap(target);
+
+  uint32_t unused_face;
+  auto it = textures_.find(BoundTexture(target, &unused_face));
+  if (it == textures_.end()) {
+    return;
+  }
+
+  // Fill in the chain below level 0 of each face, at level 0's bytes per
+  // pixel.
+  uint32_t faces = target == GL_TEXTURE_CUBE_MAP ? 6 : 1;
+  for (uint32_t face = 0; face < faces; face++) {
+    auto base = it->second.levels.find(face << 16);
+    if (base == it->second.levels.end() || base->second.width <= 0 ||
+        base->second.height <= 0) {
+      continue;
+    }
+
+    GLsizei width = base->second.width;
+    GLsizei height = base->second.height;
+    size_t bytes_per_pixel =
+        base->second.bytes / (static_cast<size_t>(width) * height);
+    GLenum face_target =
+        faces == 6 ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : target;
+    for (GLint level = 1; width > 1 || height > 1; level++) {
+      width = std::max(width / 2, 1);
+      height = std::max(height / 2, 1);
+      OnTexImage(face_target, level, width, height,
+                 static_cast<size_t>(width) * height * bytes_per_pixel);
+    }
+  }
+}
+
+void GLMemoryTracker::RenderbufferStorage(GLenum target,
+                                          GLenum internal_format,
+                                          GLsizei width, GLsizei height) {
+  egl_->glRenderbufferStorage(target, internal_format, width, height);
+
+  auto it = renderbuffers_.find(state_cache_->renderbuffer_binding());
+  if (it == renderbuffers_.end()) {
+    return;
+  }
+  Resize(kRenderbuffer, &it->second,
+         static_cast<size_t>(std::max(width, 0)) * std::max(height, 0) *
+             InternalFormatBytesPerPixel(internal_format));
+}
+
+/* static */
+size_t GLMemoryTracker::InternalFormatBytesPerPixel(GLenum internal_format) {
+  switch (internal_format) {
+    case GL_ALPHA:
+    case GL_LUMINANCE:
+    case GL_R8:
+    case GL_R8I:
+    case GL_R8UI:
+    case GL_STENCIL_INDEX8:
+      return 1;
+    case GL_LUMINANCE_ALPHA:
+    case GL_RGBA4:
+    case GL_RGB5_A1:
+    case GL_RGB565:
+    case GL_DEPTH_COMPONENT16:
+    case GL_R16F:
+    case GL_R16I:
+    case GL_R16UI:
+    case GL_RG8:
+    case GL_RG8I:
+    case GL_RG8UI:
+      return 2;
+    case GL_RGB:
+    case GL_RGB8:
+    case GL_SRGB8:
+      return 3;
+    case GL_RGB16F:
+      return 6;
+    case GL_RG32F:
+    case GL_RG32I:
+    case GL_RG32UI:
+    case GL_RGBA16F:
+    case GL_RGBA16I:
+    case GL_RGBA16UI:
+    case GL_DEPTH32F_STENCIL8:
+      return 8;
+    case GL_RGB32F:
+    case GL_RGB32I:
+    case GL_RGB32UI:
+      return 12;
+    case GL_RGBA32F:
+    case GL_RGBA32I:
+    case GL_RGBA32UI:
+      return 16;
+    default:
+      // RGBA, RGBA8, depth/stencil and the other 32-bit formats.
+      return 4;
+  }
+}
+
+GLuint GLMemoryTracker::BoundTexture(GLenum target, uint32_t* face) const {
+  if (target >= GL_TEXTURE_CUBE_MAP_POSITIVE_X &&
+      target <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z) {
+    *face = target - GL_TEXTURE_CUBE_MAP_POSITIVE_X;
+    return state_cache_->texture_binding(GL_TEXTURE_CUBE_MAP);
+  }
+  *face = 0;
+  return state_cache_->texture_binding(target);
+}
+
+void GLMemoryTracker::Resize(ObjectType type, size_t* object_bytes,
+                             size_t bytes) {
+  int64_t delta = static_cast<int64_t>(bytes) -
+                  static_cast<int64_t>(*object_bytes);
+  if (delta == 0) {
+    return;
+  }
+  *object_bytes = bytes;
+  usage_[type].bytes += delta;
+  total_bytes_ += delta;
+
+  int64_t adjusted;
+  napi_adjust_external_memory(env_, delta, &adjusted);
+}
+
+}  // namespace nodejsgl
@@ -0,0 +1,118 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef NODEJS_GL_WEBGL_MEMORY_TRACKER_H_
+#define NODEJS_GL_WEBGL_MEMORY_TRACKER_H_
+
+#include <node_api.h>
+
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+
+#include "egl_context_wrapper.h"
+#include "webgl_state_cache.h"
+
+namespace nodejsgl {
+
+// Estimates the GPU memory held by the buffers, textures and renderbuffers of
+// a context. Every change is reported to V8 through
+// napi_adjust_external_memory(). Without that, V8 would not know that a small
+// JS number can pin a large texture, and GC would not account for it. Sizes
+// come from the dimensions and formats passed to GL. Driver padding,
+// alignment and implicit multisample buffers are not counted.
+class GLMemoryTracker {
+ public:
+  enum ObjectType {
+    kBuffer,
+    kTexture,
+    kRenderbuffer,
+    kObjectTypeCount,
+  };
+
+  struct Usage {
+    uint64_t count;
+    uint64_t bytes;
+  };
+
+  GLMemoryTracker(napi_env env, EGLContextWrapper* egl_context_wrapper,
+                  GLStateCache* state_cache);
+
+  // Releases all memory reported to V8. The GL objects go away with the
+  // context.
+  ~GLMemoryTracker();
+
+  const Usage& usage(ObjectType type) const { return usage_[type]; }
+  uint64_t total_bytes() const { return total_bytes_; }
+
+  void OnCreate(ObjectType type, GLuint object);
+  void OnDelete(ObjectType type, GLuint object);
+
+  // Records new storage of |size| bytes for the buffer bound to |target|.
+  void OnBufferData(GLenum target, GLsizeiptr size);
+
+  // Records new storage of |bytes| bytes for |level| of the texture bound to
+  // |target|. |target| is a cube map face for cube map textures.
+  void OnTexImage(GLenum target, GLint level, GLsizei width, GLsizei height,
+                  size_t bytes);
+
+  // Tracked GL entry points:
+  void CopyTexImage2D(GLenum target, GLint level, GLenum internal_format,
+                      GLint x, GLint y, GLsizei width, GLsizei height,
+                      GLint border);
+  void GenerateMipmap(GLenum target);
+  void RenderbufferStorage(GLenum target, GLenum internal_format,
+                           GLsizei width, GLsizei height);
+
+  // Estimated bytes per pixel of an internal format. Unknown formats count as
+  // 4 bytes.
+  static size_t InternalFormatBytesPerPixel(GLenum internal_format);
+
+ private:
+  struct TextureLevel {
+    GLsizei width;
+    GLsizei height;
+    size_t bytes;
+  };
+
+  struct Texture {
+    // Keyed by face << 16 | level.
+    std::map<uint32_t, TextureLevel> levels;
+    size_t bytes;
+  };
+
+  // Returns the texture bound for |target| and its cube map |face|.
+  GLuint BoundTexture(GLenum target, uint32_t* face) const;
+
+  // Updates the size of one object and reports the difference to V8.
+  void Resize(ObjectType type, size_t* object_bytes, size_t bytes);
+
+  napi_env env_;
+  EGLContextWrapper* egl_;
+  GLStateCache* state_cache_;
+
+  std::unordered_map<GLuint, size_t> buffers_;
+  std::unordered_map<GLuint, Texture> textures_;
+  std::unordered_map<GLuint, size_t> renderbuffers_;
+
+  Usage usage_[kObjectTypeCount];
+  uint64_t total_bytes_;
+};
+
+}  // namespace nodejsgl
+
+#endif  // NODEJS_GL_WEBGL_MEMORY_TRACKER_H_
@@ -0,0 +1,368 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "webgl_object_registry.h"
+
+#include "instance_data.h"
+#include "utils.h"
+#include "webgl_share_group.h"
+
+namespace nodejsgl {
+
+char GLObjectRegistry::constructor_keys_[kGLObjectTypeCount];
+std::mutex GLObjectRegistry::live_wrappers_mutex_;
+std::unordered_set<GLObjectWrapper*>* GLObjectRegistry::live_wrappers_ =
+    new std::unordered_set<GLObjectWrapper*>();
+
+GLObjectRegistry::GLObjectRegistry(EGLContextWrapper* egl_context_wrapper,
+                                   GLStateCache* state_cache,
+                                   GLProgramCache* program_cache,
+                                   GLMemoryTracker* memory_tracker,
+                                   GLTexturePool* texture_pool,
+                                   GLBufferMappings* buffer_mappings,
+                                   GLSyncPool* sync_pool,
+                                   GLCommandThread* command_thread)
+    : egl_(egl_context_wrapper),
+      state_cache_(state_cache),
+      program_cache_(program_cache),
+      memory_tracker_(memory_tracker),
+      texture_pool_(texture_pool),
+      buffer_mappings_(buffer_mappings),
+      sync_pool_(sync_pool),
+      command_thread_(command_thread),
+      share_group_(nullptr),
+      pending_count_(0) {}
+
+/* static */
+napi_status GLObjectRegistry::Register(napi_env env) {
+  static const char* const kClassNames[kGLObjectTypeCount] = {
+      "WebGLBuffer",       "WebGLFramebuffer", "WebGLProgram",
+      "WebGLRenderbuffer", "WebGLShader",      "WebGLSync",
+      "WebGLTexture",
+  };
+
+  napi_status nstatus;
+  for (size_t i = 0; i < kGLObjectTypeCount; i++) {
+    napi_value ctor_value;
+    nstatus = napi_define_class(env, kClassNames[i], NAPI_AUTO_LENGTH,
+                                Constructor, nullptr, 0, nullptr, &ctor_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+
+    nstatus = InstanceData::SetConstructor(env, &constructor_keys_[i],
+                                           ctor_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  }
+  return napi_ok;
+}
+
+/* static */
+napi_value GLObjectRegistry::Constructor(napi_env env,
+                                         napi_callback_info info) {
+  napi_value js_this;
+  napi_status nstatus =
+      napi_get_cb_info(env, info, nullptr, nullptr, &js_this, nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  return js_this;
+}
+
+/* static */
+napi_status GLObjectRegistry::GetName(napi_env env, napi_value value,
+                                      GLObjectType type, GLuint* name) {
+  void* data = nullptr;
+  napi_status nstatus = napi_unwrap(env, value, &data);
+  if (nstatus == napi_ok) {
+    std::lock_guard<std::mutex> lock(live_wrappers_mutex_);
+    if (live_wrappers_->count(static_cast<GLObjectWrapper*>(data)) == 0) {
+      nstatus = napi_invalid_arg;
+    }
+  }
+  if (nstatus != napi_ok) {
+    NAPI_THROW_ERROR(env, "Invalid WebGL object.");
+    return napi_invalid_arg;
+  }
+
+  GLObjectWrapper* wrapper = static_cast<GLObjectWrapper*>(data);
+  if (type != kGLObjectTypeCount && wrapper->type != type) {
+    NAPI_THROW_ERROR(env, "WebGL object has the wrong type.");
+    return napi_invalid_arg;
+  }
+
+  // Arguments are decoded once the context of the call is current.
+  EGLContextWrapper* current = EGLContextWrapper::current();
+  const GLObjectRegistry* registry = wrapper->registry.get();
+  if (registry->egl_ != current &&
+      !(IsShared(wrapper->type) && registry->share_group_ &&
+        registry->share_group_->HasContext(current))) {
+    NAPI_THROW_ERROR(env, "WebGL object belongs to another context.");
+    return napi_invalid_arg;
+  }
+
+  *name = wrapper->name;
+  return napi_ok;
+}
+
+napi_status GLObjectRegistry::Wrap(napi_env env, GLObjectType type,
+                                   GLuint name, napi_value* result) {
+  napi_status nstatus;
+
+  napi_value ctor_value;
+  nstatus = InstanceData::GetConstructor(env, &constructor_keys_[type],
+                                         &ctor_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+
+  nstatus = napi_new_instance(env, ctor_value, 0, nullptr, result);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+
+  GLObjectWrapper* wrapper = new GLObjectWrapper();
+  wrapper->registry = shared_from_this();
+  wrapper->type = type;
+  wrapper->name = name;
+  wrapper->ref = nullptr;
+
+  nstatus =
+      napi_wrap(env, *result, wrapper, Finalize, nullptr, &wrapper->ref);
+  if (nstatus != napi_ok) {
+    delete wrapper;
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(live_wrappers_mutex_);
+    live_wrappers_->insert(wrapper);
+  }
+  wrappers_[type][name] = wrapper;
+  return napi_ok;
+}
+
+napi_status GLObjectRegistry::GetWrapper(napi_env env, GLObjectType type,
+                                         GLuint name, napi_value* result) {
+  if (name == 0) {
+    return napi_get_null(env, result);
+  }
+
+  auto it = wrappers_[type].find(name);
+  if (it != wrappers_[type].end()) {
+    // Empty if the wrapper was collected and its finalizer has not run yet.
+    napi_value wrapper_value = nullptr;
+    napi_status nstatus =
+        napi_get_reference_value(env, it->second->ref, &wrapper_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+    if (wrapper_value) {
+      *result = wrapper_value;
+      return napi_ok;
+    }
+  }
+  return napi_create_uint32(env, name, result);
+}
+
+void GLObjectRegistry::Delete(GLObjectType type, GLuint name) {
+  if (name == 0) {
+    return;
+  }
+
+  Disown(type, name);
+  DeleteObjects(type, 1, &name);
+}
+
+void GLObjectRegistry::Disown(GLObjectType type, GLuint name) {
+  auto it = wrappers_[type].find(name);
+  if (it != wrappers_[type].end()) {
+    it->second->name = 0;
+    wrappers_[type].erase(it);
+  }
+}
+
+void GLObjectRegistry::DeletePending() {
+  for (size_t i = 0; i < kGLObjectTypeCount; i++) {
+    std::vector<GLuint>& names = pending_[i];
+    if (!names.empty()) {
+      DeleteObjects(static_cast<GLObjectType>(i),
+                    static_cast<GLsizei>(names.size()), names.data());
+      names.clear();
+    }
+  }
+  pending_count_ = 0;
+}
+
+void GLObjectRegistry::Detach() {
+  for (size_t i = 0; i < kGLObjectTypeCount; i++) {
+    wrappers_[i].clear();
+    pending_[i].clear();
+  }
+  pending_count_ = 0;
+
+  egl_ = nullptr;
+  state_cache_ = nullptr;
+  program_cache_ = nullptr;
+  memory_tracker_ = nullptr;
+  texture_pool_ = nullptr;
+  buffer_mappings_ = nullptr;
+  sync_pool_ = nullptr;
+  command_thread_ = nullptr;
+  share_group_ = nullptr;
+}
+
+void GLObjectRegistry::ForgetProgram(GLuint program) {
+  if (!egl_) {
+    return;
+  }
+
+  // Called through the share group, possibly from another context's calls.
+  ScopedMakeCurrent scoped_current(egl_);
+  if (command_thread_) {
+    command_thread_->Synchronize();
+  }
+  program_cache_->ForgetProgram(program);
+}
+
+/* static */
+void GLObjectRegistry::Finalize(napi_env env, void* data, void* hint) {
+  GLObjectWrapper* wrapper = static_cast<GLObjectWrapper*>(data);
+  {
+    std::lock_guard<std::mutex> lock(live_wrappers_mutex_);
+    live_wrappers_->erase(wrapper);
+  }
+  napi_delete_reference(env, wrapper->ref);
+
+  if (wrapper->name != 0 && wrapper->registry->egl_) {
+    wrapper->registry->QueueDelete(wrapper);
+  }
+  delete wrapper;
+}
+
+void GLObjectRegistry::DeleteObjects(GLObjectType type, GLsizei count,
+                                     const GLuint* names) {
+  // Deletes of collected wrappers may run during another context's calls.
+  ScopedMakeCurrent scoped_current(egl_);
+  if (command_thread_) {
+    command_thread_->Synchronize();
+  }
+
+  switch (type) {
+    case kGLObjectBuffer:
+      egl_->glDeleteBuffers(count, names);
+      break;
+    case kGLObjectFramebuffer:
+      egl_->glDeleteFramebuffers(count, names);
+      break;
+    case kGLObjectProgram:
+      for (GLsizei i = 0; i < count; i++) {
+        egl_->glDeleteProgram(names[i]);
+      }
+      break;
+    case kGLObjectRenderbuffer:
+      egl_->glDeleteRenderbuffers(count, names);
+      break;
+    case kGLObjectShader:
+      for (GLsizei i = 0; i < count; i++) {
+        egl_->glDeleteShader(names[i]);
+      }
+      break;
+    case kGLObjectSync:
+      // |names| are GLSyncPool handles.
+      for (GLsizei i = 0; i < count; i++) {
+        sync_pool_->Delete(names[i]);
+      }
+      break;
+    case kGLObjectTexture:
+      egl_->glDeleteTextures(count, names);
+      break;
+    default:
+      break;
+  }
+
+  if (!share_group_ || !IsShared(type)) {
+    ForgetObjects(type, count, names, true);
+  } else {
+    share_group_->OnObjectsDeleted(this, type, count, names);
+  }
+}
+
+void GLObjectRegistry::ForgetObjects(GLObjectType type, GLsizei count,
+                                     const GLuint* names, bool deleted_here) {
+  if (!egl_) {
+    return;
+  }
+
+  // The command thread of the context may be using the caches.
+  ScopedMakeCurrent scoped_current(egl_);
+  if (command_thread_) {
+    command_thread_->Synchronize();
+  }
+
+  // Wrappers in this context must not delete a name GL may hand out again.
+  for (GLsizei i = 0; i < count; i++) {
+    Disown(type, names[i]);
+  }
+
+  // Deleting an object only unbinds it from the deleting context. Other
+  // contexts keep using it through their bindings, so their shadows and
+  // program reflections stay as they are.
+  switch (type) {
+    case kGLObjectBuffer:
+      for (GLsizei i = 0; i < count; i++) {
+        if (deleted_here) {
+          state_cache_->OnDeleteBuffer(names[i]);
+        }
+        memory_tracker_->OnDelete(GLMemoryTracker::kBuffer, names[i]);
+        buffer_mappings_->OnDeleteBuffer(names[i]);
+      }
+      break;
+    case kGLObjectFramebuffer:
+      for (GLsizei i = 0; i < count; i++) {
+        state_cache_->OnDeleteFramebuffer(names[i]);
+      }
+      break;
+    case kGLObjectProgram:
+      if (!deleted_here) {
+        break;
+      }
+      for (GLsizei i = 0; i < count; i++) {
+        program_cache_->OnDeleteProgram(names[i]);
+      }
+      break;
+    case kGLObjectRenderbuffer:
+      for (GLsizei i = 0; i < count; i++) {
+        if (deleted_here) {
+          state_cache_->OnDeleteRenderbuffer(names[i]);
+        }
+        memory_tracker_->OnDelete(GLMemoryTracker::kRenderbuffer, names[i]);
+      }
+      break;
+    case kGLObjectTexture:
+      for (GLsizei i = 0; i < count; i++) {
+        if (deleted_here) {
+          state_cache_->OnDeleteTexture(names[i]);
+        }
+        memory_tracker_->OnDelete(GLMemoryTracker::kTexture, names[i]);
+        texture_pool_->OnDeleteTexture(names[i]);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void GLObjectRegistry::QueueDelete(GLObjectWrapper* wrapper) {
+  wrappers_[wrapper->type].erase(wrapper->name);
+  pending_[wrapper->type].push_back(wrapper->name);
+  if (++pending_count_ >= kMaxPendingDeletes) {
+    DeletePending();
+  }
+}
+
+}  // namespace nodejsgl
@@ -0,0 +1,179 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef NODEJS_GL_WEBGL_OBJECT_REGISTRY_H_
+#define NODEJS_GL_WEBGL_OBJECT_REGISTRY_H_
+
+#include <node_api.h>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "egl_context_wrapper.h"
+#include "webgl_buffer_mappings.h"
+#include "webgl_command_thread.h"
+#include "webgl_memory_tracker.h"
+#include "webgl_program_cache.h"
+#include "webgl_state_cache.h"
+#include "webgl_sync.h"
+#include "webgl_texture_pool.h"
+
+namespace nodejsgl {
+
+enum GLObjectType {
+  kGLObjectBuffer,
+  kGLObjectFramebuffer,
+  kGLObjectProgram,
+  kGLObjectRenderbuffer,
+  kGLObjectShader,
+  kGLObjectSync,
+  kGLObjectTexture,
+  kGLObjectTypeCount,
+};
+
+class GLObjectRegistry;
+class GLShareGroup;
+
+// Native side of a WebGLBuffer/WebGLTexture/... JS object. |name| is 0 once
+// the object has been deleted explicitly. |ref| is a weak reference to the JS
+// object.
+struct GLObjectWrapper {
+  std::shared_ptr<GLObjectRegistry> registry;
+  GLObjectType type;
+  GLuint name;
+  napi_ref ref;
+};
+
+// Deletes the GL objects of a context and keeps track of the JS wrappers
+// handed out when the context wraps objects (see the |wrapObjects| context
+// option). A wrapper that is garbage collected without being deleted queues
+// its object for deletion. Queued objects are deleted in batches, before the
+// next create*() call or once kMaxPendingDeletes objects are queued.
+//
+// Wrappers share ownership of the registry so that wrappers collected after
+// the context was destroyed can tell that their objects are already gone.
+class GLObjectRegistry : public std::enable_shared_from_this<GLObjectRegistry> {
+ public:
+  GLObjectRegistry(EGLContextWrapper* egl_context_wrapper,
+                   GLStateCache* state_cache, GLProgramCache* program_cache,
+                   GLMemoryTracker* memory_tracker,
+                   GLTexturePool* texture_pool,
+                   GLBufferMappings* buffer_mappings,
+                   GLSyncPool* sync_pool, GLCommandThread* command_thread);
+
+  // Defines the WebGLBuffer, WebGLSync, WebGLTexture, ... classes.
+  static napi_status Register(napi_env env);
+
+  // Looks up the object name of a wrapper of |type| (kGLObjectTypeCount for
+  // any type). Throws and returns napi_invalid_arg if |value| is not such a
+  // wrapper, or if its object can't be used by the current context: shared
+  // objects must come from its share group, framebuffers and fences from the
+  // context itself.
+  static napi_status GetName(napi_env env, napi_value value, GLObjectType type,
+                             GLuint* name);
+
+  // Creates a JS wrapper that owns |name|.
+  napi_status Wrap(napi_env env, GLObjectType type, GLuint name,
+                   napi_value* result);
+
+  // Returns the wrapper of |name| for getParameter(), null for 0, or |name|
+  // as a number if it has no wrapper in this context (e.g. it was created by
+  // another context of the share group).
+  napi_status GetWrapper(napi_env env, GLObjectType type, GLuint name,
+                         napi_value* result);
+
+  // Deletes |name| now, e.g. for deleteTexture(). Its wrapper, if any, no
+  // longer deletes it when collected.
+  void Delete(GLObjectType type, GLuint name);
+
+  // Hands |name| back to the binding (e.g. releaseTexture()). Its wrapper, if
+  // any, no longer deletes it when collected.
+  void Disown(GLObjectType type, GLuint name);
+
+  // Deletes all objects queued by collected wrappers.
+  void DeletePending();
+  bool has_pending() const { return pending_count_ > 0; }
+
+  // Called when the context goes away, along with all its objects.
+  void Detach();
+
+  // Drops the reflection of |program| once the command thread of the context
+  // is done with it, e.g. after another context relinked the program.
+  void ForgetProgram(GLuint program);
+
+  // Disowns the wrappers of |count| deleted objects and updates the
+  // accounting of the context. Shared objects may have been deleted through
+  // another context of the share group, which calls this for every context;
+  // binding shadows are only cleared if |deleted_here|.
+  void ForgetObjects(GLObjectType type, GLsizei count, const GLuint* names,
+                     bool deleted_here);
+
+  EGLContextWrapper* egl_context_wrapper() const { return egl_; }
+  GLProgramCache* program_cache() const { return program_cache_; }
+
+  void set_share_group(GLShareGroup* share_group) {
+    share_group_ = share_group;
+  }
+
+ private:
+  static const size_t kMaxPendingDeletes = 64;
+
+  // Framebuffers and fence handles belong to one context, the names of all
+  // other objects are valid in every context of the share group.
+  static bool IsShared(GLObjectType type) {
+    return type != kGLObjectFramebuffer && type != kGLObjectSync;
+  }
+
+  static napi_value Constructor(napi_env env, napi_callback_info info);
+  static void Finalize(napi_env env, void* data, void* hint);
+
+  // Deletes |count| objects of |type| and updates the caches of every context
+  // that shares them.
+  void DeleteObjects(GLObjectType type, GLsizei count, const GLuint* names);
+
+  // Queues the object of a collected wrapper for deletion.
+  void QueueDelete(GLObjectWrapper* wrapper);
+
+  // Addresses identify the wrapper constructors in the instance data.
+  static char constructor_keys_[kGLObjectTypeCount];
+
+  // Wrappers that have not been collected, to validate napi_unwrap() results.
+  static std::mutex live_wrappers_mutex_;
+  static std::unordered_set<GLObjectWrapper*>* live_wrappers_;
+
+  EGLContextWrapper* egl_;
+  GLStateCache* state_cache_;
+  GLProgramCache* program_cache_;
+  GLMemoryTracker* memory_tracker_;
+  GLTexturePool* texture_pool_;
+  GLBufferMappings* buffer_mappings_;
+  GLSyncPool* sync_pool_;
+  // Deletes of collected wrappers may happen outside of a context call.
+  GLCommandThread* command_thread_;
+  GLShareGroup* share_group_;
+
+  std::unordered_map<GLuint, GLObjectWrapper*> wrappers_[kGLObjectTypeCount];
+  std::vector<GLuint> pending_[kGLObjectTypeCount];
+  size_t pending_count_;
+};
+
+}  // namespace nodejsgl
+
+#endif  // NODEJS_GL_WEBGL_OBJECT_REGISTRY_H_
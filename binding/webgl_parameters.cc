@@ -0,0 +1,365 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "webgl_parameters.h"
+
+#include "utils.h"
+#include "webgl_state_cache.h"
+
+namespace nodejsgl {
+
+static const ParameterInfo kParameters[] = {
+    // WebGL limits:
+    {GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, kParameterInteger, 1,
+     kParameterSourceLimit, false},
+    {GL_MAX_CUBE_MAP_TEXTURE_SIZE, kParameterInteger, 1,
+     kParameterSourceLimit, false},
+    {GL_MAX_FRAGMENT_UNIFORM_VECTORS, kParameterInteger, 1,
+     kParameterSourceLimit, false},
+    {GL_MAX_RENDERBUFFER_SIZE, kParameterInteger, 1,
+     kParameterSourceLimit, false},
+    {GL_MAX_TEXTURE_IMAGE_UNITS, kParameterInteger, 1,
+     kParameterSourceLimit, false},
+    {GL_MAX_TEXTURE_SIZE, kParameterInteger, 1, kParameterSourceLimit, false},
+    {GL_MAX_VARYING_VECTORS, kParameterInteger, 1,
+     kParameterSourceLimit, false},
+    {GL_MAX_VERTEX_ATTRIBS, kParameterInteger, 1, kParameterSourceLimit, false},
+    {GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS, kParameterInteger, 1,
+     kParameterSourceLimit, false},
+    {GL_MAX_VERTEX_UNIFORM_VECTORS, kParameterInteger, 1,
+     kParameterSourceLimit, false},
+    {GL_SUBPIXEL_BITS, kParameterInteger, 1, kParameterSourceLimit, false},
+    {GL_MAX_VIEWPORT_DIMS, kParameterIntegerArray, 2,
+     kParameterSourceLimit, false},
+    {GL_ALIASED_LINE_WIDTH_RANGE, kParameterFloatArray, 2,
+     kParameterSourceLimit, false},
+    {GL_ALIASED_POINT_SIZE_RANGE, kParameterFloatArray, 2,
+     kParameterSourceLimit, false},
+    {GL_RENDERER, kParameterString, 0, kParameterSourceLimit, false},
+    {GL_SHADING_LANGUAGE_VERSION, kParameterString, 0,
+     kParameterSourceLimit, false},
+    {GL_VENDOR, kParameterString, 0, kParameterSourceLimit, false},
+    {GL_VERSION, kParameterString, 0, kParameterSourceLimit, false},
+
+    // WebGL2 limits:
+    {GL_MAX_3D_TEXTURE_SIZE, kParameterInteger, 1, kParameterSourceLimit, true},
+    {GL_MAX_ARRAY_TEXTURE_LAYERS, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_CLIENT_WAIT_TIMEOUT_WEBGL, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_COLOR_ATTACHMENTS, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_COMBINED_FRAGMENT_UNIFORM_COMPONENTS, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_COMBINED_UNIFORM_BLOCKS, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_COMBINED_VERTEX_UNIFORM_COMPONENTS, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_DRAW_BUFFERS, kParameterInteger, 1, kParameterSourceLimit, true},
+    {GL_MAX_ELEMENT_INDEX, kParameterInteger, 1, kParameterSourceLimit, true},
+    {GL_MAX_ELEMENTS_INDICES, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_ELEMENTS_VERTICES, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_FRAGMENT_INPUT_COMPONENTS, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_FRAGMENT_UNIFORM_BLOCKS, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_FRAGMENT_UNIFORM_COMPONENTS, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_PROGRAM_TEXEL_OFFSET, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_SAMPLES, kParameterInteger, 1, kParameterSourceLimit, true},
+    {GL_MAX_SERVER_WAIT_TIMEOUT, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_TRANSFORM_FEEDBACK_SEPARATE_COMPONENTS, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_UNIFORM_BLOCK_SIZE, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_UNIFORM_BUFFER_BINDINGS, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_VARYING_COMPONENTS, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_VERTEX_OUTPUT_COMPONENTS, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_VERTEX_UNIFORM_BLOCKS, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_VERTEX_UNIFORM_COMPONENTS, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MIN_PROGRAM_TEXEL_OFFSET, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, kParameterInteger, 1,
+     kParameterSourceLimit, true},
+    {GL_MAX_TEXTURE_LOD_BIAS, kParameterFloat, 1, kParameterSourceLimit, true},
+
+    // WebGL state:
+    {GL_BLEND, kParameterBoolean, 1, kParameterSourceState, false},
+    {GL_CULL_FACE, kParameterBoolean, 1, kParameterSourceState, false},
+    {GL_DEPTH_TEST, kParameterBoolean, 1, kParameterSourceState, false},
+    {GL_DITHER, kParameterBoolean, 1, kParameterSourceState, false},
+    {GL_POLYGON_OFFSET_FILL, kParameterBoolean, 1,
+     kParameterSourceState, false},
+    {GL_SAMPLE_ALPHA_TO_COVERAGE, kParameterBoolean, 1,
+     kParameterSourceState, false},
+    {GL_SAMPLE_COVERAGE, kParameterBoolean, 1, kParameterSourceState, false},
+    {GL_SCISSOR_TEST, kParameterBoolean, 1, kParameterSourceState, false},
+    {GL_STENCIL_TEST, kParameterBoolean, 1, kParameterSourceState, false},
+    {GL_DEPTH_WRITEMASK, kParameterBoolean, 1, kParameterSourceState, false},
+    {GL_SAMPLE_COVERAGE_INVERT, kParameterBoolean, 1,
+     kParameterSourceState, false},
+    {GL_UNPACK_FLIP_Y_WEBGL, kParameterBoolean, 1,
+     kParameterSourceState, false},
+    {GL_UNPACK_PREMULTIPLY_ALPHA_WEBGL, kParameterBoolean, 1,
+     kParameterSourceState, false},
+    {GL_COLOR_WRITEMASK, kParameterBooleanArray, 4,
+     kParameterSourceState, false},
+    {GL_BLEND_COLOR, kParameterFloatArray, 4, kParameterSourceState, false},
+    {GL_COLOR_CLEAR_VALUE, kParameterFloatArray, 4,
+     kParameterSourceState, false},
+    {GL_DEPTH_RANGE, kParameterFloatArray, 2, kParameterSourceState, false},
+    {GL_DEPTH_CLEAR_VALUE, kParameterFloat, 1, kParameterSourceState, false},
+    {GL_LINE_WIDTH, kParameterFloat, 1, kParameterSourceState, false},
+    {GL_POLYGON_OFFSET_FACTOR, kParameterFloat, 1,
+     kParameterSourceState, false},
+    {GL_POLYGON_OFFSET_UNITS, kParameterFloat, 1, kParameterSourceState, false},
+    {GL_SAMPLE_COVERAGE_VALUE, kParameterFloat, 1,
+     kParameterSourceState, false},
+    {GL_ACTIVE_TEXTURE, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_ARRAY_BUFFER_BINDING, kParameterInteger, 1,
+     kParameterSourceState, false},
+    {GL_ELEMENT_ARRAY_BUFFER_BINDING, kParameterInteger, 1,
+     kParameterSourceState, false},
+    {GL_FRAMEBUFFER_BINDING, kParameterInteger, 1,
+     kParameterSourceState, false},
+    {GL_RENDERBUFFER_BINDING, kParameterInteger, 1,
+     kParameterSourceState, false},
+    {GL_CURRENT_PROGRAM, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_TEXTURE_BINDING_2D, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_TEXTURE_BINDING_CUBE_MAP, kParameterInteger, 1,
+     kParameterSourceState, false},
+    {GL_BLEND_EQUATION_RGB, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_BLEND_EQUATION_ALPHA, kParameterInteger, 1,
+     kParameterSourceState, false},
+    {GL_BLEND_SRC_RGB, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_BLEND_DST_RGB, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_BLEND_SRC_ALPHA, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_BLEND_DST_ALPHA, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_CULL_FACE_MODE, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_FRONT_FACE, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_DEPTH_FUNC, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_STENCIL_FUNC, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_STENCIL_REF, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_STENCIL_VALUE_MASK, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_STENCIL_WRITEMASK, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_STENCIL_FAIL, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_STENCIL_PASS_DEPTH_FAIL, kParameterInteger, 1,
+     kParameterSourceState, false},
+    {GL_STENCIL_PASS_DEPTH_PASS, kParameterInteger, 1,
+     kParameterSourceState, false},
+    {GL_STENCIL_BACK_FUNC, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_STENCIL_BACK_REF, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_STENCIL_BACK_VALUE_MASK, kParameterInteger, 1,
+     kParameterSourceState, false},
+    {GL_STENCIL_BACK_WRITEMASK, kParameterInteger, 1,
+     kParameterSourceState, false},
+    {GL_STENCIL_BACK_FAIL, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_STENCIL_BACK_PASS_DEPTH_FAIL, kParameterInteger, 1,
+     kParameterSourceState, false},
+    {GL_STENCIL_BACK_PASS_DEPTH_PASS, kParameterInteger, 1,
+     kParameterSourceState, false},
+    {GL_STENCIL_CLEAR_VALUE, kParameterInteger, 1,
+     kParameterSourceState, false},
+    {GL_GENERATE_MIPMAP_HINT, kParameterInteger, 1,
+     kParameterSourceState, false},
+    {GL_PACK_ALIGNMENT, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_UNPACK_ALIGNMENT, kParameterInteger, 1, kParameterSourceState, false},
+    {GL_UNPACK_COLORSPACE_CONVERSION_WEBGL, kParameterInteger, 1,
+     kParameterSourceState, false},
+    {GL_VIEWPORT, kParameterIntegerArray, 4, kParameterSourceState, false},
+    {GL_SCISSOR_BOX, kParameterIntegerArray, 4, kParameterSourceState, false},
+
+    // WebGL2 state:
+    {GL_RASTERIZER_DISCARD, kParameterBoolean, 1, kParameterSourceState, true},
+    {GL_COPY_READ_BUFFER_BINDING, kParameterInteger, 1,
+     kParameterSourceState, true},
+    {GL_COPY_WRITE_BUFFER_BINDING, kParameterInteger, 1,
+     kParameterSourceState, true},
+    {GL_PIXEL_PACK_BUFFER_BINDING, kParameterInteger, 1,
+     kParameterSourceState, true},
+    {GL_PIXEL_UNPACK_BUFFER_BINDING, kParameterInteger, 1,
+     kParameterSourceState, true},
+    {GL_TRANSFORM_FEEDBACK_BUFFER_BINDING, kParameterInteger, 1,
+     kParameterSourceState, true},
+    {GL_UNIFORM_BUFFER_BINDING, kParameterInteger, 1,
+     kParameterSourceState, true},
+    {GL_READ_FRAMEBUFFER_BINDING, kParameterInteger, 1,
+     kParameterSourceState, true},
+    {GL_TEXTURE_BINDING_3D, kParameterInteger, 1, kParameterSourceState, true},
+    {GL_TEXTURE_BINDING_2D_ARRAY, kParameterInteger, 1,
+     kParameterSourceState, true},
+    {GL_FRAGMENT_SHADER_DERIVATIVE_HINT, kParameterInteger, 1,
+     kParameterSourceState, true},
+    {GL_PACK_ROW_LENGTH, kParameterInteger, 1, kParameterSourceState, true},
+    {GL_PACK_SKIP_PIXELS, kParameterInteger, 1, kParameterSourceState, true},
+    {GL_PACK_SKIP_ROWS, kParameterInteger, 1, kParameterSourceState, true},
+    {GL_UNPACK_ROW_LENGTH, kParameterInteger, 1, kParameterSourceState, true},
+    {GL_UNPACK_IMAGE_HEIGHT, kParameterInteger, 1, kParameterSourceState, true},
+    {GL_UNPACK_SKIP_PIXELS, kParameterInteger, 1, kParameterSourceState, true},
+    {GL_UNPACK_SKIP_ROWS, kParameterInteger, 1, kParameterSourceState, true},
+    {GL_UNPACK_SKIP_IMAGES, kParameterInteger, 1, kParameterSourceState, true},
+
+    // WebGL state not tracked by GLStateCache:
+    {GL_ALPHA_BITS, kParameterInteger, 1, kParameterSourceDriver, false},
+    {GL_BLUE_BITS, kParameterInteger, 1, kParameterSourceDriver, false},
+    {GL_GREEN_BITS, kParameterInteger, 1, kParameterSourceDriver, false},
+    {GL_RED_BITS, kParameterInteger, 1, kParameterSourceDriver, false},
+    {GL_DEPTH_BITS, kParameterInteger, 1, kParameterSourceDriver, false},
+    {GL_STENCIL_BITS, kParameterInteger, 1, kParameterSourceDriver, false},
+    {GL_SAMPLES, kParameterInteger, 1, kParameterSourceDriver, false},
+    {GL_SAMPLE_BUFFERS, kParameterInteger, 1, kParameterSourceDriver, false},
+    {GL_IMPLEMENTATION_COLOR_READ_FORMAT, kParameterInteger, 1,
+     kParameterSourceDriver, false},
+    {GL_IMPLEMENTATION_COLOR_READ_TYPE, kParameterInteger, 1,
+     kParameterSourceDriver, false},
+    {GL_COMPRESSED_TEXTURE_FORMATS, kParameterCompressedFormats, 0,
+     kParameterSourceDriver, false},
+
+    // WebGL2 state not tracked by GLStateCache:
+    {GL_READ_BUFFER, kParameterInteger, 1, kParameterSourceDriver, true},
+    {GL_DRAW_BUFFER0, kParameterInteger, 1, kParameterSourceDriver, true},
+    {GL_DRAW_BUFFER1, kParameterInteger, 1, kParameterSourceDriver, true},
+    {GL_DRAW_BUFFER2, kParameterInteger, 1, kParameterSourceDriver, true},
+    {GL_DRAW_BUFFER3, kParameterInteger, 1, kParameterSourceDriver, true},
+    {GL_DRAW_BUFFER4, kParameterInteger, 1, kParameterSourceDriver, true},
+    {GL_DRAW_BUFFER5, kParameterInteger, 1, kParameterSourceDriver, true},
+    {GL_DRAW_BUFFER6, kParameterInteger, 1, kParameterSourceDriver, true},
+    {GL_DRAW_BUFFER7, kParameterInteger, 1, kParameterSourceDriver, true},
+    {GL_DRAW_BUFFER8, kParameterInteger, 1, kParameterSourceDriver, true},
+    {GL_DRAW_BUFFER9, kParameterInteger, 1, kParameterSourceDriver, true},
+    {GL_DRAW_BUFFER10, kParameterInteger, 1, kParameterSourceDriver, true},
+    {GL_DRAW_BUFFER11, kParameterInteger, 1, kParameterSourceDriver, true},
+    {GL_DRAW_BUFFER12, kParameterInteger, 1, kParameterSourceDriver, true},
+    {GL_DRAW_BUFFER13, kParameterInteger, 1, kParameterSourceDriver, true},
+    {GL_DRAW_BUFFER14, kParameterInteger, 1, kParameterSourceDriver, true},
+    {GL_DRAW_BUFFER15, kParameterInteger, 1, kParameterSourceDriver, true},
+    {GL_SAMPLER_BINDING, kParameterInteger, 1, kParameterSourceDriver, true},
+    {GL_TRANSFORM_FEEDBACK_BINDING, kParameterInteger, 1,
+     kParameterSourceDriver, true},
+    {GL_VERTEX_ARRAY_BINDING, kParameterInteger, 1,
+     kParameterSourceDriver, true},
+    {GL_TRANSFORM_FEEDBACK_ACTIVE, kParameterBoolean, 1,
+     kParameterSourceDriver, true},
+    {GL_TRANSFORM_FEEDBACK_PAUSED, kParameterBoolean, 1,
+     kParameterSourceDriver, true},
+};
+
+typedef std::unordered_map<GLenum, const ParameterInfo*> ParameterMap;
+
+static const ParameterMap* BuildParameterMap() {
+  ParameterMap* parameters = new ParameterMap();
+  for (size_t i = 0; i < ARRAY_SIZE(kParameters); ++i) {
+    (*parameters)[kParameters[i].pname] = &kParameters[i];
+  }
+  return parameters;
+}
+
+const ParameterInfo* FindParameterInfo(GLenum pname) {
+  static const ParameterMap* parameters = BuildParameterMap();
+  auto it = parameters->find(pname);
+  return it != parameters->end() ? it->second : nullptr;
+}
+
+void GLContextLimits::Init(EGLContextWrapper* egl_context_wrapper,
+                           bool webgl2) {
+  webgl2_ = webgl2;
+
+  for (size_t i = 0; i < ARRAY_SIZE(kParameters); ++i) {
+    const ParameterInfo& info = kParameters[i];
+    if (info.source != kParameterSourceLimit || (info.webgl2 && !webgl2)) {
+      continue;
+    }
+
+    switch (info.type) {
+      case kParameterFloat:
+      case kParameterFloatArray: {
+        Limit<GLfloat>& limit = floats_[info.pname];
+        limit.count = info.count;
+        egl_context_wrapper->glGetFloatv(info.pname, limit.values);
+        break;
+      }
+      case kParameterInteger:
+      case kParameterIntegerArray: {
+        Limit<GLint64>& limit = integers_[info.pname];
+        limit.count = info.count;
+        if (info.pname == GL_MAX_CLIENT_WAIT_TIMEOUT_WEBGL) {
+          // Not a driver limit, see kMaxClientWaitTimeout.
+          limit.values[0] = kMaxClientWaitTimeout;
+        } else if (webgl2) {
+          egl_context_wrapper->glGetInteger64v(info.pname, limit.values);
+        } else {
+          // glGetInteger64v() is not available on ES2 contexts.
+          GLint values[kMaxLimitCount];
+          egl_context_wrapper->glGetIntegerv(info.pname, values);
+          for (size_t j = 0; j < info.count; ++j) {
+            limit.values[j] = values[j];
+          }
+        }
+        break;
+      }
+      case kParameterString: {
+        const GLubyte* str = egl_context_wrapper->glGetString(info.pname);
+        strings_[info.pname] = str ? reinterpret_cast<const char*>(str) : "";
+        break;
+      }
+      default:
+        break;
+    }
+  }
+}
+
+bool GLContextLimits::GetFloatv(GLenum pname, GLfloat* params) const {
+  auto it = floats_.find(pname);
+  if (it == floats_.end()) {
+    return false;
+  }
+  for (size_t i = 0; i < it->second.count; ++i) {
+    params[i] = it->second.values[i];
+  }
+  return true;
+}
+
+bool GLContextLimits::GetInteger64v(GLenum pname, GLint64* params) const {
+  auto it = integers_.find(pname);
+  if (it == integers_.end()) {
+    return false;
+  }
+  for (size_t i = 0; i < it->second.count; ++i) {
+    params[i] = it->second.values[i];
+  }
+  return true;
+}
+
+const std::string* GLContextLimits::GetString(GLenum pname) const {
+  auto it = strings_.find(pname);
+  return it != strings_.end() ? &it->second : nullptr;
+}
+
+}  // namespace nodejsgl
@@ -0,0 +1,100 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef NODEJS_GL_WEBGL_PARAMETERS_H_
+#define NODEJS_GL_WEBGL_PARAMETERS_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "egl_context_wrapper.h"
+
+namespace nodejsgl {
+
+// JS type returned by getParameter() for a parameter name.
+enum ParameterType {
+  kParameterBoolean,
+  kParameterBooleanArray,  // Array of booleans
+  kParameterFloat,
+  kParameterFloatArray,  // Float32Array
+  kParameterInteger,
+  kParameterIntegerArray,  // Int32Array
+  kParameterString,
+  kParameterCompressedFormats,  // Uint32Array of variable length
+};
+
+// Where getParameter() reads a parameter value from.
+enum ParameterSource {
+  kParameterSourceLimit,  // Immutable, queried once at context creation.
+  kParameterSourceState,  // Shadowed by GLStateCache.
+  kParameterSourceDriver,  // Depends on state the binding doesn't track.
+};
+
+struct ParameterInfo {
+  GLenum pname;
+  ParameterType type;
+  uint8_t count;
+  ParameterSource source;
+  bool webgl2;
+};
+
+// Returns the getParameter() description for |pname| or nullptr if |pname| is
+// not a WebGL 1/2 parameter name.
+const ParameterInfo* FindParameterInfo(GLenum pname);
+
+// Immutable implementation limits and strings (MAX_TEXTURE_SIZE, RENDERER,
+// ...), queried once when the context is created.
+class GLContextLimits {
+ public:
+  // Queries all kParameterSourceLimit parameters. WebGL2 parameters are only
+  // queried if |webgl2| is set. The context must be current.
+  void Init(EGLContextWrapper* egl_context_wrapper, bool webgl2);
+
+  bool webgl2() const { return webgl2_; }
+
+  // MAX_CLIENT_WAIT_TIMEOUT_WEBGL in nanoseconds. clientWaitSync() blocks the
+  // JS thread, so longer timeouts are clamped to this.
+  static const GLuint64 kMaxClientWaitTimeout = 1000000000;
+
+  // Copies the limit for |pname| into |params| and returns true, or returns
+  // false if |pname| is not a cached limit. Only the |count| values of the
+  // parameter's ParameterInfo are written, e.g. one for MAX_TEXTURE_SIZE.
+  bool GetFloatv(GLenum pname, GLfloat* params) const;
+  bool GetInteger64v(GLenum pname, GLint64* params) const;
+  const std::string* GetString(GLenum pname) const;
+
+ private:
+  // Largest |count| of a limit, see MAX_VIEWPORT_DIMS.
+  static const size_t kMaxLimitCount = 2;
+
+  template <typename T>
+  struct Limit {
+    T values[kMaxLimitCount];
+    size_t count;
+  };
+
+  bool webgl2_;
+
+  std::unordered_map<GLenum, Limit<GLfloat>> floats_;
+  std::unordered_map<GLenum, Limit<GLint64>> integers_;
+  std::unordered_map<GLenum, std::string> strings_;
+};
+
+}  // namespace nodejsgl
+
+#endif  // NODEJS_GL_WEBGL_PARAMETERS_H_
@@ -0,0 +1,382 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "webgl_program_binary_cache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <utility>
+#include <vector>
+
+#include "utils.h"
+
+namespace nodejsgl {
+
+namespace {
+
+const uint32_t kFileMagic = 0x4250474e;  // "NGPB"
+const uint32_t kFileVersion = 1;
+const char kFileSuffix[] = ".bin";
+
+// Binaries are written behind this header.
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t format;  // binaryFormat reported by the driver.
+  uint32_t reserved;
+  uint64_t check;   // Key::check
+  uint64_t length;  // Bytes of binary after the header.
+};
+
+// 64-bit FNV-1a. The two halves of a key use different offset bases.
+const uint64_t kHashBasis = 14695981039346656037ull;
+const uint64_t kCheckBasis = kHashBasis ^ 0x9e3779b97f4a7c15ull;
+const uint64_t kFnvPrime = 1099511628211ull;
+
+uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * kFnvPrime;
+  }
+  return hash;
+}
+
+// Length-prefixed, so that fields can't run into each other.
+void HashField(GLProgramBinaryCache::Key* key, const std::string& field) {
+  uint64_t size = field.size();
+  key->hash = HashBytes(key->hash, &size, sizeof(size));
+  key->hash = HashBytes(key->hash, field.data(), field.size());
+  key->check = HashBytes(key->check, &size, sizeof(size));
+  key->check = HashBytes(key->check, field.data(), field.size());
+}
+
+bool EndsWith(const std::string& value, const char* suffix) {
+  size_t length = strlen(suffix);
+  return value.size() >= length &&
+         value.compare(value.size() - length, length, suffix) == 0;
+}
+
+}  // namespace
+
+GLProgramBinaryCache::GLProgramBinaryCache(
+    napi_env env, EGLContextWrapper* egl_context_wrapper,
+    GLProgramCache* program_cache, const std::string& directory)
+    : loop_(nullptr),
+      egl_(egl_context_wrapper),
+      program_cache_(program_cache),
+      directory_(directory),
+      enabled_(false),
+      max_bytes_(kDefaultMaxBytes),
+      bytes_(0),
+      hits_(0),
+      misses_(0),
+      stores_(0),
+      evictions_(0) {
+  napi_status nstatus = napi_get_uv_event_loop(env, &loop_);
+  ENSURE_NAPI_OK(env, nstatus);
+
+  GLint formats = 0;
+  egl_->glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, &formats);
+  if (formats == 0 &&
+      egl_->angle_requestable_extensions->HasExtension(
+          "GL_OES_get_program_binary")) {
+    egl_->glRequestExtensionANGLE("GL_OES_get_program_binary");
+    egl_->RefreshGLExtensions();
+    egl_->glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, &formats);
+  }
+  if (formats == 0) {
+    return;
+  }
+
+  const char* strings[] = {
+      eglQueryString(egl_->display, EGL_VERSION),
+      reinterpret_cast<const char*>(egl_->glGetString(GL_VERSION)),
+      reinterpret_cast<const char*>(egl_->glGetString(GL_VENDOR)),
+      reinterpret_cast<const char*>(egl_->glGetString(GL_RENDERER)),
+  };
+  for (const char* string : strings) {
+    driver_.append(string ? string : "");
+    driver_.push_back('\n');
+  }
+
+  uv_fs_t req;
+  int result = uv_fs_mkdir(loop_, &req, directory_.c_str(), 0755, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (result < 0 && result != UV_EEXIST) {
+    return;
+  }
+
+  enabled_ = true;
+  Scan();
+  Trim();
+}
+
+bool GLProgramBinaryCache::GetKey(GLuint program, Key* key) {
+  if (!enabled_) {
+    return false;
+  }
+
+  GLuint shaders[2];
+  GLsizei count = 0;
+  egl_->glGetAttachedShaders(program, 2, &count, shaders);
+  if (count == 0) {
+    return false;
+  }
+
+  // Sorted by shader type, so that the attach order doesn't matter.
+  std::vector<std::pair<GLint, std::string>> sources(count);
+  for (GLsizei i = 0; i < count; ++i) {
+    GLint length = 0;
+    egl_->glGetShaderiv(shaders[i], GL_SHADER_TYPE, &sources[i].first);
+    egl_->glGetShaderiv(shaders[i], GL_SHADER_SOURCE_LENGTH, &length);
+
+    std::vector<char> source(length > 0 ? length : 1);
+    GLsizei written = 0;
+    egl_->glGetShaderSource(shaders[i], static_cast<GLsizei>(source.size()),
+                            &written, source.data());
+    sources[i].second.assign(source.data(), written);
+  }
+  std::sort(sources.begin(), sources.end());
+
+  key->hash = kHashBasis;
+  key->check = kCheckBasis;
+  HashField(key, driver_);
+  for (const auto& source : sources) {
+    HashField(key, std::to_string(source.first));
+    HashField(key, source.second);
+  }
+  HashField(key, program_cache_->GetAttribBindings(program));
+  return true;
+}
+
+bool GLProgramBinaryCache::Load(GLuint program, const Key& key,
+                                std::vector<GLenum>* pending_errors) {
+  std::string file_name = FileName(key);
+  if (entries_.count(file_name) == 0) {
+    // Another process may have stored it since the directory was indexed.
+    uv_fs_t req;
+    int result = uv_fs_stat(loop_, &req, Path(file_name).c_str(), nullptr);
+    uv_fs_req_cleanup(&req);
+    if (result < 0) {
+      misses_++;
+      return false;
+    }
+  }
+
+  FILE* file = fopen(Path(file_name).c_str(), "rb");
+  if (!file) {
+    misses_++;
+    return false;
+  }
+
+  FileHeader header;
+  std::vector<uint8_t> binary;
+  bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+            header.magic == kFileMagic && header.version == kFileVersion &&
+            header.check == key.check && header.length > 0 &&
+            header.length <= max_bytes_;
+  if (ok) {
+    binary.resize(header.length);
+    ok = fread(binary.data(), 1, binary.size(), file) == binary.size();
+  }
+  fclose(file);
+
+  GLint linked = GL_FALSE;
+  if (ok) {
+    // Reading the error flags clears them, so the user's errors are handed
+    // back to the context before the load can raise any.
+    GLenum error;
+    while ((error = egl_->glGetError()) != GL_NO_ERROR) {
+      if (std::find(pending_errors->begin(), pending_errors->end(), error) ==
+          pending_errors->end()) {
+        pending_errors->push_back(error);
+      }
+    }
+    egl_->glProgramBinaryOES(program, header.format, binary.data(),
+                             static_cast<GLint>(binary.size()));
+    egl_->glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    // A rejected binary may raise GL_INVALID_ENUM/GL_INVALID_VALUE, which
+    // must not show up in the user's next getError().
+    while (egl_->glGetError() != GL_NO_ERROR) {
+    }
+  }
+  if (!linked) {
+    // Corrupt, or written by a driver that accepts different binaries.
+    Remove(file_name);
+    misses_++;
+    return false;
+  }
+
+  if (entries_.count(file_name) == 0) {
+    entries_[file_name] = {sizeof(header) + binary.size(), 0};
+    bytes_ += entries_[file_name].bytes;
+  }
+  Touch(file_name);
+  hits_++;
+  return true;
+}
+
+void GLProgramBinaryCache::Store(GLuint program, const Key& key) {
+  GLint linked = GL_FALSE;
+  egl_->glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  GLint length = 0;
+  egl_->glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH_OES, &length);
+  if (!linked || length <= 0) {
+    return;
+  }
+
+  std::vector<uint8_t> binary(length);
+  GLsizei written = 0;
+  GLenum format = 0;
+  egl_->glGetProgramBinaryOES(program, length, &written, &format,
+                              binary.data());
+  if (written <= 0) {
+    return;
+  }
+
+  FileHeader header = {};
+  header.magic = kFileMagic;
+  header.version = kFileVersion;
+  header.format = format;
+  header.check = key.check;
+  header.length = static_cast<uint64_t>(written);
+
+  // Written to a temporary file first, so that other processes never read a
+  // partial binary. Caches of other threads may store the same key.
+  std::string file_name = FileName(key);
+  std::string path = Path(file_name);
+  std::string temp_path =
+      path + "." + std::to_string(uv_os_getpid()) + "." +
+      std::to_string(reinterpret_cast<uintptr_t>(this)) + ".tmp";
+  FILE* file = fopen(temp_path.c_str(), "wb");
+  if (!file) {
+    return;
+  }
+  bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+            fwrite(binary.data(), 1, written, file) ==
+                static_cast<size_t>(written);
+  ok = fclose(file) == 0 && ok;
+
+  uv_fs_t req;
+  if (ok) {
+    ok = uv_fs_rename(loop_, &req, temp_path.c_str(), path.c_str(),
+                      nullptr) == 0;
+    uv_fs_req_cleanup(&req);
+  }
+  if (!ok) {
+    uv_fs_unlink(loop_, &req, temp_path.c_str(), nullptr);
+    uv_fs_req_cleanup(&req);
+    return;
+  }
+
+  auto it = entries_.find(file_name);
+  if (it != entries_.end()) {
+    bytes_ -= it->second.bytes;
+  }
+  Entry& entry = entries_[file_name];
+  entry.bytes = sizeof(header) + static_cast<size_t>(written);
+  entry.last_used = static_cast<double>(time(nullptr));
+  bytes_ += entry.bytes;
+  stores_++;
+  Trim();
+}
+
+void GLProgramBinaryCache::set_max_bytes(size_t max_bytes) {
+  max_bytes_ = max_bytes;
+  Trim();
+}
+
+void GLProgramBinaryCache::Scan() {
+  uv_fs_t req;
+  int result = uv_fs_scandir(loop_, &req, directory_.c_str(), 0, nullptr);
+  if (result < 0) {
+    uv_fs_req_cleanup(&req);
+    return;
+  }
+
+  uv_dirent_t dirent;
+  std::vector<std::string> file_names;
+  while (uv_fs_scandir_next(&req, &dirent) != UV_EOF) {
+    if (dirent.type != UV_DIRENT_DIR && EndsWith(dirent.name, kFileSuffix)) {
+      file_names.push_back(dirent.name);
+    }
+  }
+  uv_fs_req_cleanup(&req);
+
+  for (const std::string& file_name : file_names) {
+    uv_fs_t stat_req;
+    result = uv_fs_stat(loop_, &stat_req, Path(file_name).c_str(), nullptr);
+    if (result == 0) {
+      const uv_stat_t& stat = stat_req.statbuf;
+      Entry& entry = entries_[file_name];
+      entry.bytes = static_cast<size_t>(stat.st_size);
+      entry.last_used =
+          stat.st_mtim.tv_sec + stat.st_mtim.tv_nsec / 1000000000.0;
+      bytes_ += entry.bytes;
+    }
+    uv_fs_req_cleanup(&stat_req);
+  }
+}
+
+std::string GLProgramBinaryCache::FileName(const Key& key) const {
+  char name[17];
+  snprintf(name, sizeof(name), "%016llx",
+           static_cast<unsigned long long>(key.hash));
+  return std::string(name) + kFileSuffix;
+}
+
+std::string GLProgramBinaryCache::Path(const std::string& file_name) const {
+  return directory_ + "/" + file_name;
+}
+
+void GLProgramBinaryCache::Touch(const std::string& file_name) {
+  double now = static_cast<double>(time(nullptr));
+  entries_[file_name].last_used = now;
+
+  uv_fs_t req;
+  uv_fs_utime(loop_, &req, Path(file_name).c_str(), now, now, nullptr);
+  uv_fs_req_cleanup(&req);
+}
+
+void GLProgramBinaryCache::Remove(const std::string& file_name) {
+  uv_fs_t req;
+  uv_fs_unlink(loop_, &req, Path(file_name).c_str(), nullptr);
+  uv_fs_req_cleanup(&req);
+
+  auto it = entries_.find(file_name);
+  if (it != entries_.end()) {
+    bytes_ -= it->second.bytes;
+    entries_.erase(it);
+  }
+}
+
+void GLProgramBinaryCache::Trim() {
+  while (bytes_ > max_bytes_ && !entries_.empty()) {
+    auto oldest = entries_.begin();
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+      if (it->second.last_used < oldest->second.last_used) {
+        oldest = it;
+      }
+    }
+    Remove(oldest->first);
+    evictions_++;
+  }
+}
+
+}  // namespace nodejsgl
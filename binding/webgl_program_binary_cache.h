@@ -0,0 +1,126 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef NODEJS_GL_WEBGL_PROGRAM_BINARY_CACHE_H_
+#define NODEJS_GL_WEBGL_PROGRAM_BINARY_CACHE_H_
+
+#include <node_api.h>
+#include <uv.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "egl_context_wrapper.h"
+#include "webgl_program_cache.h"
+
+namespace nodejsgl {
+
+// Keeps the binaries of linked programs in a directory (OES_get_program_binary)
+// so that later processes load them instead of compiling and linking again.
+// A binary is stored under a hash of the attached shader sources, the
+// attribute locations bound before the link, and the ANGLE version and
+// renderer strings. Binaries the driver rejects are removed and the program is
+// linked from source.
+//
+// The directory may be shared by several contexts and processes. Each cache
+// indexes the directory when it is created and evicts the least recently used
+// binaries once its index grows past |max_bytes|.
+class GLProgramBinaryCache {
+ public:
+  struct Key {
+    uint64_t hash;   // Names the file.
+    uint64_t check;  // Stored in the file, guards against hash collisions.
+  };
+
+  GLProgramBinaryCache(napi_env env, EGLContextWrapper* egl_context_wrapper,
+                       GLProgramCache* program_cache,
+                       const std::string& directory);
+
+  // False if the driver can't return program binaries or the directory can't
+  // be created.
+  bool enabled() const { return enabled_; }
+
+  // Computes the key of |program| from its attached shaders. Returns false if
+  // the cache is disabled or |program| has no shaders attached.
+  bool GetKey(GLuint program, Key* key);
+
+  // Loads the binary stored under |key| into |program|. Returns true if
+  // |program| is now linked. GL errors pending before the load are appended
+  // to |pending_errors| so that only those raised by a rejected binary are
+  // dropped.
+  bool Load(GLuint program, const Key& key,
+            std::vector<GLenum>* pending_errors);
+
+  // Stores the binary of |program| under |key| if it linked successfully.
+  void Store(GLuint program, const Key& key);
+
+  size_t max_bytes() const { return max_bytes_; }
+  void set_max_bytes(size_t max_bytes);
+
+  uint64_t hits() const { return hits_; }
+  uint64_t misses() const { return misses_; }
+  uint64_t stores() const { return stores_; }
+  uint64_t evictions() const { return evictions_; }
+  size_t entries() const { return entries_.size(); }
+  size_t bytes() const { return bytes_; }
+
+ private:
+  static const size_t kDefaultMaxBytes = 64 * 1024 * 1024;
+
+  struct Entry {
+    size_t bytes;
+    double last_used;  // Seconds since the epoch.
+  };
+
+  // Indexes the binaries already in the directory.
+  void Scan();
+
+  std::string FileName(const Key& key) const;
+  std::string Path(const std::string& file_name) const;
+
+  // Marks a binary as used now, also on disk for other processes.
+  void Touch(const std::string& file_name);
+  void Remove(const std::string& file_name);
+
+  // Removes least recently used binaries until |bytes_| <= |max_bytes_|.
+  void Trim();
+
+  // Only used for synchronous file system calls.
+  uv_loop_t* loop_;
+  EGLContextWrapper* egl_;
+  GLProgramCache* program_cache_;
+  std::string directory_;
+  // Driver identification hashed into every key.
+  std::string driver_;
+  bool enabled_;
+
+  std::unordered_map<std::string, Entry> entries_;
+
+  size_t max_bytes_;
+  size_t bytes_;
+  uint64_t hits_;
+  uint64_t misses_;
+  uint64_t stores_;
+  uint64_t evictions_;
+};
+
+}  // namespace nodejsgl
+
+#endif  // NODEJS_GL_WEBGL_PROGRAM_BINARY_CACHE_H_
@@ -0,0 +1,639 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "webgl_program_cache.h"
+
+#include <cstring>
+
+#include "webgl_share_group.h"
+
+namespace nodejsgl {
+
+// Adds |variable| to |locations|. Arrays are reported as "name[0]" and may
+// also be looked up by their base name.
+static void AddLocation(const GLProgramCache::Variable& variable,
+                        std::unordered_map<std::string, GLint>* locations) {
+  (*locations)[variable.name] = variable.location;
+
+  const std::string& name = variable.name;
+  if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+    (*locations)[name.substr(0, name.size() - 3)] = variable.location;
+  }
+}
+
+// Returns the number of 32-bit components of a uniform of |type| and whether
+// it is set with float, int or either kind of setter.
+static size_t UniformComponents(GLenum type, bool* is_float, bool* is_int) {
+  *is_float = false;
+  *is_int = false;
+  switch (type) {
+    case GL_FLOAT:
+      *is_float = true;
+      return 1;
+    case GL_FLOAT_VEC2:
+      *is_float = true;
+      return 2;
+    case GL_FLOAT_VEC3:
+      *is_float = true;
+      return 3;
+    case GL_FLOAT_VEC4:
+    case GL_FLOAT_MAT2:
+      *is_float = true;
+      return 4;
+    case GL_FLOAT_MAT3:
+      *is_float = true;
+      return 9;
+    case GL_FLOAT_MAT4:
+      *is_float = true;
+      return 16;
+    case GL_INT:
+    case GL_SAMPLER_2D:
+    case GL_SAMPLER_3D:
+    case GL_SAMPLER_CUBE:
+    case GL_SAMPLER_2D_SHADOW:
+    case GL_SAMPLER_2D_ARRAY:
+    case GL_SAMPLER_2D_ARRAY_SHADOW:
+    case GL_SAMPLER_CUBE_SHADOW:
+    case GL_INT_SAMPLER_2D:
+    case GL_INT_SAMPLER_3D:
+    case GL_INT_SAMPLER_CUBE:
+    case GL_INT_SAMPLER_2D_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_2D:
+    case GL_UNSIGNED_INT_SAMPLER_3D:
+    case GL_UNSIGNED_INT_SAMPLER_CUBE:
+    case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+      *is_int = true;
+      return 1;
+    case GL_INT_VEC2:
+      *is_int = true;
+      return 2;
+    case GL_INT_VEC3:
+      *is_int = true;
+      return 3;
+    case GL_INT_VEC4:
+      *is_int = true;
+      return 4;
+    case GL_BOOL:
+      *is_float = *is_int = true;
+      return 1;
+    case GL_BOOL_VEC2:
+      *is_float = *is_int = true;
+      return 2;
+    case GL_BOOL_VEC3:
+      *is_float = *is_int = true;
+      return 3;
+    case GL_BOOL_VEC4:
+      *is_float = *is_int = true;
+      return 4;
+    default:
+      // Unsigned and non-square matrix types have no setters here.
+      return 0;
+  }
+}
+
+GLProgramCache::GLProgramCache(EGLContextWrapper* egl_context_wrapper,
+                               GLStateCache* state_cache)
+    : egl_(egl_context_wrapper),
+      state_cache_(state_cache),
+      share_group_(nullptr),
+      shared_(false),
+      next_layout_handle_(1),
+      uniform_elision_enabled_(true),
+      uniform_hits_(0),
+      uniform_misses_(0) {}
+
+GLProgramCache::Program* GLProgramCache::GetProgram(GLuint program) {
+  auto it = programs_.find(program);
+  if (it != programs_.end()) {
+    return it->second.get();
+  }
+
+  if (program == 0 || !egl_->glIsProgram(program)) {
+    return nullptr;
+  }
+
+  GLint link_status = GL_FALSE;
+  egl_->glGetProgramiv(program, GL_LINK_STATUS, &link_status);
+  if (link_status != GL_TRUE) {
+    return nullptr;
+  }
+
+  std::unique_ptr<Program> info(new Program());
+  Reflect(program, info.get());
+
+  Program* result = info.get();
+  programs_[program] = std::move(info);
+  return result;
+}
+
+GLint GLProgramCache::GetAttribLocation(GLuint program,
+                                        const std::string& name) {
+  Program* info = GetProgram(program);
+  if (!info) {
+    return egl_->glGetAttribLocation(program, name.c_str());
+  }
+
+  auto it = info->attrib_locations.find(name);
+  if (it != info->attrib_locations.end()) {
+    return it->second;
+  }
+
+  GLint location = egl_->glGetAttribLocation(program, name.c_str());
+  info->attrib_locations[name] = location;
+  return location;
+}
+
+GLint GLProgramCache::GetUniformLocation(GLuint program,
+                                         const std::string& name) {
+  Program* info = GetProgram(program);
+  if (!info) {
+    return egl_->glGetUniformLocation(program, name.c_str());
+  }
+
+  auto it = info->uniform_locations.find(name);
+  if (it != info->uniform_locations.end()) {
+    return it->second;
+  }
+
+  // Array elements other than [0], struct members, misspelled names, ...
+  GLint location = egl_->glGetUniformLocation(program, name.c_str());
+  info->uniform_locations[name] = location;
+  return location;
+}
+
+uint32_t GLProgramCache::CreateUniformLayout(
+    GLuint program, const std::vector<std::string>& names) {
+  Program* info = GetProgram(program);
+  if (!info) {
+    return 0;
+  }
+
+  std::vector<size_t> uniforms;
+  if (names.empty()) {
+    for (size_t i = 0; i < info->uniforms.size(); ++i) {
+      uniforms.push_back(i);
+    }
+  } else {
+    for (const std::string& name : names) {
+      for (size_t i = 0; i < info->uniforms.size(); ++i) {
+        const std::string& uniform_name = info->uniforms[i].name;
+        if (uniform_name == name ||
+            (uniform_name.size() == name.size() + 3 &&
+             uniform_name.compare(0, name.size(), name) == 0 &&
+             uniform_name.compare(name.size(), 3, "[0]") == 0)) {
+          uniforms.push_back(i);
+          break;
+        }
+      }
+    }
+  }
+
+  UniformLayout layout;
+  layout.byte_length = 0;
+  for (size_t i : uniforms) {
+    const Variable& uniform = info->uniforms[i];
+    bool is_float;
+    bool is_int;
+    size_t components = UniformComponents(uniform.type, &is_float, &is_int);
+    if (uniform.location < 0 || components == 0) {
+      continue;
+    }
+
+    UniformLayoutEntry entry;
+    entry.uniform = i;
+    entry.location = uniform.location;
+    entry.type = uniform.type;
+    entry.count = uniform.size;
+    entry.offset = layout.byte_length;
+    layout.entries.push_back(entry);
+
+    layout.byte_length += static_cast<uint32_t>(uniform.size * components *
+                                                sizeof(GLfloat));
+  }
+
+  uint32_t handle = next_layout_handle_++;
+  info->uniform_layouts[handle] = std::move(layout);
+  return handle;
+}
+
+const GLProgramCache::UniformLayout* GLProgramCache::GetUniformLayout(
+    GLuint program, uint32_t handle) {
+  Program* info = GetProgram(program);
+  if (!info) {
+    return nullptr;
+  }
+
+  auto it = info->uniform_layouts.find(handle);
+  return it != info->uniform_layouts.end() ? &it->second : nullptr;
+}
+
+void GLProgramCache::SetUniforms(GLuint program, const UniformLayout& layout,
+                                 const uint8_t* data) {
+  state_cache_->UseProgram(program);
+
+  for (const UniformLayoutEntry& entry : layout.entries) {
+    const GLfloat* floats =
+        reinterpret_cast<const GLfloat*>(data + entry.offset);
+    const GLint* ints = reinterpret_cast<const GLint*>(data + entry.offset);
+    switch (entry.type) {
+      case GL_FLOAT:
+        Uniform1fv(entry.location, entry.count, floats);
+        break;
+      case GL_FLOAT_VEC2:
+        Uniform2fv(entry.location, entry.count, floats);
+        break;
+      case GL_FLOAT_VEC3:
+        Uniform3fv(entry.location, entry.count, floats);
+        break;
+      case GL_FLOAT_VEC4:
+        Uniform4fv(entry.location, entry.count, floats);
+        break;
+      case GL_FLOAT_MAT2:
+        UniformMatrix2fv(entry.location, entry.count, GL_FALSE, floats);
+        break;
+      case GL_FLOAT_MAT3:
+        UniformMatrix3fv(entry.location, entry.count, GL_FALSE, floats);
+        break;
+      case GL_FLOAT_MAT4:
+        UniformMatrix4fv(entry.location, entry.count, GL_FALSE, floats);
+        break;
+      case GL_INT_VEC2:
+      case GL_BOOL_VEC2:
+        Uniform2iv(entry.location, entry.count, ints);
+        break;
+      case GL_INT_VEC3:
+      case GL_BOOL_VEC3:
+        Uniform3iv(entry.location, entry.count, ints);
+        break;
+      case GL_INT_VEC4:
+      case GL_BOOL_VEC4:
+        Uniform4iv(entry.location, entry.count, ints);
+        break;
+      default:
+        // GL_INT, GL_BOOL and samplers.
+        Uniform1iv(entry.location, entry.count, ints);
+        break;
+    }
+  }
+}
+
+void GLProgramCache::ForgetProgram(GLuint program) { programs_.erase(program); }
+
+void GLProgramCache::OnBindAttribLocation(GLuint program, GLuint index,
+                                          const std::string& name) {
+  attrib_bindings_[program][name] = index;
+}
+
+std::string GLProgramCache::GetAttribBindings(GLuint program) const {
+  std::string bindings;
+  auto it = attrib_bindings_.find(program);
+  if (it != attrib_bindings_.end()) {
+    for (const auto& binding : it->second) {
+      bindings += binding.first + "=" + std::to_string(binding.second) + ";";
+    }
+  }
+  return bindings;
+}
+
+void GLProgramCache::OnDeleteProgram(GLuint program) {
+  attrib_bindings_.erase(program);
+  ForgetProgram(program);
+}
+
+void GLProgramCache::OnLinkProgram(GLuint program) {
+  if (share_group_) {
+    share_group_->OnProgramChanged(program);
+  } else {
+    ForgetProgram(program);
+  }
+}
+
+void GLProgramCache::Reflect(GLuint program, Program* info) {
+  GLint count = 0;
+  GLint max_length = 0;
+  std::vector<char> name;
+
+  egl_->glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+  egl_->glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+  name.resize(max_length > 0 ? max_length : 1);
+
+  info->uniforms.resize(count);
+  for (GLint i = 0; i < count; ++i) {
+    Variable& uniform = info->uniforms[i];
+    GLsizei length = 0;
+    egl_->glGetActiveUniform(program, i, name.size(), &length, &uniform.size,
+                             &uniform.type, name.data());
+    uniform.name.assign(name.data(), length);
+    uniform.location =
+        egl_->glGetUniformLocation(program, uniform.name.c_str());
+    AddLocation(uniform, &info->uniform_locations);
+  }
+
+  count = 0;
+  max_length = 0;
+  egl_->glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &count);
+  egl_->glGetProgramiv(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &max_length);
+  name.resize(max_length > 0 ? max_length : 1);
+
+  info->attribs.resize(count);
+  for (GLint i = 0; i < count; ++i) {
+    Variable& attrib = info->attribs[i];
+    GLsizei length = 0;
+    egl_->glGetActiveAttrib(program, i, name.size(), &length, &attrib.size,
+                            &attrib.type, name.data());
+    attrib.name.assign(name.data(), length);
+    attrib.location = egl_->glGetAttribLocation(program, attrib.name.c_str());
+    AddLocation(attrib, &info->attrib_locations);
+  }
+
+  ReflectUniformValues(program, info);
+}
+
+void GLProgramCache::ReflectUniformValues(GLuint program, Program* info) {
+  size_t byte_size = 0;
+  size_t element_count = 0;
+  for (const Variable& uniform : info->uniforms) {
+    if (uniform.location < 0) {
+      // Uniform block members are not set with glUniform*().
+      continue;
+    }
+
+    bool is_float;
+    bool is_int;
+    size_t components = UniformComponents(uniform.type, &is_float, &is_int);
+    if (components == 0) {
+      continue;
+    }
+
+    UniformValue value;
+    value.element_size = static_cast<uint16_t>(components * sizeof(GLfloat));
+    value.kind = is_float && is_int ? kUniformBool
+                                    : (is_float ? kUniformFloat : kUniformInt);
+    value.is_array = uniform.size > 1;
+
+    // Array element locations are not guaranteed to be consecutive, so each
+    // element is looked up by name.
+    std::string base_name = uniform.name;
+    if (value.is_array && base_name.size() > 3 &&
+        base_name.compare(base_name.size() - 3, 3, "[0]") == 0) {
+      base_name.resize(base_name.size() - 3);
+    }
+    for (GLint i = 0; i < uniform.size; ++i) {
+      GLint location = uniform.location;
+      if (i > 0) {
+        std::string name = base_name + "[" + std::to_string(i) + "]";
+        location = egl_->glGetUniformLocation(program, name.c_str());
+        info->uniform_locations[name] = location;
+        if (location < 0) {
+          continue;
+        }
+      }
+
+      value.offset = static_cast<uint32_t>(byte_size +
+                                           i * value.element_size);
+      value.index = static_cast<uint32_t>(element_count + i);
+      value.elements = static_cast<uint32_t>(uniform.size - i);
+      info->uniform_slots[location] = value;
+    }
+
+    byte_size += uniform.size * value.element_size;
+    element_count += uniform.size;
+  }
+
+  info->uniform_values.resize(byte_size);
+  info->uniform_known.assign(element_count, false);
+}
+
+bool GLProgramCache::ShouldUpload(GLint location, UniformKind kind,
+                                  size_t components, GLsizei count,
+                                  const void* value) {
+  Program* info = GetProgram(state_cache_->program());
+  if (!info || count <= 0) {
+    uniform_misses_++;
+    return true;
+  }
+
+  auto it = info->uniform_slots.find(location);
+  if (it == info->uniform_slots.end()) {
+    // Includes location -1, which GL silently ignores.
+    uniform_misses_++;
+    return true;
+  }
+
+  const UniformValue& slot = it->second;
+  bool kind_matches = slot.kind == kind || slot.kind == kUniformBool;
+  if (!kind_matches || slot.element_size != components * sizeof(GLfloat) ||
+      (!slot.is_array && count > 1)) {
+    // GL reports an error and leaves the uniform unchanged.
+    uniform_misses_++;
+    return true;
+  }
+
+  // Elements past the end of the array are ignored by GL.
+  size_t elements = static_cast<size_t>(count) < slot.elements
+                        ? static_cast<size_t>(count)
+                        : slot.elements;
+  size_t byte_length = elements * slot.element_size;
+  uint8_t* shadow = info->uniform_values.data() + slot.offset;
+
+  if (uniform_elision_enabled_ && !shared_) {
+    bool known = true;
+    for (size_t i = 0; i < elements && known; ++i) {
+      known = info->uniform_known[slot.index + i];
+    }
+    if (known && memcmp(shadow, value, byte_length) == 0) {
+      uniform_hits_++;
+      return false;
+    }
+  }
+
+  memcpy(shadow, value, byte_length);
+  for (size_t i = 0; i < elements; ++i) {
+    info->uniform_known[slot.index + i] = true;
+  }
+  uniform_misses_++;
+  return true;
+}
+
+void GLProgramCache::ForgetUniform(GLint location, GLsizei count) {
+  Program* info = GetProgram(state_cache_->program());
+  if (!info) {
+    return;
+  }
+
+  auto it = info->uniform_slots.find(location);
+  if (it == info->uniform_slots.end()) {
+    return;
+  }
+
+  const UniformValue& slot = it->second;
+  for (uint32_t i = 0; i < slot.elements && i < static_cast<uint32_t>(count);
+       ++i) {
+    info->uniform_known[slot.index + i] = false;
+  }
+}
+
+void GLProgramCache::Uniform1f(GLint location, GLfloat v0) {
+  if (ShouldUpload(location, kUniformFloat, 1, 1, &v0)) {
+    egl_->glUniform1f(location, v0);
+  }
+}
+
+void GLProgramCache::Uniform2f(GLint location, GLfloat v0, GLfloat v1) {
+  const GLfloat value[] = {v0, v1};
+  if (ShouldUpload(location, kUniformFloat, 2, 1, value)) {
+    egl_->glUniform2f(location, v0, v1);
+  }
+}
+
+void GLProgramCache::Uniform3f(GLint location, GLfloat v0, GLfloat v1,
+                               GLfloat v2) {
+  const GLfloat value[] = {v0, v1, v2};
+  if (ShouldUpload(location, kUniformFloat, 3, 1, value)) {
+    egl_->glUniform3f(location, v0, v1, v2);
+  }
+}
+
+void GLProgramCache::Uniform4f(GLint location, GLfloat v0, GLfloat v1,
+                               GLfloat v2, GLfloat v3) {
+  const GLfloat value[] = {v0, v1, v2, v3};
+  if (ShouldUpload(location, kUniformFloat, 4, 1, value)) {
+    egl_->glUniform4f(location, v0, v1, v2, v3);
+  }
+}
+
+void GLProgramCache::Uniform1i(GLint location, GLint v0) {
+  if (ShouldUpload(location, kUniformInt, 1, 1, &v0)) {
+    egl_->glUniform1i(location, v0);
+  }
+}
+
+void GLProgramCache::Uniform2i(GLint location, GLint v0, GLint v1) {
+  const GLint value[] = {v0, v1};
+  if (ShouldUpload(location, kUniformInt, 2, 1, value)) {
+    egl_->glUniform2i(location, v0, v1);
+  }
+}
+
+void GLProgramCache::Uniform3i(GLint location, GLint v0, GLint v1, GLint v2) {
+  const GLint value[] = {v0, v1, v2};
+  if (ShouldUpload(location, kUniformInt, 3, 1, value)) {
+    egl_->glUniform3i(location, v0, v1, v2);
+  }
+}
+
+void GLProgramCache::Uniform4i(GLint location, GLint v0, GLint v1, GLint v2,
+                               GLint v3) {
+  const GLint value[] = {v0, v1, v2, v3};
+  if (ShouldUpload(location, kUniformInt, 4, 1, value)) {
+    egl_->glUniform4i(location, v0, v1, v2, v3);
+  }
+}
+
+void GLProgramCache::Uniform1fv(GLint location, GLsizei count,
+                                const GLfloat* value) {
+  if (ShouldUpload(location, kUniformFloat, 1, count, value)) {
+    egl_->glUniform1fv(location, count, value);
+  }
+}
+
+void GLProgramCache::Uniform2fv(GLint location, GLsizei count,
+                                const GLfloat* value) {
+  if (ShouldUpload(location, kUniformFloat, 2, count, value)) {
+    egl_->glUniform2fv(location, count, value);
+  }
+}
+
+void GLProgramCache::Uniform3fv(GLint location, GLsizei count,
+                                const GLfloat* value) {
+  if (ShouldUpload(location, kUniformFloat, 3, count, value)) {
+    egl_->glUniform3fv(location, count, value);
+  }
+}
+
+void GLProgramCache::Uniform4fv(GLint location, GLsizei count,
+                                const GLfloat* value) {
+  if (ShouldUpload(location, kUniformFloat, 4, count, value)) {
+    egl_->glUniform4fv(location, count, value);
+  }
+}
+
+void GLProgramCache::Uniform1iv(GLint location, GLsizei count,
+                                const GLint* value) {
+  if (ShouldUpload(location, kUniformInt, 1, count, value)) {
+    egl_->glUniform1iv(location, count, value);
+  }
+}
+
+void GLProgramCache::Uniform2iv(GLint location, GLsizei count,
+                                const GLint* value) {
+  if (ShouldUpload(location, kUniformInt, 2, count, value)) {
+    egl_->glUniform2iv(location, count, value);
+  }
+}
+
+void GLProgramCache::Uniform3iv(GLint location, GLsizei count,
+                                const GLint* value) {
+  if (ShouldUpload(location, kUniformInt, 3, count, value)) {
+    egl_->glUniform3iv(location, count, value);
+  }
+}
+
+void GLProgramCache::Uniform4iv(GLint location, GLsizei count,
+                                const GLint* value) {
+  if (ShouldUpload(location, kUniformInt, 4, count, value)) {
+    egl_->glUniform4iv(location, count, value);
+  }
+}
+
+// Transposed uploads are not shadowed; WebGL 1 rejects them anyway. The
+// shadow of the uniform is dropped so the next upload is always forwarded.
+
+void GLProgramCache::UniformMatrix2fv(GLint location, GLsizei count,
+                                      GLboolean transpose,
+                                      const GLfloat* value) {
+  if (transpose) {
+    ForgetUniform(location, count);
+    egl_->glUniformMatrix2fv(location, count, transpose, value);
+  } else if (ShouldUpload(location, kUniformFloat, 4, count, value)) {
+    egl_->glUniformMatrix2fv(location, count, transpose, value);
+  }
+}
+
+void GLProgramCache::UniformMatrix3fv(GLint location, GLsizei count,
+                                      GLboolean transpose,
+                                      const GLfloat* value) {
+  if (transpose) {
+    ForgetUniform(location, count);
+    egl_->glUniformMatrix3fv(location, count, transpose, value);
+  } else if (ShouldUpload(location, kUniformFloat, 9, count, value)) {
+    egl_->glUniformMatrix3fv(location, count, transpose, value);
+  }
+}
+
+void GLProgramCache::UniformMatrix4fv(GLint location, GLsizei count,
+                                      GLboolean transpose,
+                                      const GLfloat* value) {
+  if (transpose) {
+    ForgetUniform(location, count);
+    egl_->glUniformMatrix4fv(location, count, transpose, value);
+  } else if (ShouldUpload(location, kUniformFloat, 16, count, value)) {
+    egl_->glUniformMatrix4fv(location, count, transpose, value);
+  }
+}
+
+}  // namespace nodejsgl
@@ -0,0 +1,220 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef NODEJS_GL_WEBGL_PROGRAM_CACHE_H_
+#define NODEJS_GL_WEBGL_PROGRAM_CACHE_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "egl_context_wrapper.h"
+#include "webgl_state_cache.h"
+
+namespace nodejsgl {
+
+class GLShareGroup;
+
+// Caches the active uniforms and attributes of linked programs so location
+// lookups and getActiveUniform()/getActiveAttrib() don't go to the driver.
+// A program is reflected the first time it is queried after a successful
+// link. Relinking or deleting the program drops its entry.
+//
+// Also shadows the uniform values of each program and skips glUniform*()
+// calls that would upload the value the uniform already has.
+class GLProgramCache {
+ public:
+  struct Variable {
+    std::string name;
+    GLint size;
+    GLenum type;
+    GLint location;
+  };
+
+  // Shadow of the uniform array element at one location.
+  struct UniformValue {
+    uint32_t offset;        // Byte offset into |uniform_values|.
+    uint32_t index;         // Index into |uniform_known|.
+    uint32_t elements;      // Array elements from this location to the end.
+    uint16_t element_size;  // Bytes per array element.
+    uint8_t kind;           // See UniformKind.
+    bool is_array;
+  };
+
+  // One uniform of a setUniforms() layout.
+  struct UniformLayoutEntry {
+    size_t uniform;   // Index into |uniforms|.
+    GLint location;
+    GLenum type;
+    GLsizei count;    // Array elements uploaded.
+    uint32_t offset;  // Byte offset into the packed buffer.
+  };
+
+  // Uniforms of a program packed back to back in one buffer. Each array
+  // element takes 4 bytes per component (floats, or int32 for ints, bools and
+  // samplers) and matrices are column-major.
+  struct UniformLayout {
+    std::vector<UniformLayoutEntry> entries;
+    uint32_t byte_length;
+  };
+
+  struct Program {
+    // Indexed by active uniform/attribute index.
+    std::vector<Variable> uniforms;
+    std::vector<Variable> attribs;
+
+    // Location by name. Also holds names looked up by the user that are not
+    // reported by the driver (e.g. inactive names).
+    std::unordered_map<std::string, GLint> uniform_locations;
+    std::unordered_map<std::string, GLint> attrib_locations;
+
+    // Packed values of all uniform array elements, sized at reflection time.
+    std::unordered_map<GLint, UniformValue> uniform_slots;
+    std::vector<uint8_t> uniform_values;
+    std::vector<bool> uniform_known;
+
+    // Layouts created for this program, by handle.
+    std::unordered_map<uint32_t, UniformLayout> uniform_layouts;
+  };
+
+  GLProgramCache(EGLContextWrapper* egl_context_wrapper,
+                 GLStateCache* state_cache);
+
+  // Returns the reflection of |program|, or nullptr if |program| is not
+  // successfully linked.
+  Program* GetProgram(GLuint program);
+
+  // Returns the location of |name| in |program|. Falls back to the driver if
+  // |program| is not linked so GL reports the error.
+  GLint GetAttribLocation(GLuint program, const std::string& name);
+  GLint GetUniformLocation(GLuint program, const std::string& name);
+
+  // Creates a layout for |names| (all settable active uniforms if empty) and
+  // returns its handle, or 0 if |program| is not linked. Names that are not
+  // active uniforms are left out of the layout. Relinking or deleting the
+  // program invalidates its layouts.
+  uint32_t CreateUniformLayout(GLuint program,
+                               const std::vector<std::string>& names);
+  const UniformLayout* GetUniformLayout(GLuint program, uint32_t handle);
+
+  // Makes |program| current and uploads every uniform of |layout| from
+  // |data|, which must hold at least |layout.byte_length| 4-byte aligned
+  // bytes. Uploads go through the uniform value shadow.
+  void SetUniforms(GLuint program, const UniformLayout& layout,
+                   const uint8_t* data);
+
+  // Drops the entry of |program|. The share group calls this for every
+  // context once the program is deleted.
+  void OnDeleteProgram(GLuint program);
+
+  // Drops the entry of |program| in every context of the share group.
+  void OnLinkProgram(GLuint program);
+
+  // Drops the entry of |program| in this cache only.
+  void ForgetProgram(GLuint program);
+
+  // Attribute locations bound with glBindAttribLocation() take effect on the
+  // next link, so they are part of the program binary cache key.
+  void OnBindAttribLocation(GLuint program, GLuint index,
+                            const std::string& name);
+
+  // Returns the bindings of |program| as "name=index;" pairs sorted by name,
+  // or an empty string if none were made in this context.
+  std::string GetAttribBindings(GLuint program) const;
+
+  void set_share_group(GLShareGroup* share_group) {
+    share_group_ = share_group;
+  }
+
+  // Called once the programs are shared with another context. Uniform uploads
+  // are no longer elided since the other context may change uniform values.
+  void set_shared() { shared_ = true; }
+
+  // When disabled, every uniform upload is forwarded (the shadow is still
+  // kept up to date).
+  bool uniform_elision_enabled() const { return uniform_elision_enabled_; }
+  void set_uniform_elision_enabled(bool enabled) {
+    uniform_elision_enabled_ = enabled;
+  }
+
+  // Uploads skipped/forwarded by the uniform value shadow.
+  uint64_t uniform_hits() const { return uniform_hits_; }
+  uint64_t uniform_misses() const { return uniform_misses_; }
+
+  // Uniform setters for the current program:
+  void Uniform1f(GLint location, GLfloat v0);
+  void Uniform2f(GLint location, GLfloat v0, GLfloat v1);
+  void Uniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2);
+  void Uniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2,
+                 GLfloat v3);
+  void Uniform1i(GLint location, GLint v0);
+  void Uniform2i(GLint location, GLint v0, GLint v1);
+  void Uniform3i(GLint location, GLint v0, GLint v1, GLint v2);
+  void Uniform4i(GLint location, GLint v0, GLint v1, GLint v2, GLint v3);
+  void Uniform1fv(GLint location, GLsizei count, const GLfloat* value);
+  void Uniform2fv(GLint location, GLsizei count, const GLfloat* value);
+  void Uniform3fv(GLint location, GLsizei count, const GLfloat* value);
+  void Uniform4fv(GLint location, GLsizei count, const GLfloat* value);
+  void Uniform1iv(GLint location, GLsizei count, const GLint* value);
+  void Uniform2iv(GLint location, GLsizei count, const GLint* value);
+  void Uniform3iv(GLint location, GLsizei count, const GLint* value);
+  void Uniform4iv(GLint location, GLsizei count, const GLint* value);
+  void UniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose,
+                        const GLfloat* value);
+  void UniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose,
+                        const GLfloat* value);
+  void UniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose,
+                        const GLfloat* value);
+
+ private:
+  enum UniformKind : uint8_t {
+    kUniformFloat,
+    kUniformInt,
+    kUniformBool,  // Accepts both float and int setters.
+  };
+
+  // Returns false and counts a hit if |count| elements of |components| 32-bit
+  // values at |location| of the current program match the shadow. Otherwise
+  // updates the shadow and returns true.
+  bool ShouldUpload(GLint location, UniformKind kind, size_t components,
+                    GLsizei count, const void* value);
+
+  // Marks |count| elements at |location| of the current program as unknown.
+  void ForgetUniform(GLint location, GLsizei count);
+
+  void Reflect(GLuint program, Program* info);
+  void ReflectUniformValues(GLuint program, Program* info);
+
+  EGLContextWrapper* egl_;
+  GLStateCache* state_cache_;
+  GLShareGroup* share_group_;
+  bool shared_;
+  std::unordered_map<GLuint, std::unique_ptr<Program>> programs_;
+  std::unordered_map<GLuint, std::map<std::string, GLuint>> attrib_bindings_;
+  uint32_t next_layout_handle_;
+
+  bool uniform_elision_enabled_;
+  uint64_t uniform_hits_;
+  uint64_t uniform_misses_;
+};
+
+}  // namespace nodejsgl
+
+#endif  // NODEJS_GL_WEBGL_PROGRAM_CACHE_H_
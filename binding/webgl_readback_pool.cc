@@ -0,0 +1,151 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "webgl_readback_pool.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef COMPILER_MSVC
+#include <malloc.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "utils.h"
+
+namespace nodejsgl {
+
+static void* AlignedAlloc(size_t alignment, size_t size) {
+#ifdef COMPILER_MSVC
+  return _aligned_malloc(size, alignment);
+#else
+  void* data = nullptr;
+  return posix_memalign(&data, alignment, size) == 0 ? data : nullptr;
+#endif
+}
+
+static void AlignedFree(void* data) {
+#ifdef COMPILER_MSVC
+  _aligned_free(data);
+#else
+  free(data);
+#endif
+}
+
+/* static */
+ReadbackPool* ReadbackPool::Get() {
+  // Never destroyed: finalizers may run during shutdown.
+  static ReadbackPool* pool = new ReadbackPool();
+  return pool;
+}
+
+ReadbackPool::ReadbackPool() : cached_bytes_(0) {
+#ifdef COMPILER_MSVC
+  page_size_ = 4096;
+#else
+  long page_size = sysconf(_SC_PAGESIZE);
+  page_size_ = page_size > 0 ? static_cast<size_t>(page_size) : 4096;
+#endif
+}
+
+size_t ReadbackPool::BucketIndex(size_t capacity) const {
+  size_t index = 0;
+  for (size_t size = page_size_; size < capacity; size <<= 1) {
+    index++;
+  }
+  return index;
+}
+
+void* ReadbackPool::Allocate(size_t size, size_t* capacity) {
+  // Round up to a power-of-two number of pages.
+  size_t block_size = page_size_;
+  while (block_size < size) {
+    if (block_size > SIZE_MAX / 2) {
+      return nullptr;
+    }
+    block_size <<= 1;
+  }
+  *capacity = block_size;
+
+  size_t index = BucketIndex(block_size);
+  void* data = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index < buckets_.size() && !buckets_[index].empty()) {
+      data = buckets_[index].back();
+      buckets_[index].pop_back();
+      cached_bytes_ -= block_size;
+    }
+  }
+
+  if (!data) {
+    data = AlignedAlloc(page_size_, block_size);
+  }
+  if (data) {
+    memset(data, 0, size);
+  }
+  return data;
+}
+
+void ReadbackPool::Release(void* data, size_t capacity) {
+  size_t index = BucketIndex(capacity);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (buckets_.size() <= index) {
+      buckets_.resize(index + 1);
+    }
+    std::vector<void*>& bucket = buckets_[index];
+    if (bucket.size() < kMaxBlocksPerBucket &&
+        cached_bytes_ + capacity <= kMaxCachedBytes) {
+      bucket.push_back(data);
+      cached_bytes_ += capacity;
+      return;
+    }
+  }
+
+  AlignedFree(data);
+}
+
+napi_status ReadbackPool::CreateArrayBuffer(napi_env env, void* data,
+                                            size_t capacity,
+                                            size_t byte_length,
+                                            napi_value* result) {
+  napi_status nstatus = napi_create_external_arraybuffer(
+      env, data, byte_length, Finalize, reinterpret_cast<void*>(capacity),
+      result);
+  if (nstatus == napi_ok) {
+    return napi_ok;
+  }
+
+  // Some runtimes (e.g. with the V8 sandbox) don't allow external memory.
+  void* copy;
+  nstatus = napi_create_arraybuffer(env, byte_length, &copy, result);
+  if (nstatus == napi_ok) {
+    memcpy(copy, data, byte_length);
+  }
+  Release(data, capacity);
+  return nstatus;
+}
+
+/* static */
+void ReadbackPool::Finalize(napi_env env, void* data, void* hint) {
+  Get()->Release(data, reinterpret_cast<size_t>(hint));
+}
+
+}  // namespace nodejsgl
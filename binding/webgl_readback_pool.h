@@ -0,0 +1,73 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef NODEJS_GL_WEBGL_READBACK_POOL_H_
+#define NODEJS_GL_WEBGL_READBACK_POOL_H_
+
+#include <node_api.h>
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace nodejsgl {
+
+// Page-aligned host memory that GL reads write into directly. The memory is
+// then handed to JS as an external ArrayBuffer, with no copy. Blocks are
+// bucketed by power-of-two size and go back to the pool when their
+// ArrayBuffer is collected. The pool is shared by all contexts and threads,
+// since ArrayBuffers may outlive the context that filled them.
+class ReadbackPool {
+ public:
+  static ReadbackPool* Get();
+
+  // Returns a page-aligned block of |*capacity| >= |size| bytes, or nullptr.
+  // The first |size| bytes are zeroed: blocks are recycled across contexts
+  // and a failed or partial readback must not expose what they held before.
+  void* Allocate(size_t size, size_t* capacity);
+
+  // Returns a block to the pool (or frees it if the pool is full).
+  void Release(void* data, size_t capacity);
+
+  // Creates an ArrayBuffer over the first |byte_length| bytes of |data|.
+  // |data| is released once the ArrayBuffer is collected. If the runtime
+  // does not allow external ArrayBuffers, copies and releases |data|.
+  napi_status CreateArrayBuffer(napi_env env, void* data, size_t capacity,
+                                size_t byte_length, napi_value* result);
+
+ private:
+  // Cache limits for blocks that are not in use.
+  static const size_t kMaxBlocksPerBucket = 4;
+  static const size_t kMaxCachedBytes = 512 * 1024 * 1024;
+
+  ReadbackPool();
+
+  static void Finalize(napi_env env, void* data, void* hint);
+
+  // Index of the bucket holding blocks of |capacity| bytes.
+  size_t BucketIndex(size_t capacity) const;
+
+  size_t page_size_;
+
+  std::mutex mutex_;
+  std::vector<std::vector<void*>> buckets_;
+  size_t cached_bytes_;
+};
+
+}  // namespace nodejsgl
+
+#endif  // NODEJS_GL_WEBGL_READBACK_POOL_H_
@@ -17,17 +17,32 @@
 
 #include "webgl_rendering_context.h"
 
+#include "instance_data.h"
 #include "utils.h"
+#include "webgl_buffer_mappings.h"
+#include "webgl_command_buffer.h"
+#include "webgl_command_thread.h"
 #include "webgl_extensions.h"
+#include "webgl_fence_poller.h"
+#include "webgl_memory_tracker.h"
+#include "webgl_object_registry.h"
+#include "webgl_readback_pool.h"
+#include "webgl_scratch_arena.h"
+#include "webgl_stream_buffer.h"
 #include "webgl_sync.h"
+#include "webgl_texture_pool.h"
 
 #include "angle/include/GLES2/gl2.h"
 #include "angle/include/GLES3/gl3.h"
 #include "angle/include/GLES3/gl32.h"
 
+#include <cmath>
 #include <cstring>
 #include <iostream>
 #include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace nodejsgl {
@@ -38,34 +53,33 @@ enum NodeJSGLArrayType {
   kFloat32 = 1,
 };
 
+// Plain JS Arrays of up to this many elements (a mat4) are converted into
+// storage inside ArrayLikeBuffer instead of the context's scratch arena.
+static const size_t kInlineArrayElements = 16;
+
 // Class to automatically handle V8 buffers (TypedArrays/Arrays) with
 // auto-cleanup. Specify array type to automatically allocate a different byte
-// width (defaults to float).
+// width (defaults to float). Plain JS Arrays are converted into inline storage
+// or scratch arena memory, which is released when the buffer goes out of scope.
 class ArrayLikeBuffer {
  public:
   ArrayLikeBuffer()
-      : data(nullptr), length(0), should_delete(false), array_type(kFloat32) {}
+      : data(nullptr),
+        length(0),
+        element_size(1),
+        array_type(kFloat32),
+        arena(nullptr) {}
 
   ArrayLikeBuffer(NodeJSGLArrayType array_type)
       : data(nullptr),
         length(0),
-        should_delete(false),
-        array_type(array_type) {}
+        element_size(1),
+        array_type(array_type),
+        arena(nullptr) {}
 
   ~ArrayLikeBuffer() {
-    if (should_delete && data != nullptr) {
-      switch (array_type) {
-        case kInt32:
-          delete static_cast<int32_t *>(data);
-          break;
-        case kFloat32:
-          delete static_cast<float *>(data);
-          break;
-        default:
-          fprintf(
-              stderr,
-              "WARNING: Unknown Array buffer type will not be cleaned up\n");
-      }
+    if (arena != nullptr) {
+      arena->Rewind(arena_mark);
     }
   }
 
@@ -84,10 +98,25 @@ class ArrayLikeBuffer {
   }
 
   void *data;
-  size_t length;
-  bool should_delete;
+  size_t length;        // In bytes.
+  size_t element_size;  // Bytes per element of the source view.
 
   NodeJSGLArrayType array_type;
+
+  // Set if |data| was allocated from |arena|.
+  ScratchArena *arena;
+  ScratchArena::Mark arena_mark;
+
+  // Holds converted JS Arrays of up to kInlineArrayElements elements.
+  union {
+    float floats[kInlineArrayElements];
+    int32_t ints[kInlineArrayElements];
+  } inline_data;
+
+ private:
+  // |data| may point into |inline_data|.
+  ArrayLikeBuffer(const ArrayLikeBuffer &);
+  ArrayLikeBuffer &operator=(const ArrayLikeBuffer &);
 };
 
 bool WebGLRenderingContext::CheckForErrors() {
@@ -120,11 +149,109 @@ bool WebGLRenderingContext::CheckForErrors() {
   return had_error;
 }
 
-#define GL_BROWSER_DEFAULT_WEBGL 0x9244
-#define GL_CONTEXT_LOST_WEBGL 0x9242
-#define GL_UNPACK_COLORSPACE_CONVERSION_WEBGL 0x9243
-#define GL_UNPACK_FLIP_Y_WEBGL 0x9240
-#define GL_UNPACK_PREMULTIPLY_ALPHA_WEBGL 0x9241
+GLFencePoller *WebGLRenderingContext::GetFencePoller() {
+  if (!fence_poller_) {
+    fence_poller_ =
+        new GLFencePoller(env_, eglContextWrapper_, ref_, command_thread_);
+    sync_pool_->set_fence_poller(fence_poller_);
+  }
+  return fence_poller_;
+}
+
+// Returns the slot in |stream_buffers_| for |target|, or -1 if streamWrite()
+// doesn't support |target|.
+static int StreamBufferIndex(GLenum target) {
+  switch (target) {
+    case GL_ARRAY_BUFFER:
+      return 0;
+    case GL_ELEMENT_ARRAY_BUFFER:
+      return 1;
+    case GL_UNIFORM_BUFFER:
+      return 2;
+    default:
+      return -1;
+  }
+}
+
+GLStreamBuffer *WebGLRenderingContext::GetStreamBuffer(GLenum target) {
+  int index = StreamBufferIndex(target);
+  if (index < 0 || (target == GL_UNIFORM_BUFFER && !limits_.webgl2())) {
+    return nullptr;
+  }
+  if (!stream_buffers_[index]) {
+    // 16 bytes keeps every vertex attribute and index type aligned.
+    GLint64 alignment = 16;
+    if (target == GL_UNIFORM_BUFFER) {
+      GLint64 uniform_alignment;
+      if (limits_.GetInteger64v(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT,
+                                &uniform_alignment) &&
+          uniform_alignment > alignment) {
+        alignment = uniform_alignment;
+      }
+    }
+    stream_buffers_[index] = new GLStreamBuffer(
+        eglContextWrapper_, state_cache_, memory_tracker_, target,
+        static_cast<size_t>(alignment), limits_.webgl2());
+  }
+  return stream_buffers_[index];
+}
+
+napi_status WebGLRenderingContext::CreateObjectValue(GLObjectType type,
+                                                     GLuint name,
+                                                     napi_value *result) {
+  // Callers may never delete fences and rely on the GC instead.
+  if (!wrap_objects_ && type != kGLObjectSync) {
+    return napi_create_uint32(env_, name, result);
+  }
+  if (name == 0) {
+    return napi_get_null(env_, result);
+  }
+
+  // Objects of collected wrappers are deleted with the next create*() call.
+  if (object_registry_->has_pending()) {
+    object_registry_->DeletePending();
+  }
+  return object_registry_->Wrap(env_, type, name, result);
+}
+
+void WebGLRenderingContext::GetParameterValues(const ParameterInfo &param,
+                                               GLboolean *values) {
+  if (param.source == kParameterSourceState &&
+      state_cache_->GetBooleanv(param.pname, values)) {
+    return;
+  }
+  eglContextWrapper_->glGetBooleanv(param.pname, values);
+}
+
+void WebGLRenderingContext::GetParameterValues(const ParameterInfo &param,
+                                               GLfloat *values) {
+  if (param.source == kParameterSourceLimit &&
+      limits_.GetFloatv(param.pname, values)) {
+    return;
+  }
+  if (param.source == kParameterSourceState &&
+      state_cache_->GetFloatv(param.pname, values)) {
+    return;
+  }
+  eglContextWrapper_->glGetFloatv(param.pname, values);
+}
+
+void WebGLRenderingContext::GetParameterValues(const ParameterInfo &param,
+                                               GLint64 *values) {
+  if (param.source == kParameterSourceLimit &&
+      limits_.GetInteger64v(param.pname, values)) {
+    return;
+  }
+  if (param.source == kParameterSourceState &&
+      state_cache_->GetInteger64v(param.pname, values)) {
+    return;
+  }
+  GLint int_values[4];
+  eglContextWrapper_->glGetIntegerv(param.pname, int_values);
+  for (size_t i = 0; i < param.count; ++i) {
+    values[i] = int_values[i];
+  }
+}
 
 // Returns wrapped context pointer only.
 static napi_status GetContext(napi_env env, napi_callback_info info,
@@ -140,154 +267,509 @@ static napi_status GetContext(napi_env env, napi_callback_info info,
   nstatus = napi_unwrap(env, js_this, reinterpret_cast<void **>(context));
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
+  (*context)->MakeCurrent();
   return napi_ok;
 }
 
 static napi_status UnwrapContext(napi_env env, napi_value js_this,
                                  WebGLRenderingContext **context) {
   ENSURE_VALUE_IS_OBJECT_RETVAL(env, js_this, napi_invalid_arg);
-  return napi_unwrap(env, js_this, reinterpret_cast<void **>(context));
+  napi_status nstatus =
+      napi_unwrap(env, js_this, reinterpret_cast<void **>(context));
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+
+  // Contexts share the thread, and work queued on the command thread runs
+  // before anything else.
+  (*context)->MakeCurrent();
+  return napi_ok;
+}
+
+// Like UnwrapContext() but doesn't wait for work queued on the command thread.
+// Throws if the context has no command thread.
+static napi_status UnwrapCommandThreadContext(
+    napi_env env, napi_value js_this, WebGLRenderingContext **context,
+    GLCommandThread **command_thread) {
+  ENSURE_VALUE_IS_OBJECT_RETVAL(env, js_this, napi_invalid_arg);
+  napi_status nstatus =
+      napi_unwrap(env, js_this, reinterpret_cast<void **>(context));
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+
+  *command_thread = (*context)->command_thread();
+  if (!*command_thread) {
+    NAPI_THROW_ERROR(env, "Context was created without commandThread");
+    return napi_invalid_arg;
+  }
+  return napi_ok;
 }
 
-// TODO(cleanup and refactor) all of these helpers!
-static napi_status GetContextBoolParams(napi_env env, napi_callback_info info,
-                                        WebGLRenderingContext **context,
-                                        size_t param_length, bool *params) {
+// Returns wrapped context pointer and exactly |argc| raw argument values.
+static napi_status GetContextArgs(napi_env env, napi_callback_info info,
+                                  WebGLRenderingContext **context, size_t argc,
+                                  napi_value *args) {
   napi_status nstatus;
 
-  size_t argc = param_length;
-  std::vector<napi_value> args;
-  args.resize(param_length);
+  size_t argc_actual = argc;
   napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args.data(), &js_this, nullptr);
+  nstatus = napi_get_cb_info(env, info, &argc_actual, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  ENSURE_ARGC_RETVAL(env, argc, param_length, napi_invalid_arg);
+  ENSURE_ARGC_RETVAL(env, argc_actual, argc, napi_invalid_arg);
 
-  nstatus = UnwrapContext(env, js_this, context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  return UnwrapContext(env, js_this, context);
+}
 
-  for (size_t i = 0; i < param_length; ++i) {
-    ENSURE_VALUE_IS_BOOLEAN_RETVAL(env, args[i], napi_invalid_arg);
+// Slow path for decoding a numeric GL argument once the napi_get_value_*()
+// fast path failed. Null-params get set to 0 in GL world (see
+// UniformLocationArg for the exception). Booleans are accepted as 0/1 and
+// WebGLObject wrappers of any type as their object name (see GetObjectArg()).
+template <typename T>
+static napi_status GetNonNumberArg(napi_env env, napi_value value, T *out) {
+  napi_valuetype value_type;
+  napi_status nstatus = napi_typeof(env, value, &value_type);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-    nstatus = napi_get_value_bool(env, args[i], &params[i]);
+  if (value_type == napi_null) {
+    *out = 0;
+    return napi_ok;
+  }
+  if (value_type == napi_boolean) {
+    bool bool_value;
+    nstatus = napi_get_value_bool(env, value, &bool_value);
     ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+    *out = bool_value ? 1 : 0;
+    return napi_ok;
+  }
+  if (value_type == napi_object && std::is_unsigned<T>::value) {
+    GLuint name;
+    nstatus = GLObjectRegistry::GetName(env, value, kGLObjectTypeCount, &name);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+    *out = static_cast<T>(name);
+    return napi_ok;
   }
 
-  return napi_ok;
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, value, napi_number_expected);
+  return napi_number_expected;
 }
 
-// Returns wrapped context pointer and uint32_t params.
-static napi_status GetContextUint32Params(napi_env env, napi_callback_info info,
-                                          WebGLRenderingContext **context,
-                                          size_t param_length,
-                                          uint32_t *params) {
-  napi_status nstatus;
+// Decodes a JS value into the native type of a GL argument. Each decoder tries
+// the napi_get_value_*() call first so the common case costs a single N-API
+// call; type checks only run when that fails.
+template <typename T>
+struct NapiArg;
 
-  size_t argc = param_length;
-  std::vector<napi_value> args;
-  args.resize(param_length);
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args.data(), &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+template <>
+struct NapiArg<uint32_t> {
+  static napi_status Get(napi_env env, napi_value value, uint32_t *out) {
+    napi_status nstatus = napi_get_value_uint32(env, value, out);
+    return nstatus == napi_number_expected ? GetNonNumberArg(env, value, out)
+                                           : nstatus;
+  }
+};
+
+template <>
+struct NapiArg<int32_t> {
+  static napi_status Get(napi_env env, napi_value value, int32_t *out) {
+    napi_status nstatus = napi_get_value_int32(env, value, out);
+    return nstatus == napi_number_expected ? GetNonNumberArg(env, value, out)
+                                           : nstatus;
+  }
+};
+
+template <>
+struct NapiArg<double> {
+  static napi_status Get(napi_env env, napi_value value, double *out) {
+    napi_status nstatus = napi_get_value_double(env, value, out);
+    return nstatus == napi_number_expected ? GetNonNumberArg(env, value, out)
+                                           : nstatus;
+  }
+};
 
-  ENSURE_ARGC_RETVAL(env, argc, param_length, napi_invalid_arg);
+template <>
+struct NapiArg<float> {
+  static napi_status Get(napi_env env, napi_value value, float *out) {
+    double double_value;
+    napi_status nstatus = NapiArg<double>::Get(env, value, &double_value);
+    *out = static_cast<float>(double_value);
+    return nstatus;
+  }
+};
 
-  nstatus = UnwrapContext(env, js_this, context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+template <>
+struct NapiArg<bool> {
+  static napi_status Get(napi_env env, napi_value value, bool *out) {
+    napi_status nstatus = napi_get_value_bool(env, value, out);
+    if (nstatus != napi_boolean_expected) {
+      return nstatus;
+    }
+    // Allow numbers for booleans, e.g. GL_TRUE/GL_FALSE:
+    double double_value;
+    nstatus = napi_get_value_double(env, value, &double_value);
+    if (nstatus != napi_ok) {
+      ENSURE_VALUE_IS_BOOLEAN_RETVAL(env, value, napi_boolean_expected);
+    }
+    *out = double_value != 0;
+    return napi_ok;
+  }
+};
+
+template <>
+struct NapiArg<GLboolean> {
+  static napi_status Get(napi_env env, napi_value value, GLboolean *out) {
+    bool bool_value;
+    napi_status nstatus = NapiArg<bool>::Get(env, value, &bool_value);
+    *out = bool_value ? GL_TRUE : GL_FALSE;
+    return nstatus;
+  }
+};
+
+// Byte offsets into bound buffers (e.g. drawElements() and
+// vertexAttribPointer()) are passed to GL as pointers.
+template <>
+struct NapiArg<const void *> {
+  static napi_status Get(napi_env env, napi_value value, const void **out) {
+    int64_t offset;
+    napi_status nstatus = napi_get_value_int64(env, value, &offset);
+    if (nstatus == napi_number_expected) {
+      uint32_t null_offset;
+      nstatus = GetNonNumberArg(env, value, &null_offset);
+      offset = null_offset;
+    }
+    *out = reinterpret_cast<const void *>(static_cast<intptr_t>(offset));
+    return nstatus;
+  }
+};
+
+// Location argument of the uniform*() setters. A null location decodes to -1
+// so that GL ignores the call, like WebGL does for a null
+// WebGLUniformLocation.
+struct UniformLocationArg {
+  GLint value;
+};
+
+template <>
+struct NapiArg<UniformLocationArg> {
+  static napi_status Get(napi_env env, napi_value value,
+                         UniformLocationArg *out) {
+    napi_status nstatus = napi_get_value_int32(env, value, &out->value);
+    if (nstatus != napi_number_expected) {
+      return nstatus;
+    }
 
-  for (size_t i = 0; i < param_length; ++i) {
-    // Null-params get set to 0 in GL world.
     napi_valuetype value_type;
-    nstatus = napi_typeof(env, args[i], &value_type);
+    nstatus = napi_typeof(env, value, &value_type);
     ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
-
     if (value_type == napi_null) {
-      params[i] = 0;
-    } else if (value_type == napi_number) {
-      nstatus = napi_get_value_uint32(env, args[i], &params[i]);
-      ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
-    } else {
-      ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[i], nstatus);
+      out->value = -1;
+      return napi_ok;
     }
+    return GetNonNumberArg(env, value, &out->value);
+  }
+};
+
+// Decodes an object argument: a name, null for 0, or a WebGLObject wrapper of
+// |type| that the current context can use.
+static napi_status GetObjectArg(napi_env env, napi_value value,
+                                GLObjectType type, GLuint *name) {
+  napi_status nstatus = napi_get_value_uint32(env, value, name);
+  if (nstatus != napi_number_expected) {
+    return nstatus;
   }
 
-  return napi_ok;
+  napi_valuetype value_type;
+  nstatus = napi_typeof(env, value, &value_type);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  if (value_type == napi_object) {
+    return GLObjectRegistry::GetName(env, value, type, name);
+  }
+  return GetNonNumberArg(env, value, name);
 }
 
-// Returns wrapped context pointer and uint32_t params.
-static napi_status GetContextInt32Params(napi_env env, napi_callback_info info,
-                                         WebGLRenderingContext **context,
-                                         size_t param_length, int32_t *params) {
-  napi_status nstatus;
+// Object argument of entry points registered with the *_OBJECT_THUNK()
+// macros. Converts to the GLuint the entry point takes.
+template <GLObjectType Type>
+struct ObjectArg {
+  GLuint value;
 
-  size_t argc = param_length;
-  std::vector<napi_value> args;
-  args.resize(param_length);
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args.data(), &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  operator GLuint() const { return value; }
+};
+
+typedef ObjectArg<kGLObjectBuffer> BufferArg;
+typedef ObjectArg<kGLObjectFramebuffer> FramebufferArg;
+typedef ObjectArg<kGLObjectProgram> ProgramArg;
+typedef ObjectArg<kGLObjectRenderbuffer> RenderbufferArg;
+typedef ObjectArg<kGLObjectShader> ShaderArg;
+typedef ObjectArg<kGLObjectTexture> TextureArg;
+
+template <GLObjectType Type>
+struct NapiArg<ObjectArg<Type>> {
+  static napi_status Get(napi_env env, napi_value value,
+                         ObjectArg<Type> *out) {
+    return GetObjectArg(env, value, Type, &out->value);
+  }
+};
 
-  ENSURE_ARGC_RETVAL(env, argc, param_length, napi_invalid_arg);
+template <typename T>
+static napi_status GetNapiArg(napi_env env, napi_value value, T *out) {
+  return NapiArg<T>::Get(env, value, out);
+}
 
-  nstatus = UnwrapContext(env, js_this, context);
+// Returns wrapped context pointer and |N| params of type |T|. The arity is
+// known at compile time so argument values live on the stack.
+template <typename T, size_t N>
+static napi_status GetContextParams(napi_env env, napi_callback_info info,
+                                    WebGLRenderingContext **context,
+                                    T (&params)[N]) {
+  napi_value args[N];
+  napi_status nstatus = GetContextArgs(env, info, context, N, args);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  for (size_t i = 0; i < param_length; ++i) {
-    // Null-params get set to 0 in GL world.
-    napi_valuetype value_type;
-    nstatus = napi_typeof(env, args[i], &value_type);
+  for (size_t i = 0; i < N; ++i) {
+    nstatus = GetNapiArg(env, args[i], &params[i]);
     ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
-
-    if (value_type == napi_null) {
-      params[i] = 0;
-    } else if (value_type == napi_number) {
-      nstatus = napi_get_value_int32(env, args[i], &params[i]);
-      ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
-    } else {
-      ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[i], nstatus);
-    }
   }
-
   return napi_ok;
 }
 
-static napi_status GetContextDoubleParams(napi_env env, napi_callback_info info,
+// Returns wrapped context pointer and a single param of type |T|.
+template <typename T>
+static napi_status GetContextParam(napi_env env, napi_callback_info info,
+                                   WebGLRenderingContext **context, T *param) {
+  T params[1];
+  napi_status nstatus = GetContextParams(env, info, context, params);
+  *param = params[0];
+  return nstatus;
+}
+
+// Returns wrapped context pointer and a single object param of |type|.
+static napi_status GetContextObjectParam(napi_env env, napi_callback_info info,
+                                         WebGLRenderingContext **context,
+                                         GLObjectType type, GLuint *name) {
+  napi_value args[1];
+  napi_status nstatus = GetContextArgs(env, info, context, 1, args);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  return GetObjectArg(env, args[0], type, name);
+}
+
+// Returns wrapped context pointer, an object param of |type| and a numeric
+// param, e.g. for getProgramParameter(program, pname).
+static napi_status GetContextObjectParams(napi_env env, napi_callback_info info,
                                           WebGLRenderingContext **context,
-                                          size_t param_length, double *params) {
+                                          GLObjectType type,
+                                          GLuint (&params)[2]) {
+  napi_value args[2];
+  napi_status nstatus = GetContextArgs(env, info, context, 2, args);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  nstatus = GetObjectArg(env, args[0], type, &params[0]);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  return GetNapiArg(env, args[1], &params[1]);
+}
+
+// Converts values returned from GL entry points to JS values.
+static napi_value ToNapiValue(napi_env env, GLboolean value) {
+  napi_value result;
+  napi_status nstatus = napi_get_boolean(env, value, &result);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  return result;
+}
+
+static napi_value ToNapiValue(napi_env env, GLenum value) {
+  napi_value result;
+  napi_status nstatus = napi_create_uint32(env, value, &result);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  return result;
+}
+
+// Creates a typed array of |length| elements copied from |data|.
+template <typename T>
+static napi_status CreateTypedArray(napi_env env, napi_typedarray_type type,
+                                    size_t length, const T *data,
+                                    napi_value *result) {
   napi_status nstatus;
 
-  size_t argc = param_length;
-  std::vector<napi_value> args;
-  args.resize(param_length);
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args.data(), &js_this, nullptr);
+  void *array_data = nullptr;
+  napi_value array_buffer_value;
+  nstatus = napi_create_arraybuffer(env, length * sizeof(T), &array_data,
+                                    &array_buffer_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  if (length > 0) {
+    memcpy(array_data, data, length * sizeof(T));
+  }
 
-  ENSURE_ARGC_RETVAL(env, argc, param_length, napi_invalid_arg);
+  return napi_create_typedarray(env, type, length, array_buffer_value, 0,
+                                result);
+}
 
-  nstatus = UnwrapContext(env, js_this, context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+template <typename R>
+struct GLResult {
+  template <typename Fn, typename... Args>
+  static napi_value Call(napi_env env, Fn fn, Args... args) {
+    return ToNapiValue(env, fn(args...));
+  }
+};
 
-  for (size_t i = 0; i < param_length; ++i) {
-    // Null-params get set to 0 in GL world.
-    napi_valuetype value_type;
-    nstatus = napi_typeof(env, args[i], &value_type);
-    ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+template <>
+struct GLResult<void> {
+  template <typename Fn, typename... Args>
+  static napi_value Call(napi_env env, Fn fn, Args... args) {
+    fn(args...);
+    return nullptr;
+  }
+};
 
-    if (value_type == napi_null) {
-      params[i] = 0;
-    } else if (value_type == napi_number) {
-      nstatus = napi_get_value_double(env, args[i], &params[i]);
-      ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
-    } else {
-      ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[i], nstatus);
+template <size_t... I>
+struct IndexSequence {};
+
+template <size_t N, size_t... I>
+struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, I...> {};
+
+template <size_t... I>
+struct MakeIndexSequence<0, I...> {
+  typedef IndexSequence<I...> Type;
+};
+
+// Decodes the JS arguments of a native entry point taking |Args| directly
+// into a stack tuple and forwards them to a |Callee| constructed for the
+// wrapped context. The arity and argument types are known at compile time.
+template <typename Callee, typename R, typename... Args>
+struct NapiThunk {
+  static napi_value Invoke(napi_env env, napi_callback_info info) {
+    return Invoke(env, info,
+                  typename MakeIndexSequence<sizeof...(Args)>::Type());
+  }
+
+ private:
+  template <size_t... I>
+  static napi_value Invoke(napi_env env, napi_callback_info info,
+                           IndexSequence<I...>) {
+    WebGLRenderingContext *context = nullptr;
+    // One extra slot avoids a zero-length array for glFinish() and friends.
+    napi_value args[sizeof...(Args) + 1];
+    napi_status nstatus =
+        GetContextArgs(env, info, &context, sizeof...(Args), args);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+    std::tuple<typename std::decay<Args>::type...> params;
+    napi_status statuses[] = {
+        napi_ok, GetNapiArg(env, args[I], &std::get<I>(params))...};
+    for (napi_status status : statuses) {
+      if (status != napi_ok) {
+        return nullptr;
+      }
     }
+
+    napi_value result =
+        GLResult<R>::Call(env, Callee(context), std::get<I>(params)...);
+
+#if DEBUG
+    context->CheckForErrors();
+#endif
+    return result;
   }
+};
 
-  return napi_ok;
+// N-API callback generated at compile time for a GL entry point on
+// EGLContextWrapper. Argument types and count are taken from the entry point
+// signature, e.g.
+// GLCall<decltype(EGLContextWrapper::glUniform2f),
+//        &EGLContextWrapper::glUniform2f> decodes (GLint, GLfloat, GLfloat).
+// Use the GL_THUNK() macro to register these.
+template <typename R, typename... Args,
+          R(GL_APIENTRY *EGLContextWrapper::*Fn)(Args...)>
+struct GLCall<R(GL_APIENTRY *)(Args...), Fn>
+    : NapiThunk<GLCall<R(GL_APIENTRY *)(Args...), Fn>, R, Args...> {
+  explicit GLCall(WebGLRenderingContext *context)
+      : fn_(context->eglContextWrapper_->*Fn) {}
+
+  R operator()(Args... args) const { return fn_(args...); }
+
+ private:
+  R(GL_APIENTRY *fn_)(Args...);
+};
+
+#define GL_THUNK(fn) \
+  GLCall<decltype(EGLContextWrapper::fn), &EGLContextWrapper::fn>::Invoke
+
+// Same as GLCall but for entry points that go through one of the caches of
+// the context (GLStateCache or GLProgramCache).
+template <typename R, typename C, typename... Args, R (C::*Fn)(Args...)>
+struct CacheCall<R (C::*)(Args...), Fn>
+    : NapiThunk<CacheCall<R (C::*)(Args...), Fn>, R, Args...> {
+  explicit CacheCall(WebGLRenderingContext *context)
+      : cache_(context->GetCache<C>()) {}
+
+  R operator()(Args... args) const { return (cache_->*Fn)(args...); }
+
+ private:
+  C *cache_;
+};
+
+template <>
+GLStateCache *WebGLRenderingContext::GetCache<GLStateCache>() {
+  return state_cache_;
+}
+
+template <>
+GLProgramCache *WebGLRenderingContext::GetCache<GLProgramCache>() {
+  return program_cache_;
+}
+
+template <>
+GLMemoryTracker *WebGLRenderingContext::GetCache<GLMemoryTracker>() {
+  return memory_tracker_;
 }
 
+#define STATE_CACHE_THUNK(fn) \
+  CacheCall<decltype(&GLStateCache::fn), &GLStateCache::fn>::Invoke
+
+#define PROGRAM_CACHE_THUNK(fn) \
+  CacheCall<decltype(&GLProgramCache::fn), &GLProgramCache::fn>::Invoke
+
+// Same as PROGRAM_CACHE_THUNK but for the uniform setters, whose first
+// argument is decoded as a UniformLocationArg.
+template <typename T, T Fn>
+struct UniformCall;
+
+template <typename... Args, void (GLProgramCache::*Fn)(GLint, Args...)>
+struct UniformCall<void (GLProgramCache::*)(GLint, Args...), Fn>
+    : NapiThunk<UniformCall<void (GLProgramCache::*)(GLint, Args...), Fn>,
+                void, UniformLocationArg, Args...> {
+  explicit UniformCall(WebGLRenderingContext *context) : call_(context) {}
+
+  void operator()(UniformLocationArg location, Args... args) const {
+    call_(location.value, args...);
+  }
+
+ private:
+  CacheCall<void (GLProgramCache::*)(GLint, Args...), Fn> call_;
+};
+
+#define UNIFORM_THUNK(fn) \
+  UniformCall<decltype(&GLProgramCache::fn), &GLProgramCache::fn>::Invoke
+
+#define MEMORY_TRACKER_THUNK(fn) \
+  CacheCall<decltype(&GLMemoryTracker::fn), &GLMemoryTracker::fn>::Invoke
+
+// Same as |Call| (a GLCall or CacheCall) but decodes the arguments as
+// |Decoded|, e.g. TextureArg for the texture of bindTexture(), so that
+// wrappers of another object type are rejected.
+template <typename Call, typename R, typename... Decoded>
+struct TypedCall : NapiThunk<TypedCall<Call, R, Decoded...>, R, Decoded...> {
+  explicit TypedCall(WebGLRenderingContext *context) : call_(context) {}
+
+  R operator()(Decoded... args) const { return call_(args...); }
+
+ private:
+  Call call_;
+};
+
+#define GL_OBJECT_THUNK(fn, ...)                                              \
+  TypedCall<GLCall<decltype(EGLContextWrapper::fn), &EGLContextWrapper::fn>, \
+            __VA_ARGS__>::Invoke
+
+#define STATE_CACHE_OBJECT_THUNK(fn, ...)                                  \
+  TypedCall<CacheCall<decltype(&GLStateCache::fn), &GLStateCache::fn>, \
+            __VA_ARGS__>::Invoke
+
 static napi_status GetStringParam(napi_env env, napi_value string_value,
                                   std::string &string) {
   ENSURE_VALUE_IS_STRING_RETVAL(env, string_value, napi_invalid_arg);
@@ -308,104 +790,550 @@ static napi_status GetStringParam(napi_env env, napi_value string_value,
   return napi_ok;
 }
 
-// Returns a pointer to JS array-like objects. This method should be used when
-// accessing underlying datastores for all JS-Array-like objects.
-static napi_status GetArrayLikeBuffer(napi_env env, napi_value array_like_value,
-                                      ArrayLikeBuffer *alb) {
-  ENSURE_VALUE_IS_ARRAY_LIKE_RETVAL(env, array_like_value, napi_invalid_arg);
+// Like GetStringParam() but reads strings that fit into a stack buffer with
+// a single N-API call. Used for short names such as uniform names.
+static napi_status GetShortStringParam(napi_env env, napi_value string_value,
+                                       std::string &string) {
+  ENSURE_VALUE_IS_STRING_RETVAL(env, string_value, napi_invalid_arg);
 
-  bool is_typed_array = false;
-  napi_status nstatus =
-      napi_is_typedarray(env, array_like_value, &is_typed_array);
+  char buffer[NAPI_STRING_SIZE];
+  size_t str_length;
+  napi_status nstatus = napi_get_value_string_utf8(
+      env, string_value, buffer, sizeof(buffer), &str_length);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
-  if (is_typed_array) {
-    napi_value arraybuffer_value;
-    nstatus = napi_get_typedarray_info(env, array_like_value, nullptr, nullptr,
-                                       &alb->data, &arraybuffer_value, nullptr);
-    ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
-
-    nstatus = napi_get_arraybuffer_info(env, arraybuffer_value, nullptr,
-                                        &alb->length);
-    ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-    return napi_ok;
+  if (str_length + 1 >= sizeof(buffer)) {
+    // Possibly truncated.
+    return GetStringParam(env, string_value, string);
   }
 
-  bool is_array = false;
-  nstatus = napi_is_array(env, array_like_value, &is_array);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
-  if (is_array) {
-    uint32_t length;
-    nstatus = napi_get_array_length(env, array_like_value, &length);
-    ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
-    alb->length = length;
-
-    // Allocate a buffer based on the value set in ArrayLikeBuffer.
-    switch (alb->array_type) {
-      case kFloat32:
-        alb->data = malloc(sizeof(float) * length);
-        break;
-      case kInt32:
-        alb->data = malloc(sizeof(int32_t) * length);
-        break;
-      default:
-        NAPI_THROW_ERROR(env, "Unsupported array type for generic arrays!");
-        return napi_invalid_arg;
-    }
+  string.assign(buffer, str_length);
+  return napi_ok;
+}
 
-    // Notify ArrayLikeBuffer to cleanup buffer on deconstruction:
-    alb->should_delete = true;
+// Creates a WebGLActiveInfo-like object.
+static napi_value CreateActiveInfo(napi_env env, const char *name,
+                                   size_t name_length, GLint size,
+                                   GLenum type) {
+  napi_status nstatus;
 
-    // Place values in buffer:
-    for (uint32_t i = 0; i < length; i++) {
-      napi_value cur_value;
-      nstatus = napi_get_element(env, array_like_value, i, &cur_value);
-      ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  napi_value name_value;
+  nstatus = napi_create_string_utf8(env, name, name_length, &name_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-      switch (alb->array_type) {
-        case kFloat32: {
-          double value;
-          nstatus = napi_get_value_double(env, cur_value, &value);
-          ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  napi_value size_value;
+  nstatus = napi_create_int32(env, size, &size_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-          static_cast<float *>(alb->data)[i] = static_cast<float>(value);
-          break;
-        }
-        case kInt32: {
-          int32_t value;
-          nstatus = napi_get_value_int32(env, cur_value, &value);
-          ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  napi_value type_value;
+  nstatus = napi_create_uint32(env, type, &type_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-          static_cast<int32_t *>(alb->data)[i] = value;
-          break;
-        }
-        default:
-          NAPI_THROW_ERROR(env, "Unsupported array type for generic arrays!");
-          return napi_invalid_arg;
-      }
-    }
+  napi_value active_info_value;
+  nstatus = napi_create_object(env, &active_info_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-    return napi_ok;
-  }
+  nstatus = napi_set_named_property(env, active_info_value, "name", name_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  NAPI_THROW_ERROR(env, "Invalid data type.");
-  return napi_invalid_arg;
-}
+  nstatus = napi_set_named_property(env, active_info_value, "size", size_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-napi_ref WebGLRenderingContext::constructor_ref_;
+  nstatus = napi_set_named_property(env, active_info_value, "type", type_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  return active_info_value;
+}
+
+// Reads a timeout in nanoseconds from a Number or a BigInt and throws for NaN.
+// If |clamp| is set (clientWaitSync()), negative values throw and values above
+// GLContextLimits::kMaxClientWaitTimeout are clamped to it. Otherwise values
+// that don't fit into a GLuint64 (e.g. -1) wait forever (GL_TIMEOUT_IGNORED).
+static napi_status GetTimeoutArg(napi_env env, napi_value value, bool clamp,
+                                 GLuint64 *timeout) {
+  napi_valuetype value_type;
+  napi_status nstatus = napi_typeof(env, value, &value_type);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+
+  bool negative;
+  bool too_large;
+  if (value_type == napi_bigint) {
+    // Only the lowest word is read, |word_count| tells whether it's the only
+    // one.
+    int sign_bit;
+    size_t word_count = 1;
+    uint64_t word = 0;
+    nstatus =
+        napi_get_value_bigint_words(env, value, &sign_bit, &word_count, &word);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+    negative = sign_bit != 0;
+    too_large = word_count > 1;
+    *timeout = word;
+  } else {
+    ENSURE_VALUE_IS_NUMBER_RETVAL(env, value, napi_number_expected);
+    double double_value;
+    nstatus = napi_get_value_double(env, value, &double_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+    if (std::isnan(double_value)) {
+      NAPI_THROW_ERROR(env, "Timeout is NaN");
+      return napi_invalid_arg;
+    }
+    negative = double_value < 0;
+    too_large = double_value >= 18446744073709551616.0;
+    if (!negative && !too_large) {
+      *timeout = static_cast<GLuint64>(double_value);
+    }
+  }
+
+  if (!clamp) {
+    if (negative || too_large) {
+      *timeout = GL_TIMEOUT_IGNORED;
+    }
+    return napi_ok;
+  }
+
+  if (negative) {
+    NAPI_THROW_ERROR(env, "Timeout must not be negative");
+    return napi_invalid_arg;
+  }
+  if (too_large || *timeout > GLContextLimits::kMaxClientWaitTimeout) {
+    *timeout = GLContextLimits::kMaxClientWaitTimeout;
+  }
+  return napi_ok;
+}
+
+// Returns the size in bytes of one element of a TypedArray of |type|.
+static size_t TypedArrayElementSize(napi_typedarray_type type) {
+  switch (type) {
+    case napi_int8_array:
+    case napi_uint8_array:
+    case napi_uint8_clamped_array:
+      return 1;
+    case napi_int16_array:
+    case napi_uint16_array:
+      return 2;
+    case napi_float64_array:
+    case napi_bigint64_array:
+    case napi_biguint64_array:
+      return 8;
+    default:
+      return 4;
+  }
+}
+
+// Returns the number of bytes per pixel of |format| and |type| or 0 if the
+// combination is unknown.
+static size_t BytesPerPixel(GLenum format, GLenum type) {
+  size_t components;
+  switch (format) {
+    case GL_RED:
+    case GL_RED_INTEGER:
+    case GL_ALPHA:
+    case GL_LUMINANCE:
+    case GL_DEPTH_COMPONENT:
+      components = 1;
+      break;
+    case GL_RG:
+    case GL_RG_INTEGER:
+    case GL_LUMINANCE_ALPHA:
+    case GL_DEPTH_STENCIL:
+      components = 2;
+      break;
+    case GL_RGB:
+    case GL_RGB_INTEGER:
+      components = 3;
+      break;
+    case GL_RGBA:
+    case GL_RGBA_INTEGER:
+      components = 4;
+      break;
+    default:
+      return 0;
+  }
+
+  switch (type) {
+    case GL_UNSIGNED_BYTE:
+    case GL_BYTE:
+      return components;
+    case GL_UNSIGNED_SHORT:
+    case GL_SHORT:
+    case GL_HALF_FLOAT:
+    case GL_HALF_FLOAT_OES:
+      return components * 2;
+    case GL_UNSIGNED_INT:
+    case GL_INT:
+    case GL_FLOAT:
+      return components * 4;
+    case GL_UNSIGNED_SHORT_5_6_5:
+    case GL_UNSIGNED_SHORT_4_4_4_4:
+    case GL_UNSIGNED_SHORT_5_5_5_1:
+      return 2;
+    case GL_UNSIGNED_INT_2_10_10_10_REV:
+    case GL_UNSIGNED_INT_10F_11F_11F_REV:
+    case GL_UNSIGNED_INT_5_9_9_9_REV:
+    case GL_UNSIGNED_INT_24_8:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+// Returns the number of bytes glReadPixels() writes for a |width| x |height|
+// rectangle with the current PACK_* pixel store state, or 0 if unknown.
+static size_t ReadPixelsByteLength(GLStateCache *state_cache, GLsizei width,
+                                   GLsizei height, GLenum format,
+                                   GLenum type) {
+  size_t bytes_per_pixel = BytesPerPixel(format, type);
+  if (bytes_per_pixel == 0 || width <= 0 || height <= 0) {
+    return 0;
+  }
+
+  size_t alignment = state_cache->pixel_store(GL_PACK_ALIGNMENT);
+  size_t row_length = state_cache->pixel_store(GL_PACK_ROW_LENGTH);
+  size_t skip_pixels = state_cache->pixel_store(GL_PACK_SKIP_PIXELS);
+  size_t skip_rows = state_cache->pixel_store(GL_PACK_SKIP_ROWS);
+
+  size_t row_pixels = row_length > 0 ? row_length : width;
+  size_t row_bytes = row_pixels * bytes_per_pixel;
+  if (alignment > 1) {
+    row_bytes = (row_bytes + alignment - 1) / alignment * alignment;
+  }
+
+  // The last row is not padded.
+  return (skip_rows + height - 1) * row_bytes +
+         (skip_pixels + width) * bytes_per_pixel;
+}
+
+// Returns the 32-bit words of a command stream passed to executeCommands(),
+// which can be an ArrayBuffer or a 32-bit typed array.
+static napi_status GetCommandBufferArg(napi_env env, napi_value value,
+                                       const uint32_t **words,
+                                       size_t *word_count) {
+  napi_status nstatus;
+
+  void *data = nullptr;
+  size_t byte_length = 0;
+  bool is_arraybuffer = false;
+  nstatus = napi_is_arraybuffer(env, value, &is_arraybuffer);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  if (is_arraybuffer) {
+    nstatus = napi_get_arraybuffer_info(env, value, &data, &byte_length);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  } else {
+    bool is_typed_array = false;
+    nstatus = napi_is_typedarray(env, value, &is_typed_array);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+    if (is_typed_array) {
+      napi_typedarray_type array_type;
+      size_t length;
+      nstatus = napi_get_typedarray_info(env, value, &array_type, &length,
+                                         &data, nullptr, nullptr);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+      if (array_type != napi_uint32_array && array_type != napi_int32_array &&
+          array_type != napi_float32_array) {
+        NAPI_THROW_ERROR(env, "Command buffer must be a 32-bit typed array");
+        return napi_invalid_arg;
+      }
+      byte_length = length * sizeof(uint32_t);
+    } else {
+      NAPI_THROW_ERROR(env, "Command buffer must be an ArrayBuffer");
+      return napi_invalid_arg;
+    }
+  }
+
+  if (reinterpret_cast<uintptr_t>(data) % sizeof(uint32_t) != 0) {
+    NAPI_THROW_ERROR(env, "Command buffer must be 4-byte aligned");
+    return napi_invalid_arg;
+  }
+
+  *words = static_cast<const uint32_t *>(data);
+  *word_count = byte_length / sizeof(uint32_t);
+  return napi_ok;
+}
+
+// Rejects |deferred| with an Error carrying |message|.
+static void RejectWithError(napi_env env, napi_deferred deferred,
+                            const char *message) {
+  napi_value message_value;
+  napi_status nstatus =
+      napi_create_string_utf8(env, message, NAPI_AUTO_LENGTH, &message_value);
+  ENSURE_NAPI_OK(env, nstatus);
+
+  napi_value error_value;
+  nstatus = napi_create_error(env, nullptr, message_value, &error_value);
+  ENSURE_NAPI_OK(env, nstatus);
+
+  nstatus = napi_reject_deferred(env, deferred, error_value);
+  ENSURE_NAPI_OK(env, nstatus);
+}
+
+// Returns a pointer to JS array-like objects. This method should be used when
+// accessing underlying datastores for all JS-Array-like objects. Plain JS
+// Arrays are converted into |alb| or memory from |arena|.
+static napi_status GetArrayLikeBuffer(napi_env env, napi_value array_like_value,
+                                      ScratchArena *arena,
+                                      ArrayLikeBuffer *alb) {
+  ENSURE_VALUE_IS_ARRAY_LIKE_RETVAL(env, array_like_value, napi_invalid_arg);
+
+  // Views only cover [byteOffset, byteOffset + byteLength) of their buffer.
+  bool is_typed_array = false;
+  napi_status nstatus =
+      napi_is_typedarray(env, array_like_value, &is_typed_array);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  if (is_typed_array) {
+    napi_typedarray_type array_type;
+    size_t length;
+    nstatus = napi_get_typedarray_info(env, array_like_value, &array_type,
+                                       &length, &alb->data, nullptr, nullptr);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+
+    alb->element_size = TypedArrayElementSize(array_type);
+    alb->length = length * alb->element_size;
+    return napi_ok;
+  }
+
+  bool is_dataview = false;
+  nstatus = napi_is_dataview(env, array_like_value, &is_dataview);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  if (is_dataview) {
+    nstatus = napi_get_dataview_info(env, array_like_value, &alb->length,
+                                     &alb->data, nullptr, nullptr);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+
+    alb->element_size = 1;
+    return napi_ok;
+  }
+
+  bool is_array = false;
+  nstatus = napi_is_array(env, array_like_value, &is_array);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  if (is_array) {
+    if (alb->array_type != kFloat32 && alb->array_type != kInt32) {
+      NAPI_THROW_ERROR(env, "Unsupported array type for generic arrays!");
+      return napi_invalid_arg;
+    }
+
+    uint32_t length;
+    nstatus = napi_get_array_length(env, array_like_value, &length);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+    // float and int32_t are both 4 bytes.
+    alb->element_size = sizeof(float);
+    alb->length = length * alb->element_size;
+
+    // Small arrays (uniforms, vertexAttrib*fv()) are converted inline, larger
+    // ones into the scratch arena. Neither touches the heap once the arena
+    // has grown to the working set.
+    if (length <= kInlineArrayElements) {
+      alb->data = &alb->inline_data;
+      arena->CountInlineAllocation();
+    } else {
+      ScratchArena::Mark mark = arena->GetMark();
+      alb->data = arena->Allocate(alb->length);
+      if (alb->data == nullptr) {
+        NAPI_THROW_ERROR(env, "Out of memory converting Array.");
+        return napi_generic_failure;
+      }
+      alb->arena = arena;
+      alb->arena_mark = mark;
+    }
+
+    // Place values in buffer:
+    for (uint32_t i = 0; i < length; i++) {
+      napi_value cur_value;
+      nstatus = napi_get_element(env, array_like_value, i, &cur_value);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+
+      if (alb->array_type == kFloat32) {
+        double value;
+        nstatus = napi_get_value_double(env, cur_value, &value);
+        ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+
+        static_cast<float *>(alb->data)[i] = static_cast<float>(value);
+      } else {
+        int32_t value;
+        nstatus = napi_get_value_int32(env, cur_value, &value);
+        ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+
+        static_cast<int32_t *>(alb->data)[i] = value;
+      }
+    }
+
+    return napi_ok;
+  }
+
+  NAPI_THROW_ERROR(env, "Invalid data type.");
+  return napi_invalid_arg;
+}
+
+// Narrows |alb| to |length| elements starting at element |src_offset|, for the
+// WebGL2 srcOffset/length overloads. A |length| of 0 covers the rest of the
+// view. Throws if the range is not inside the view.
+static napi_status ApplySourceRange(napi_env env, ArrayLikeBuffer *alb,
+                                    uint32_t src_offset, uint32_t length) {
+  size_t elements = alb->length / alb->element_size;
+  if (src_offset > elements ||
+      (length > 0 && length > elements - src_offset)) {
+    NAPI_THROW_ERROR(env, "srcOffset/length is out of the bounds of the view");
+    return napi_invalid_arg;
+  }
+
+  alb->data =
+      static_cast<uint8_t *>(alb->data) + src_offset * alb->element_size;
+  alb->length = (length > 0 ? length : elements - src_offset) *
+                alb->element_size;
+  return napi_ok;
+}
 
-WebGLRenderingContext::WebGLRenderingContext(napi_env env,
-                                             GLContextOptions opts)
-    : env_(env), ref_(nullptr) {
+// Reads the optional trailing argument |index|. |value| is left unchanged if
+// the argument was not passed or is undefined.
+static napi_status GetOptionalArg(napi_env env, size_t argc, napi_value *args,
+                                  size_t index, uint32_t *value) {
+  if (index >= argc) {
+    return napi_ok;
+  }
+
+  napi_valuetype value_type;
+  napi_status nstatus = napi_typeof(env, args[index], &value_type);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  if (value_type == napi_undefined) {
+    return napi_ok;
+  }
+
+  return GetNapiArg(env, args[index], value);
+}
+
+// Reads the numeric property |name| of |object|. |value| is left unchanged if
+// the property is missing or undefined, which throws if |required| is set.
+static napi_status GetNumberProperty(napi_env env, napi_value object,
+                                     const char *name, bool required,
+                                     uint32_t *value) {
+  napi_value property_value;
+  napi_status nstatus = napi_get_named_property(env, object, name,
+                                                &property_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+
+  napi_valuetype value_type;
+  nstatus = napi_typeof(env, property_value, &value_type);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  if (value_type == napi_undefined) {
+    if (required) {
+      std::string message = std::string("Missing property: ") + name;
+      NAPI_THROW_ERROR(env, message.c_str());
+      return napi_invalid_arg;
+    }
+    return napi_ok;
+  }
+
+  return GetNapiArg(env, property_value, value);
+}
+
+char WebGLRenderingContext::constructor_key_;
+
+WebGLRenderingContext::WebGLRenderingContext(
+    napi_env env, GLContextOptions opts, WebGLRenderingContext *share_with)
+    : env_(env),
+      ref_(nullptr),
+      state_cache_(nullptr),
+      program_cache_(nullptr),
+      program_binary_cache_(nullptr),
+      fence_poller_(nullptr),
+      command_thread_(nullptr),
+      sync_pool_(nullptr),
+      scratch_arena_(nullptr),
+      memory_tracker_(nullptr),
+      texture_pool_(nullptr),
+      buffer_mappings_(nullptr),
+      stream_buffers_(),
+      wrap_objects_(opts.wrap_objects) {
   eglContextWrapper_ = EGLContextWrapper::Create(env, opts);
   if (!eglContextWrapper_) {
     NAPI_THROW_ERROR(env, "Could not create EGL context");
     return;
   }
-  alloc_count_ = 0;
+  state_cache_ = new GLStateCache(eglContextWrapper_);
+  state_cache_->Init();
+  program_cache_ = new GLProgramCache(eglContextWrapper_, state_cache_);
+  share_group_ = share_with ? share_with->share_group_
+                            : std::make_shared<GLShareGroup>();
+  if (!opts.program_binary_cache_dir.empty()) {
+    program_binary_cache_ =
+        new GLProgramBinaryCache(env, eglContextWrapper_, program_cache_,
+                                 opts.program_binary_cache_dir);
+  }
+  sync_pool_ = new GLSyncPool(eglContextWrapper_);
+  if (opts.command_thread) {
+    command_thread_ = new GLCommandThread(env, eglContextWrapper_,
+                                          state_cache_, program_cache_);
+  }
+  scratch_arena_ = new ScratchArena();
+  memory_tracker_ =
+      new GLMemoryTracker(env, eglContextWrapper_, state_cache_);
+  texture_pool_ =
+      new GLTexturePool(eglContextWrapper_, state_cache_, memory_tracker_);
+  buffer_mappings_ =
+      new GLBufferMappings(env, eglContextWrapper_, state_cache_);
+  object_registry_ = std::make_shared<GLObjectRegistry>(
+      eglContextWrapper_, state_cache_, program_cache_, memory_tracker_,
+      texture_pool_, buffer_mappings_, sync_pool_, command_thread_);
+  share_group_->AddContext(object_registry_.get());
+  limits_.Init(eglContextWrapper_, opts.client_major_es_version >= 3);
+
+  if (opts.max_shader_compiler_threads >= 0 &&
+      KHRParallelShaderCompileExtension::Enable(eglContextWrapper_)) {
+    eglContextWrapper_->glMaxShaderCompilerThreadsKHR(
+        static_cast<GLuint>(opts.max_shader_compiler_threads));
+  }
 }
 
 WebGLRenderingContext::~WebGLRenderingContext() {
+  // May run in the middle of another context's calls.
+  ScopedMakeCurrent scoped_current(eglContextWrapper_);
+
+  // Wrappers may outlive the context. Their objects go away with it.
+  if (object_registry_) {
+    object_registry_->Detach();
+  }
+  // Runs the remaining queued work and joins the thread first, so the context
+  // is current on this thread for the cleanup below.
+  if (command_thread_) {
+    delete command_thread_;
+  }
+  if (fence_poller_) {
+    delete fence_poller_;
+  }
+  if (sync_pool_) {
+    delete sync_pool_;
+  }
+  if (scratch_arena_) {
+    delete scratch_arena_;
+  }
+  if (texture_pool_) {
+    delete texture_pool_;
+  }
+  for (GLStreamBuffer *stream_buffer : stream_buffers_) {
+    if (stream_buffer) {
+      delete stream_buffer;
+    }
+  }
+  if (buffer_mappings_) {
+    delete buffer_mappings_;
+  }
+  if (memory_tracker_) {
+    delete memory_tracker_;
+  }
+  // Shared objects stay alive as long as another context of the group does.
+  if (share_group_ && object_registry_) {
+    share_group_->RemoveContext(eglContextWrapper_, object_registry_.get());
+  }
+  if (program_binary_cache_) {
+    delete program_binary_cache_;
+  }
+  if (program_cache_) {
+    delete program_cache_;
+  }
+  if (state_cache_) {
+    delete state_cache_;
+  }
   if (eglContextWrapper_) {
     delete eglContextWrapper_;
   }
@@ -420,67 +1348,74 @@ napi_status WebGLRenderingContext::Register(napi_env env, napi_value exports) {
   napi_property_descriptor properties[] = {
       // WebGL methods:
       // clang-format off
-      NAPI_DEFINE_METHOD("attachShader", AttachShader),
+      NAPI_DEFINE_METHOD("acquireTexture", AcquireTexture),
+      NAPI_DEFINE_METHOD("attachShader", GL_OBJECT_THUNK(glAttachShader, void, ProgramArg, ShaderArg)),
       NAPI_DEFINE_METHOD("bindAttribLocation", BindAttribLocation),
-      NAPI_DEFINE_METHOD("bindBuffer", BindBuffer),
-      NAPI_DEFINE_METHOD("bindFramebuffer", BindFramebuffer),
-      NAPI_DEFINE_METHOD("bindRenderbuffer", BindRenderbuffer),
-      NAPI_DEFINE_METHOD("bindTexture", BindTexture),
-      NAPI_DEFINE_METHOD("blendColor", BlendColor),
-      NAPI_DEFINE_METHOD("blendEquation", BlendEquation),
-      NAPI_DEFINE_METHOD("blendEquationSeparate", BlendEquationSeparate),
-      NAPI_DEFINE_METHOD("blendFunc", BlendFunc),
-      NAPI_DEFINE_METHOD("blendFuncSeparate", BlendFuncSeparate),
+      NAPI_DEFINE_METHOD("bindBuffer", STATE_CACHE_OBJECT_THUNK(BindBuffer, void, GLenum, BufferArg)),
+      NAPI_DEFINE_METHOD("bindFramebuffer", STATE_CACHE_OBJECT_THUNK(BindFramebuffer, void, GLenum, FramebufferArg)),
+      NAPI_DEFINE_METHOD("bindRenderbuffer", STATE_CACHE_OBJECT_THUNK(BindRenderbuffer, void, GLenum, RenderbufferArg)),
+      NAPI_DEFINE_METHOD("bindTexture", STATE_CACHE_OBJECT_THUNK(BindTexture, void, GLenum, TextureArg)),
+      NAPI_DEFINE_METHOD("blendColor", STATE_CACHE_THUNK(BlendColor)),
+      NAPI_DEFINE_METHOD("blendEquation", STATE_CACHE_THUNK(BlendEquation)),
+      NAPI_DEFINE_METHOD("blendEquationSeparate", STATE_CACHE_THUNK(BlendEquationSeparate)),
+      NAPI_DEFINE_METHOD("blendFunc", STATE_CACHE_THUNK(BlendFunc)),
+      NAPI_DEFINE_METHOD("blendFuncSeparate", STATE_CACHE_THUNK(BlendFuncSeparate)),
       NAPI_DEFINE_METHOD("bufferData", BufferData),
       NAPI_DEFINE_METHOD("bufferSubData", BufferSubData),
-      NAPI_DEFINE_METHOD("checkFramebufferStatus", CheckFramebufferStatus),
-      NAPI_DEFINE_METHOD("clear", Clear),
-      NAPI_DEFINE_METHOD("clearColor", ClearColor),
-      NAPI_DEFINE_METHOD("clearDepth", ClearDepth),
-      NAPI_DEFINE_METHOD("clearStencil", ClearStencil),
+      NAPI_DEFINE_METHOD("checkFramebufferStatus", GL_THUNK(glCheckFramebufferStatus)),
+      NAPI_DEFINE_METHOD("clear", GL_THUNK(glClear)),
+      NAPI_DEFINE_METHOD("clearColor", STATE_CACHE_THUNK(ClearColor)),
+      NAPI_DEFINE_METHOD("clearDepth", STATE_CACHE_THUNK(ClearDepth)),
+      NAPI_DEFINE_METHOD("clearStencil", STATE_CACHE_THUNK(ClearStencil)),
       NAPI_DEFINE_METHOD("clientWaitSync", ClientWaitSync),
-      NAPI_DEFINE_METHOD("colorMask", ColorMask),
-      NAPI_DEFINE_METHOD("compileShader", CompileShader),
+      NAPI_DEFINE_METHOD("colorMask", STATE_CACHE_THUNK(ColorMask)),
+      NAPI_DEFINE_METHOD("compileShader", GL_OBJECT_THUNK(glCompileShader, void, ShaderArg)),
       NAPI_DEFINE_METHOD("compressedTexImage2D", CompressedTexImage2D),
       NAPI_DEFINE_METHOD("compressedTexSubImage2D", CompressedTexSubImage2D),
-      NAPI_DEFINE_METHOD("copyTexImage2D", CopyTexImage2D),
-      NAPI_DEFINE_METHOD("copyTexSubImage2D", CopyTexSubImage2D),
+      NAPI_DEFINE_METHOD("copyTexImage2D", MEMORY_TRACKER_THUNK(CopyTexImage2D)),
+      NAPI_DEFINE_METHOD("copyTexSubImage2D", GL_THUNK(glCopyTexSubImage2D)),
       NAPI_DEFINE_METHOD("createBuffer", CreateBuffer),
       NAPI_DEFINE_METHOD("createFramebuffer", CreateFramebuffer),
       NAPI_DEFINE_METHOD("createProgram", CreateProgram),
       NAPI_DEFINE_METHOD("createRenderbuffer", CreateRenderbuffer),
       NAPI_DEFINE_METHOD("createShader", CreateShader),
       NAPI_DEFINE_METHOD("createTexture", CreateTexture),
-      NAPI_DEFINE_METHOD("cullFace", CullFace),
+      NAPI_DEFINE_METHOD("createUniformLayout", CreateUniformLayout),
+      NAPI_DEFINE_METHOD("cullFace", STATE_CACHE_THUNK(CullFace)),
       NAPI_DEFINE_METHOD("deleteBuffer", DeleteBuffer),
       NAPI_DEFINE_METHOD("deleteFramebuffer", DeleteFramebuffer),
       NAPI_DEFINE_METHOD("deleteProgram", DeleteProgram),
       NAPI_DEFINE_METHOD("deleteRenderbuffer", DeleteRenderbuffer),
       NAPI_DEFINE_METHOD("deleteShader", DeleteShader),
+      NAPI_DEFINE_METHOD("deleteSync", DeleteSync),
       NAPI_DEFINE_METHOD("deleteTexture", DeleteTexture),
-      NAPI_DEFINE_METHOD("depthFunc", DepthFunc),
-      NAPI_DEFINE_METHOD("depthMask", DepthMask),
-      NAPI_DEFINE_METHOD("depthRange", DepthRange),
-      NAPI_DEFINE_METHOD("detachShader", DetachShader),
-      NAPI_DEFINE_METHOD("disable", Disable),
-      NAPI_DEFINE_METHOD("disableVertexAttribArray", DisableVertexAttribArray),
-      NAPI_DEFINE_METHOD("drawArrays", DrawArrays),
-      NAPI_DEFINE_METHOD("drawElements", DrawElements),
-      NAPI_DEFINE_METHOD("enable", Enable),
-      NAPI_DEFINE_METHOD("enableVertexAttribArray", EnableVertexAttribArray),
+      NAPI_DEFINE_METHOD("depthFunc", STATE_CACHE_THUNK(DepthFunc)),
+      NAPI_DEFINE_METHOD("depthMask", STATE_CACHE_THUNK(DepthMask)),
+      NAPI_DEFINE_METHOD("depthRange", STATE_CACHE_THUNK(DepthRange)),
+      NAPI_DEFINE_METHOD("detachShader", GL_OBJECT_THUNK(glDetachShader, void, ProgramArg, ShaderArg)),
+      NAPI_DEFINE_METHOD("disable", STATE_CACHE_THUNK(Disable)),
+      NAPI_DEFINE_METHOD("disableVertexAttribArray", GL_THUNK(glDisableVertexAttribArray)),
+      NAPI_DEFINE_METHOD("drawArrays", GL_THUNK(glDrawArrays)),
+      NAPI_DEFINE_METHOD("drawElements", GL_THUNK(glDrawElements)),
+      NAPI_DEFINE_METHOD("enable", STATE_CACHE_THUNK(Enable)),
+      NAPI_DEFINE_METHOD("enableVertexAttribArray", GL_THUNK(glEnableVertexAttribArray)),
+      NAPI_DEFINE_METHOD("executeCommands", ExecuteCommands),
+      NAPI_DEFINE_METHOD("executeCommandsAsync", ExecuteCommandsAsync),
       NAPI_DEFINE_METHOD("fenceSync", FenceSynce),
-      NAPI_DEFINE_METHOD("finish", Finish),
-      NAPI_DEFINE_METHOD("flush", Flush),
-      NAPI_DEFINE_METHOD("framebufferRenderbuffer", FramebufferRenderbuffer),
-      NAPI_DEFINE_METHOD("framebufferTexture2D", FramebufferTexture2D),
-      NAPI_DEFINE_METHOD("frontFace", FrontFace),
-      NAPI_DEFINE_METHOD("generateMipmap", GenerateMipmap),
+      NAPI_DEFINE_METHOD("finish", GL_THUNK(glFinish)),
+      NAPI_DEFINE_METHOD("finishAsync", FinishAsync),
+      NAPI_DEFINE_METHOD("flush", GL_THUNK(glFlush)),
+      NAPI_DEFINE_METHOD("framebufferRenderbuffer", GL_OBJECT_THUNK(glFramebufferRenderbuffer, void, GLenum, GLenum, GLenum, RenderbufferArg)),
+      NAPI_DEFINE_METHOD("framebufferTexture2D", GL_OBJECT_THUNK(glFramebufferTexture2D, void, GLenum, GLenum, GLenum, TextureArg, GLint)),
+      NAPI_DEFINE_METHOD("frontFace", STATE_CACHE_THUNK(FrontFace)),
+      NAPI_DEFINE_METHOD("generateMipmap", MEMORY_TRACKER_THUNK(GenerateMipmap)),
       NAPI_DEFINE_METHOD("getActiveAttrib", GetActiveAttrib),
       NAPI_DEFINE_METHOD("getActiveUniform", GetActiveUniform),
       NAPI_DEFINE_METHOD("getAttachedShaders", GetAttachedShaders),
       NAPI_DEFINE_METHOD("getAttribLocation", GetAttribLocation),
       NAPI_DEFINE_METHOD("getBufferParameter", GetBufferParameter),
       NAPI_DEFINE_METHOD("getBufferSubData", GetBufferSubData),
+      NAPI_DEFINE_METHOD("getBufferSubDataToArrayBuffer", GetBufferSubDataToArrayBuffer),
       NAPI_DEFINE_METHOD("getContextAttributes", GetContextAttributes),
       NAPI_DEFINE_METHOD("getError", GetError),
 // getExtension(extensionName: "OES_vertex_array_object"): OES_vertex_array_object | null;
@@ -492,79 +1427,99 @@ napi_status WebGLRenderingContext::Register(napi_env env, napi_value exports) {
 // getExtension(extensionName: "ANGLE_instanced_arrays"): ANGLE_instanced_arrays | null;
       NAPI_DEFINE_METHOD("getFramebufferAttachmentParameter", GetFramebufferAttachmentParameter),
       NAPI_DEFINE_METHOD("getExtension", GetExtension),
+      NAPI_DEFINE_METHOD("getMemoryInfo", GetMemoryInfo),
       NAPI_DEFINE_METHOD("getParameter", GetParameter),
+      NAPI_DEFINE_METHOD("getProgramBinaryCacheStats", GetProgramBinaryCacheStats),
       NAPI_DEFINE_METHOD("getProgramInfoLog", GetProgramInfoLog),
       NAPI_DEFINE_METHOD("getProgramParameter", GetProgramParameter),
       NAPI_DEFINE_METHOD("getRenderbufferParameter", GetRenderbufferParameter),
+      NAPI_DEFINE_METHOD("getScratchArenaStats", GetScratchArenaStats),
       NAPI_DEFINE_METHOD("getShaderInfoLog", GetShaderInfoLog),
       NAPI_DEFINE_METHOD("getShaderParameter", GetShaderParameter),
       NAPI_DEFINE_METHOD("getShaderPrecisionFormat", GetShaderPrecisionFormat),
       NAPI_DEFINE_METHOD("getShaderSource", ShaderSource),
+      NAPI_DEFINE_METHOD("getStateCacheStats", GetStateCacheStats),
       NAPI_DEFINE_METHOD("getSupportedExtensions", GetSupportedExtensions),
       NAPI_DEFINE_METHOD("getTexParameter", GetTexParameter),
+      NAPI_DEFINE_METHOD("getTexturePoolStats", GetTexturePoolStats),
 // getUniform(program: WebGLProgram | null, location: WebGLUniformLocation | null): any;
       NAPI_DEFINE_METHOD("getUniformLocation", GetUniformLocation),
 // getVertexAttrib(index: number, pname: number): any;
 // getVertexuniform1iAttribOffset(index: number, pname: number): number;
-      NAPI_DEFINE_METHOD("hint", Hint),
-      NAPI_DEFINE_METHOD("isBuffer", IsBuffer),
+      NAPI_DEFINE_METHOD("hint", STATE_CACHE_THUNK(Hint)),
+      NAPI_DEFINE_METHOD("isBuffer", GL_OBJECT_THUNK(glIsBuffer, GLboolean, BufferArg)),
       NAPI_DEFINE_METHOD("isContextLost", IsContextLost),
-      NAPI_DEFINE_METHOD("isEnabled", IsEnabled),
-      NAPI_DEFINE_METHOD("isFramebuffer", IsFramebuffer),
-      NAPI_DEFINE_METHOD("isProgram", IsProgram),
-      NAPI_DEFINE_METHOD("isRenderbuffer", IsRenderbuffer),
-      NAPI_DEFINE_METHOD("isShader", IsShader),
-      NAPI_DEFINE_METHOD("isTexture", IsTexture),
-      NAPI_DEFINE_METHOD("lineWidth", LineWidth),
+      NAPI_DEFINE_METHOD("isEnabled", GL_THUNK(glIsEnabled)),
+      NAPI_DEFINE_METHOD("isFramebuffer", GL_OBJECT_THUNK(glIsFramebuffer, GLboolean, FramebufferArg)),
+      NAPI_DEFINE_METHOD("isProgram", GL_OBJECT_THUNK(glIsProgram, GLboolean, ProgramArg)),
+      NAPI_DEFINE_METHOD("isRenderbuffer", GL_OBJECT_THUNK(glIsRenderbuffer, GLboolean, RenderbufferArg)),
+      NAPI_DEFINE_METHOD("isShader", GL_OBJECT_THUNK(glIsShader, GLboolean, ShaderArg)),
+      NAPI_DEFINE_METHOD("isSync", IsSync),
+      NAPI_DEFINE_METHOD("isTexture", GL_OBJECT_THUNK(glIsTexture, GLboolean, TextureArg)),
+      NAPI_DEFINE_METHOD("lineWidth", STATE_CACHE_THUNK(LineWidth)),
       NAPI_DEFINE_METHOD("linkProgram", LinkProgram),
-      NAPI_DEFINE_METHOD("pixelStorei", PixelStorei),
-      NAPI_DEFINE_METHOD("polygonOffset", PolygonOffset),
+      NAPI_DEFINE_METHOD("linkProgramAsync", LinkProgramAsync),
+      NAPI_DEFINE_METHOD("mapBufferRange", MapBufferRange),
+      NAPI_DEFINE_METHOD("pixelStorei", STATE_CACHE_THUNK(PixelStorei)),
+      NAPI_DEFINE_METHOD("polygonOffset", STATE_CACHE_THUNK(PolygonOffset)),
       NAPI_DEFINE_METHOD("readPixels", ReadPixels),
-      NAPI_DEFINE_METHOD("renderbufferStorage", RenderbufferStorage),
-      NAPI_DEFINE_METHOD("sampleCoverage", SampleCoverage),
-      NAPI_DEFINE_METHOD("scissor", Scissor),
+      NAPI_DEFINE_METHOD("readPixelsAsync", ReadPixelsAsync),
+      NAPI_DEFINE_METHOD("readPixelsToArrayBuffer", ReadPixelsToArrayBuffer),
+      NAPI_DEFINE_METHOD("releaseTexture", ReleaseTexture),
+      NAPI_DEFINE_METHOD("renderbufferStorage", MEMORY_TRACKER_THUNK(RenderbufferStorage)),
+      NAPI_DEFINE_METHOD("sampleCoverage", STATE_CACHE_THUNK(SampleCoverage)),
+      NAPI_DEFINE_METHOD("scissor", STATE_CACHE_THUNK(Scissor)),
+      NAPI_DEFINE_METHOD("setProgramBinaryCacheLimit", SetProgramBinaryCacheLimit),
+      NAPI_DEFINE_METHOD("setStateCacheEnabled", SetStateCacheEnabled),
+      NAPI_DEFINE_METHOD("setTexturePoolLimit", SetTexturePoolLimit),
+      NAPI_DEFINE_METHOD("setUniforms", SetUniforms),
       NAPI_DEFINE_METHOD("shaderSource", ShaderSource),
-      NAPI_DEFINE_METHOD("stencilFunc", StencilFunc),
-      NAPI_DEFINE_METHOD("stencilFuncSeparate", StencilFuncSeparate),
-      NAPI_DEFINE_METHOD("stencilMask", StencilMask),
-      NAPI_DEFINE_METHOD("stencilMaskSeparate", StencilMaskSeparate),
-      NAPI_DEFINE_METHOD("stencilOp", StencilOp),
-      NAPI_DEFINE_METHOD("stencilOpSeparate", StencilOpSeparate),
+      NAPI_DEFINE_METHOD("signalHandoff", SignalHandoff),
+      NAPI_DEFINE_METHOD("stencilFunc", STATE_CACHE_THUNK(StencilFunc)),
+      NAPI_DEFINE_METHOD("stencilFuncSeparate", STATE_CACHE_THUNK(StencilFuncSeparate)),
+      NAPI_DEFINE_METHOD("stencilMask", STATE_CACHE_THUNK(StencilMask)),
+      NAPI_DEFINE_METHOD("stencilMaskSeparate", STATE_CACHE_THUNK(StencilMaskSeparate)),
+      NAPI_DEFINE_METHOD("stencilOp", STATE_CACHE_THUNK(StencilOp)),
+      NAPI_DEFINE_METHOD("stencilOpSeparate", STATE_CACHE_THUNK(StencilOpSeparate)),
+      NAPI_DEFINE_METHOD("streamWrite", StreamWrite),
       NAPI_DEFINE_METHOD("texImage2D", TexImage2D),
-      NAPI_DEFINE_METHOD("texParameteri", TexParameteri),
-      NAPI_DEFINE_METHOD("texParameterf", TexParameterf),
+      NAPI_DEFINE_METHOD("texParameteri", GL_THUNK(glTexParameteri)),
+      NAPI_DEFINE_METHOD("texParameterf", GL_THUNK(glTexParameterf)),
       NAPI_DEFINE_METHOD("texSubImage2D", TexSubImage2D),
-      NAPI_DEFINE_METHOD("uniform1f", Uniform1f),
+      NAPI_DEFINE_METHOD("uniform1f", UNIFORM_THUNK(Uniform1f)),
       NAPI_DEFINE_METHOD("uniform1fv", Uniform1fv),
-      NAPI_DEFINE_METHOD("uniform1i", Uniform1i),
+      NAPI_DEFINE_METHOD("uniform1i", UNIFORM_THUNK(Uniform1i)),
       NAPI_DEFINE_METHOD("uniform1iv", Uniform1iv),
-      NAPI_DEFINE_METHOD("uniform2f", Uniform2f),
+      NAPI_DEFINE_METHOD("uniform2f", UNIFORM_THUNK(Uniform2f)),
       NAPI_DEFINE_METHOD("uniform2fv", Uniform2fv),
-      NAPI_DEFINE_METHOD("uniform2i", Uniform2i),
+      NAPI_DEFINE_METHOD("uniform2i", UNIFORM_THUNK(Uniform2i)),
       NAPI_DEFINE_METHOD("uniform2iv", Uniform2iv),
-      NAPI_DEFINE_METHOD("uniform3i", Uniform3i),
+      NAPI_DEFINE_METHOD("uniform3i", UNIFORM_THUNK(Uniform3i)),
       NAPI_DEFINE_METHOD("uniform3iv", Uniform3iv),
-      NAPI_DEFINE_METHOD("uniform3f", Uniform3f),
+      NAPI_DEFINE_METHOD("uniform3f", UNIFORM_THUNK(Uniform3f)),
       NAPI_DEFINE_METHOD("uniform3fv", Uniform3fv),
-      NAPI_DEFINE_METHOD("uniform4f", Uniform4f),
+      NAPI_DEFINE_METHOD("uniform4f", UNIFORM_THUNK(Uniform4f)),
       NAPI_DEFINE_METHOD("uniform4fv", Uniform4fv),
-      NAPI_DEFINE_METHOD("uniform4i", Uniform4i),
+      NAPI_DEFINE_METHOD("uniform4i", UNIFORM_THUNK(Uniform4i)),
       NAPI_DEFINE_METHOD("uniform4iv", Uniform4iv),
       NAPI_DEFINE_METHOD("uniformMatrix2fv", UniformMatrix2fv),
       NAPI_DEFINE_METHOD("uniformMatrix3fv", UniformMatrix3fv),
       NAPI_DEFINE_METHOD("uniformMatrix4fv", UniformMatrix4fv),
-      NAPI_DEFINE_METHOD("useProgram", UseProgram),
-      NAPI_DEFINE_METHOD("validateProgram", ValidateProgram),
-      NAPI_DEFINE_METHOD("vertexAttrib1f", VertexAttrib1f),
+      NAPI_DEFINE_METHOD("unmapBuffer", UnmapBuffer),
+      NAPI_DEFINE_METHOD("useProgram", STATE_CACHE_OBJECT_THUNK(UseProgram, void, ProgramArg)),
+      NAPI_DEFINE_METHOD("validateProgram", GL_OBJECT_THUNK(glValidateProgram, void, ProgramArg)),
+      NAPI_DEFINE_METHOD("vertexAttrib1f", GL_THUNK(glVertexAttrib1f)),
       NAPI_DEFINE_METHOD("vertexAttrib1fv", VertexAttrib1fv),
-      NAPI_DEFINE_METHOD("vertexAttrib2f", VertexAttrib2f),
+      NAPI_DEFINE_METHOD("vertexAttrib2f", GL_THUNK(glVertexAttrib2f)),
       NAPI_DEFINE_METHOD("vertexAttrib2fv", VertexAttrib2fv),
-      NAPI_DEFINE_METHOD("vertexAttrib3f", VertexAttrib3f),
+      NAPI_DEFINE_METHOD("vertexAttrib3f", GL_THUNK(glVertexAttrib3f)),
       NAPI_DEFINE_METHOD("vertexAttrib3fv", VertexAttrib3fv),
-      NAPI_DEFINE_METHOD("vertexAttrib4f", VertexAttrib4f),
+      NAPI_DEFINE_METHOD("vertexAttrib4f", GL_THUNK(glVertexAttrib4f)),
       NAPI_DEFINE_METHOD("vertexAttrib4fv", VertexAttrib4fv),
-      NAPI_DEFINE_METHOD("vertexAttribPointer", VertexAttribPointer),
-      NAPI_DEFINE_METHOD("viewport", Viewport),
+      NAPI_DEFINE_METHOD("vertexAttribPointer", GL_THUNK(glVertexAttribPointer)),
+      NAPI_DEFINE_METHOD("viewport", STATE_CACHE_THUNK(Viewport)),
+      NAPI_DEFINE_METHOD("waitHandoff", WaitHandoff),
+      NAPI_DEFINE_METHOD("waitSyncAsync", WaitSyncAsync),
       // clang-format on
 
       // WebGL attributes:
@@ -945,7 +1900,7 @@ napi_status WebGLRenderingContext::Register(napi_env env, napi_value exports) {
       NapiDefineIntProperty(env, GL_ZERO, "ZERO"),
 
       // WebGL2 methods:
-      NAPI_DEFINE_METHOD("activeTexture", ActiveTexture),
+      NAPI_DEFINE_METHOD("activeTexture", STATE_CACHE_THUNK(ActiveTexture)),
 
       // WebGL2 attributes:
       NapiDefineIntProperty(env, GL_CONDITION_SATISFIED, "CONDITION_SATISFIED"),
@@ -960,8 +1915,135 @@ napi_status WebGLRenderingContext::Register(napi_env env, napi_value exports) {
       NapiDefineIntProperty(env, GL_RED, "RED"),
       NapiDefineIntProperty(env, GL_SYNC_GPU_COMMANDS_COMPLETE,
                             "SYNC_GPU_COMMANDS_COMPLETE"),
+
+      // mapBufferRange() access bits:
+      NapiDefineIntProperty(env, GL_MAP_FLUSH_EXPLICIT_BIT,
+                            "MAP_FLUSH_EXPLICIT_BIT"),
+      NapiDefineIntProperty(env, GL_MAP_INVALIDATE_BUFFER_BIT,
+                            "MAP_INVALIDATE_BUFFER_BIT"),
+      NapiDefineIntProperty(env, GL_MAP_INVALIDATE_RANGE_BIT,
+                            "MAP_INVALIDATE_RANGE_BIT"),
+      NapiDefineIntProperty(env, GL_MAP_READ_BIT, "MAP_READ_BIT"),
+      NapiDefineIntProperty(env, GL_MAP_UNSYNCHRONIZED_BIT,
+                            "MAP_UNSYNCHRONIZED_BIT"),
+      NapiDefineIntProperty(env, GL_MAP_WRITE_BIT, "MAP_WRITE_BIT"),
+
+      // WebGL2 getParameter() names:
+      NapiDefineIntProperty(env, GL_COPY_READ_BUFFER_BINDING,
+                            "COPY_READ_BUFFER_BINDING"),
+      NapiDefineIntProperty(env, GL_COPY_WRITE_BUFFER_BINDING,
+                            "COPY_WRITE_BUFFER_BINDING"),
+      NapiDefineIntProperty(env, GL_DRAW_BUFFER0, "DRAW_BUFFER0"),
+      NapiDefineIntProperty(env, GL_DRAW_BUFFER1, "DRAW_BUFFER1"),
+      NapiDefineIntProperty(env, GL_DRAW_BUFFER2, "DRAW_BUFFER2"),
+      NapiDefineIntProperty(env, GL_DRAW_BUFFER3, "DRAW_BUFFER3"),
+      NapiDefineIntProperty(env, GL_DRAW_BUFFER4, "DRAW_BUFFER4"),
+      NapiDefineIntProperty(env, GL_DRAW_BUFFER5, "DRAW_BUFFER5"),
+      NapiDefineIntProperty(env, GL_DRAW_BUFFER6, "DRAW_BUFFER6"),
+      NapiDefineIntProperty(env, GL_DRAW_BUFFER7, "DRAW_BUFFER7"),
+      NapiDefineIntProperty(env, GL_DRAW_BUFFER8, "DRAW_BUFFER8"),
+      NapiDefineIntProperty(env, GL_DRAW_BUFFER9, "DRAW_BUFFER9"),
+      NapiDefineIntProperty(env, GL_DRAW_BUFFER10, "DRAW_BUFFER10"),
+      NapiDefineIntProperty(env, GL_DRAW_BUFFER11, "DRAW_BUFFER11"),
+      NapiDefineIntProperty(env, GL_DRAW_BUFFER12, "DRAW_BUFFER12"),
+      NapiDefineIntProperty(env, GL_DRAW_BUFFER13, "DRAW_BUFFER13"),
+      NapiDefineIntProperty(env, GL_DRAW_BUFFER14, "DRAW_BUFFER14"),
+      NapiDefineIntProperty(env, GL_DRAW_BUFFER15, "DRAW_BUFFER15"),
+      NapiDefineIntProperty(env, GL_DRAW_FRAMEBUFFER_BINDING,
+                            "DRAW_FRAMEBUFFER_BINDING"),
+      NapiDefineIntProperty(env, GL_FRAGMENT_SHADER_DERIVATIVE_HINT,
+                            "FRAGMENT_SHADER_DERIVATIVE_HINT"),
+      NapiDefineIntProperty(env, GL_MAX_3D_TEXTURE_SIZE, "MAX_3D_TEXTURE_SIZE"),
+      NapiDefineIntProperty(env, GL_MAX_ARRAY_TEXTURE_LAYERS,
+                            "MAX_ARRAY_TEXTURE_LAYERS"),
+      NapiDefineIntProperty(env, GL_MAX_CLIENT_WAIT_TIMEOUT_WEBGL,
+                            "MAX_CLIENT_WAIT_TIMEOUT_WEBGL"),
+      NapiDefineIntProperty(env, GL_MAX_COLOR_ATTACHMENTS,
+                            "MAX_COLOR_ATTACHMENTS"),
+      NapiDefineIntProperty(env, GL_MAX_COMBINED_FRAGMENT_UNIFORM_COMPONENTS,
+                            "MAX_COMBINED_FRAGMENT_UNIFORM_COMPONENTS"),
+      NapiDefineIntProperty(env, GL_MAX_COMBINED_UNIFORM_BLOCKS,
+                            "MAX_COMBINED_UNIFORM_BLOCKS"),
+      NapiDefineIntProperty(env, GL_MAX_COMBINED_VERTEX_UNIFORM_COMPONENTS,
+                            "MAX_COMBINED_VERTEX_UNIFORM_COMPONENTS"),
+      NapiDefineIntProperty(env, GL_MAX_DRAW_BUFFERS, "MAX_DRAW_BUFFERS"),
+      NapiDefineIntProperty(env, GL_MAX_ELEMENTS_INDICES,
+                            "MAX_ELEMENTS_INDICES"),
+      NapiDefineIntProperty(env, GL_MAX_ELEMENTS_VERTICES,
+                            "MAX_ELEMENTS_VERTICES"),
+      NapiDefineIntProperty(env, GL_MAX_ELEMENT_INDEX, "MAX_ELEMENT_INDEX"),
+      NapiDefineIntProperty(env, GL_MAX_FRAGMENT_INPUT_COMPONENTS,
+                            "MAX_FRAGMENT_INPUT_COMPONENTS"),
+      NapiDefineIntProperty(env, GL_MAX_FRAGMENT_UNIFORM_BLOCKS,
+                            "MAX_FRAGMENT_UNIFORM_BLOCKS"),
+      NapiDefineIntProperty(env, GL_MAX_FRAGMENT_UNIFORM_COMPONENTS,
+                            "MAX_FRAGMENT_UNIFORM_COMPONENTS"),
+      NapiDefineIntProperty(env, GL_MAX_PROGRAM_TEXEL_OFFSET,
+                            "MAX_PROGRAM_TEXEL_OFFSET"),
+      NapiDefineIntProperty(env, GL_MAX_SAMPLES, "MAX_SAMPLES"),
+      NapiDefineIntProperty(env, GL_MAX_SERVER_WAIT_TIMEOUT,
+                            "MAX_SERVER_WAIT_TIMEOUT"),
+      NapiDefineIntProperty(env, GL_MAX_TEXTURE_LOD_BIAS,
+                            "MAX_TEXTURE_LOD_BIAS"),
+      NapiDefineIntProperty(env, GL_MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS,
+                            "MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS"),
+      NapiDefineIntProperty(env, GL_MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS,
+                            "MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS"),
+      NapiDefineIntProperty(env, GL_MAX_TRANSFORM_FEEDBACK_SEPARATE_COMPONENTS,
+                            "MAX_TRANSFORM_FEEDBACK_SEPARATE_COMPONENTS"),
+      NapiDefineIntProperty(env, GL_MAX_UNIFORM_BLOCK_SIZE,
+                            "MAX_UNIFORM_BLOCK_SIZE"),
+      NapiDefineIntProperty(env, GL_MAX_UNIFORM_BUFFER_BINDINGS,
+                            "MAX_UNIFORM_BUFFER_BINDINGS"),
+      NapiDefineIntProperty(env, GL_MAX_VARYING_COMPONENTS,
+                            "MAX_VARYING_COMPONENTS"),
+      NapiDefineIntProperty(env, GL_MAX_VERTEX_OUTPUT_COMPONENTS,
+                            "MAX_VERTEX_OUTPUT_COMPONENTS"),
+      NapiDefineIntProperty(env, GL_MAX_VERTEX_UNIFORM_BLOCKS,
+                            "MAX_VERTEX_UNIFORM_BLOCKS"),
+      NapiDefineIntProperty(env, GL_MAX_VERTEX_UNIFORM_COMPONENTS,
+                            "MAX_VERTEX_UNIFORM_COMPONENTS"),
+      NapiDefineIntProperty(env, GL_MIN_PROGRAM_TEXEL_OFFSET,
+                            "MIN_PROGRAM_TEXEL_OFFSET"),
+      NapiDefineIntProperty(env, GL_PACK_ROW_LENGTH, "PACK_ROW_LENGTH"),
+      NapiDefineIntProperty(env, GL_PACK_SKIP_PIXELS, "PACK_SKIP_PIXELS"),
+      NapiDefineIntProperty(env, GL_PACK_SKIP_ROWS, "PACK_SKIP_ROWS"),
+      NapiDefineIntProperty(env, GL_PIXEL_PACK_BUFFER_BINDING,
+                            "PIXEL_PACK_BUFFER_BINDING"),
+      NapiDefineIntProperty(env, GL_PIXEL_UNPACK_BUFFER_BINDING,
+                            "PIXEL_UNPACK_BUFFER_BINDING"),
+      NapiDefineIntProperty(env, GL_RASTERIZER_DISCARD, "RASTERIZER_DISCARD"),
+      NapiDefineIntProperty(env, GL_READ_BUFFER, "READ_BUFFER"),
+      NapiDefineIntProperty(env, GL_READ_FRAMEBUFFER_BINDING,
+                            "READ_FRAMEBUFFER_BINDING"),
+      NapiDefineIntProperty(env, GL_SAMPLER_BINDING, "SAMPLER_BINDING"),
+      NapiDefineIntProperty(env, GL_TEXTURE_BINDING_2D_ARRAY,
+                            "TEXTURE_BINDING_2D_ARRAY"),
+      NapiDefineIntProperty(env, GL_TEXTURE_BINDING_3D, "TEXTURE_BINDING_3D"),
+      NapiDefineIntProperty(env, GL_TRANSFORM_FEEDBACK_ACTIVE,
+                            "TRANSFORM_FEEDBACK_ACTIVE"),
+      NapiDefineIntProperty(env, GL_TRANSFORM_FEEDBACK_BINDING,
+                            "TRANSFORM_FEEDBACK_BINDING"),
+      NapiDefineIntProperty(env, GL_TRANSFORM_FEEDBACK_BUFFER_BINDING,
+                            "TRANSFORM_FEEDBACK_BUFFER_BINDING"),
+      NapiDefineIntProperty(env, GL_TRANSFORM_FEEDBACK_PAUSED,
+                            "TRANSFORM_FEEDBACK_PAUSED"),
+      NapiDefineIntProperty(env, GL_UNIFORM_BUFFER_BINDING,
+                            "UNIFORM_BUFFER_BINDING"),
+      NapiDefineIntProperty(env, GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT,
+                            "UNIFORM_BUFFER_OFFSET_ALIGNMENT"),
+      NapiDefineIntProperty(env, GL_UNPACK_IMAGE_HEIGHT, "UNPACK_IMAGE_HEIGHT"),
+      NapiDefineIntProperty(env, GL_UNPACK_ROW_LENGTH, "UNPACK_ROW_LENGTH"),
+      NapiDefineIntProperty(env, GL_UNPACK_SKIP_IMAGES, "UNPACK_SKIP_IMAGES"),
+      NapiDefineIntProperty(env, GL_UNPACK_SKIP_PIXELS, "UNPACK_SKIP_PIXELS"),
+      NapiDefineIntProperty(env, GL_UNPACK_SKIP_ROWS, "UNPACK_SKIP_ROWS"),
+      NapiDefineIntProperty(env, GL_VERTEX_ARRAY_BINDING,
+                            "VERTEX_ARRAY_BINDING"),
   };
 
+  nstatus = GLObjectRegistry::Register(env);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+
   // Create constructor
   napi_value ctor_value;
   nstatus = napi_define_class(env, "WebGLRenderingContext", NAPI_AUTO_LENGTH,
@@ -969,8 +2051,7 @@ napi_status WebGLRenderingContext::Register(napi_env env, napi_value exports) {
                               ARRAY_SIZE(properties), properties, &ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  // Bind reference
-  nstatus = napi_create_reference(env, ctor_value, 1, &constructor_ref_);
+  nstatus = InstanceData::SetConstructor(env, &constructor_key_, ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
   return napi_ok;
@@ -983,11 +2064,11 @@ napi_status WebGLRenderingContext::NewInstance(napi_env env,
   napi_status nstatus;
 
   napi_value ctor_value;
-  nstatus = napi_get_reference_value(env, constructor_ref_, &ctor_value);
+  nstatus = InstanceData::GetConstructor(env, &constructor_key_, &ctor_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
 
-  size_t argc = 5;
-  napi_value args[5];
+  size_t argc = 13;
+  napi_value args[13];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
@@ -1006,12 +2087,14 @@ napi_value WebGLRenderingContext::InitInternal(napi_env env,
 
   ENSURE_CONSTRUCTOR_CALL_RETVAL(env, info, nullptr);
 
-  size_t argc = 5;
-  napi_value args[5];
+  size_t argc = 13;
+  napi_value args[13];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, argc, nullptr);
+  if (argc < 5) {
+    ENSURE_ARGC_RETVAL(env, argc, 5, nullptr);
+  }
 
   GLContextOptions opts;
   nstatus = napi_get_value_uint32(env, args[0], &opts.width);
@@ -1029,12 +2112,123 @@ napi_value WebGLRenderingContext::InitInternal(napi_env env,
   nstatus = napi_get_value_bool(env, args[4], &opts.webgl_compatibility);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = new WebGLRenderingContext(env, opts);
+  if (argc > 5) {
+    nstatus = napi_get_value_bool(env, args[5], &opts.wrap_objects);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  }
+
+  if (argc > 6) {
+    nstatus = napi_get_value_bool(env, args[6], &opts.command_thread);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  }
+
+  WebGLRenderingContext *share_with = nullptr;
+  if (argc > 7) {
+    napi_valuetype value_type;
+    nstatus = napi_typeof(env, args[7], &value_type);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+    if (value_type != napi_undefined && value_type != napi_null) {
+      napi_value ctor_value;
+      nstatus =
+          InstanceData::GetConstructor(env, &constructor_key_, &ctor_value);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+      bool is_context = false;
+      nstatus = napi_instanceof(env, args[7], ctor_value, &is_context);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+      if (!is_context) {
+        NAPI_THROW_ERROR(env, "shareWith must be a WebGLRenderingContext");
+        return nullptr;
+      }
+
+      nstatus =
+          napi_unwrap(env, args[7], reinterpret_cast<void **>(&share_with));
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+      if (!share_with->eglContextWrapper_) {
+        NAPI_THROW_ERROR(env, "shareWith context is not usable");
+        return nullptr;
+      }
+      opts.share_context = share_with->eglContextWrapper_->context;
+    }
+  }
+
+  if (argc > 8) {
+    napi_valuetype value_type;
+    nstatus = napi_typeof(env, args[8], &value_type);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+    if (value_type != napi_undefined) {
+      uint32_t max_threads;
+      nstatus = napi_get_value_uint32(env, args[8], &max_threads);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+      opts.max_shader_compiler_threads = max_threads;
+    }
+  }
+
+  if (argc > 9) {
+    napi_valuetype value_type;
+    nstatus = napi_typeof(env, args[9], &value_type);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+    if (value_type != napi_undefined) {
+      ENSURE_VALUE_IS_STRING_RETVAL(env, args[9], nullptr);
+      nstatus = GetStringParam(env, args[9], opts.program_binary_cache_dir);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    }
+  }
+
+  if (argc > 10) {
+    napi_valuetype value_type;
+    nstatus = napi_typeof(env, args[10], &value_type);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+    if (value_type != napi_undefined) {
+      ENSURE_VALUE_IS_STRING_RETVAL(env, args[10], nullptr);
+      nstatus = GetStringParam(env, args[10], opts.blob_cache_file);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    }
+  }
+
+  if (argc > 11) {
+    napi_valuetype value_type;
+    nstatus = napi_typeof(env, args[11], &value_type);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+    if (value_type != napi_undefined) {
+      double max_bytes;
+      nstatus = napi_get_value_double(env, args[11], &max_bytes);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+      if (max_bytes < 0) {
+        NAPI_THROW_ERROR(env, "blobCacheMaxBytes must not be negative");
+        return nullptr;
+      }
+      opts.blob_cache_max_bytes = static_cast<size_t>(max_bytes);
+    }
+  }
+
+  if (argc > 12) {
+    napi_valuetype value_type;
+    nstatus = napi_typeof(env, args[12], &value_type);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+    if (value_type != napi_undefined) {
+      nstatus = napi_get_value_bool(env, args[12], &opts.surfaceless);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    }
+  }
+
+  WebGLRenderingContext *context =
+      new WebGLRenderingContext(env, opts, share_with);
   ENSURE_VALUE_IS_NOT_NULL_RETVAL(env, context, nullptr);
 
   nstatus = napi_wrap(env, js_this, context, Cleanup, nullptr, &context->ref_);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
+  if (context->command_thread_) {
+    context->command_thread_->set_context_ref(context->ref_);
+  }
+
   return js_this;
 }
 
@@ -1048,45 +2242,70 @@ void WebGLRenderingContext::Cleanup(napi_env env, void *native, void *hint) {
  * ********************************************/
 
 /* static */
-napi_value WebGLRenderingContext::ActiveTexture(napi_env env,
-                                                napi_callback_info info) {
-  LOG_CALL("ActiveTexture");
+napi_value WebGLRenderingContext::AcquireTexture(napi_env env,
+                                                 napi_callback_info info) {
+  LOG_CALL("AcquireTexture");
   napi_status nstatus;
 
   WebGLRenderingContext *context = nullptr;
+  napi_value args[1];
+  nstatus = GetContextArgs(env, info, &context, 1, args);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  ENSURE_VALUE_IS_OBJECT_RETVAL(env, args[0], nullptr);
 
-  GLenum texture;
-  nstatus = GetContextUint32Params(env, info, &context, 1, &texture);
+  GLTexturePool::Desc desc;
+  desc.target = GL_TEXTURE_2D;
+  nstatus = GetNumberProperty(env, args[0], "target", false, &desc.target);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glActiveTexture(texture);
+  nstatus = GetNumberProperty(env, args[0], "internalFormat", true,
+                              &desc.internal_format);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
+  // Unsized internal formats double as the format.
+  desc.format = desc.internal_format;
+  nstatus = GetNumberProperty(env, args[0], "format", false, &desc.format);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-/* static */
-napi_value WebGLRenderingContext::AttachShader(napi_env env,
-                                               napi_callback_info info) {
-  LOG_CALL("AttachShader");
-  napi_status nstatus;
+  desc.type = GL_UNSIGNED_BYTE;
+  nstatus = GetNumberProperty(env, args[0], "type", false, &desc.type);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = nullptr;
-  uint32_t args[2];
-  nstatus = GetContextUint32Params(env, info, &context, 2, args);
+  uint32_t width;
+  nstatus = GetNumberProperty(env, args[0], "width", true, &width);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glAttachShader(args[0], args[1]);
+  uint32_t height;
+  nstatus = GetNumberProperty(env, args[0], "height", true, &height);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
+  uint32_t levels = 1;
+  nstatus = GetNumberProperty(env, args[0], "levels", false, &levels);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-/* static */
+  desc.width = static_cast<GLsizei>(width);
+  desc.height = static_cast<GLsizei>(height);
+  desc.levels = static_cast<GLsizei>(levels);
+
+  GLuint texture = context->texture_pool_->Acquire(desc);
+  if (texture == 0) {
+    NAPI_THROW_ERROR(env, "Invalid texture descriptor");
+    return nullptr;
+  }
+
+  napi_value texture_value;
+  nstatus = context->CreateObjectValue(kGLObjectTexture, texture,
+                                       &texture_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+#if DEBUG
+  context->CheckForErrors();
+#endif
+  return texture_value;
+}
+
+/* static */
 napi_value WebGLRenderingContext::BindAttribLocation(napi_env env,
                                                      napi_callback_info info) {
   LOG_CALL("BindAttribLocation");
@@ -1103,9 +2322,8 @@ napi_value WebGLRenderingContext::BindAttribLocation(napi_env env,
   nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
   GLuint program;
-  nstatus = napi_get_value_uint32(env, args[0], &program);
+  nstatus = GetObjectArg(env, args[0], kGLObjectProgram, &program);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
@@ -1120,161 +2338,7 @@ napi_value WebGLRenderingContext::BindAttribLocation(napi_env env,
 
   context->eglContextWrapper_->glBindAttribLocation(program, index,
                                                     name.c_str());
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::BindBuffer(napi_env env,
-                                             napi_callback_info info) {
-  LOG_CALL("BindBuffer");
-  napi_status nstatus;
-
-  WebGLRenderingContext *context = nullptr;
-  uint32_t args[2];
-  nstatus = GetContextUint32Params(env, info, &context, 2, args);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glBindBuffer(args[0], args[1]);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::BindFramebuffer(napi_env env,
-                                                  napi_callback_info info) {
-  LOG_CALL("BindFramebuffer");
-  napi_status nstatus;
-
-  WebGLRenderingContext *context = nullptr;
-  uint32_t args[2];
-  nstatus = GetContextUint32Params(env, info, &context, 2, args);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glBindFramebuffer(args[0], args[1]);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::BindRenderbuffer(napi_env env,
-                                                   napi_callback_info info) {
-  LOG_CALL("BindRenderbuffer");
-  napi_status nstatus;
-
-  WebGLRenderingContext *context = nullptr;
-  uint32_t args[2];
-  nstatus = GetContextUint32Params(env, info, &context, 2, args);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glBindRenderbuffer(args[0], args[1]);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::BlendColor(napi_env env,
-                                             napi_callback_info info) {
-  LOG_CALL("BlendColor");
-  napi_status nstatus;
-
-  double values[4];
-  WebGLRenderingContext *context = nullptr;
-  nstatus = GetContextDoubleParams(env, info, &context, 4, values);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glBlendColor(
-      static_cast<GLclampf>(values[0]), static_cast<GLclampf>(values[1]),
-      static_cast<GLclampf>(values[2]), static_cast<GLclampf>(values[3]));
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::BlendEquation(napi_env env,
-                                                napi_callback_info info) {
-  LOG_CALL("BlendEquation");
-  napi_status nstatus;
-
-  WebGLRenderingContext *context = nullptr;
-  GLuint mode;
-  nstatus = GetContextUint32Params(env, info, &context, 1, &mode);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glBlendEquation(mode);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::BlendEquationSeparate(
-    napi_env env, napi_callback_info info) {
-  LOG_CALL("BlendEquationSeparate");
-  napi_status nstatus;
-
-  WebGLRenderingContext *context = nullptr;
-  GLenum args[2];
-  nstatus = GetContextUint32Params(env, info, &context, 2, args);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glBlendEquationSeparate(args[0], args[1]);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::BlendFunc(napi_env env,
-                                            napi_callback_info info) {
-  LOG_CALL("BlendFunc");
-  napi_status nstatus;
-
-  WebGLRenderingContext *context = nullptr;
-  GLenum args[2];
-  nstatus = GetContextUint32Params(env, info, &context, 2, args);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glBlendFunc(args[0], args[1]);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::BlendFuncSeparate(napi_env env,
-                                                    napi_callback_info info) {
-  LOG_CALL("BlendFuncSeparate");
-  napi_status nstatus;
-
-  WebGLRenderingContext *context = nullptr;
-  GLenum args[4];
-  nstatus = GetContextUint32Params(env, info, &context, 4, args);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glBlendFuncSeparate(args[0], args[1], args[2],
-                                                   args[3]);
+  context->program_cache_->OnBindAttribLocation(program, index, name);
 
 #if DEBUG
   context->CheckForErrors();
@@ -1288,12 +2352,15 @@ napi_value WebGLRenderingContext::BufferData(napi_env env,
   LOG_CALL("BufferData");
   napi_status nstatus;
 
-  size_t argc = 3;
-  napi_value args[3];
+  // WebGL2 adds optional srcOffset and length arguments.
+  size_t argc = 5;
+  napi_value args[5];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 3, nullptr);
+  if (argc < 3) {
+    ENSURE_ARGC_RETVAL(env, argc, 3, nullptr);
+  }
 
   WebGLRenderingContext *context = nullptr;
   nstatus = UnwrapContext(env, js_this, &context);
@@ -1317,7 +2384,18 @@ napi_value WebGLRenderingContext::BufferData(napi_env env,
     nstatus = napi_get_value_uint32(env, args[1], &length);
     ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
   } else {
-    nstatus = GetArrayLikeBuffer(env, args[1], &alb);
+    nstatus = GetArrayLikeBuffer(env, args[1], context->scratch_arena_, &alb);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+    uint32_t src_offset = 0;
+    nstatus = GetOptionalArg(env, argc, args, 3, &src_offset);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+    uint32_t src_length = 0;
+    nstatus = GetOptionalArg(env, argc, args, 4, &src_length);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+    nstatus = ApplySourceRange(env, &alb, src_offset, src_length);
     ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
     length = alb.length;
@@ -1328,7 +2406,9 @@ napi_value WebGLRenderingContext::BufferData(napi_env env,
   nstatus = napi_get_value_uint32(env, args[2], &usage);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
+  context->buffer_mappings_->OnBufferData(target);
   context->eglContextWrapper_->glBufferData(target, length, alb.data, usage);
+  context->memory_tracker_->OnBufferData(target, length);
 
 #if DEBUG
   context->CheckForErrors();
@@ -1342,12 +2422,15 @@ napi_value WebGLRenderingContext::BufferSubData(napi_env env,
   LOG_CALL("BufferSubData");
   napi_status nstatus;
 
-  size_t argc = 3;
-  napi_value args[3];
+  // WebGL2 adds optional srcOffset and length arguments.
+  size_t argc = 5;
+  napi_value args[5];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 3, nullptr);
+  if (argc < 3) {
+    ENSURE_ARGC_RETVAL(env, argc, 3, nullptr);
+  }
 
   WebGLRenderingContext *context = nullptr;
   nstatus = UnwrapContext(env, js_this, &context);
@@ -1365,30 +2448,22 @@ napi_value WebGLRenderingContext::BufferSubData(napi_env env,
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   ArrayLikeBuffer alb;
-  nstatus = GetArrayLikeBuffer(env, args[2], &alb);
+  nstatus = GetArrayLikeBuffer(env, args[2], context->scratch_arena_, &alb);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  context->eglContextWrapper_->glBufferSubData(target, offset, alb.length,
-                                               alb.data);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
 
-/* static */
-napi_value WebGLRenderingContext::BindTexture(napi_env env,
-                                              napi_callback_info info) {
-  LOG_CALL("BindTexture");
-  napi_status nstatus;
+  uint32_t src_offset = 0;
+  nstatus = GetOptionalArg(env, argc, args, 3, &src_offset);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = nullptr;
+  uint32_t src_length = 0;
+  nstatus = GetOptionalArg(env, argc, args, 4, &src_length);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  uint32_t args[2];
-  nstatus = GetContextUint32Params(env, info, &context, 2, args);
+  nstatus = ApplySourceRange(env, &alb, src_offset, src_length);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glBindTexture(args[0], args[1]);
+  context->eglContextWrapper_->glBufferSubData(target, offset, alb.length,
+                                               alb.data);
 
 #if DEBUG
   context->CheckForErrors();
@@ -1397,100 +2472,103 @@ napi_value WebGLRenderingContext::BindTexture(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::CheckFramebufferStatus(
-    napi_env env, napi_callback_info info) {
-  LOG_CALL("CheckFramebufferStatus");
+napi_value WebGLRenderingContext::ClientWaitSync(napi_env env,
+                                                 napi_callback_info info) {
+  LOG_CALL("ClientWaitSync");
+
   napi_status nstatus;
 
   WebGLRenderingContext *context = nullptr;
-  uint32_t arg_value;
-  nstatus = GetContextUint32Params(env, info, &context, 1, &arg_value);
+  napi_value args[3];
+  nstatus = GetContextArgs(env, info, &context, 3, args);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLuint status =
-      context->eglContextWrapper_->glCheckFramebufferStatus(arg_value);
+  uint32_t handle;
+  nstatus = GetNapiArg(env, args[0], &handle);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  napi_value status_value;
-  nstatus = napi_create_uint32(env, status, &status_value);
+  GLbitfield flags;
+  nstatus = GetNapiArg(env, args[1], &flags);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return status_value;
-}
+  GLuint64 timeout;
+  nstatus = GetTimeoutArg(env, args[2], true, &timeout);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-/* static */
-napi_value WebGLRenderingContext::Clear(napi_env env, napi_callback_info info) {
-  LOG_CALL("Clear");
+  // Unknown handles pass a null fence so GL reports the error.
+  GLsync sync = context->sync_pool_->Get(handle);
+  GLenum result =
+      context->eglContextWrapper_->glClientWaitSync(sync, flags, timeout);
 
-  WebGLRenderingContext *context = nullptr;
-  GLbitfield mask;
-  napi_status nstatus = GetContextUint32Params(env, info, &context, 1, &mask);
+  napi_value result_value;
+  nstatus = napi_create_uint32(env, result, &result_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glClear(mask);
-
 #if DEBUG
   context->CheckForErrors();
 #endif
-  return nullptr;
+  return result_value;
 }
 
 /* static */
-napi_value WebGLRenderingContext::ClearColor(napi_env env,
-                                             napi_callback_info info) {
-  LOG_CALL("ClearColor");
+napi_value WebGLRenderingContext::CompressedTexImage2D(
+    napi_env env, napi_callback_info info) {
+  LOG_CALL("CompressedTexImage2D");
 
   napi_status nstatus;
 
-  double values[4];
-  WebGLRenderingContext *context = nullptr;
-  nstatus = GetContextDoubleParams(env, info, &context, 4, values);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glClearColor(values[0], values[1], values[2],
-                                            values[3]);
+  size_t argc = 7;
+  napi_value args[7];
+  napi_value js_this;
 
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
+  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  ENSURE_ARGC_RETVAL(env, argc, 7, nullptr);
 
-/* static */
-napi_value WebGLRenderingContext::ClearDepth(napi_env env,
-                                             napi_callback_info info) {
-  LOG_CALL("ClearDepth");
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[3], nullptr);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[4], nullptr);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[5], nullptr);
 
-  napi_status nstatus;
+  GLenum target;
+  nstatus = napi_get_value_uint32(env, args[0], &target);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  double depth;
-  WebGLRenderingContext *context = nullptr;
-  nstatus = GetContextDoubleParams(env, info, &context, 1, &depth);
+  GLint level;
+  nstatus = napi_get_value_int32(env, args[1], &level);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glClearDepthf(static_cast<GLclampf>(depth));
+  GLenum internal_format;
+  nstatus = napi_get_value_uint32(env, args[2], &internal_format);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
+  GLsizei width;
+  nstatus = napi_get_value_int32(env, args[3], &width);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-/* static */
-napi_value WebGLRenderingContext::ClearStencil(napi_env env,
-                                               napi_callback_info info) {
-  LOG_CALL("ClearStencil");
+  GLsizei height;
+  nstatus = napi_get_value_int32(env, args[4], &height);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  napi_status nstatus;
+  GLint border;
+  nstatus = napi_get_value_int32(env, args[5], &border);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLint s;
   WebGLRenderingContext *context = nullptr;
-  nstatus = GetContextInt32Params(env, info, &context, 1, &s);
+  nstatus = UnwrapContext(env, js_this, &context);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  ArrayLikeBuffer alb;
+  nstatus = GetArrayLikeBuffer(env, args[6], context->scratch_arena_, &alb);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glClearStencil(s);
+  context->eglContextWrapper_->glCompressedTexImage2D(
+      target, level, internal_format, width, height, border,
+      static_cast<GLsizei>(alb.length), alb.data);
+  context->memory_tracker_->OnTexImage(target, level, width, height,
+                                       alb.length);
 
 #if DEBUG
   context->CheckForErrors();
@@ -1499,161 +2577,9 @@ napi_value WebGLRenderingContext::ClearStencil(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::ClientWaitSync(napi_env env,
-                                                 napi_callback_info info) {
-  LOG_CALL("ClientWaitSync");
-
-  napi_status nstatus;
-
-  size_t argc = 3;
-  napi_value args[3];
-  napi_value js_this;
-
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 3, nullptr);
-
-  ENSURE_VALUE_IS_OBJECT_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
-
-  GLsync sync;
-  nstatus = napi_unwrap(env, args[0], reinterpret_cast<void **>(&sync));
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLbitfield flags;
-  nstatus = napi_get_value_uint32(env, args[1], &flags);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  // TODO(kreeger): Note that N-API doesn't have uint64 support.
-  uint32_t timeout;
-  nstatus = napi_get_value_uint32(env, args[2], &timeout);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLenum result =
-      context->eglContextWrapper_->glClientWaitSync(sync, flags, timeout);
-
-  napi_value result_value;
-  nstatus = napi_create_uint32(env, result, &result_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return result_value;
-}
-
-/* static */
-napi_value WebGLRenderingContext::ColorMask(napi_env env,
-                                            napi_callback_info info) {
-  LOG_CALL("ColorMask");
-
-  napi_status nstatus;
-
-  bool args[4];
-  WebGLRenderingContext *context = nullptr;
-  nstatus = GetContextBoolParams(env, info, &context, 4, args);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glColorMask(
-      static_cast<GLboolean>(args[0]), static_cast<GLboolean>(args[1]),
-      static_cast<GLboolean>(args[2]), static_cast<GLboolean>(args[3]));
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::CompileShader(napi_env env,
-                                                napi_callback_info info) {
-  LOG_CALL("CompileShader");
-  WebGLRenderingContext *context = nullptr;
-  GLuint shader;
-  napi_status nstatus = GetContextUint32Params(env, info, &context, 1, &shader);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glCompileShader(shader);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::CompressedTexImage2D(
-    napi_env env, napi_callback_info info) {
-  LOG_CALL("CompressedTexImage2D");
-
-  napi_status nstatus;
-
-  size_t argc = 7;
-  napi_value args[7];
-  napi_value js_this;
-
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 7, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[3], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[4], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[5], nullptr);
-
-  GLenum target;
-  nstatus = napi_get_value_uint32(env, args[0], &target);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLint level;
-  nstatus = napi_get_value_int32(env, args[1], &level);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLenum internal_format;
-  nstatus = napi_get_value_uint32(env, args[2], &internal_format);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLsizei width;
-  nstatus = napi_get_value_int32(env, args[3], &width);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLsizei height;
-  nstatus = napi_get_value_int32(env, args[4], &height);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLint border;
-  nstatus = napi_get_value_int32(env, args[5], &border);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  ArrayLikeBuffer alb;
-  nstatus = GetArrayLikeBuffer(env, args[6], &alb);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glCompressedTexImage2D(
-      target, level, internal_format, width, height, border,
-      static_cast<GLsizei>(alb.length), alb.data);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::CompressedTexSubImage2D(
-    napi_env env, napi_callback_info info) {
-  LOG_CALL("CompressedTexSubImage2D");
+napi_value WebGLRenderingContext::CompressedTexSubImage2D(
+    napi_env env, napi_callback_info info) {
+  LOG_CALL("CompressedTexSubImage2D");
 
   napi_status nstatus;
 
@@ -1701,14 +2627,14 @@ napi_value WebGLRenderingContext::CompressedTexSubImage2D(
   nstatus = napi_get_value_uint32(env, args[6], &format);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  ArrayLikeBuffer alb;
-  nstatus = GetArrayLikeBuffer(env, args[7], &alb);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
   WebGLRenderingContext *context = nullptr;
   nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
+  ArrayLikeBuffer alb;
+  nstatus = GetArrayLikeBuffer(env, args[7], context->scratch_arena_, &alb);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
   context->eglContextWrapper_->glCompressedTexSubImage2D(
       target, level, xoffset, yoffset, width, height, format,
       static_cast<GLsizei>(alb.length), alb.data);
@@ -1719,134 +2645,6 @@ napi_value WebGLRenderingContext::CompressedTexSubImage2D(
   return nullptr;
 }
 
-/* static */
-napi_value WebGLRenderingContext::CopyTexImage2D(napi_env env,
-                                                 napi_callback_info info) {
-  LOG_CALL("CopyTexImage2D");
-
-  napi_status nstatus;
-
-  size_t argc = 8;
-  napi_value args[8];
-  napi_value js_this;
-
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 8, nullptr);
-
-  for (size_t i = 0; i < 8; i++) {
-    ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[i], nullptr);
-  }
-
-  GLenum target;
-  nstatus = napi_get_value_uint32(env, args[0], &target);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLint level;
-  nstatus = napi_get_value_int32(env, args[1], &level);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLenum internalformat;
-  nstatus = napi_get_value_uint32(env, args[2], &internalformat);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLint x;
-  nstatus = napi_get_value_int32(env, args[3], &x);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLint y;
-  nstatus = napi_get_value_int32(env, args[4], &y);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLsizei width;
-  nstatus = napi_get_value_int32(env, args[5], &width);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLsizei height;
-  nstatus = napi_get_value_int32(env, args[6], &height);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLint border;
-  nstatus = napi_get_value_int32(env, args[7], &border);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glCopyTexImage2D(target, level, internalformat,
-                                                x, y, width, height, border);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::CopyTexSubImage2D(napi_env env,
-                                                    napi_callback_info info) {
-  LOG_CALL("CopyTexSubImage2D");
-
-  napi_status nstatus;
-
-  size_t argc = 8;
-  napi_value args[8];
-  napi_value js_this;
-
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 8, nullptr);
-
-  for (size_t i = 0; i < 8; i++) {
-    ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[i], nullptr);
-  }
-
-  GLenum target;
-  nstatus = napi_get_value_uint32(env, args[0], &target);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLint level;
-  nstatus = napi_get_value_int32(env, args[1], &level);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLint xoffset;
-  nstatus = napi_get_value_int32(env, args[2], &xoffset);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLint yoffset;
-  nstatus = napi_get_value_int32(env, args[3], &yoffset);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLint x;
-  nstatus = napi_get_value_int32(env, args[4], &x);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLint y;
-  nstatus = napi_get_value_int32(env, args[5], &y);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLsizei width;
-  nstatus = napi_get_value_int32(env, args[6], &width);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLsizei height;
-  nstatus = napi_get_value_int32(env, args[7], &height);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glCopyTexSubImage2D(
-      target, level, xoffset, yoffset, x, y, width, height);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
 /* static */
 napi_value WebGLRenderingContext::CreateBuffer(napi_env env,
                                                napi_callback_info info) {
@@ -1859,12 +2657,10 @@ napi_value WebGLRenderingContext::CreateBuffer(napi_env env,
 
   GLuint buffer;
   context->eglContextWrapper_->glGenBuffers(1, &buffer);
-
-  // TODO(kreeger): Keep track of global objects.
-  context->alloc_count_++;
+  context->memory_tracker_->OnCreate(GLMemoryTracker::kBuffer, buffer);
 
   napi_value buffer_value;
-  nstatus = napi_create_uint32(env, buffer, &buffer_value);
+  nstatus = context->CreateObjectValue(kGLObjectBuffer, buffer, &buffer_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
 #if DEBUG
@@ -1886,11 +2682,9 @@ napi_value WebGLRenderingContext::CreateFramebuffer(napi_env env,
   GLuint buffer;
   context->eglContextWrapper_->glGenFramebuffers(1, &buffer);
 
-  // TODO(kreeger): Keep track of global objects.
-  context->alloc_count_++;
-
   napi_value frame_buffer_value;
-  nstatus = napi_create_uint32(env, buffer, &frame_buffer_value);
+  nstatus = context->CreateObjectValue(kGLObjectFramebuffer, buffer,
+                                       &frame_buffer_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
 #if DEBUG
@@ -1909,11 +2703,9 @@ napi_value WebGLRenderingContext::CreateProgram(napi_env env,
 
   GLuint program = context->eglContextWrapper_->glCreateProgram();
 
-  // TODO(kreeger): Keep track of global objects.
-  context->alloc_count_++;
-
   napi_value program_value;
-  nstatus = napi_create_uint32(env, program, &program_value);
+  nstatus = context->CreateObjectValue(kGLObjectProgram, program,
+                                       &program_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
 #if DEBUG
@@ -1933,9 +2725,12 @@ napi_value WebGLRenderingContext::CreateRenderbuffer(napi_env env,
 
   GLuint renderbuffer;
   context->eglContextWrapper_->glGenRenderbuffers(1, &renderbuffer);
+  context->memory_tracker_->OnCreate(GLMemoryTracker::kRenderbuffer,
+                                     renderbuffer);
 
   napi_value renderbuffer_value;
-  nstatus = napi_create_uint32(env, renderbuffer, &renderbuffer_value);
+  nstatus = context->CreateObjectValue(kGLObjectRenderbuffer, renderbuffer,
+                                       &renderbuffer_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
 #if DEBUG
@@ -1952,16 +2747,13 @@ napi_value WebGLRenderingContext::CreateShader(napi_env env,
 
   WebGLRenderingContext *context = nullptr;
   GLenum shader_type;
-  nstatus = GetContextUint32Params(env, info, &context, 1, &shader_type);
+  nstatus = GetContextParam(env, info, &context, &shader_type);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   GLuint shader = context->eglContextWrapper_->glCreateShader(shader_type);
 
-  // TODO(kreeger): Keep track of global objects.
-  context->alloc_count_++;
-
   napi_value shader_value;
-  nstatus = napi_create_uint32(env, shader, &shader_value);
+  nstatus = context->CreateObjectValue(kGLObjectShader, shader, &shader_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
 #if DEBUG
@@ -1981,12 +2773,11 @@ napi_value WebGLRenderingContext::CreateTexture(napi_env env,
 
   GLuint texture;
   context->eglContextWrapper_->glGenTextures(1, &texture);
-
-  // TODO(kreeger): Keep track of global objects.
-  context->alloc_count_++;
+  context->memory_tracker_->OnCreate(GLMemoryTracker::kTexture, texture);
 
   napi_value texture_value;
-  nstatus = napi_create_uint32(env, texture, &texture_value);
+  nstatus = context->CreateObjectValue(kGLObjectTexture, texture,
+                                       &texture_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
 #if DEBUG
@@ -1996,141 +2787,134 @@ napi_value WebGLRenderingContext::CreateTexture(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::CullFace(napi_env env,
-                                           napi_callback_info info) {
-  LOG_CALL("CullFace");
+napi_value WebGLRenderingContext::CreateUniformLayout(napi_env env,
+                                                      napi_callback_info info) {
+  LOG_CALL("CreateUniformLayout");
+  napi_status nstatus;
 
-  WebGLRenderingContext *context = nullptr;
-  GLenum mode;
-  napi_status nstatus = GetContextUint32Params(env, info, &context, 1, &mode);
+  size_t argc = 2;
+  napi_value args[2];
+  napi_value js_this;
+  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glCullFace(mode);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::DeleteBuffer(napi_env env,
-                                               napi_callback_info info) {
-  LOG_CALL("DeleteBuffer");
+  if (argc < 1) {
+    NAPI_THROW_ERROR(env, "Program is required");
+    return nullptr;
+  }
 
   WebGLRenderingContext *context = nullptr;
-  GLuint buffer;
-  napi_status nstatus = GetContextUint32Params(env, info, &context, 1, &buffer);
+  nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glDeleteBuffers(1, &buffer);
+  GLuint program;
+  nstatus = GetObjectArg(env, args[0], kGLObjectProgram, &program);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  // TODO(kreeger): Keep track of global objects.
-  context->alloc_count_--;
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
+  // Without a list of names the layout covers all active uniforms.
+  std::vector<std::string> names;
+  napi_valuetype names_type = napi_undefined;
+  if (argc > 1) {
+    nstatus = napi_typeof(env, args[1], &names_type);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  }
+  if (names_type != napi_undefined && names_type != napi_null) {
+    ENSURE_VALUE_IS_ARRAY_RETVAL(env, args[1], nullptr);
 
-/* static */
-napi_value WebGLRenderingContext::DeleteFramebuffer(napi_env env,
-                                                    napi_callback_info info) {
-  LOG_CALL("DeleteFramebuffer");
+    uint32_t length;
+    nstatus = napi_get_array_length(env, args[1], &length);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = nullptr;
-  GLuint frame_buffer;
-  napi_status nstatus =
-      GetContextUint32Params(env, info, &context, 1, &frame_buffer);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    names.resize(length);
+    for (uint32_t i = 0; i < length; i++) {
+      napi_value name_value;
+      nstatus = napi_get_element(env, args[1], i, &name_value);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glDeleteFramebuffers(1, &frame_buffer);
+      nstatus = GetShortStringParam(env, name_value, names[i]);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    }
+  }
 
-  // TODO(kreeger): Keep track of global objects.
-  context->alloc_count_--;
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
+  GLProgramCache *program_cache = context->program_cache_;
+  uint32_t handle = program_cache->CreateUniformLayout(program, names);
+  if (handle == 0) {
+    // Program is not linked.
+    return nullptr;
+  }
 
-/* static */
-napi_value WebGLRenderingContext::DeleteProgram(napi_env env,
-                                                napi_callback_info info) {
-  LOG_CALL("DeleteProgram");
+  const GLProgramCache::UniformLayout *layout =
+      program_cache->GetUniformLayout(program, handle);
+  const GLProgramCache::Program *program_info =
+      program_cache->GetProgram(program);
 
-  WebGLRenderingContext *context = nullptr;
-  GLuint program;
-  napi_status nstatus =
-      GetContextUint32Params(env, info, &context, 1, &program);
+  napi_value uniforms_value;
+  nstatus = napi_create_array_with_length(env, layout->entries.size(),
+                                          &uniforms_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glDeleteProgram(program);
-
-  // TODO(kreeger): Keep track of global objects.
-  context->alloc_count_--;
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
+  for (size_t i = 0; i < layout->entries.size(); i++) {
+    const GLProgramCache::UniformLayoutEntry &entry = layout->entries[i];
+    const GLProgramCache::Variable &uniform =
+        program_info->uniforms[entry.uniform];
 
-/* static */
-napi_value WebGLRenderingContext::DeleteRenderbuffer(napi_env env,
-                                                     napi_callback_info info) {
-  LOG_CALL("DeleteRenderbuffer");
+    napi_value uniform_value =
+        CreateActiveInfo(env, uniform.name.c_str(), uniform.name.size(),
+                         uniform.size, uniform.type);
+    if (uniform_value == nullptr) {
+      return nullptr;
+    }
 
-  WebGLRenderingContext *context = nullptr;
-  GLuint renderbuffer;
-  napi_status nstatus =
-      GetContextUint32Params(env, info, &context, 1, &renderbuffer);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    napi_value offset_value;
+    nstatus = napi_create_uint32(env, entry.offset, &offset_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    nstatus =
+        napi_set_named_property(env, uniform_value, "offset", offset_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glDeleteRenderbuffers(1, &renderbuffer);
+    nstatus = napi_set_element(env, uniforms_value, i, uniform_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  }
 
-  // TODO(kreeger): Keep track of global objects.
-  context->alloc_count_--;
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
+  napi_value layout_value;
+  nstatus = napi_create_object(env, &layout_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-/* static */
-napi_value WebGLRenderingContext::DeleteShader(napi_env env,
-                                               napi_callback_info info) {
-  LOG_CALL("DeleteShader");
+  napi_value handle_value;
+  nstatus = napi_create_uint32(env, handle, &handle_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  nstatus = napi_set_named_property(env, layout_value, "handle", handle_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = nullptr;
-  GLuint shader;
-  napi_status nstatus = GetContextUint32Params(env, info, &context, 1, &shader);
+  napi_value byte_length_value;
+  nstatus = napi_create_uint32(env, layout->byte_length, &byte_length_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  nstatus = napi_set_named_property(env, layout_value, "byteLength",
+                                    byte_length_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glDeleteShader(shader);
+  nstatus =
+      napi_set_named_property(env, layout_value, "uniforms", uniforms_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  // TODO(kreeger): Keep track of global objects.
-  context->alloc_count_--;
 #if DEBUG
   context->CheckForErrors();
 #endif
-  return nullptr;
+  return layout_value;
 }
 
 /* static */
-napi_value WebGLRenderingContext::DeleteTexture(napi_env env,
-                                                napi_callback_info info) {
-  LOG_CALL("DeleteTexture");
+napi_value WebGLRenderingContext::DeleteBuffer(napi_env env,
+                                               napi_callback_info info) {
+  LOG_CALL("DeleteBuffer");
 
   WebGLRenderingContext *context = nullptr;
-  GLuint texture;
-  napi_status nstatus =
-      GetContextUint32Params(env, info, &context, 1, &texture);
+  GLuint buffer;
+  napi_status nstatus = GetContextObjectParam(env, info, &context,
+                                              kGLObjectBuffer, &buffer);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glDeleteTextures(1, &texture);
+  context->object_registry_->Delete(kGLObjectBuffer, buffer);
 
-  // TODO(kreeger): Keep track of global objects.
-  context->alloc_count_--;
 #if DEBUG
   context->CheckForErrors();
 #endif
@@ -2138,16 +2922,17 @@ napi_value WebGLRenderingContext::DeleteTexture(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::DepthFunc(napi_env env,
-                                            napi_callback_info info) {
-  LOG_CALL("DepthFunc");
+napi_value WebGLRenderingContext::DeleteFramebuffer(napi_env env,
+                                                    napi_callback_info info) {
+  LOG_CALL("DeleteFramebuffer");
 
   WebGLRenderingContext *context = nullptr;
-  GLenum func;
-  napi_status nstatus = GetContextUint32Params(env, info, &context, 1, &func);
+  GLuint frame_buffer;
+  napi_status nstatus = GetContextObjectParam(
+      env, info, &context, kGLObjectFramebuffer, &frame_buffer);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glDepthFunc(func);
+  context->object_registry_->Delete(kGLObjectFramebuffer, frame_buffer);
 
 #if DEBUG
   context->CheckForErrors();
@@ -2156,16 +2941,17 @@ napi_value WebGLRenderingContext::DepthFunc(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::DepthMask(napi_env env,
-                                            napi_callback_info info) {
-  LOG_CALL("DepthMask");
+napi_value WebGLRenderingContext::DeleteProgram(napi_env env,
+                                                napi_callback_info info) {
+  LOG_CALL("DeleteProgram");
 
   WebGLRenderingContext *context = nullptr;
-  bool flag;
-  napi_status nstatus = GetContextBoolParams(env, info, &context, 1, &flag);
+  GLuint program;
+  napi_status nstatus = GetContextObjectParam(env, info, &context,
+                                              kGLObjectProgram, &program);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glDepthMask(static_cast<GLboolean>(flag));
+  context->object_registry_->Delete(kGLObjectProgram, program);
 
 #if DEBUG
   context->CheckForErrors();
@@ -2174,17 +2960,17 @@ napi_value WebGLRenderingContext::DepthMask(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::DepthRange(napi_env env,
-                                             napi_callback_info info) {
-  LOG_CALL("DepthRange");
+napi_value WebGLRenderingContext::DeleteRenderbuffer(napi_env env,
+                                                     napi_callback_info info) {
+  LOG_CALL("DeleteRenderbuffer");
 
   WebGLRenderingContext *context = nullptr;
-  double args[2];
-  napi_status nstatus = GetContextDoubleParams(env, info, &context, 2, args);
+  GLuint renderbuffer;
+  napi_status nstatus = GetContextObjectParam(
+      env, info, &context, kGLObjectRenderbuffer, &renderbuffer);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glDepthRangef(static_cast<GLfloat>(args[0]),
-                                             static_cast<GLfloat>(args[1]));
+  context->object_registry_->Delete(kGLObjectRenderbuffer, renderbuffer);
 
 #if DEBUG
   context->CheckForErrors();
@@ -2193,16 +2979,17 @@ napi_value WebGLRenderingContext::DepthRange(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::DetachShader(napi_env env,
+napi_value WebGLRenderingContext::DeleteShader(napi_env env,
                                                napi_callback_info info) {
-  LOG_CALL("DetachShader");
+  LOG_CALL("DeleteShader");
 
   WebGLRenderingContext *context = nullptr;
-  GLuint args[2];
-  napi_status nstatus = GetContextUint32Params(env, info, &context, 2, args);
+  GLuint shader;
+  napi_status nstatus = GetContextObjectParam(env, info, &context,
+                                              kGLObjectShader, &shader);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glDetachShader(args[0], args[1]);
+  context->object_registry_->Delete(kGLObjectShader, shader);
 
 #if DEBUG
   context->CheckForErrors();
@@ -2211,16 +2998,16 @@ napi_value WebGLRenderingContext::DetachShader(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::Disable(napi_env env,
-                                          napi_callback_info info) {
-  LOG_CALL("Disable");
+napi_value WebGLRenderingContext::DeleteSync(napi_env env,
+                                             napi_callback_info info) {
+  LOG_CALL("DeleteSync");
 
   WebGLRenderingContext *context = nullptr;
-  GLenum cap;
-  napi_status nstatus = GetContextUint32Params(env, info, &context, 1, &cap);
+  uint32_t handle;
+  napi_status nstatus = GetContextParam(env, info, &context, &handle);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glDisable(cap);
+  context->object_registry_->Delete(kGLObjectSync, handle);
 
 #if DEBUG
   context->CheckForErrors();
@@ -2229,16 +3016,17 @@ napi_value WebGLRenderingContext::Disable(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::DisableVertexAttribArray(
-    napi_env env, napi_callback_info info) {
-  LOG_CALL("DisableVertexAttribArray");
+napi_value WebGLRenderingContext::DeleteTexture(napi_env env,
+                                                napi_callback_info info) {
+  LOG_CALL("DeleteTexture");
 
   WebGLRenderingContext *context = nullptr;
-  GLuint index;
-  napi_status nstatus = GetContextUint32Params(env, info, &context, 1, &index);
+  GLuint texture;
+  napi_status nstatus = GetContextObjectParam(env, info, &context,
+                                              kGLObjectTexture, &texture);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glDisableVertexAttribArray(index);
+  context->object_registry_->Delete(kGLObjectTexture, texture);
 
 #if DEBUG
   context->CheckForErrors();
@@ -2247,40 +3035,41 @@ napi_value WebGLRenderingContext::DisableVertexAttribArray(
 }
 
 /* static */
-napi_value WebGLRenderingContext::DrawArrays(napi_env env,
-                                             napi_callback_info info) {
-  LOG_CALL("DrawArrays");
-
+napi_value WebGLRenderingContext::ExecuteCommands(napi_env env,
+                                                  napi_callback_info info) {
+  LOG_CALL("ExecuteCommands");
   napi_status nstatus;
 
-  size_t argc = 3;
-  napi_value args[3];
+  size_t argc = 2;
+  napi_value args[2];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 3, nullptr);
-
-  for (size_t i = 0; i < 3; i++) {
-    ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[i], nullptr);
-  }
+  ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
 
   WebGLRenderingContext *context = nullptr;
   nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLenum mode;
-  nstatus = napi_get_value_uint32(env, args[0], &mode);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLint first;
-  nstatus = napi_get_value_int32(env, args[1], &first);
+  const uint32_t *words;
+  size_t word_count;
+  nstatus = GetCommandBufferArg(env, args[0], &words, &word_count);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLsizei count;
-  nstatus = napi_get_value_int32(env, args[2], &count);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
+  uint32_t command_count;
+  nstatus = napi_get_value_uint32(env, args[1], &command_count);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glDrawArrays(mode, first, count);
+  uint32_t error_index = 0;
+  if (!ExecuteCommandBuffer(context->state_cache_, context->program_cache_,
+                            words, word_count, command_count,
+                            &error_index)) {
+    std::string message = "Invalid command at index " +
+                          std::to_string(error_index) + " in command buffer";
+    NAPI_THROW_ERROR(env, message.c_str());
+    return nullptr;
+  }
 
 #if DEBUG
   context->CheckForErrors();
@@ -2289,87 +3078,60 @@ napi_value WebGLRenderingContext::DrawArrays(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::DrawElements(napi_env env,
-                                               napi_callback_info info) {
-  LOG_CALL("DrawElements");
-
+napi_value WebGLRenderingContext::ExecuteCommandsAsync(
+    napi_env env, napi_callback_info info) {
+  LOG_CALL("ExecuteCommandsAsync");
   napi_status nstatus;
 
-  size_t argc = 4;
-  napi_value args[4];
+  size_t argc = 2;
+  napi_value args[2];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 4, nullptr);
-
-  for (size_t i = 0; i < 4; i++) {
-    ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[i], nullptr);
-  }
+  ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
 
   WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLenum mode;
-  nstatus = napi_get_value_uint32(env, args[0], &mode);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLsizei count;
-  nstatus = napi_get_value_int32(env, args[1], &count);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLenum type;
-  nstatus = napi_get_value_uint32(env, args[2], &type);
+  GLCommandThread *command_thread = nullptr;
+  nstatus =
+      UnwrapCommandThreadContext(env, js_this, &context, &command_thread);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  uint32_t offset;
-  nstatus = napi_get_value_uint32(env, args[3], &offset);
+  const uint32_t *words;
+  size_t word_count;
+  nstatus = GetCommandBufferArg(env, args[0], &words, &word_count);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glDrawElements(
-      mode, count, type, reinterpret_cast<GLvoid *>(offset));
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::Enable(napi_env env,
-                                         napi_callback_info info) {
-  LOG_CALL("Enable");
-
-  WebGLRenderingContext *context = nullptr;
-  GLenum cap;
-  napi_status nstatus = GetContextUint32Params(env, info, &context, 1, &cap);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
+  uint32_t command_count;
+  nstatus = napi_get_value_uint32(env, args[1], &command_count);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glEnable(cap);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::EnableVertexAttribArray(
-    napi_env env, napi_callback_info info) {
-  LOG_CALL("EnableVertexAttribArray");
-
-  WebGLRenderingContext *context = nullptr;
-  GLenum index;
-  napi_status nstatus = GetContextUint32Params(env, info, &context, 1, &index);
+  napi_deferred deferred;
+  napi_value promise_value;
+  nstatus = napi_create_promise(env, &deferred, &promise_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glEnableVertexAttribArray(index);
+  // The stream is copied, so the caller can reuse its buffer right away.
+  nstatus = command_thread->Submit(
+      words, word_count, command_count,
+      [deferred](napi_env env, bool ok, uint32_t error_index) {
+        if (!ok) {
+          std::string message = "Invalid command at index " +
+                                std::to_string(error_index) +
+                                " in command buffer";
+          RejectWithError(env, deferred, message.c_str());
+          return;
+        }
+        napi_value undefined_value;
+        napi_status nstatus = napi_get_undefined(env, &undefined_value);
+        ENSURE_NAPI_OK(env, nstatus);
+        napi_resolve_deferred(env, deferred, undefined_value);
+      });
+  if (nstatus != napi_ok) {
+    RejectWithError(env, deferred, "Could not queue commands");
+  }
 
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
+  return promise_value;
 }
 
 /* static */
@@ -2380,13 +3142,18 @@ napi_value WebGLRenderingContext::FenceSynce(napi_env env,
   WebGLRenderingContext *context = nullptr;
 
   uint32_t args[2];
-  napi_status nstatus = GetContextUint32Params(env, info, &context, 2, args);
+  napi_status nstatus = GetContextParams(env, info, &context, args);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   GLsync sync = context->eglContextWrapper_->glFenceSync(args[0], args[1]);
+  uint32_t handle = sync ? context->sync_pool_->Add(sync) : 0;
 
   napi_value sync_value;
-  nstatus = WrapGLsync(env, sync, context->eglContextWrapper_, &sync_value);
+  if (handle == 0) {
+    nstatus = napi_get_null(env, &sync_value);
+  } else {
+    nstatus = context->CreateObjectValue(kGLObjectSync, handle, &sync_value);
+  }
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
 #if DEBUG
@@ -2396,42 +3163,39 @@ napi_value WebGLRenderingContext::FenceSynce(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::Finish(napi_env env,
-                                         napi_callback_info info) {
-  LOG_CALL("Finish");
+napi_value WebGLRenderingContext::FinishAsync(napi_env env,
+                                              napi_callback_info info) {
+  LOG_CALL("FinishAsync");
+  napi_status nstatus;
 
-  WebGLRenderingContext *context = nullptr;
-  napi_status nstatus = GetContext(env, info, &context);
+  size_t argc = 0;
+  napi_value js_this;
+  nstatus = napi_get_cb_info(env, info, &argc, nullptr, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glFinish();
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::GetError(napi_env env,
-                                           napi_callback_info info) {
-  LOG_CALL("GetError");
-  napi_status nstatus;
-
   WebGLRenderingContext *context = nullptr;
-  nstatus = GetContext(env, info, &context);
+  GLCommandThread *command_thread = nullptr;
+  nstatus =
+      UnwrapCommandThreadContext(env, js_this, &context, &command_thread);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLenum error = context->eglContextWrapper_->glGetError();
-
-  napi_value error_value;
+  napi_deferred deferred;
+  napi_value promise_value;
+  nstatus = napi_create_promise(env, &deferred, &promise_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  nstatus = napi_create_uint32(env, error, &error_value);
 
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return error_value;
+  nstatus = command_thread->Finish(
+      [deferred](napi_env env, bool ok, uint32_t error_index) {
+        napi_value undefined_value;
+        napi_status nstatus = napi_get_undefined(env, &undefined_value);
+        ENSURE_NAPI_OK(env, nstatus);
+        napi_resolve_deferred(env, deferred, undefined_value);
+      });
+  if (nstatus != napi_ok) {
+    RejectWithError(env, deferred, "Could not queue finish");
+  }
+
+  return promise_value;
 }
 
 /* static */
@@ -2442,22 +3206,65 @@ napi_value WebGLRenderingContext::GetFramebufferAttachmentParameter(
 
   GLenum args[3];
   WebGLRenderingContext *context = nullptr;
-  nstatus = GetContextUint32Params(env, info, &context, 3, args);
+  nstatus = GetContextParams(env, info, &context, args);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
+  EGLContextWrapper *egl = context->eglContextWrapper_;
   GLint params;
-  context->eglContextWrapper_->glGetFramebufferAttachmentParameteriv(
-      args[0], args[1], args[2], &params);
+  egl->glGetFramebufferAttachmentParameteriv(args[0], args[1], args[2],
+                                             &params);
+
+  // The attached object is returned as the same wrapper create*() returned,
+  // its type depends on what is attached.
+  GLint object_type = GL_NONE;
+  if (context->wrap_objects_ &&
+      args[2] == GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME) {
+    egl->glGetFramebufferAttachmentParameteriv(
+        args[0], args[1], GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, &object_type);
+  }
 #if DEBUG
   context->CheckForErrors();
 #endif
 
   napi_value params_value;
-  nstatus = napi_create_int32(env, params, &params_value);
+  if (object_type == GL_TEXTURE || object_type == GL_RENDERBUFFER) {
+    nstatus = context->object_registry_->GetWrapper(
+        env,
+        object_type == GL_TEXTURE ? kGLObjectTexture : kGLObjectRenderbuffer,
+        static_cast<GLuint>(params), &params_value);
+  } else {
+    nstatus = napi_create_int32(env, params, &params_value);
+  }
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   return params_value;
 }
 
+/* static */
+napi_value WebGLRenderingContext::GetError(napi_env env,
+                                           napi_callback_info info) {
+  LOG_CALL("GetError");
+
+  WebGLRenderingContext *context = nullptr;
+  napi_status nstatus = GetContext(env, info, &context);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  GLenum error;
+  std::vector<GLenum> &pending_errors = context->pending_errors_;
+  if (!pending_errors.empty()) {
+    error = pending_errors.front();
+    pending_errors.erase(pending_errors.begin());
+  } else {
+    error = context->eglContextWrapper_->glGetError();
+  }
+
+  napi_value error_value;
+  nstatus = napi_create_uint32(env, error, &error_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  return error_value;
+}
+
 /* static */
 napi_value WebGLRenderingContext::GetExtension(napi_env env,
                                                napi_callback_info info) {
@@ -2519,6 +3326,10 @@ napi_value WebGLRenderingContext::GetExtension(napi_env env,
              EXTTextureFilterAnisotropicExtension::IsSupported(egl_ctx)) {
     nstatus = EXTTextureFilterAnisotropicExtension::NewInstance(
         env, &webgl_extension, egl_ctx);
+  } else if (strcmp(name, "KHR_parallel_shader_compile") == 0 &&
+             KHRParallelShaderCompileExtension::IsSupported(egl_ctx)) {
+    nstatus = KHRParallelShaderCompileExtension::NewInstance(
+        env, &webgl_extension, egl_ctx);
   } else if (strcmp(name, "OES_element_index_uint") == 0 &&
              OESElementIndexUintExtension::IsSupported(egl_ctx)) {
     nstatus = OESElementIndexUintExtension::NewInstance(env, &webgl_extension,
@@ -2568,220 +3379,214 @@ napi_value WebGLRenderingContext::GetExtension(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::GetParameter(napi_env env,
-                                               napi_callback_info info) {
-  LOG_CALL("GetParameter");
-  napi_status nstatus;
+napi_value WebGLRenderingContext::GetMemoryInfo(napi_env env,
+                                                napi_callback_info info) {
+  LOG_CALL("GetMemoryInfo");
 
-  GLenum name;
   WebGLRenderingContext *context = nullptr;
-  nstatus = GetContextUint32Params(env, info, &context, 1, &name);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  switch (name) {
-    case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
-    case GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS:
-    case GL_MAX_CUBE_MAP_TEXTURE_SIZE:
-    case GL_MAX_VERTEX_ATTRIBS:
-    case GL_MAX_VERTEX_UNIFORM_VECTORS:
-    case GL_MAX_VARYING_VECTORS:
-    case GL_MAX_FRAGMENT_UNIFORM_VECTORS:
-    case GL_MAX_TEXTURE_SIZE:
-    case GL_MAX_TEXTURE_IMAGE_UNITS:
-      GLint params;
-      context->eglContextWrapper_->glGetIntegerv(name, &params);
-
-      napi_value params_value;
-      nstatus = napi_create_int32(env, params, &params_value);
-      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-      return params_value;
-
-    case GL_VERSION: {
-      const GLubyte *str = context->eglContextWrapper_->glGetString(name);
-      if (str) {
-        const char *str_c_str = reinterpret_cast<const char *>(str);
-        napi_value str_value;
-        nstatus = napi_create_string_utf8(env, str_c_str, strlen(str_c_str),
-                                          &str_value);
-        ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  napi_status nstatus;
+  nstatus = GetContext(env, info, &context);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-        return str_value;
-      }
-      break;
-    }
+  GLMemoryTracker *tracker = context->memory_tracker_;
 
-    case GL_ARRAY_BUFFER_BINDING: {
-      GLint previous_buffer = 0;
-      context->eglContextWrapper_->glGetIntegerv(GL_ARRAY_BUFFER_BINDING,
-                                                 &previous_buffer);
+  napi_value info_value;
+  nstatus = napi_create_object(env, &info_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-      napi_value previous_buffer_value;
-      nstatus = napi_create_int32(env, previous_buffer, &previous_buffer_value);
-      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  const std::pair<const char *, GLMemoryTracker::ObjectType> types[] = {
+      {"buffers", GLMemoryTracker::kBuffer},
+      {"textures", GLMemoryTracker::kTexture},
+      {"renderbuffers", GLMemoryTracker::kRenderbuffer},
+  };
+  for (const auto &type : types) {
+    const GLMemoryTracker::Usage &usage = tracker->usage(type.second);
 
-      return previous_buffer_value;
-    }
+    napi_value usage_value;
+    nstatus = napi_create_object(env, &usage_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-    case GL_RENDERER: {
-      const GLubyte *str = context->eglContextWrapper_->glGetString(name);
-      if (str) {
-        const char *str_c_str = reinterpret_cast<const char *>(str);
-        napi_value str_value;
-        nstatus = napi_create_string_utf8(env, str_c_str, strlen(str_c_str),
-                                          &str_value);
-        ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    napi_value count_value;
+    nstatus = napi_create_double(env, static_cast<double>(usage.count),
+                                 &count_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    nstatus = napi_set_named_property(env, usage_value, "count", count_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-        return str_value;
-      }
-      break;
-    }
+    napi_value bytes_value;
+    nstatus = napi_create_double(env, static_cast<double>(usage.bytes),
+                                 &bytes_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    nstatus = napi_set_named_property(env, usage_value, "bytes", bytes_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-      // TODO(kreeger): Add more of these
+    nstatus = napi_set_named_property(env, info_value, type.first, usage_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  }
 
+  napi_value total_value;
+  nstatus = napi_create_double(
+      env, static_cast<double>(tracker->total_bytes()), &total_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  nstatus = napi_set_named_property(env, info_value, "totalBytes", total_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  return info_value;
+}
+
+// Returns true and sets |type| if |pname| queries the binding of an object
+// that create*() wraps, e.g. TEXTURE_BINDING_2D.
+static bool BindingObjectType(GLenum pname, GLObjectType *type) {
+  switch (pname) {
+    case GL_ARRAY_BUFFER_BINDING:
+    case GL_COPY_READ_BUFFER_BINDING:
+    case GL_COPY_WRITE_BUFFER_BINDING:
+    case GL_ELEMENT_ARRAY_BUFFER_BINDING:
+    case GL_PIXEL_PACK_BUFFER_BINDING:
+    case GL_PIXEL_UNPACK_BUFFER_BINDING:
+    case GL_TRANSFORM_FEEDBACK_BUFFER_BINDING:
+    case GL_UNIFORM_BUFFER_BINDING:
+      *type = kGLObjectBuffer;
+      return true;
+    case GL_FRAMEBUFFER_BINDING:
+    case GL_READ_FRAMEBUFFER_BINDING:
+      *type = kGLObjectFramebuffer;
+      return true;
+    case GL_CURRENT_PROGRAM:
+      *type = kGLObjectProgram;
+      return true;
+    case GL_RENDERBUFFER_BINDING:
+      *type = kGLObjectRenderbuffer;
+      return true;
+    case GL_TEXTURE_BINDING_2D:
+    case GL_TEXTURE_BINDING_2D_ARRAY:
+    case GL_TEXTURE_BINDING_3D:
+    case GL_TEXTURE_BINDING_CUBE_MAP:
+      *type = kGLObjectTexture;
+      return true;
     default:
-      NAPI_THROW_ERROR(env, "Unsupported getParameter() option");
+      return false;
   }
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::Flush(napi_env env, napi_callback_info info) {
-  LOG_CALL("Flush");
-
-  WebGLRenderingContext *context = nullptr;
-  napi_status nstatus = GetContext(env, info, &context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glFlush();
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::FramebufferRenderbuffer(
-    napi_env env, napi_callback_info info) {
-  LOG_CALL("FramebufferRenderbuffer");
-
-  napi_status nstatus;
-
-  uint32_t args[4];
-  WebGLRenderingContext *context = nullptr;
-  nstatus = GetContextUint32Params(env, info, &context, 4, args);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glFramebufferRenderbuffer(args[0], args[1],
-                                                         args[2], args[3]);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
 }
 
 /* static */
-napi_value WebGLRenderingContext::FramebufferTexture2D(
-    napi_env env, napi_callback_info info) {
-  LOG_CALL("FramebufferTexture2D");
+napi_value WebGLRenderingContext::GetParameter(napi_env env,
+                                               napi_callback_info info) {
+  LOG_CALL("GetParameter");
   napi_status nstatus;
 
-  size_t argc = 5;
-  napi_value args[5];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 5, nullptr);
-
+  GLenum name;
   WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
+  nstatus = GetContextParam(env, info, &context, &name);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
-
-  // The texture can be null
-  napi_valuetype value_type;
-  nstatus = napi_typeof(env, args[3], &value_type);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  if (value_type != napi_null) {
-    ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[3], nullptr);
+  const ParameterInfo *param = FindParameterInfo(name);
+  if (!param || (param->webgl2 && !context->limits_.webgl2())) {
+    NAPI_THROW_ERROR(env, "Unsupported getParameter() option");
+    return nullptr;
   }
 
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[4], nullptr);
-
-  GLenum target;
-  nstatus = napi_get_value_uint32(env, args[0], &target);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLenum attachment;
-  nstatus = napi_get_value_uint32(env, args[1], &attachment);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  napi_value result_value = nullptr;
+  switch (param->type) {
+    case kParameterBoolean:
+    case kParameterBooleanArray: {
+      GLboolean values[4];
+      context->GetParameterValues(*param, values);
 
-  GLenum textarget;
-  nstatus = napi_get_value_uint32(env, args[2], &textarget);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+      if (param->type == kParameterBoolean) {
+        nstatus = napi_get_boolean(env, values[0], &result_value);
+        ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+        break;
+      }
 
-  GLuint texture = 0;
-  if (value_type != napi_null) {
-    nstatus = napi_get_value_uint32(env, args[3], &texture);
-    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  }
+      nstatus = napi_create_array_with_length(env, param->count, &result_value);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+      for (uint32_t i = 0; i < param->count; ++i) {
+        napi_value value;
+        nstatus = napi_get_boolean(env, values[i], &value);
+        ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+        nstatus = napi_set_element(env, result_value, i, value);
+        ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+      }
+      break;
+    }
 
-  GLint level;
-  nstatus = napi_get_value_int32(env, args[4], &level);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    case kParameterFloat:
+    case kParameterFloatArray: {
+      GLfloat values[4];
+      context->GetParameterValues(*param, values);
 
-  context->eglContextWrapper_->glFramebufferTexture2D(
-      target, attachment, textarget, texture, level);
+      if (param->type == kParameterFloat) {
+        nstatus = napi_create_double(env, values[0], &result_value);
+        ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+        break;
+      }
 
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
+      nstatus = CreateTypedArray(env, napi_float32_array, param->count,
+                                 values, &result_value);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+      break;
+    }
 
-/* static */
-napi_value WebGLRenderingContext::FrontFace(napi_env env,
-                                            napi_callback_info info) {
-  LOG_CALL("FrontFace");
+    case kParameterInteger:
+    case kParameterIntegerArray: {
+      GLint64 values[4];
+      context->GetParameterValues(*param, values);
 
-  WebGLRenderingContext *context = nullptr;
-  GLenum mode;
-  napi_status nstatus = GetContextUint32Params(env, info, &context, 1, &mode);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+      GLObjectType object_type;
+      if (context->wrap_objects_ && BindingObjectType(name, &object_type)) {
+        nstatus = context->object_registry_->GetWrapper(
+            env, object_type, static_cast<GLuint>(values[0]), &result_value);
+        ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+        break;
+      }
 
-  context->eglContextWrapper_->glFrontFace(mode);
+      if (param->type == kParameterInteger) {
+        nstatus = napi_create_int64(env, values[0], &result_value);
+        ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+        break;
+      }
 
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
+      GLint int_values[4];
+      for (size_t i = 0; i < param->count; ++i) {
+        int_values[i] = static_cast<GLint>(values[i]);
+      }
+      nstatus = CreateTypedArray(env, napi_int32_array, param->count,
+                                 int_values, &result_value);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+      break;
+    }
 
-/* static */
-napi_value WebGLRenderingContext::GenerateMipmap(napi_env env,
-                                                 napi_callback_info info) {
-  LOG_CALL("GenerateMipmap");
+    case kParameterString: {
+      const std::string *str = context->limits_.GetString(name);
+      nstatus = napi_create_string_utf8(env, str->c_str(), str->size(),
+                                        &result_value);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+      break;
+    }
 
-  WebGLRenderingContext *context = nullptr;
-  GLenum target;
-  napi_status nstatus = GetContextUint32Params(env, info, &context, 1, &target);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    case kParameterCompressedFormats: {
+      // Depends on the enabled extensions, so this is always queried.
+      GLint count = 0;
+      context->eglContextWrapper_->glGetIntegerv(
+          GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+      std::vector<GLint> formats(count);
+      if (count > 0) {
+        context->eglContextWrapper_->glGetIntegerv(
+            GL_COMPRESSED_TEXTURE_FORMATS, formats.data());
+      }
 
-  context->eglContextWrapper_->glGenerateMipmap(target);
+      nstatus = CreateTypedArray(env, napi_uint32_array, count,
+                                 formats.data(), &result_value);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+      break;
+    }
+  }
 
 #if DEBUG
   context->CheckForErrors();
 #endif
-  return nullptr;
+  return result_value;
 }
 
 /* static */
@@ -2790,9 +3595,9 @@ napi_value WebGLRenderingContext::GetAttachedShaders(napi_env env,
   LOG_CALL("GetAttachedShaders");
 
   WebGLRenderingContext *context = nullptr;
-  GLenum program;
-  napi_status nstatus =
-      GetContextUint32Params(env, info, &context, 1, &program);
+  GLuint program;
+  napi_status nstatus = GetContextObjectParam(env, info, &context,
+                                              kGLObjectProgram, &program);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   GLint attached_shader_count;
@@ -2817,7 +3622,12 @@ napi_value WebGLRenderingContext::GetAttachedShaders(napi_env env,
 
   for (GLsizei i = 0; i < count; i++) {
     napi_value shader_value;
-    nstatus = napi_create_uint32(env, shaders[i], &shader_value);
+    if (context->wrap_objects_) {
+      nstatus = context->object_registry_->GetWrapper(
+          env, kGLObjectShader, shaders[i], &shader_value);
+    } else {
+      nstatus = napi_create_uint32(env, shaders[i], &shader_value);
+    }
     ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
     nstatus = napi_set_element(env, shaders_array_value, i, shader_value);
@@ -2836,56 +3646,41 @@ napi_value WebGLRenderingContext::GetActiveAttrib(napi_env env,
 
   WebGLRenderingContext *context = nullptr;
   GLuint args[2];
-  nstatus = GetContextUint32Params(env, info, &context, 2, args);
+  nstatus = GetContextObjectParams(env, info, &context, kGLObjectProgram, args);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLint max_attr_length;
+  GLProgramCache::Program *program =
+      context->program_cache_->GetProgram(args[0]);
+  if (program && args[1] < program->attribs.size()) {
+    const GLProgramCache::Variable &attrib = program->attribs[args[1]];
+    return CreateActiveInfo(env, attrib.name.c_str(), attrib.name.size(),
+                            attrib.size, attrib.type);
+  }
+
+  // Not linked or out of range - let GL report the error.
+  GLint max_attrib_length;
   context->eglContextWrapper_->glGetProgramiv(
-      args[0], GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &max_attr_length);
+      args[0], GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &max_attrib_length);
 
   GLsizei length = 0;
   GLsizei size;
   GLenum type;
 
-  AutoBuffer<char> buffer(max_attr_length);
-  context->eglContextWrapper_->glGetActiveAttrib(
-      args[0], args[1], max_attr_length, &length, &size, &type, buffer.get());
+  AutoBuffer<char> buffer(max_attrib_length);
+  context->eglContextWrapper_->glGetActiveAttrib(args[0], args[1],
+                                                 max_attrib_length, &length,
+                                                 &size, &type, buffer.get());
 
 #if DEBUG
   context->CheckForErrors();
 #endif
 
   if (length <= 0) {
-    // Attribute not found - return nullptr.
+    // Attrib not found - return nullptr.
     return nullptr;
   }
 
-  napi_value name_value;
-  nstatus = napi_create_string_utf8(env, buffer.get(), length, &name_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  napi_value size_value;
-  nstatus = napi_create_int32(env, size, &size_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  napi_value type_value;
-  nstatus = napi_create_uint32(env, type, &type_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  napi_value active_info_value;
-  nstatus = napi_create_object(env, &active_info_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  nstatus = napi_set_named_property(env, active_info_value, "name", name_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  nstatus = napi_set_named_property(env, active_info_value, "size", size_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  nstatus = napi_set_named_property(env, active_info_value, "type", type_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  return active_info_value;
+  return CreateActiveInfo(env, buffer.get(), length, size, type);
 }
 
 /* static */
@@ -2894,28 +3689,21 @@ napi_value WebGLRenderingContext::GetAttribLocation(napi_env env,
   LOG_CALL("GetAttribLocation");
   napi_status nstatus;
 
-  size_t argc = 2;
-  napi_value args[2];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
-
   WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
+  napi_value args[2];
+  nstatus = GetContextArgs(env, info, &context, 2, args);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
   GLuint program;
-  nstatus = napi_get_value_uint32(env, args[0], &program);
+  nstatus = GetObjectArg(env, args[0], kGLObjectProgram, &program);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   std::string attrib_name;
-  nstatus = GetStringParam(env, args[1], attrib_name);
+  nstatus = GetShortStringParam(env, args[1], attrib_name);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLint location = context->eglContextWrapper_->glGetAttribLocation(
-      program, attrib_name.c_str());
+  GLint location =
+      context->program_cache_->GetAttribLocation(program, attrib_name);
 
   napi_value location_value;
   nstatus = napi_create_int32(env, location, &location_value);
@@ -2936,9 +3724,18 @@ napi_value WebGLRenderingContext::GetActiveUniform(napi_env env,
 
   WebGLRenderingContext *context = nullptr;
   GLuint args[2];
-  nstatus = GetContextUint32Params(env, info, &context, 2, args);
+  nstatus = GetContextObjectParams(env, info, &context, kGLObjectProgram, args);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
+  GLProgramCache::Program *program =
+      context->program_cache_->GetProgram(args[0]);
+  if (program && args[1] < program->uniforms.size()) {
+    const GLProgramCache::Variable &uniform = program->uniforms[args[1]];
+    return CreateActiveInfo(env, uniform.name.c_str(), uniform.name.size(),
+                            uniform.size, uniform.type);
+  }
+
+  // Not linked or out of range - let GL report the error.
   GLint max_uniform_length;
   context->eglContextWrapper_->glGetProgramiv(
       args[0], GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_uniform_length);
@@ -2957,36 +3754,11 @@ napi_value WebGLRenderingContext::GetActiveUniform(napi_env env,
 #endif
 
   if (length <= 0) {
-    // Attribute not found - return nullptr.
+    // Uniform not found - return nullptr.
     return nullptr;
   }
 
-  napi_value name_value;
-  nstatus = napi_create_string_utf8(env, buffer.get(), length, &name_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  napi_value size_value;
-  nstatus = napi_create_int32(env, size, &size_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  napi_value type_value;
-  nstatus = napi_create_uint32(env, type, &type_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  napi_value active_info_value;
-  nstatus = napi_create_object(env, &active_info_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  nstatus = napi_set_named_property(env, active_info_value, "name", name_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  nstatus = napi_set_named_property(env, active_info_value, "size", size_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  nstatus = napi_set_named_property(env, active_info_value, "type", type_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  return active_info_value;
+  return CreateActiveInfo(env, buffer.get(), length, size, type);
 }
 
 /* static */
@@ -2997,7 +3769,7 @@ napi_value WebGLRenderingContext::GetBufferParameter(napi_env env,
 
   GLenum args[2];
   WebGLRenderingContext *context = nullptr;
-  nstatus = GetContextUint32Params(env, info, &context, 2, args);
+  nstatus = GetContextParams(env, info, &context, args);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   GLint params;
@@ -3017,15 +3789,18 @@ napi_value WebGLRenderingContext::GetBufferParameter(napi_env env,
 /* static */
 napi_value WebGLRenderingContext::GetBufferSubData(napi_env env,
                                                    napi_callback_info info) {
+  LOG_CALL("GetBufferSubData");
   napi_status nstatus;
 
-  // TODO(kreeger): This method requires 3 - but takes upto 5 args.
-  size_t argc = 3;
-  napi_value args[3];
+  // Optional dstOffset and length arguments select a range of the view.
+  size_t argc = 5;
+  napi_value args[5];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 3, nullptr);
+  if (argc < 3) {
+    ENSURE_ARGC_RETVAL(env, argc, 3, nullptr);
+  }
 
   ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
   ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
@@ -3039,52 +3814,108 @@ napi_value WebGLRenderingContext::GetBufferSubData(napi_env env,
   nstatus = napi_get_value_uint32(env, args[1], &offset);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
+  WebGLRenderingContext *context = nullptr;
+  nstatus = UnwrapContext(env, js_this, &context);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
   ArrayLikeBuffer alb;
-  nstatus = GetArrayLikeBuffer(env, args[2], &alb);
+  nstatus = GetArrayLikeBuffer(env, args[2], context->scratch_arena_, &alb);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
+  uint32_t dst_offset = 0;
+  nstatus = GetOptionalArg(env, argc, args, 3, &dst_offset);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  uint32_t dst_length = 0;
+  nstatus = GetOptionalArg(env, argc, args, 4, &dst_length);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  nstatus = ApplySourceRange(env, &alb, dst_offset, dst_length);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   void *buffer = context->eglContextWrapper_->glMapBufferRange(
       target, offset, alb.length, GL_MAP_READ_BIT);
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  memcpy(alb.data, buffer, alb.length);
+  if (buffer) {
+    memcpy(alb.data, buffer, alb.length);
+    context->eglContextWrapper_->glUnmapBuffer(target);
+  }
 
-  context->eglContextWrapper_->glUnmapBuffer(target);
 #if DEBUG
   context->CheckForErrors();
 #endif
-
   return nullptr;
 }
 
 /* static */
-napi_value WebGLRenderingContext::GetContextAttributes(
+napi_value WebGLRenderingContext::GetBufferSubDataToArrayBuffer(
     napi_env env, napi_callback_info info) {
-  LOG_CALL("GetContextAttributes");
+  LOG_CALL("GetBufferSubDataToArrayBuffer");
 
   napi_status nstatus;
 
-  napi_value context_attr_value;
-  nstatus = napi_create_object(env, &context_attr_value);
+  WebGLRenderingContext *context = nullptr;
+  uint32_t args[3];
+  nstatus = GetContextParams(env, info, &context, args);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  // TODO(kreeger): These context values should be stored at creation time.
-  napi_value alpha_value;
-  nstatus = napi_get_boolean(env, true, &alpha_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  nstatus =
-      napi_set_named_property(env, context_attr_value, "alpha", alpha_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  GLenum target = args[0];
+  GLintptr offset = args[1];
+  GLsizeiptr length = args[2];
 
-  napi_value antialias_value;
-  nstatus = napi_get_boolean(env, true, &antialias_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  nstatus = napi_set_named_property(env, context_attr_value, "antialias",
+  ReadbackPool *pool = ReadbackPool::Get();
+  size_t capacity;
+  void *data = pool->Allocate(length, &capacity);
+  if (!data) {
+    NAPI_THROW_ERROR(env, "Out of memory");
+    return nullptr;
+  }
+
+  EGLContextWrapper *egl = context->eglContextWrapper_;
+  void *mapped = egl->glMapBufferRange(target, offset, length, GL_MAP_READ_BIT);
+  if (!mapped) {
+    pool->Release(data, capacity);
+#if DEBUG
+    context->CheckForErrors();
+#endif
+    return nullptr;
+  }
+  memcpy(data, mapped, length);
+  egl->glUnmapBuffer(target);
+
+  napi_value arraybuffer_value;
+  nstatus =
+      pool->CreateArrayBuffer(env, data, capacity, length, &arraybuffer_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+#if DEBUG
+  context->CheckForErrors();
+#endif
+  return arraybuffer_value;
+}
+
+/* static */
+napi_value WebGLRenderingContext::GetContextAttributes(
+    napi_env env, napi_callback_info info) {
+  LOG_CALL("GetContextAttributes");
+
+  napi_status nstatus;
+
+  napi_value context_attr_value;
+  nstatus = napi_create_object(env, &context_attr_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  // TODO(kreeger): These context values should be stored at creation time.
+  napi_value alpha_value;
+  nstatus = napi_get_boolean(env, true, &alpha_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  nstatus =
+      napi_set_named_property(env, context_attr_value, "alpha", alpha_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  napi_value antialias_value;
+  nstatus = napi_get_boolean(env, true, &antialias_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  nstatus = napi_set_named_property(env, context_attr_value, "antialias",
                                     antialias_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
@@ -3139,6 +3970,49 @@ napi_value WebGLRenderingContext::GetContextAttributes(
   return stencil_value;
 }
 
+/* static */
+napi_value WebGLRenderingContext::GetProgramBinaryCacheStats(
+    napi_env env, napi_callback_info info) {
+  LOG_CALL("GetProgramBinaryCacheStats");
+
+  WebGLRenderingContext *context = nullptr;
+  napi_status nstatus;
+  nstatus = GetContext(env, info, &context);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  napi_value stats_value;
+  GLProgramBinaryCache *cache = context->program_binary_cache_;
+  if (!cache || !cache->enabled()) {
+    nstatus = napi_get_null(env, &stats_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    return stats_value;
+  }
+
+  nstatus = napi_create_object(env, &stats_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  // Counters are reported as doubles, which are exact up to 2^53.
+  const std::pair<const char *, double> counters[] = {
+      {"hits", static_cast<double>(cache->hits())},
+      {"misses", static_cast<double>(cache->misses())},
+      {"stores", static_cast<double>(cache->stores())},
+      {"evictions", static_cast<double>(cache->evictions())},
+      {"entries", static_cast<double>(cache->entries())},
+      {"bytes", static_cast<double>(cache->bytes())},
+      {"maxBytes", static_cast<double>(cache->max_bytes())},
+  };
+  for (const auto &counter : counters) {
+    napi_value counter_value;
+    nstatus = napi_create_double(env, counter.second, &counter_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    nstatus = napi_set_named_property(env, stats_value, counter.first,
+                                      counter_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  }
+
+  return stats_value;
+}
+
 /* static */
 napi_value WebGLRenderingContext::GetProgramInfoLog(napi_env env,
                                                     napi_callback_info info) {
@@ -3147,7 +4021,8 @@ napi_value WebGLRenderingContext::GetProgramInfoLog(napi_env env,
 
   WebGLRenderingContext *context = nullptr;
   GLuint program;
-  nstatus = GetContextUint32Params(env, info, &context, 1, &program);
+  nstatus = GetContextObjectParam(env, info, &context,
+                                  kGLObjectProgram, &program);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   GLint log_length;
@@ -3176,8 +4051,8 @@ napi_value WebGLRenderingContext::GetProgramParameter(napi_env env,
   napi_status nstatus;
 
   WebGLRenderingContext *context = nullptr;
-  uint32_t args[2];
-  nstatus = GetContextUint32Params(env, info, &context, 2, args);
+  GLuint args[2];
+  nstatus = GetContextObjectParams(env, info, &context, kGLObjectProgram, args);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   GLint param;
@@ -3186,6 +4061,7 @@ napi_value WebGLRenderingContext::GetProgramParameter(napi_env env,
   napi_value param_value;
 
   switch (args[1]) {
+    case GL_COMPLETION_STATUS_KHR:
     case GL_DELETE_STATUS:
     case GL_LINK_STATUS:
     case GL_VALIDATE_STATUS:
@@ -3212,7 +4088,7 @@ napi_value WebGLRenderingContext::GetRenderbufferParameter(
 
   WebGLRenderingContext *context = nullptr;
   GLenum args[2];
-  nstatus = GetContextUint32Params(env, info, &context, 2, args);
+  nstatus = GetContextParams(env, info, &context, args);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   GLint params;
@@ -3237,7 +4113,7 @@ napi_value WebGLRenderingContext::GetShaderPrecisionFormat(
 
   WebGLRenderingContext *context = nullptr;
   GLenum args[2];
-  nstatus = GetContextUint32Params(env, info, &context, 2, args);
+  nstatus = GetContextParams(env, info, &context, args);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   GLint range[2];
@@ -3287,7 +4163,8 @@ napi_value WebGLRenderingContext::GetShaderInfoLog(napi_env env,
 
   WebGLRenderingContext *context = nullptr;
   GLuint shader;
-  nstatus = GetContextUint32Params(env, info, &context, 1, &shader);
+  nstatus = GetContextObjectParam(env, info, &context,
+                                  kGLObjectShader, &shader);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   GLint log_length;
@@ -3316,8 +4193,9 @@ napi_value WebGLRenderingContext::GetShaderParameter(napi_env env,
   napi_status nstatus;
 
   WebGLRenderingContext *context = nullptr;
-  uint32_t arg_values[2];
-  nstatus = GetContextUint32Params(env, info, &context, 2, arg_values);
+  GLuint arg_values[2];
+  nstatus = GetContextObjectParams(env, info, &context,
+                                   kGLObjectShader, arg_values);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   GLint param;
@@ -3327,6 +4205,7 @@ napi_value WebGLRenderingContext::GetShaderParameter(napi_env env,
   napi_value param_value;
 
   switch (arg_values[1]) {
+    case GL_COMPLETION_STATUS_KHR:
     case GL_DELETE_STATUS:
     case GL_COMPILE_STATUS:
       nstatus = napi_get_boolean(env, param, &param_value);
@@ -3344,6 +4223,105 @@ napi_value WebGLRenderingContext::GetShaderParameter(napi_env env,
   return param_value;
 }
 
+/* static */
+napi_value WebGLRenderingContext::GetScratchArenaStats(
+    napi_env env, napi_callback_info info) {
+  LOG_CALL("GetScratchArenaStats");
+
+  WebGLRenderingContext *context = nullptr;
+  napi_status nstatus;
+  nstatus = GetContext(env, info, &context);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  ScratchArena *arena = context->scratch_arena_;
+
+  napi_value stats_value;
+  nstatus = napi_create_object(env, &stats_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  // Counters are reported as doubles, which are exact up to 2^53.
+  const std::pair<const char *, double> counters[] = {
+      {"inlineAllocations", static_cast<double>(arena->inline_allocations())},
+      {"arenaAllocations", static_cast<double>(arena->arena_allocations())},
+      {"heapAllocations", static_cast<double>(arena->heap_allocations())},
+      {"capacity", static_cast<double>(arena->capacity())},
+  };
+  for (const auto &counter : counters) {
+    napi_value counter_value;
+    nstatus = napi_create_double(env, counter.second, &counter_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    nstatus = napi_set_named_property(env, stats_value, counter.first,
+                                      counter_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  }
+
+  return stats_value;
+}
+
+/* static */
+napi_value WebGLRenderingContext::GetStateCacheStats(napi_env env,
+                                                     napi_callback_info info) {
+  LOG_CALL("GetStateCacheStats");
+
+  WebGLRenderingContext *context = nullptr;
+  napi_status nstatus;
+  nstatus = GetContext(env, info, &context);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  GLStateCache *state_cache = context->state_cache_;
+
+  napi_value stats_value;
+  nstatus = napi_create_object(env, &stats_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  napi_value enabled_value;
+  nstatus = napi_get_boolean(env, state_cache->enabled(), &enabled_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  nstatus =
+      napi_set_named_property(env, stats_value, "enabled", enabled_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  // Counters are reported as doubles, which are exact up to 2^53.
+  napi_value elided_value;
+  nstatus = napi_create_double(
+      env, static_cast<double>(state_cache->elided_calls()), &elided_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  nstatus =
+      napi_set_named_property(env, stats_value, "elidedCalls", elided_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  napi_value forwarded_value;
+  nstatus = napi_create_double(
+      env, static_cast<double>(state_cache->forwarded_calls()),
+      &forwarded_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  nstatus = napi_set_named_property(env, stats_value, "forwardedCalls",
+                                    forwarded_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  GLProgramCache *program_cache = context->program_cache_;
+
+  napi_value uniform_hits_value;
+  nstatus = napi_create_double(
+      env, static_cast<double>(program_cache->uniform_hits()),
+      &uniform_hits_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  nstatus = napi_set_named_property(env, stats_value, "uniformHits",
+                                    uniform_hits_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  napi_value uniform_misses_value;
+  nstatus = napi_create_double(
+      env, static_cast<double>(program_cache->uniform_misses()),
+      &uniform_misses_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  nstatus = napi_set_named_property(env, stats_value, "uniformMisses",
+                                    uniform_misses_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  return stats_value;
+}
+
 /* static */
 napi_value WebGLRenderingContext::GetSupportedExtensions(
     napi_env env, napi_callback_info info) {
@@ -3392,7 +4370,7 @@ napi_value WebGLRenderingContext::GetTexParameter(napi_env env,
 
   WebGLRenderingContext *context = nullptr;
   GLenum args[2];
-  nstatus = GetContextUint32Params(env, info, &context, 2, args);
+  nstatus = GetContextParams(env, info, &context, args);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   napi_value params_value;
@@ -3465,83 +4443,73 @@ napi_value WebGLRenderingContext::GetTexParameter(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::GetUniformLocation(napi_env env,
-                                                     napi_callback_info info) {
-  LOG_CALL("GetUniformLocation");
-  napi_status nstatus;
-
-  size_t argc = 2;
-  napi_value args[2];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  GLuint program;
-  nstatus = napi_get_value_uint32(env, args[0], &program);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  std::string uniform_name;
-  nstatus = GetStringParam(env, args[1], uniform_name);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+napi_value WebGLRenderingContext::GetTexturePoolStats(napi_env env,
+                                                      napi_callback_info info) {
+  LOG_CALL("GetTexturePoolStats");
 
   WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
+  napi_status nstatus;
+  nstatus = GetContext(env, info, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLint location = context->eglContextWrapper_->glGetUniformLocation(
-      program, uniform_name.c_str());
+  GLTexturePool *pool = context->texture_pool_;
 
-  napi_value location_value;
-  nstatus = napi_create_int32(env, location, &location_value);
+  napi_value stats_value;
+  nstatus = napi_create_object(env, &stats_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return location_value;
+  // Counters are reported as doubles, which are exact up to 2^53.
+  const std::pair<const char *, double> counters[] = {
+      {"hits", static_cast<double>(pool->hits())},
+      {"misses", static_cast<double>(pool->misses())},
+      {"evictions", static_cast<double>(pool->evictions())},
+      {"freeTextures", static_cast<double>(pool->free_textures())},
+      {"freeBytes", static_cast<double>(pool->free_bytes())},
+      {"acquiredTextures", static_cast<double>(pool->acquired_textures())},
+      {"maxBytes", static_cast<double>(pool->max_bytes())},
+  };
+  for (const auto &counter : counters) {
+    napi_value counter_value;
+    nstatus = napi_create_double(env, counter.second, &counter_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    nstatus = napi_set_named_property(env, stats_value, counter.first,
+                                      counter_value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  }
+
+  return stats_value;
 }
 
 /* static */
-napi_value WebGLRenderingContext::Hint(napi_env env, napi_callback_info info) {
-  LOG_CALL("Hint");
+napi_value WebGLRenderingContext::GetUniformLocation(napi_env env,
+                                                     napi_callback_info info) {
+  LOG_CALL("GetUniformLocation");
   napi_status nstatus;
 
   WebGLRenderingContext *context = nullptr;
-  GLenum args[2];
-  nstatus = GetContextUint32Params(env, info, &context, 2, args);
+  napi_value args[2];
+  nstatus = GetContextArgs(env, info, &context, 2, args);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glHint(args[0], args[1]);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::IsBuffer(napi_env env,
-                                           napi_callback_info info) {
-  LOG_CALL("IsBuffer");
-  napi_status nstatus;
+  GLuint program;
+  nstatus = GetObjectArg(env, args[0], kGLObjectProgram, &program);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = nullptr;
-  GLuint buffer;
-  nstatus = GetContextUint32Params(env, info, &context, 1, &buffer);
+  std::string uniform_name;
+  nstatus = GetShortStringParam(env, args[1], uniform_name);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLboolean is_buffer = context->eglContextWrapper_->glIsBuffer(buffer);
+  GLint location =
+      context->program_cache_->GetUniformLocation(program, uniform_name);
 
-  napi_value result_value;
-  nstatus = napi_get_boolean(env, is_buffer, &result_value);
+  napi_value location_value;
+  nstatus = napi_create_int32(env, location, &location_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
 #if DEBUG
   context->CheckForErrors();
 #endif
-  return result_value;
+  return location_value;
 }
 
 /* static */
@@ -3559,242 +4527,224 @@ napi_value WebGLRenderingContext::IsContextLost(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::IsEnabled(napi_env env,
-                                            napi_callback_info info) {
-  LOG_CALL("IsEnabled");
-  napi_status nstatus;
+napi_value WebGLRenderingContext::IsSync(napi_env env,
+                                         napi_callback_info info) {
+  LOG_CALL("IsSync");
 
   WebGLRenderingContext *context = nullptr;
-  GLenum cap;
-  nstatus = GetContextUint32Params(env, info, &context, 1, &cap);
+  uint32_t handle;
+  napi_status nstatus = GetContextParam(env, info, &context, &handle);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLboolean is_enabled = context->eglContextWrapper_->glIsEnabled(cap);
+  GLsync sync = context->sync_pool_->Get(handle);
+  bool is_sync = sync && context->eglContextWrapper_->glIsSync(sync);
 
-  napi_value result_value;
-  nstatus = napi_get_boolean(env, is_enabled, &result_value);
+  napi_value is_sync_value;
+  nstatus = napi_get_boolean(env, is_sync, &is_sync_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
 #if DEBUG
   context->CheckForErrors();
 #endif
-  return result_value;
+  return is_sync_value;
 }
 
 /* static */
-napi_value WebGLRenderingContext::IsFramebuffer(napi_env env,
-                                                napi_callback_info info) {
-  LOG_CALL("IsFramebuffer");
-  napi_status nstatus;
+napi_value WebGLRenderingContext::LinkProgram(napi_env env,
+                                              napi_callback_info info) {
+  LOG_CALL("LinkProgram");
 
   WebGLRenderingContext *context = nullptr;
-  GLuint framebuffer;
-  nstatus = GetContextUint32Params(env, info, &context, 1, &framebuffer);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLboolean is_framebuffer =
-      context->eglContextWrapper_->glIsFramebuffer(framebuffer);
-
-  napi_value result_value;
-  nstatus = napi_get_boolean(env, is_framebuffer, &result_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  GLuint program;
+  napi_status nstatus = GetContextObjectParam(env, info, &context,
+                                              kGLObjectProgram, &program);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  GLProgramBinaryCache *binary_cache = context->program_binary_cache_;
+  GLProgramBinaryCache::Key key;
+  bool cacheable = binary_cache && binary_cache->GetKey(program, &key);
+  if (!cacheable ||
+      !binary_cache->Load(program, key, &context->pending_errors_)) {
+    context->eglContextWrapper_->glLinkProgram(program);
+    if (cacheable) {
+      // Waits for the link, use linkProgramAsync() to avoid blocking.
+      binary_cache->Store(program, key);
+    }
+  }
+  context->program_cache_->OnLinkProgram(program);
 
 #if DEBUG
   context->CheckForErrors();
 #endif
-  return result_value;
+  return nullptr;
 }
 
 /* static */
-napi_value WebGLRenderingContext::IsProgram(napi_env env,
-                                            napi_callback_info info) {
-  LOG_CALL("IsProgram");
-  napi_status nstatus;
+napi_value WebGLRenderingContext::LinkProgramAsync(napi_env env,
+                                                   napi_callback_info info) {
+  LOG_CALL("LinkProgramAsync");
 
   WebGLRenderingContext *context = nullptr;
   GLuint program;
-  nstatus = GetContextUint32Params(env, info, &context, 1, &program);
+  napi_status nstatus = GetContextObjectParam(env, info, &context,
+                                              kGLObjectProgram, &program);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLboolean is_program = context->eglContextWrapper_->glIsProgram(program);
-
-  napi_value result_value;
-  nstatus = napi_get_boolean(env, is_program, &result_value);
+  napi_deferred deferred;
+  napi_value promise_value;
+  nstatus = napi_create_promise(env, &deferred, &promise_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
+  EGLContextWrapper *egl = context->eglContextWrapper_;
+  GLProgramBinaryCache *binary_cache = context->program_binary_cache_;
+  GLProgramBinaryCache::Key key;
+  bool cacheable = binary_cache && binary_cache->GetKey(program, &key);
+  bool loaded = cacheable &&
+                binary_cache->Load(program, key, &context->pending_errors_);
+  if (!loaded) {
+    egl->glLinkProgram(program);
+  }
+  context->program_cache_->OnLinkProgram(program);
+
+  // Resolves with LINK_STATUS. Querying it right away would wait for the
+  // link, so poll COMPLETION_STATUS_KHR first.
+  bool store = cacheable && !loaded;
+  auto on_linked = [context, program, deferred, store, key](napi_env env,
+                                                             GLenum status) {
+    GLint linked = GL_FALSE;
+    if (status != GL_WAIT_FAILED) {
+      context->eglContextWrapper_->glGetProgramiv(program, GL_LINK_STATUS,
+                                                  &linked);
+    }
+    if (linked && store && context->program_binary_cache_) {
+      context->program_binary_cache_->Store(program, key);
+    }
+
+    napi_value linked_value;
+    napi_status nstatus = napi_get_boolean(env, linked, &linked_value);
+    ENSURE_NAPI_OK(env, nstatus);
+    napi_resolve_deferred(env, deferred, linked_value);
+  };
+
+  if (loaded || !KHRParallelShaderCompileExtension::Enable(egl)) {
+    // The link already finished.
+    on_linked(env, GL_ALREADY_SIGNALED);
+  } else {
+    nstatus = context->GetFencePoller()->AddProgram(program, on_linked);
+    if (nstatus != napi_ok) {
+      RejectWithError(env, deferred, "Could not wait for the program link");
+    }
+  }
+
 #if DEBUG
   context->CheckForErrors();
 #endif
-  return result_value;
+  return promise_value;
 }
 
 /* static */
-napi_value WebGLRenderingContext::IsRenderbuffer(napi_env env,
+napi_value WebGLRenderingContext::MapBufferRange(napi_env env,
                                                  napi_callback_info info) {
-  LOG_CALL("IsRenderbuffer");
-  napi_status nstatus;
+  LOG_CALL("MapBufferRange");
 
   WebGLRenderingContext *context = nullptr;
-  GLuint render_buffer;
-  nstatus = GetContextUint32Params(env, info, &context, 1, &render_buffer);
+  uint32_t args[4];
+  napi_status nstatus = GetContextParams(env, info, &context, args);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLboolean is_renderbuffer =
-      context->eglContextWrapper_->glIsRenderbuffer(render_buffer);
-
-  napi_value result_value;
-  nstatus = napi_get_boolean(env, is_renderbuffer, &result_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  napi_value arraybuffer_value;
+  nstatus = context->buffer_mappings_->Map(args[0], args[1], args[2], args[3],
+                                           &arraybuffer_value);
+  if (nstatus != napi_ok) {
+    return nullptr;
+  }
 
 #if DEBUG
   context->CheckForErrors();
 #endif
-  return result_value;
+  return arraybuffer_value;
 }
 
 /* static */
-napi_value WebGLRenderingContext::IsShader(napi_env env,
-                                           napi_callback_info info) {
-  LOG_CALL("IsShader");
+napi_value WebGLRenderingContext::ReadPixels(napi_env env,
+                                             napi_callback_info info) {
+  LOG_CALL("ReadPixels");
+
   napi_status nstatus;
 
-  WebGLRenderingContext *context = nullptr;
-  GLuint shader;
-  nstatus = GetContextUint32Params(env, info, &context, 1, &shader);
+  // WebGL2 adds an optional dstOffset argument.
+  size_t argc = 8;
+  napi_value args[8];
+  napi_value js_this;
+  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  if (argc < 7) {
+    ENSURE_ARGC_RETVAL(env, argc, 7, nullptr);
+  }
 
-  GLboolean is_shader = context->eglContextWrapper_->glIsShader(shader);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[3], nullptr);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[4], nullptr);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[5], nullptr);
 
-  napi_value result_value;
-  nstatus = napi_get_boolean(env, is_shader, &result_value);
+  WebGLRenderingContext *context = nullptr;
+  nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return result_value;
-}
+  GLint x;
+  nstatus = napi_get_value_int32(env, args[0], &x);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-/* static */
-napi_value WebGLRenderingContext::IsTexture(napi_env env,
-                                            napi_callback_info info) {
-  LOG_CALL("IsTexture");
-  napi_status nstatus;
+  GLint y;
+  nstatus = napi_get_value_int32(env, args[1], &y);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = nullptr;
-  GLuint texture;
-  nstatus = GetContextUint32Params(env, info, &context, 1, &texture);
+  GLsizei width;
+  nstatus = napi_get_value_int32(env, args[2], &width);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLboolean is_texture = context->eglContextWrapper_->glIsTexture(texture);
+  GLsizei height;
+  nstatus = napi_get_value_int32(env, args[3], &height);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  napi_value result_value;
-  nstatus = napi_get_boolean(env, is_texture, &result_value);
+  GLenum format;
+  nstatus = napi_get_value_uint32(env, args[4], &format);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return result_value;
-}
-
-/* static */
-napi_value WebGLRenderingContext::LineWidth(napi_env env,
-                                            napi_callback_info info) {
-  LOG_CALL("LineWidth");
-
-  WebGLRenderingContext *context = nullptr;
-  double width;
-  napi_status nstatus = GetContextDoubleParams(env, info, &context, 1, &width);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glLineWidth(static_cast<GLfloat>(width));
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::LinkProgram(napi_env env,
-                                              napi_callback_info info) {
-  LOG_CALL("LinkProgram");
-
-  WebGLRenderingContext *context = nullptr;
-  GLuint program;
-  napi_status nstatus =
-      GetContextUint32Params(env, info, &context, 1, &program);
+  GLenum type;
+  nstatus = napi_get_value_uint32(env, args[5], &type);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glLinkProgram(program);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::PixelStorei(napi_env env,
-                                              napi_callback_info info) {
-  LOG_CALL("PixelStorei");
-
-  napi_status nstatus;
-  size_t argc = 2;
-  napi_value args[2];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
+  napi_valuetype value_type;
+  nstatus = napi_typeof(env, args[6], &value_type);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
 
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  napi_valuetype result;
-  nstatus = napi_typeof(env, args[1], &result);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  if (result == napi_boolean) {
-    ENSURE_VALUE_IS_BOOLEAN_RETVAL(env, args[1], nullptr);
+  ArrayLikeBuffer alb;
+  if (value_type == napi_number) {
+    // WebGL2: byte offset into the bound PIXEL_PACK_BUFFER.
+    uint32_t offset;
+    nstatus = napi_get_value_uint32(env, args[6], &offset);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    alb.data = reinterpret_cast<void *>(static_cast<uintptr_t>(offset));
   } else {
-    ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-  }
-
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLenum pname;
-  nstatus = napi_get_value_uint32(env, args[0], &pname);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    nstatus = GetArrayLikeBuffer(env, args[6], context->scratch_arena_, &alb);
+    if (nstatus != napi_ok) {
+      NAPI_THROW_ERROR(env, "Invalid value passed for data buffer");
+      return nullptr;
+    }
 
-  GLint param;
-  if (result == napi_boolean) {
-    nstatus = napi_get_value_bool(env, args[1], (bool *)&param);
+    uint32_t dst_offset = 0;
+    nstatus = GetOptionalArg(env, argc, args, 7, &dst_offset);
     ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  } else {
-    nstatus = napi_get_value_int32(env, args[1], &param);
+
+    nstatus = ApplySourceRange(env, &alb, dst_offset, 0);
     ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
   }
 
-  context->eglContextWrapper_->glPixelStorei(pname, param);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::PolygonOffset(napi_env env,
-                                                napi_callback_info info) {
-  LOG_CALL("PolygonOffset");
-
-  WebGLRenderingContext *context = nullptr;
-  double args[2];
-  napi_status nstatus = GetContextDoubleParams(env, info, &context, 2, args);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glPolygonOffset(static_cast<GLfloat>(args[0]),
-                                               static_cast<GLfloat>(args[1]));
+  context->eglContextWrapper_->glReadPixels(x, y, width, height, format, type,
+                                            alb.data);
 
 #if DEBUG
   context->CheckForErrors();
@@ -3803,205 +4753,269 @@ napi_value WebGLRenderingContext::PolygonOffset(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::ReadPixels(napi_env env,
-                                             napi_callback_info info) {
-  LOG_CALL("ReadPixels");
+napi_value WebGLRenderingContext::ReadPixelsAsync(napi_env env,
+                                                  napi_callback_info info) {
+  LOG_CALL("ReadPixelsAsync");
 
   napi_status nstatus;
 
-  size_t argc = 7;
-  napi_value args[7];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 7, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[3], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[4], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[5], nullptr);
-
   WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
+  napi_value args[7];
+  nstatus = GetContextArgs(env, info, &context, 7, args);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   GLint x;
-  nstatus = napi_get_value_int32(env, args[0], &x);
+  nstatus = GetNapiArg(env, args[0], &x);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   GLint y;
-  nstatus = napi_get_value_int32(env, args[1], &y);
+  nstatus = GetNapiArg(env, args[1], &y);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   GLsizei width;
-  nstatus = napi_get_value_int32(env, args[2], &width);
+  nstatus = GetNapiArg(env, args[2], &width);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   GLsizei height;
-  nstatus = napi_get_value_int32(env, args[3], &height);
+  nstatus = GetNapiArg(env, args[3], &height);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   GLenum format;
-  nstatus = napi_get_value_uint32(env, args[4], &format);
+  nstatus = GetNapiArg(env, args[4], &format);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   GLenum type;
-  nstatus = napi_get_value_uint32(env, args[5], &type);
+  nstatus = GetNapiArg(env, args[5], &type);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  ArrayLikeBuffer alb;
-  nstatus = GetArrayLikeBuffer(env, args[6], &alb);
-  if (nstatus != napi_ok) {
-    napi_valuetype value_type;
-    nstatus = napi_typeof(env, args[6], &value_type);
-    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-    if (value_type != napi_number) {
-      NAPI_THROW_ERROR(env, "Invalid value passed for data buffer");
-      return nullptr;
-    }
+  bool is_typed_array = false;
+  nstatus = napi_is_typedarray(env, args[6], &is_typed_array);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  if (!is_typed_array) {
+    NAPI_THROW_ERROR(env, "Destination must be a TypedArray");
+    return nullptr;
   }
 
-  context->eglContextWrapper_->glReadPixels(x, y, width, height, format, type,
-                                            alb.data);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::RenderbufferStorage(napi_env env,
-                                                      napi_callback_info info) {
-  LOG_CALL("RenderbufferStorage");
-
-  napi_status nstatus;
+  napi_typedarray_type array_type;
+  size_t length;
+  void *data;
+  nstatus = napi_get_typedarray_info(env, args[6], &array_type, &length, &data,
+                                     nullptr, nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  size_t dst_byte_length = length * TypedArrayElementSize(array_type);
 
-  size_t argc = 4;
-  napi_value args[4];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
+  napi_deferred deferred;
+  napi_value promise_value;
+  nstatus = napi_create_promise(env, &deferred, &promise_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 4, nullptr);
 
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[3], nullptr);
+  // GL writes as many bytes as the PACK_* state asks for, whatever the size
+  // of the destination.
+  size_t byte_length = ReadPixelsByteLength(context->state_cache_, width,
+                                            height, format, type);
+  if (byte_length == 0) {
+    RejectWithError(env, deferred,
+                    "Invalid size, format or type for readPixelsAsync()");
+    return promise_value;
+  }
+  if (dst_byte_length < byte_length) {
+    RejectWithError(env, deferred,
+                    "Destination is too small for readPixelsAsync()");
+    return promise_value;
+  }
 
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  EGLContextWrapper *egl = context->eglContextWrapper_;
+  if (!context->limits_.webgl2()) {
+    // ES 2 has neither pixel pack buffers nor fences - read synchronously.
+    egl->glReadPixels(x, y, width, height, format, type, data);
+    nstatus = napi_resolve_deferred(env, deferred, args[6]);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    return promise_value;
+  }
 
-  GLenum target;
-  nstatus = napi_get_value_uint32(env, args[0], &target);
+  // Keep the destination alive until the copy.
+  napi_ref dst_ref;
+  nstatus = napi_create_reference(env, args[6], 1, &dst_ref);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLenum internal_format;
-  nstatus = napi_get_value_uint32(env, args[1], &internal_format);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  // Read into a pixel pack buffer; glReadPixels() returns without waiting for
+  // the GPU.
+  GLStateCache *state_cache = context->state_cache_;
+  GLuint previous_buffer = state_cache->buffer_binding(GL_PIXEL_PACK_BUFFER);
+  GLuint buffer;
+  egl->glGenBuffers(1, &buffer);
+  state_cache->BindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+  egl->glBufferData(GL_PIXEL_PACK_BUFFER, byte_length, nullptr,
+                    GL_STREAM_READ);
+  egl->glReadPixels(x, y, width, height, format, type, nullptr);
+  state_cache->BindBuffer(GL_PIXEL_PACK_BUFFER, previous_buffer);
+
+  GLsync sync = egl->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  auto on_signaled = [context, buffer, byte_length, sync, deferred, dst_ref](
+                         napi_env env, GLenum status) {
+    EGLContextWrapper *egl = context->eglContextWrapper_;
+    GLStateCache *state_cache = context->state_cache_;
+
+    napi_value dst_value;
+    napi_status nstatus = napi_get_reference_value(env, dst_ref, &dst_value);
+    napi_delete_reference(env, dst_ref);
+    ENSURE_NAPI_OK(env, nstatus);
+
+    bool copied = false;
+    if (status != GL_WAIT_FAILED) {
+      GLuint previous_buffer =
+          state_cache->buffer_binding(GL_PIXEL_PACK_BUFFER);
+      state_cache->BindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+      void *mapped = egl->glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                           byte_length, GL_MAP_READ_BIT);
+      if (mapped) {
+        // Look the destination up again, it may have been detached since.
+        napi_typedarray_type array_type;
+        size_t length;
+        void *data;
+        nstatus = napi_get_typedarray_info(env, dst_value, &array_type,
+                                           &length, &data, nullptr, nullptr);
+        if (nstatus == napi_ok) {
+          size_t dst_length = length * TypedArrayElementSize(array_type);
+          memcpy(data, mapped,
+                 dst_length < byte_length ? dst_length : byte_length);
+          copied = true;
+        }
+        egl->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+      }
+      state_cache->BindBuffer(GL_PIXEL_PACK_BUFFER, previous_buffer);
+    }
 
-  GLsizei width;
-  nstatus = napi_get_value_int32(env, args[2], &width);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    egl->glDeleteBuffers(1, &buffer);
+    egl->glDeleteSync(sync);
 
-  GLsizei height;
-  nstatus = napi_get_value_int32(env, args[3], &height);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    if (copied) {
+      napi_resolve_deferred(env, deferred, dst_value);
+    } else {
+      RejectWithError(env, deferred, "readPixelsAsync() failed");
+    }
+  };
 
-  context->eglContextWrapper_->glRenderbufferStorage(target, internal_format,
-                                                     width, height);
+  nstatus =
+      context->GetFencePoller()->Add(sync, GL_TIMEOUT_IGNORED, on_signaled);
+  if (nstatus != napi_ok) {
+    on_signaled(env, GL_WAIT_FAILED);
+  }
 
 #if DEBUG
   context->CheckForErrors();
 #endif
-  return nullptr;
+  return promise_value;
 }
 
 /* static */
-napi_value WebGLRenderingContext::SampleCoverage(napi_env env,
-                                                 napi_callback_info info) {
-  LOG_CALL("Scissor");
+napi_value WebGLRenderingContext::ReadPixelsToArrayBuffer(
+    napi_env env, napi_callback_info info) {
+  LOG_CALL("ReadPixelsToArrayBuffer");
+
   napi_status nstatus;
 
-  size_t argc = 2;
-  napi_value args[2];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
+  WebGLRenderingContext *context = nullptr;
+  uint32_t args[6];
+  nstatus = GetContextParams(env, info, &context, args);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
 
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_BOOLEAN_RETVAL(env, args[1], nullptr);
+  GLint x = static_cast<GLint>(args[0]);
+  GLint y = static_cast<GLint>(args[1]);
+  GLsizei width = static_cast<GLsizei>(args[2]);
+  GLsizei height = static_cast<GLsizei>(args[3]);
+  GLenum format = args[4];
+  GLenum type = args[5];
 
-  double value;
-  nstatus = napi_get_value_double(env, args[0], &value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  GLStateCache *state_cache = context->state_cache_;
+  if (state_cache->buffer_binding(GL_PIXEL_PACK_BUFFER) != 0) {
+    NAPI_THROW_ERROR(env, "A PIXEL_PACK_BUFFER is bound");
+    return nullptr;
+  }
 
-  bool invert;
-  nstatus = napi_get_value_bool(env, args[1], &invert);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  size_t byte_length =
+      ReadPixelsByteLength(state_cache, width, height, format, type);
+  if (byte_length == 0) {
+    NAPI_THROW_ERROR(env, "Invalid size, format or type for readPixels()");
+    return nullptr;
+  }
 
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  // GL writes straight into the memory that backs the returned ArrayBuffer.
+  ReadbackPool *pool = ReadbackPool::Get();
+  size_t capacity;
+  void *data = pool->Allocate(byte_length, &capacity);
+  if (!data) {
+    NAPI_THROW_ERROR(env, "Out of memory");
+    return nullptr;
+  }
 
-  context->eglContextWrapper_->glSampleCoverage(static_cast<GLclampf>(value),
-                                                static_cast<GLboolean>(invert));
+  context->eglContextWrapper_->glReadPixels(x, y, width, height, format, type,
+                                            data);
+
+  napi_value arraybuffer_value;
+  nstatus = pool->CreateArrayBuffer(env, data, capacity, byte_length,
+                                    &arraybuffer_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
 #if DEBUG
   context->CheckForErrors();
 #endif
-  return nullptr;
+  return arraybuffer_value;
 }
 
 /* static */
-napi_value WebGLRenderingContext::Scissor(napi_env env,
-                                          napi_callback_info info) {
-  LOG_CALL("Scissor");
+napi_value WebGLRenderingContext::StreamWrite(napi_env env,
+                                              napi_callback_info info) {
+  LOG_CALL("StreamWrite");
   napi_status nstatus;
 
-  size_t argc = 4;
-  napi_value args[4];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
+  WebGLRenderingContext *context = nullptr;
+  napi_value args[2];
+  nstatus = GetContextArgs(env, info, &context, 2, args);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 4, nullptr);
 
   ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[3], nullptr);
-
-  GLint x;
-  nstatus = napi_get_value_int32(env, args[0], &x);
+  GLenum target;
+  nstatus = napi_get_value_uint32(env, args[0], &target);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLint y;
-  nstatus = napi_get_value_int32(env, args[1], &y);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  GLStreamBuffer *stream_buffer = context->GetStreamBuffer(target);
+  if (!stream_buffer) {
+    NAPI_THROW_ERROR(env, "Unsupported streamWrite() target");
+    return nullptr;
+  }
 
-  GLsizei width;
-  nstatus = napi_get_value_int32(env, args[2], &width);
+  ArrayLikeBuffer alb;
+  nstatus = GetArrayLikeBuffer(env, args[1], context->scratch_arena_, &alb);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLsizei height;
-  nstatus = napi_get_value_int32(env, args[3], &height);
+  GLuint buffer;
+  size_t offset = stream_buffer->Write(alb.data, alb.length, &buffer);
+
+  napi_value result_value;
+  nstatus = napi_create_object(env, &result_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
+  // The ring buffer belongs to the context, so it is always returned as a
+  // number, even if the context wraps objects.
+  napi_value buffer_value;
+  nstatus = napi_create_uint32(env, buffer, &buffer_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  nstatus = napi_set_named_property(env, result_value, "buffer", buffer_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glScissor(x, y, width, height);
+  napi_value offset_value;
+  nstatus = napi_create_double(env, static_cast<double>(offset),
+                               &offset_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  nstatus = napi_set_named_property(env, result_value, "offset", offset_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
 #if DEBUG
   context->CheckForErrors();
 #endif
-  return nullptr;
+  return result_value;
 }
 
 /* static */
@@ -4011,8 +5025,8 @@ napi_value WebGLRenderingContext::TexImage2D(napi_env env,
 
   napi_status nstatus;
 
-  size_t argc = 9;
-  napi_value args[9];
+  size_t argc = 10;
+  napi_value args[10];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
@@ -4022,6 +5036,10 @@ napi_value WebGLRenderingContext::TexImage2D(napi_env env,
   GLsizei border;
   GLenum format;
   GLint type;
+  WebGLRenderingContext *context = nullptr;
+  nstatus = UnwrapContext(env, js_this, &context);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
   ArrayLikeBuffer alb;
 
   // texImage2D has a WebGL1 API that only takes 6 args intead of 9. This
@@ -4074,11 +5092,15 @@ napi_value WebGLRenderingContext::TexImage2D(napi_env env,
     nstatus = napi_get_named_property(env, args[5], "data", &data_value);
     ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-    nstatus = GetArrayLikeBuffer(env, data_value, &alb);
+    nstatus = GetArrayLikeBuffer(env, data_value, context->scratch_arena_,
+                                 &alb);
     ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
   } else {
-    // If argc is not 6, it should match arguments for OpenGL ES API.
-    ENSURE_ARGC_RETVAL(env, argc, 9, nullptr);
+    // If argc is not 6, it should match arguments for OpenGL ES API, with an
+    // optional WebGL2 srcOffset argument.
+    if (argc != 10) {
+      ENSURE_ARGC_RETVAL(env, argc, 9, nullptr);
+    }
 
     ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
     ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
@@ -4108,8 +5130,21 @@ napi_value WebGLRenderingContext::TexImage2D(napi_env env,
     nstatus = napi_typeof(env, args[8], &value_type);
     ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-    if (value_type != napi_null) {
-      nstatus = GetArrayLikeBuffer(env, args[8], &alb);
+    if (value_type == napi_number) {
+      // WebGL2: byte offset into the bound PIXEL_UNPACK_BUFFER.
+      uint32_t offset;
+      nstatus = napi_get_value_uint32(env, args[8], &offset);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+      alb.data = reinterpret_cast<void *>(static_cast<uintptr_t>(offset));
+    } else if (value_type != napi_null) {
+      nstatus = GetArrayLikeBuffer(env, args[8], context->scratch_arena_, &alb);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+      uint32_t src_offset = 0;
+      nstatus = GetOptionalArg(env, argc, args, 9, &src_offset);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+      nstatus = ApplySourceRange(env, &alb, src_offset, 0);
       ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
     }
   }
@@ -4126,13 +5161,12 @@ napi_value WebGLRenderingContext::TexImage2D(napi_env env,
   nstatus = napi_get_value_uint32(env, args[2], &internal_format);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
   context->eglContextWrapper_->glTexImage2D(target, level, internal_format,
                                             width, height, border, format, type,
                                             alb.data);
+  context->memory_tracker_->OnTexImage(
+      target, level, width, height,
+      static_cast<size_t>(width) * height * BytesPerPixel(format, type));
 
 #if DEBUG
   context->CheckForErrors();
@@ -4141,34 +5175,22 @@ napi_value WebGLRenderingContext::TexImage2D(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::ShaderSource(napi_env env,
-                                               napi_callback_info info) {
-  LOG_CALL("ShaderSource");
-  napi_status nstatus;
+napi_value WebGLRenderingContext::ReleaseTexture(napi_env env,
+                                                 napi_callback_info info) {
+  LOG_CALL("ReleaseTexture");
 
-  size_t argc = 2;
-  napi_value args[2];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
+  WebGLRenderingContext *context = nullptr;
+  GLuint texture;
+  napi_status nstatus = GetContextObjectParam(env, info, &context,
+                                              kGLObjectTexture, &texture);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
 
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  GLuint shader;
-  nstatus = napi_get_value_uint32(env, args[0], &shader);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  std::string source;
-  nstatus = GetStringParam(env, args[1], source);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLint length = source.size();
-  const char *codes[] = {source.c_str()};
-  context->eglContextWrapper_->glShaderSource(shader, 1, codes, &length);
+  if (!context->texture_pool_->Release(texture)) {
+    NAPI_THROW_ERROR(env, "Texture was not acquired with acquireTexture()");
+    return nullptr;
+  }
+  // The pool owns the texture again. Its wrapper must not delete it.
+  context->object_registry_->Disown(kGLObjectTexture, texture);
 
 #if DEBUG
   context->CheckForErrors();
@@ -4177,39 +5199,23 @@ napi_value WebGLRenderingContext::ShaderSource(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::StencilFunc(napi_env env,
-                                              napi_callback_info info) {
-  LOG_CALL("StencilFunc");
-  napi_status nstatus;
-
-  size_t argc = 3;
-  napi_value args[3];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 3, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
-
-  GLenum func;
-  nstatus = napi_get_value_uint32(env, args[0], &func);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLint ref;
-  nstatus = napi_get_value_int32(env, args[1], &ref);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLuint mask;
-  nstatus = napi_get_value_uint32(env, args[2], &mask);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+napi_value WebGLRenderingContext::SetProgramBinaryCacheLimit(
+    napi_env env, napi_callback_info info) {
+  LOG_CALL("SetProgramBinaryCacheLimit");
 
   WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
+  double max_bytes;
+  napi_status nstatus = GetContextParam(env, info, &context, &max_bytes);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glStencilFunc(func, ref, mask);
+  if (max_bytes < 0) {
+    NAPI_THROW_ERROR(env, "Program binary cache limit must not be negative");
+    return nullptr;
+  }
+  if (context->program_binary_cache_) {
+    context->program_binary_cache_->set_max_bytes(
+        static_cast<size_t>(max_bytes));
+  }
 
 #if DEBUG
   context->CheckForErrors();
@@ -4218,61 +5224,35 @@ napi_value WebGLRenderingContext::StencilFunc(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::StencilFuncSeparate(napi_env env,
-                                                      napi_callback_info info) {
-  LOG_CALL("StencilFuncSeparate");
-  napi_status nstatus;
-
-  size_t argc = 4;
-  napi_value args[4];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 4, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[3], nullptr);
-
-  GLenum face;
-  nstatus = napi_get_value_uint32(env, args[0], &face);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLenum func;
-  nstatus = napi_get_value_uint32(env, args[1], &func);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLint ref;
-  nstatus = napi_get_value_int32(env, args[2], &ref);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLuint mask;
-  nstatus = napi_get_value_uint32(env, args[3], &mask);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+napi_value WebGLRenderingContext::SetStateCacheEnabled(
+    napi_env env, napi_callback_info info) {
+  LOG_CALL("SetStateCacheEnabled");
 
   WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
+  bool enabled;
+  napi_status nstatus = GetContextParam(env, info, &context, &enabled);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glStencilFuncSeparate(face, func, ref, mask);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
+  context->state_cache_->set_enabled(enabled);
+  context->program_cache_->set_uniform_elision_enabled(enabled);
   return nullptr;
 }
 
 /* static */
-napi_value WebGLRenderingContext::StencilMask(napi_env env,
-                                              napi_callback_info info) {
-  LOG_CALL("StencilMask");
-  GLuint mask;
+napi_value WebGLRenderingContext::SetTexturePoolLimit(napi_env env,
+                                                      napi_callback_info info) {
+  LOG_CALL("SetTexturePoolLimit");
+
   WebGLRenderingContext *context = nullptr;
-  napi_status nstatus = GetContextUint32Params(env, info, &context, 1, &mask);
+  double max_bytes;
+  napi_status nstatus = GetContextParam(env, info, &context, &max_bytes);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glStencilMask(mask);
+  if (max_bytes < 0) {
+    NAPI_THROW_ERROR(env, "Texture pool limit must not be negative");
+    return nullptr;
+  }
+  context->texture_pool_->set_max_bytes(static_cast<size_t>(max_bytes));
 
 #if DEBUG
   context->CheckForErrors();
@@ -4281,54 +5261,75 @@ napi_value WebGLRenderingContext::StencilMask(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::StencilMaskSeparate(napi_env env,
-                                                      napi_callback_info info) {
-  LOG_CALL("StencilMaskSeparate");
+napi_value WebGLRenderingContext::SetUniforms(napi_env env,
+                                              napi_callback_info info) {
+  LOG_CALL("SetUniforms");
+  napi_status nstatus;
 
-  uint32_t args[2];
   WebGLRenderingContext *context = nullptr;
-  napi_status nstatus = GetContextUint32Params(env, info, &context, 2, args);
+  napi_value args[3];
+  nstatus = GetContextArgs(env, info, &context, 3, args);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glStencilMaskSeparate(
-      static_cast<GLenum>(args[0]), static_cast<GLuint>(args[1]));
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::StencilOp(napi_env env,
-                                            napi_callback_info info) {
-  LOG_CALL("StencilOp");
+  GLuint program;
+  nstatus = GetObjectArg(env, args[0], kGLObjectProgram, &program);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLenum args[3];
-  WebGLRenderingContext *context = nullptr;
-  napi_status nstatus = GetContextUint32Params(env, info, &context, 3, args);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
+  uint32_t handle;
+  nstatus = napi_get_value_uint32(env, args[1], &handle);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glStencilOp(args[0], args[1], args[2]);
+  // The packed values can be passed as an ArrayBuffer or any view on one.
+  void *data = nullptr;
+  size_t byte_length = 0;
+  bool is_arraybuffer = false;
+  nstatus = napi_is_arraybuffer(env, args[2], &is_arraybuffer);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  if (is_arraybuffer) {
+    nstatus = napi_get_arraybuffer_info(env, args[2], &data, &byte_length);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  } else {
+    bool is_typed_array = false;
+    nstatus = napi_is_typedarray(env, args[2], &is_typed_array);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    if (!is_typed_array) {
+      NAPI_THROW_ERROR(env, "Uniform values must be an ArrayBuffer");
+      return nullptr;
+    }
 
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
+    napi_typedarray_type array_type;
+    size_t length;
+    nstatus = napi_get_typedarray_info(env, args[2], &array_type, &length,
+                                       &data, nullptr, nullptr);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    if (array_type != napi_uint32_array && array_type != napi_int32_array &&
+        array_type != napi_float32_array) {
+      NAPI_THROW_ERROR(env, "Uniform values must be a 32-bit typed array");
+      return nullptr;
+    }
+    byte_length = length * sizeof(uint32_t);
+  }
 
-/* static */
-napi_value WebGLRenderingContext::StencilOpSeparate(napi_env env,
-                                                    napi_callback_info info) {
-  LOG_CALL("StencilOpSeparate");
+  if (reinterpret_cast<uintptr_t>(data) % sizeof(uint32_t) != 0) {
+    NAPI_THROW_ERROR(env, "Uniform values must be 4-byte aligned");
+    return nullptr;
+  }
 
-  GLenum args[4];
-  WebGLRenderingContext *context = nullptr;
-  napi_status nstatus = GetContextUint32Params(env, info, &context, 4, args);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  const GLProgramCache::UniformLayout *layout =
+      context->program_cache_->GetUniformLayout(program, handle);
+  if (layout == nullptr) {
+    // Also the case after the program was relinked or deleted.
+    NAPI_THROW_ERROR(env, "Unknown uniform layout for program");
+    return nullptr;
+  }
+  if (byte_length < layout->byte_length) {
+    NAPI_THROW_ERROR(env, "Uniform values are smaller than the layout");
+    return nullptr;
+  }
 
-  context->eglContextWrapper_->glStencilOpSeparate(args[0], args[1], args[2],
-                                                   args[3]);
+  context->program_cache_->SetUniforms(program, *layout,
+                                       static_cast<const uint8_t *>(data));
 
 #if DEBUG
   context->CheckForErrors();
@@ -4337,39 +5338,33 @@ napi_value WebGLRenderingContext::StencilOpSeparate(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::TexParameteri(napi_env env,
-                                                napi_callback_info info) {
-  LOG_CALL("TexParameteri");
+napi_value WebGLRenderingContext::ShaderSource(napi_env env,
+                                               napi_callback_info info) {
+  LOG_CALL("ShaderSource");
   napi_status nstatus;
 
-  size_t argc = 3;
-  napi_value args[3];
+  size_t argc = 2;
+  napi_value args[2];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 3, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
-
-  GLenum target;
-  nstatus = napi_get_value_uint32(env, args[0], &target);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
 
-  GLenum pname;
-  nstatus = napi_get_value_uint32(env, args[1], &pname);
+  GLuint shader;
+  nstatus = GetObjectArg(env, args[0], kGLObjectShader, &shader);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLint param;
-  nstatus = napi_get_value_int32(env, args[2], &param);
+  std::string source;
+  nstatus = GetStringParam(env, args[1], source);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   WebGLRenderingContext *context = nullptr;
   nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glTexParameteri(target, pname, param);
+  GLint length = source.size();
+  const char *codes[] = {source.c_str()};
+  context->eglContextWrapper_->glShaderSource(shader, 1, codes, &length);
 
 #if DEBUG
   context->CheckForErrors();
@@ -4378,45 +5373,26 @@ napi_value WebGLRenderingContext::TexParameteri(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::TexParameterf(napi_env env,
+napi_value WebGLRenderingContext::SignalHandoff(napi_env env,
                                                 napi_callback_info info) {
-  LOG_CALL("TexParameterf");
+  LOG_CALL("SignalHandoff");
   napi_status nstatus;
 
-  size_t argc = 3;
-  napi_value args[3];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 3, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
-
-  GLenum target;
-  nstatus = napi_get_value_uint32(env, args[0], &target);
+  WebGLRenderingContext *context = nullptr;
+  nstatus = GetContext(env, info, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLenum pname;
-  nstatus = napi_get_value_uint32(env, args[1], &pname);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  uint32_t handle = context->share_group_->Signal(context->eglContextWrapper_,
+                                                  context->limits_.webgl2());
 
-  double param;
-  nstatus = napi_get_value_double(env, args[2], &param);
+  napi_value handle_value;
+  nstatus = napi_create_uint32(env, handle, &handle_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glTexParameterf(target, pname,
-                                               static_cast<GLfloat>(param));
-
 #if DEBUG
   context->CheckForErrors();
 #endif
-  return nullptr;
+  return handle_value;
 }
 
 napi_value WebGLRenderingContext::TexSubImage2D(napi_env env,
@@ -4424,12 +5400,15 @@ napi_value WebGLRenderingContext::TexSubImage2D(napi_env env,
   LOG_CALL("TexSubImage2D");
   napi_status nstatus;
 
-  size_t argc = 9;
-  napi_value args[9];
+  // WebGL2 adds an optional srcOffset argument.
+  size_t argc = 10;
+  napi_value args[10];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 9, nullptr);
+  if (argc != 10) {
+    ENSURE_ARGC_RETVAL(env, argc, 9, nullptr);
+  }
 
   ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
   ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
@@ -4453,370 +5432,54 @@ napi_value WebGLRenderingContext::TexSubImage2D(napi_env env,
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   GLint xoffset;
-  nstatus = napi_get_value_int32(env, args[2], &xoffset);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLint yoffset;
-  nstatus = napi_get_value_int32(env, args[3], &yoffset);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLsizei width;
-  nstatus = napi_get_value_int32(env, args[4], &width);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLsizei height;
-  nstatus = napi_get_value_int32(env, args[5], &height);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLenum format;
-  nstatus = napi_get_value_uint32(env, args[6], &format);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLenum type;
-  nstatus = napi_get_value_uint32(env, args[7], &type);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  ArrayLikeBuffer alb;
-  nstatus = GetArrayLikeBuffer(env, args[8], &alb);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glTexSubImage2D(
-      target, level, xoffset, yoffset, width, height, format, type, alb.data);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::Uniform1i(napi_env env,
-                                            napi_callback_info info) {
-  LOG_CALL("Uniform1i");
-  napi_status nstatus;
-
-  size_t argc = 2;
-  napi_value args[2];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-
-  GLint location;
-  nstatus = napi_get_value_int32(env, args[0], &location);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  GLint v0;
-  nstatus = napi_get_value_int32(env, args[1], &v0);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glUniform1i(location, v0);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::Uniform1iv(napi_env env,
-                                             napi_callback_info info) {
-  LOG_CALL("Uniform1iv");
-  napi_status nstatus;
-
-  size_t argc = 2;
-  napi_value args[2];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-
-  GLint location;
-  nstatus = napi_get_value_int32(env, args[0], &location);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  ArrayLikeBuffer alb(kInt32);
-  nstatus = GetArrayLikeBuffer(env, args[1], &alb);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glUniform1iv(location,
-                                            static_cast<GLsizei>(alb.size()),
-                                            static_cast<GLint *>(alb.data));
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::Uniform1f(napi_env env,
-                                            napi_callback_info info) {
-  LOG_CALL("Uniform1f");
-  napi_status nstatus;
-
-  size_t argc = 2;
-  napi_value args[2];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-
-  GLint location;
-  nstatus = napi_get_value_int32(env, args[0], &location);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  double v0;
-  nstatus = napi_get_value_double(env, args[1], &v0);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glUniform1f(location, static_cast<GLfloat>(v0));
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::Uniform1fv(napi_env env,
-                                             napi_callback_info info) {
-  LOG_CALL("Uniform1fv");
-  napi_status nstatus;
-
-  size_t argc = 2;
-  napi_value args[2];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-
-  GLint location;
-  nstatus = napi_get_value_int32(env, args[0], &location);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  ArrayLikeBuffer alb;
-  nstatus = GetArrayLikeBuffer(env, args[1], &alb);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glUniform1fv(
-      location, alb.size(), reinterpret_cast<GLfloat *>(alb.data));
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::Uniform2f(napi_env env,
-                                            napi_callback_info info) {
-  LOG_CALL("Uniform2f");
-  napi_status nstatus;
-
-  size_t argc = 3;
-  napi_value args[3];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 3, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
-
-  GLint location;
-  nstatus = napi_get_value_int32(env, args[0], &location);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  double v0;
-  nstatus = napi_get_value_double(env, args[1], &v0);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  double v1;
-  nstatus = napi_get_value_double(env, args[2], &v1);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glUniform2f(location, static_cast<GLfloat>(v0),
-                                           static_cast<GLfloat>(v1));
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::Uniform2fv(napi_env env,
-                                             napi_callback_info info) {
-  LOG_CALL("Uniform2fv");
-  napi_status nstatus;
-
-  size_t argc = 2;
-  napi_value args[2];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-
-  GLint location;
-  nstatus = napi_get_value_int32(env, args[0], &location);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  ArrayLikeBuffer alb;
-  nstatus = GetArrayLikeBuffer(env, args[1], &alb);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glUniform2fv(
-      location, static_cast<GLsizei>(alb.size() >> 1),
-      static_cast<GLfloat *>(alb.data));
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::Uniform2i(napi_env env,
-                                            napi_callback_info info) {
-  LOG_CALL("Uniform2i");
-  napi_status nstatus;
-
-  WebGLRenderingContext *context = nullptr;
-  int32_t args[3];
-  nstatus = GetContextInt32Params(env, info, &context, 3, args);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glUniform2i(args[0], args[1], args[2]);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::Uniform2iv(napi_env env,
-                                             napi_callback_info info) {
-  LOG_CALL("Uniform2iv");
-  napi_status nstatus;
-
-  size_t argc = 2;
-  napi_value args[2];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-
-  GLint location;
-  nstatus = napi_get_value_int32(env, args[0], &location);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  ArrayLikeBuffer alb(kInt32);
-  nstatus = GetArrayLikeBuffer(env, args[1], &alb);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glUniform2iv(
-      location, static_cast<GLsizei>(alb.size() >> 1),
-      reinterpret_cast<GLint *>(alb.data));
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::Uniform3i(napi_env env,
-                                            napi_callback_info info) {
-  LOG_CALL("Uniform3i");
-
-  GLint args[4];
-  WebGLRenderingContext *context = nullptr;
-  napi_status nstatus = GetContextInt32Params(env, info, &context, 4, args);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  context->eglContextWrapper_->glUniform3i(args[0], args[1], args[2], args[3]);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
+  nstatus = napi_get_value_int32(env, args[2], &xoffset);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-/* static */
-napi_value WebGLRenderingContext::Uniform3iv(napi_env env,
-                                             napi_callback_info info) {
-  LOG_CALL("Uniform3iv");
-  napi_status nstatus;
+  GLint yoffset;
+  nstatus = napi_get_value_int32(env, args[3], &yoffset);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  size_t argc = 2;
-  napi_value args[2];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
+  GLsizei width;
+  nstatus = napi_get_value_int32(env, args[4], &width);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
 
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
+  GLsizei height;
+  nstatus = napi_get_value_int32(env, args[5], &height);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLint location;
-  nstatus = napi_get_value_int32(env, args[0], &location);
+  GLenum format;
+  nstatus = napi_get_value_uint32(env, args[6], &format);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  ArrayLikeBuffer alb(kInt32);
-  nstatus = GetArrayLikeBuffer(env, args[1], &alb);
+  GLenum type;
+  nstatus = napi_get_value_uint32(env, args[7], &type);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
+  napi_valuetype value_type;
+  nstatus = napi_typeof(env, args[8], &value_type);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glUniform3iv(
-      location, static_cast<GLsizei>(alb.size() / 3),
-      reinterpret_cast<GLint *>(alb.data));
+  ArrayLikeBuffer alb;
+  if (value_type == napi_number) {
+    // WebGL2: byte offset into the bound PIXEL_UNPACK_BUFFER.
+    uint32_t offset;
+    nstatus = napi_get_value_uint32(env, args[8], &offset);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    alb.data = reinterpret_cast<void *>(static_cast<uintptr_t>(offset));
+  } else {
+    nstatus = GetArrayLikeBuffer(env, args[8], context->scratch_arena_, &alb);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+    uint32_t src_offset = 0;
+    nstatus = GetOptionalArg(env, argc, args, 9, &src_offset);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+    nstatus = ApplySourceRange(env, &alb, src_offset, 0);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  }
+
+  context->eglContextWrapper_->glTexSubImage2D(
+      target, level, xoffset, yoffset, width, height, format, type, alb.data);
 
 #if DEBUG
   context->CheckForErrors();
@@ -4825,46 +5488,47 @@ napi_value WebGLRenderingContext::Uniform3iv(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::Uniform3f(napi_env env,
-                                            napi_callback_info info) {
-  LOG_CALL("Uniform3f");
+napi_value WebGLRenderingContext::Uniform1iv(napi_env env,
+                                             napi_callback_info info) {
+  LOG_CALL("Uniform1iv");
   napi_status nstatus;
 
+  // WebGL2 adds optional srcOffset and srcLength arguments.
   size_t argc = 4;
   napi_value args[4];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 4, nullptr);
+  if (argc < 2) {
+    ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
+  }
 
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[3], nullptr);
+  UniformLocationArg location;
+  nstatus = GetNapiArg(env, args[0], &location);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLint location;
-  nstatus = napi_get_value_int32(env, args[0], &location);
+  WebGLRenderingContext *context = nullptr;
+  nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  double v0;
-  nstatus = napi_get_value_double(env, args[1], &v0);
+  ArrayLikeBuffer alb(kInt32);
+  nstatus = GetArrayLikeBuffer(env, args[1], context->scratch_arena_, &alb);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  double v1;
-  nstatus = napi_get_value_double(env, args[2], &v1);
+  uint32_t src_offset = 0;
+  nstatus = GetOptionalArg(env, argc, args, 2, &src_offset);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  double v2;
-  nstatus = napi_get_value_double(env, args[3], &v2);
+  uint32_t src_length = 0;
+  nstatus = GetOptionalArg(env, argc, args, 3, &src_length);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
+  nstatus = ApplySourceRange(env, &alb, src_offset, src_length);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glUniform3f(location, static_cast<GLfloat>(v0),
-                                           static_cast<GLfloat>(v1),
-                                           static_cast<GLfloat>(v2));
+  context->program_cache_->Uniform1iv(location.value,
+                                      static_cast<GLsizei>(alb.size()),
+                                      static_cast<GLint *>(alb.data));
 
 #if DEBUG
   context->CheckForErrors();
@@ -4873,35 +5537,46 @@ napi_value WebGLRenderingContext::Uniform3f(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::Uniform3fv(napi_env env,
+napi_value WebGLRenderingContext::Uniform1fv(napi_env env,
                                              napi_callback_info info) {
-  LOG_CALL("Uniform3fv");
+  LOG_CALL("Uniform1fv");
   napi_status nstatus;
 
-  size_t argc = 2;
-  napi_value args[2];
+  // WebGL2 adds optional srcOffset and srcLength arguments.
+  size_t argc = 4;
+  napi_value args[4];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
+  if (argc < 2) {
+    ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
+  }
 
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
+  UniformLocationArg location;
+  nstatus = GetNapiArg(env, args[0], &location);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLint location;
-  nstatus = napi_get_value_int32(env, args[0], &location);
+  WebGLRenderingContext *context = nullptr;
+  nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   ArrayLikeBuffer alb;
-  nstatus = GetArrayLikeBuffer(env, args[1], &alb);
+  nstatus = GetArrayLikeBuffer(env, args[1], context->scratch_arena_, &alb);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
+  uint32_t src_offset = 0;
+  nstatus = GetOptionalArg(env, argc, args, 2, &src_offset);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glUniform3fv(
-      location, static_cast<GLsizei>(alb.size() / 3),
-      reinterpret_cast<GLfloat *>(alb.data));
+  uint32_t src_length = 0;
+  nstatus = GetOptionalArg(env, argc, args, 3, &src_length);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  nstatus = ApplySourceRange(env, &alb, src_offset, src_length);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  context->program_cache_->Uniform1fv(
+      location.value, alb.size(), reinterpret_cast<GLfloat *>(alb.data));
 
 #if DEBUG
   context->CheckForErrors();
@@ -4910,55 +5585,47 @@ napi_value WebGLRenderingContext::Uniform3fv(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::Uniform4fv(napi_env env,
+napi_value WebGLRenderingContext::Uniform2fv(napi_env env,
                                              napi_callback_info info) {
-  LOG_CALL("Uniform4fv");
+  LOG_CALL("Uniform2fv");
   napi_status nstatus;
 
-  size_t argc = 2;
-  napi_value args[2];
+  // WebGL2 adds optional srcOffset and srcLength arguments.
+  size_t argc = 4;
+  napi_value args[4];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-
-  GLint location;
-  nstatus = napi_get_value_int32(env, args[0], &location);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  if (argc < 2) {
+    ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
+  }
 
-  ArrayLikeBuffer alb;
-  nstatus = GetArrayLikeBuffer(env, args[1], &alb);
+  UniformLocationArg location;
+  nstatus = GetNapiArg(env, args[0], &location);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   WebGLRenderingContext *context = nullptr;
   nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glUniform4fv(
-      location, static_cast<GLsizei>(alb.size() >> 2),
-      reinterpret_cast<GLfloat *>(alb.data));
+  ArrayLikeBuffer alb;
+  nstatus = GetArrayLikeBuffer(env, args[1], context->scratch_arena_, &alb);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
+  uint32_t src_offset = 0;
+  nstatus = GetOptionalArg(env, argc, args, 2, &src_offset);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-/* static */
-napi_value WebGLRenderingContext::Uniform4i(napi_env env,
-                                            napi_callback_info info) {
-  LOG_CALL("Uniform4i");
-  napi_status nstatus;
+  uint32_t src_length = 0;
+  nstatus = GetOptionalArg(env, argc, args, 3, &src_length);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = nullptr;
-  int32_t args[5];
-  nstatus = GetContextInt32Params(env, info, &context, 5, args);
+  nstatus = ApplySourceRange(env, &alb, src_offset, src_length);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glUniform4i(args[0], args[1], args[2], args[3],
-                                           args[4]);
+  context->program_cache_->Uniform2fv(
+      location.value, static_cast<GLsizei>(alb.size() >> 1),
+      static_cast<GLfloat *>(alb.data));
 
 #if DEBUG
   context->CheckForErrors();
@@ -4967,35 +5634,47 @@ napi_value WebGLRenderingContext::Uniform4i(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::Uniform4iv(napi_env env,
+napi_value WebGLRenderingContext::Uniform2iv(napi_env env,
                                              napi_callback_info info) {
-  LOG_CALL("Uniform4iv");
+  LOG_CALL("Uniform2iv");
   napi_status nstatus;
 
-  size_t argc = 2;
-  napi_value args[2];
+  // WebGL2 adds optional srcOffset and srcLength arguments.
+  size_t argc = 4;
+  napi_value args[4];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
+  if (argc < 2) {
+    ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
+  }
 
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
+  UniformLocationArg location;
+  nstatus = GetNapiArg(env, args[0], &location);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLint location;
-  nstatus = napi_get_value_int32(env, args[0], &location);
+  WebGLRenderingContext *context = nullptr;
+  nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   ArrayLikeBuffer alb(kInt32);
-  nstatus = GetArrayLikeBuffer(env, args[1], &alb);
+  nstatus = GetArrayLikeBuffer(env, args[1], context->scratch_arena_, &alb);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
+  uint32_t src_offset = 0;
+  nstatus = GetOptionalArg(env, argc, args, 2, &src_offset);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glUniform4iv(
-      location, static_cast<GLsizei>(alb.size() >> 2),
-      static_cast<GLint *>(alb.data));
+  uint32_t src_length = 0;
+  nstatus = GetOptionalArg(env, argc, args, 3, &src_length);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  nstatus = ApplySourceRange(env, &alb, src_offset, src_length);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  context->program_cache_->Uniform2iv(
+      location.value, static_cast<GLsizei>(alb.size() >> 1),
+      reinterpret_cast<GLint *>(alb.data));
 
 #if DEBUG
   context->CheckForErrors();
@@ -5004,51 +5683,47 @@ napi_value WebGLRenderingContext::Uniform4iv(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::Uniform4f(napi_env env,
-                                            napi_callback_info info) {
-  LOG_CALL("Uniform4f");
+napi_value WebGLRenderingContext::Uniform3iv(napi_env env,
+                                             napi_callback_info info) {
+  LOG_CALL("Uniform3iv");
   napi_status nstatus;
 
-  size_t argc = 5;
-  napi_value args[5];
+  // WebGL2 adds optional srcOffset and srcLength arguments.
+  size_t argc = 4;
+  napi_value args[4];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 5, nullptr);
+  if (argc < 2) {
+    ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
+  }
 
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
+  UniformLocationArg location;
+  nstatus = GetNapiArg(env, args[0], &location);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[3], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[4], nullptr);
-
-  GLint location;
-  nstatus = napi_get_value_int32(env, args[0], &location);
+  WebGLRenderingContext *context = nullptr;
+  nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  double v0;
-  nstatus = napi_get_value_double(env, args[1], &v0);
+  ArrayLikeBuffer alb(kInt32);
+  nstatus = GetArrayLikeBuffer(env, args[1], context->scratch_arena_, &alb);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  double v1;
-  nstatus = napi_get_value_double(env, args[2], &v1);
+  uint32_t src_offset = 0;
+  nstatus = GetOptionalArg(env, argc, args, 2, &src_offset);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  double v2;
-  nstatus = napi_get_value_double(env, args[3], &v2);
+  uint32_t src_length = 0;
+  nstatus = GetOptionalArg(env, argc, args, 3, &src_length);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  double v3;
-  nstatus = napi_get_value_double(env, args[4], &v3);
+  nstatus = ApplySourceRange(env, &alb, src_offset, src_length);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glUniform4f(
-      location, static_cast<GLfloat>(v0), static_cast<GLfloat>(v1),
-      static_cast<GLfloat>(v2), static_cast<GLfloat>(v3));
+  context->program_cache_->Uniform3iv(
+      location.value, static_cast<GLsizei>(alb.size() / 3),
+      reinterpret_cast<GLint *>(alb.data));
 
 #if DEBUG
   context->CheckForErrors();
@@ -5057,41 +5732,47 @@ napi_value WebGLRenderingContext::Uniform4f(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::UniformMatrix2fv(napi_env env,
-                                                   napi_callback_info info) {
-  LOG_CALL("UniformMatrix2fv");
-
+napi_value WebGLRenderingContext::Uniform3fv(napi_env env,
+                                             napi_callback_info info) {
+  LOG_CALL("Uniform3fv");
   napi_status nstatus;
 
-  size_t argc = 3;
-  napi_value args[3];
+  // WebGL2 adds optional srcOffset and srcLength arguments.
+  size_t argc = 4;
+  napi_value args[4];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  if (argc < 2) {
+    ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
+  }
 
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_BOOLEAN_RETVAL(env, args[1], nullptr);
-
-  GLint location;
-  nstatus = napi_get_value_int32(env, args[0], &location);
+  UniformLocationArg location;
+  nstatus = GetNapiArg(env, args[0], &location);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  bool transpose;
-  nstatus = napi_get_value_bool(env, args[1], &transpose);
+  WebGLRenderingContext *context = nullptr;
+  nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   ArrayLikeBuffer alb;
-  nstatus = GetArrayLikeBuffer(env, args[2], &alb);
+  nstatus = GetArrayLikeBuffer(env, args[1], context->scratch_arena_, &alb);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
+  uint32_t src_offset = 0;
+  nstatus = GetOptionalArg(env, argc, args, 2, &src_offset);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glUniformMatrix2fv(
-      location, static_cast<GLsizei>(alb.size() >> 2),
-      static_cast<GLboolean>(transpose),
-      static_cast<const GLfloat *>(alb.data));
+  uint32_t src_length = 0;
+  nstatus = GetOptionalArg(env, argc, args, 3, &src_length);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  nstatus = ApplySourceRange(env, &alb, src_offset, src_length);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  context->program_cache_->Uniform3fv(
+      location.value, static_cast<GLsizei>(alb.size() / 3),
+      reinterpret_cast<GLfloat *>(alb.data));
 
 #if DEBUG
   context->CheckForErrors();
@@ -5100,41 +5781,47 @@ napi_value WebGLRenderingContext::UniformMatrix2fv(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::UniformMatrix3fv(napi_env env,
-                                                   napi_callback_info info) {
-  LOG_CALL("UniformMatrix3fv");
-
+napi_value WebGLRenderingContext::Uniform4fv(napi_env env,
+                                             napi_callback_info info) {
+  LOG_CALL("Uniform4fv");
   napi_status nstatus;
 
-  size_t argc = 3;
-  napi_value args[3];
+  // WebGL2 adds optional srcOffset and srcLength arguments.
+  size_t argc = 4;
+  napi_value args[4];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  if (argc < 2) {
+    ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
+  }
 
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_BOOLEAN_RETVAL(env, args[1], nullptr);
-
-  GLint location;
-  nstatus = napi_get_value_int32(env, args[0], &location);
+  UniformLocationArg location;
+  nstatus = GetNapiArg(env, args[0], &location);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  bool transpose;
-  nstatus = napi_get_value_bool(env, args[1], &transpose);
+  WebGLRenderingContext *context = nullptr;
+  nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   ArrayLikeBuffer alb;
-  nstatus = GetArrayLikeBuffer(env, args[2], &alb);
+  nstatus = GetArrayLikeBuffer(env, args[1], context->scratch_arena_, &alb);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
+  uint32_t src_offset = 0;
+  nstatus = GetOptionalArg(env, argc, args, 2, &src_offset);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glUniformMatrix3fv(
-      location, static_cast<GLsizei>(alb.size() / 9),
-      static_cast<GLboolean>(transpose),
-      static_cast<const GLfloat *>(alb.data));
+  uint32_t src_length = 0;
+  nstatus = GetOptionalArg(env, argc, args, 3, &src_length);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  nstatus = ApplySourceRange(env, &alb, src_offset, src_length);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  context->program_cache_->Uniform4fv(
+      location.value, static_cast<GLsizei>(alb.size() >> 2),
+      reinterpret_cast<GLfloat *>(alb.data));
 
 #if DEBUG
   context->CheckForErrors();
@@ -5143,79 +5830,47 @@ napi_value WebGLRenderingContext::UniformMatrix3fv(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::UniformMatrix4fv(napi_env env,
-                                                   napi_callback_info info) {
-  LOG_CALL("UniformMatrix4fv");
-
+napi_value WebGLRenderingContext::Uniform4iv(napi_env env,
+                                             napi_callback_info info) {
+  LOG_CALL("Uniform4iv");
   napi_status nstatus;
 
-  size_t argc = 3;
-  napi_value args[3];
+  // WebGL2 adds optional srcOffset and srcLength arguments.
+  size_t argc = 4;
+  napi_value args[4];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  if (argc < 2) {
+    ENSURE_ARGC_RETVAL(env, argc, 2, nullptr);
+  }
 
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_BOOLEAN_RETVAL(env, args[1], nullptr);
-
-  GLint location;
-  nstatus = napi_get_value_int32(env, args[0], &location);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  bool transpose;
-  nstatus = napi_get_value_bool(env, args[1], &transpose);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  ArrayLikeBuffer alb;
-  nstatus = GetArrayLikeBuffer(env, args[2], &alb);
+  UniformLocationArg location;
+  nstatus = GetNapiArg(env, args[0], &location);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   WebGLRenderingContext *context = nullptr;
   nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glUniformMatrix4fv(
-      location, static_cast<GLsizei>(alb.size() >> 4),
-      static_cast<GLboolean>(transpose),
-      static_cast<const GLfloat *>(alb.data));
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::UseProgram(napi_env env,
-                                             napi_callback_info info) {
-  LOG_CALL("UseProgram");
-
-  WebGLRenderingContext *context = nullptr;
-  GLuint program;
-  napi_status nstatus =
-      GetContextUint32Params(env, info, &context, 1, &program);
+  ArrayLikeBuffer alb(kInt32);
+  nstatus = GetArrayLikeBuffer(env, args[1], context->scratch_arena_, &alb);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glUseProgram(program);
-
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
-}
-
-/* static */
-napi_value WebGLRenderingContext::ValidateProgram(napi_env env,
-                                                  napi_callback_info info) {
-  LOG_CALL("ValidateProgram");
+  uint32_t src_offset = 0;
+  nstatus = GetOptionalArg(env, argc, args, 2, &src_offset);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = nullptr;
-  GLuint program;
-  napi_status nstatus =
-      GetContextUint32Params(env, info, &context, 1, &program);
+  uint32_t src_length = 0;
+  nstatus = GetOptionalArg(env, argc, args, 3, &src_length);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  nstatus = ApplySourceRange(env, &alb, src_offset, src_length);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glValidateProgram(program);
+  context->program_cache_->Uniform4iv(
+      location.value, static_cast<GLsizei>(alb.size() >> 2),
+      static_cast<GLint *>(alb.data));
 
 #if DEBUG
   context->CheckForErrors();
@@ -5224,34 +5879,55 @@ napi_value WebGLRenderingContext::ValidateProgram(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::VertexAttrib1f(napi_env env,
-                                                 napi_callback_info info) {
-  LOG_CALL("VertexAttrib1f");
+napi_value WebGLRenderingContext::UniformMatrix2fv(napi_env env,
+                                                   napi_callback_info info) {
+  LOG_CALL("UniformMatrix2fv");
 
   napi_status nstatus;
 
-  size_t argc = 2;
-  napi_value args[2];
+  // WebGL2 adds optional srcOffset and srcLength arguments.
+  size_t argc = 5;
+  napi_value args[5];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  if (argc < 3) {
+    ENSURE_ARGC_RETVAL(env, argc, 3, nullptr);
+  }
 
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
+  ENSURE_VALUE_IS_BOOLEAN_RETVAL(env, args[1], nullptr);
 
-  GLuint index;
-  nstatus = napi_get_value_uint32(env, args[0], &index);
+  UniformLocationArg location;
+  nstatus = GetNapiArg(env, args[0], &location);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  double v0;
-  nstatus = napi_get_value_double(env, args[1], &v0);
+  bool transpose;
+  nstatus = napi_get_value_bool(env, args[1], &transpose);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   WebGLRenderingContext *context = nullptr;
   nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glVertexAttrib1f(index, v0);
+  ArrayLikeBuffer alb;
+  nstatus = GetArrayLikeBuffer(env, args[2], context->scratch_arena_, &alb);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  uint32_t src_offset = 0;
+  nstatus = GetOptionalArg(env, argc, args, 3, &src_offset);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  uint32_t src_length = 0;
+  nstatus = GetOptionalArg(env, argc, args, 4, &src_length);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  nstatus = ApplySourceRange(env, &alb, src_offset, src_length);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  context->program_cache_->UniformMatrix2fv(
+      location.value, static_cast<GLsizei>(alb.size() >> 2),
+      static_cast<GLboolean>(transpose),
+      static_cast<const GLfloat *>(alb.data));
 
 #if DEBUG
   context->CheckForErrors();
@@ -5260,74 +5936,112 @@ napi_value WebGLRenderingContext::VertexAttrib1f(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::VertexAttrib1fv(napi_env env,
-                                                  napi_callback_info info) {
-  LOG_CALL("VertexAttrib1fv");
+napi_value WebGLRenderingContext::UniformMatrix3fv(napi_env env,
+                                                   napi_callback_info info) {
+  LOG_CALL("UniformMatrix3fv");
 
   napi_status nstatus;
 
-  size_t argc = 2;
-  napi_value args[2];
+  // WebGL2 adds optional srcOffset and srcLength arguments.
+  size_t argc = 5;
+  napi_value args[5];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  if (argc < 3) {
+    ENSURE_ARGC_RETVAL(env, argc, 3, nullptr);
+  }
 
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
+  ENSURE_VALUE_IS_BOOLEAN_RETVAL(env, args[1], nullptr);
 
-  GLuint index;
-  nstatus = napi_get_value_uint32(env, args[0], &index);
+  UniformLocationArg location;
+  nstatus = GetNapiArg(env, args[0], &location);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  ArrayLikeBuffer alb;
-  nstatus = GetArrayLikeBuffer(env, args[1], &alb);
+  bool transpose;
+  nstatus = napi_get_value_bool(env, args[1], &transpose);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   WebGLRenderingContext *context = nullptr;
   nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glVertexAttrib1fv(
-      index, static_cast<GLfloat *>(alb.data));
+  ArrayLikeBuffer alb;
+  nstatus = GetArrayLikeBuffer(env, args[2], context->scratch_arena_, &alb);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  uint32_t src_offset = 0;
+  nstatus = GetOptionalArg(env, argc, args, 3, &src_offset);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  uint32_t src_length = 0;
+  nstatus = GetOptionalArg(env, argc, args, 4, &src_length);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  nstatus = ApplySourceRange(env, &alb, src_offset, src_length);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  context->program_cache_->UniformMatrix3fv(
+      location.value, static_cast<GLsizei>(alb.size() / 9),
+      static_cast<GLboolean>(transpose),
+      static_cast<const GLfloat *>(alb.data));
 
 #if DEBUG
   context->CheckForErrors();
 #endif
   return nullptr;
 }
+
 /* static */
-napi_value WebGLRenderingContext::VertexAttrib2f(napi_env env,
-                                                 napi_callback_info info) {
-  LOG_CALL("VertexAttrib2f");
+napi_value WebGLRenderingContext::UniformMatrix4fv(napi_env env,
+                                                   napi_callback_info info) {
+  LOG_CALL("UniformMatrix4fv");
 
   napi_status nstatus;
 
-  size_t argc = 3;
-  napi_value args[3];
+  // WebGL2 adds optional srcOffset and srcLength arguments.
+  size_t argc = 5;
+  napi_value args[5];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  if (argc < 3) {
+    ENSURE_ARGC_RETVAL(env, argc, 3, nullptr);
+  }
 
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
-
-  GLuint index;
-  nstatus = napi_get_value_uint32(env, args[0], &index);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  ENSURE_VALUE_IS_BOOLEAN_RETVAL(env, args[1], nullptr);
 
-  double v0;
-  nstatus = napi_get_value_double(env, args[1], &v0);
+  UniformLocationArg location;
+  nstatus = GetNapiArg(env, args[0], &location);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  double v1;
-  nstatus = napi_get_value_double(env, args[2], &v1);
+  bool transpose;
+  nstatus = napi_get_value_bool(env, args[1], &transpose);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   WebGLRenderingContext *context = nullptr;
   nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glVertexAttrib2f(index, v0, v1);
+  ArrayLikeBuffer alb;
+  nstatus = GetArrayLikeBuffer(env, args[2], context->scratch_arena_, &alb);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  uint32_t src_offset = 0;
+  nstatus = GetOptionalArg(env, argc, args, 3, &src_offset);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  uint32_t src_length = 0;
+  nstatus = GetOptionalArg(env, argc, args, 4, &src_length);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  nstatus = ApplySourceRange(env, &alb, src_offset, src_length);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  context->program_cache_->UniformMatrix4fv(
+      location.value, static_cast<GLsizei>(alb.size() >> 4),
+      static_cast<GLboolean>(transpose),
+      static_cast<const GLfloat *>(alb.data));
 
 #if DEBUG
   context->CheckForErrors();
@@ -5336,91 +6050,66 @@ napi_value WebGLRenderingContext::VertexAttrib2f(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::VertexAttrib2fv(napi_env env,
-                                                  napi_callback_info info) {
-  LOG_CALL("VertexAttrib2fv");
-
-  napi_status nstatus;
-
-  size_t argc = 2;
-  napi_value args[2];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
+napi_value WebGLRenderingContext::UnmapBuffer(napi_env env,
+                                              napi_callback_info info) {
+  LOG_CALL("UnmapBuffer");
 
-  GLuint index;
-  nstatus = napi_get_value_uint32(env, args[0], &index);
+  WebGLRenderingContext *context = nullptr;
+  GLenum target;
+  napi_status nstatus = GetContextParam(env, info, &context, &target);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  ArrayLikeBuffer alb;
-  nstatus = GetArrayLikeBuffer(env, args[1], &alb);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  GLboolean result = context->buffer_mappings_->Unmap(target);
 
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
+  napi_value result_value;
+  nstatus = napi_get_boolean(env, result == GL_TRUE, &result_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glVertexAttrib2fv(
-      index, static_cast<GLfloat *>(alb.data));
-
 #if DEBUG
   context->CheckForErrors();
 #endif
-  return nullptr;
+  return result_value;
 }
 
 /* static */
-napi_value WebGLRenderingContext::VertexAttrib3f(napi_env env,
-                                                 napi_callback_info info) {
-  LOG_CALL("VertexAttrib3f");
+napi_value WebGLRenderingContext::VertexAttrib1fv(napi_env env,
+                                                  napi_callback_info info) {
+  LOG_CALL("VertexAttrib1fv");
 
   napi_status nstatus;
 
-  size_t argc = 4;
-  napi_value args[4];
+  size_t argc = 2;
+  napi_value args[2];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[3], nullptr);
 
   GLuint index;
   nstatus = napi_get_value_uint32(env, args[0], &index);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  double v0;
-  nstatus = napi_get_value_double(env, args[1], &v0);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  double v1;
-  nstatus = napi_get_value_double(env, args[1], &v1);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  double v2;
-  nstatus = napi_get_value_double(env, args[1], &v2);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
   WebGLRenderingContext *context = nullptr;
   nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glVertexAttrib3f(index, v0, v1, v2);
+  ArrayLikeBuffer alb;
+  nstatus = GetArrayLikeBuffer(env, args[1], context->scratch_arena_, &alb);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  context->eglContextWrapper_->glVertexAttrib1fv(
+      index, static_cast<GLfloat *>(alb.data));
 
 #if DEBUG
   context->CheckForErrors();
 #endif
   return nullptr;
 }
-
 /* static */
-napi_value WebGLRenderingContext::VertexAttrib3fv(napi_env env,
+napi_value WebGLRenderingContext::VertexAttrib2fv(napi_env env,
                                                   napi_callback_info info) {
-  LOG_CALL("VertexAttrib1fv");
+  LOG_CALL("VertexAttrib2fv");
 
   napi_status nstatus;
 
@@ -5436,15 +6125,15 @@ napi_value WebGLRenderingContext::VertexAttrib3fv(napi_env env,
   nstatus = napi_get_value_uint32(env, args[0], &index);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  ArrayLikeBuffer alb;
-  nstatus = GetArrayLikeBuffer(env, args[1], &alb);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
   WebGLRenderingContext *context = nullptr;
   nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glVertexAttrib3fv(
+  ArrayLikeBuffer alb;
+  nstatus = GetArrayLikeBuffer(env, args[1], context->scratch_arena_, &alb);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  context->eglContextWrapper_->glVertexAttrib2fv(
       index, static_cast<GLfloat *>(alb.data));
 
 #if DEBUG
@@ -5454,49 +6143,34 @@ napi_value WebGLRenderingContext::VertexAttrib3fv(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::VertexAttrib4f(napi_env env,
-                                                 napi_callback_info info) {
-  LOG_CALL("VertexAttrib4f");
+napi_value WebGLRenderingContext::VertexAttrib3fv(napi_env env,
+                                                  napi_callback_info info) {
+  LOG_CALL("VertexAttrib1fv");
 
   napi_status nstatus;
 
-  size_t argc = 5;
-  napi_value args[5];
+  size_t argc = 2;
+  napi_value args[2];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
   ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[3], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[4], nullptr);
 
   GLuint index;
   nstatus = napi_get_value_uint32(env, args[0], &index);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  double v0;
-  nstatus = napi_get_value_double(env, args[1], &v0);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  double v1;
-  nstatus = napi_get_value_double(env, args[1], &v1);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  double v2;
-  nstatus = napi_get_value_double(env, args[1], &v2);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  double v3;
-  nstatus = napi_get_value_double(env, args[1], &v3);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
   WebGLRenderingContext *context = nullptr;
   nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glVertexAttrib4f(index, v0, v1, v2, v3);
+  ArrayLikeBuffer alb;
+  nstatus = GetArrayLikeBuffer(env, args[1], context->scratch_arena_, &alb);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  context->eglContextWrapper_->glVertexAttrib3fv(
+      index, static_cast<GLfloat *>(alb.data));
 
 #if DEBUG
   context->CheckForErrors();
@@ -5523,14 +6197,14 @@ napi_value WebGLRenderingContext::VertexAttrib4fv(napi_env env,
   nstatus = napi_get_value_uint32(env, args[0], &index);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  ArrayLikeBuffer alb;
-  nstatus = GetArrayLikeBuffer(env, args[1], &alb);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
   WebGLRenderingContext *context = nullptr;
   nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
+  ArrayLikeBuffer alb;
+  nstatus = GetArrayLikeBuffer(env, args[1], context->scratch_arena_, &alb);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
   context->eglContextWrapper_->glVertexAttrib4fv(
       index, static_cast<GLfloat *>(alb.data));
 
@@ -5541,55 +6215,19 @@ napi_value WebGLRenderingContext::VertexAttrib4fv(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::VertexAttribPointer(napi_env env,
-                                                      napi_callback_info info) {
-  LOG_CALL("VertexAttribPointer");
-  napi_status nstatus;
-
-  size_t argc = 6;
-  napi_value args[6];
-  napi_value js_this;
-  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 6, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  uint32_t index;
-  nstatus = napi_get_value_uint32(env, args[0], &index);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-  GLint size;
-  nstatus = napi_get_value_int32(env, args[1], &size);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
-  GLenum type;
-  nstatus = napi_get_value_uint32(env, args[2], &type);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  ENSURE_VALUE_IS_BOOLEAN_RETVAL(env, args[3], nullptr);
-  bool normalized;
-  nstatus = napi_get_value_bool(env, args[3], &normalized);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[4], nullptr);
-  GLsizei stride;
-  nstatus = napi_get_value_int32(env, args[4], &stride);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[5], nullptr);
-  uint32_t offset;
-  nstatus = napi_get_value_uint32(env, args[5], &offset);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+napi_value WebGLRenderingContext::WaitHandoff(napi_env env,
+                                              napi_callback_info info) {
+  LOG_CALL("WaitHandoff");
 
   WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
+  uint32_t handle;
+  napi_status nstatus = GetContextParam(env, info, &context, &handle);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  context->eglContextWrapper_->glVertexAttribPointer(
-      index, size, type, normalized, stride,
-      reinterpret_cast<GLvoid *>(offset));
+  if (!context->share_group_->Wait(context->eglContextWrapper_, handle)) {
+    NAPI_THROW_ERROR(env, "Unknown or already waited handoff");
+    return nullptr;
+  }
 
 #if DEBUG
   context->CheckForErrors();
@@ -5598,49 +6236,77 @@ napi_value WebGLRenderingContext::VertexAttribPointer(napi_env env,
 }
 
 /* static */
-napi_value WebGLRenderingContext::Viewport(napi_env env,
-                                           napi_callback_info info) {
-  LOG_CALL("Viewport");
+napi_value WebGLRenderingContext::WaitSyncAsync(napi_env env,
+                                                napi_callback_info info) {
+  LOG_CALL("WaitSyncAsync");
+
   napi_status nstatus;
 
-  size_t argc = 4;
-  napi_value args[4];
+  size_t argc = 2;
+  napi_value args[2];
   napi_value js_this;
   nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-  ENSURE_ARGC_RETVAL(env, argc, 4, nullptr);
-
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
-  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[3], nullptr);
+  if (argc < 1) {
+    NAPI_THROW_ERROR(env, "Sync is required");
+    return nullptr;
+  }
 
-  GLint x;
-  nstatus = napi_get_value_int32(env, args[0], &x);
+  WebGLRenderingContext *context = nullptr;
+  nstatus = UnwrapContext(env, js_this, &context);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLint y;
-  nstatus = napi_get_value_int32(env, args[1], &y);
+  uint32_t handle;
+  nstatus = GetNapiArg(env, args[0], &handle);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  GLsizei width;
-  nstatus = napi_get_value_int32(env, args[2], &width);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  // Waits forever unless a timeout in nanoseconds is passed.
+  GLuint64 timeout = GL_TIMEOUT_IGNORED;
+  if (argc > 1) {
+    nstatus = GetTimeoutArg(env, args[1], false, &timeout);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  }
 
-  GLsizei height;
-  nstatus = napi_get_value_int32(env, args[3], &height);
+  napi_deferred deferred;
+  napi_value promise_value;
+  nstatus = napi_create_promise(env, &deferred, &promise_value);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  WebGLRenderingContext *context = nullptr;
-  nstatus = UnwrapContext(env, js_this, &context);
+  GLsync sync = context->sync_pool_->Get(handle);
+  if (!sync) {
+    RejectWithError(env, deferred, "Invalid WebGLSync");
+    return promise_value;
+  }
+
+  // A collected WebGLSync deletes its fence, so the wrapper is kept alive
+  // until the wait is over.
+  napi_valuetype sync_type;
+  nstatus = napi_typeof(env, args[0], &sync_type);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  napi_ref sync_ref = nullptr;
+  if (sync_type == napi_object) {
+    nstatus = napi_create_reference(env, args[0], 1, &sync_ref);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  }
 
-  context->eglContextWrapper_->glViewport(x, y, width, height);
+  nstatus = context->GetFencePoller()->Add(
+      sync, timeout, [deferred, sync_ref](napi_env env, GLenum status) {
+        if (sync_ref) {
+          napi_delete_reference(env, sync_ref);
+        }
+        napi_value status_value;
+        napi_status nstatus = napi_create_uint32(env, status, &status_value);
+        ENSURE_NAPI_OK(env, nstatus);
+        napi_resolve_deferred(env, deferred, status_value);
+      });
+  if (nstatus != napi_ok) {
+    if (sync_ref) {
+      napi_delete_reference(env, sync_ref);
+    }
+    RejectWithError(env, deferred, "Could not wait for WebGLSync");
+  }
 
-#if DEBUG
-  context->CheckForErrors();
-#endif
-  return nullptr;
+  return promise_value;
 }
 
 }  // namespace nodejsgl
@@ -20,182 +20,229 @@
 
 #include <node_api.h>
 
-#include <atomic>
+#include <memory>
+#include <vector>
 
 #include "egl_context_wrapper.h"
+#include "webgl_buffer_mappings.h"
+#include "webgl_command_thread.h"
+#include "webgl_fence_poller.h"
+#include "webgl_memory_tracker.h"
+#include "webgl_object_registry.h"
+#include "webgl_parameters.h"
+#include "webgl_program_binary_cache.h"
+#include "webgl_program_cache.h"
+#include "webgl_scratch_arena.h"
+#include "webgl_share_group.h"
+#include "webgl_state_cache.h"
+#include "webgl_stream_buffer.h"
+#include "webgl_sync.h"
+#include "webgl_texture_pool.h"
 
 namespace nodejsgl {
 
+template <typename Callee, typename R, typename... Args>
+struct NapiThunk;
+
+// Compile-time generated N-API callback for a GL entry point, see GL_THUNK().
+template <typename T, T EGLContextWrapper::*Fn>
+struct GLCall;
+
+// Compile-time generated N-API callback for an entry point on one of the
+// context caches, see STATE_CACHE_THUNK() and PROGRAM_CACHE_THUNK().
+template <typename T, T Fn>
+struct CacheCall;
+
 class WebGLRenderingContext {
  public:
   static napi_status Register(napi_env env, napi_value exports);
   static napi_status NewInstance(napi_env env, napi_value* instance,
                                  napi_callback_info info);
 
+  // Waits for work queued on the command thread, if any, and makes the
+  // context current. Must be called before the context is used from the JS
+  // thread.
+  void MakeCurrent() {
+    if (command_thread_) {
+      command_thread_->Synchronize();
+    }
+    if (eglContextWrapper_) {
+      eglContextWrapper_->MakeCurrent();
+    }
+  }
+
+  GLCommandThread* command_thread() { return command_thread_; }
+
  private:
-  WebGLRenderingContext(napi_env env, GLContextOptions opts);
+  // Joins the share group of |share_with| if set.
+  WebGLRenderingContext(napi_env env, GLContextOptions opts,
+                        WebGLRenderingContext* share_with);
   ~WebGLRenderingContext();
 
   static napi_value InitInternal(napi_env env, napi_callback_info info);
   static void Cleanup(napi_env env, void* native, void* hint);
 
-  // User facing methods:
-  static napi_value ActiveTexture(napi_env env, napi_callback_info info);
-  static napi_value AttachShader(napi_env env, napi_callback_info info);
+  // User facing methods that need more than argument decoding. Entry points
+  // that map 1:1 onto GL are registered with GL_THUNK() in Register().
+  static napi_value AcquireTexture(napi_env env, napi_callback_info info);
   static napi_value BindAttribLocation(napi_env env, napi_callback_info info);
-  static napi_value BindBuffer(napi_env env, napi_callback_info info);
-  static napi_value BindFramebuffer(napi_env env, napi_callback_info info);
-  static napi_value BindRenderbuffer(napi_env env, napi_callback_info info);
-  static napi_value BindTexture(napi_env env, napi_callback_info info);
-  static napi_value BlendColor(napi_env env, napi_callback_info info);
-  static napi_value BlendEquation(napi_env env, napi_callback_info info);
-  static napi_value BlendEquationSeparate(napi_env env,
-                                          napi_callback_info info);
-  static napi_value BlendFunc(napi_env env, napi_callback_info info);
-  static napi_value BlendFuncSeparate(napi_env env, napi_callback_info info);
   static napi_value BufferData(napi_env env, napi_callback_info info);
   static napi_value BufferSubData(napi_env env, napi_callback_info info);
-  static napi_value CheckFramebufferStatus(napi_env env,
-                                           napi_callback_info info);
-  static napi_value Clear(napi_env env, napi_callback_info info);
-  static napi_value ClearColor(napi_env env, napi_callback_info info);
-  static napi_value ClearDepth(napi_env env, napi_callback_info info);
-  static napi_value ClearStencil(napi_env env, napi_callback_info info);
   static napi_value ClientWaitSync(napi_env env, napi_callback_info info);
-  static napi_value ColorMask(napi_env env, napi_callback_info info);
-  static napi_value CompileShader(napi_env env, napi_callback_info info);
   static napi_value CompressedTexImage2D(napi_env env, napi_callback_info info);
   static napi_value CompressedTexSubImage2D(napi_env env,
                                             napi_callback_info info);
-  static napi_value CopyTexImage2D(napi_env env, napi_callback_info info);
-  static napi_value CopyTexSubImage2D(napi_env env, napi_callback_info info);
   static napi_value CreateBuffer(napi_env env, napi_callback_info info);
   static napi_value CreateFramebuffer(napi_env env, napi_callback_info info);
   static napi_value CreateProgram(napi_env env, napi_callback_info info);
   static napi_value CreateRenderbuffer(napi_env env, napi_callback_info info);
   static napi_value CreateShader(napi_env env, napi_callback_info info);
   static napi_value CreateTexture(napi_env env, napi_callback_info info);
-  static napi_value CullFace(napi_env env, napi_callback_info info);
+  static napi_value CreateUniformLayout(napi_env env, napi_callback_info info);
   static napi_value DeleteBuffer(napi_env env, napi_callback_info info);
   static napi_value DeleteFramebuffer(napi_env env, napi_callback_info info);
   static napi_value DeleteProgram(napi_env env, napi_callback_info info);
   static napi_value DeleteRenderbuffer(napi_env env, napi_callback_info info);
   static napi_value DeleteShader(napi_env env, napi_callback_info info);
+  static napi_value DeleteSync(napi_env env, napi_callback_info info);
   static napi_value DeleteTexture(napi_env env, napi_callback_info info);
-  static napi_value DepthFunc(napi_env env, napi_callback_info info);
-  static napi_value DepthMask(napi_env env, napi_callback_info info);
-  static napi_value DepthRange(napi_env env, napi_callback_info info);
-  static napi_value DetachShader(napi_env env, napi_callback_info info);
-  static napi_value Disable(napi_env env, napi_callback_info info);
-  static napi_value DisableVertexAttribArray(napi_env env,
-                                             napi_callback_info info);
-  static napi_value DrawArrays(napi_env env, napi_callback_info info);
-  static napi_value DrawElements(napi_env env, napi_callback_info info);
-  static napi_value Enable(napi_env env, napi_callback_info info);
-  static napi_value EnableVertexAttribArray(napi_env env,
-                                            napi_callback_info info);
+  static napi_value ExecuteCommands(napi_env env, napi_callback_info info);
+  static napi_value ExecuteCommandsAsync(napi_env env,
+                                         napi_callback_info info);
   static napi_value FenceSynce(napi_env env, napi_callback_info info);
+  static napi_value FinishAsync(napi_env env, napi_callback_info info);
   // TODO(kreeger): Check alignment in CC file here
-  static napi_value Finish(napi_env env, napi_callback_info info);
-  static napi_value Flush(napi_env env, napi_callback_info info);
-  static napi_value FramebufferRenderbuffer(napi_env env,
-                                            napi_callback_info info);
-  static napi_value FramebufferTexture2D(napi_env env, napi_callback_info info);
-  static napi_value FrontFace(napi_env env, napi_callback_info info);
-  static napi_value GenerateMipmap(napi_env env, napi_callback_info info);
   static napi_value GetAttachedShaders(napi_env env, napi_callback_info info);
   static napi_value GetAttribLocation(napi_env env, napi_callback_info info);
   static napi_value GetActiveAttrib(napi_env env, napi_callback_info info);
   static napi_value GetActiveUniform(napi_env env, napi_callback_info info);
   static napi_value GetBufferParameter(napi_env env, napi_callback_info info);
   static napi_value GetBufferSubData(napi_env env, napi_callback_info info);
+  static napi_value GetBufferSubDataToArrayBuffer(napi_env env,
+                                                  napi_callback_info info);
   static napi_value GetContextAttributes(napi_env env, napi_callback_info info);
-  static napi_value GetError(napi_env env, napi_callback_info info);
   static napi_value GetFramebufferAttachmentParameter(napi_env env,
                                                       napi_callback_info info);
+  static napi_value GetError(napi_env env, napi_callback_info info);
   static napi_value GetExtension(napi_env env, napi_callback_info info);
+  static napi_value GetMemoryInfo(napi_env env, napi_callback_info info);
   static napi_value GetParameter(napi_env env, napi_callback_info info);
+  static napi_value GetProgramBinaryCacheStats(napi_env env,
+                                               napi_callback_info info);
   static napi_value GetProgramInfoLog(napi_env env, napi_callback_info info);
   static napi_value GetProgramParameter(napi_env env, napi_callback_info info);
   static napi_value GetRenderbufferParameter(napi_env env,
                                              napi_callback_info info);
+  static napi_value GetScratchArenaStats(napi_env env,
+                                         napi_callback_info info);
   static napi_value GetShaderPrecisionFormat(napi_env env,
                                              napi_callback_info info);
   static napi_value GetShaderInfoLog(napi_env env, napi_callback_info info);
   static napi_value GetShaderParameter(napi_env env, napi_callback_info info);
+  static napi_value GetStateCacheStats(napi_env env, napi_callback_info info);
   static napi_value GetSupportedExtensions(napi_env env,
                                            napi_callback_info info);
   static napi_value GetTexParameter(napi_env env, napi_callback_info info);
+  static napi_value GetTexturePoolStats(napi_env env, napi_callback_info info);
   static napi_value GetUniformLocation(napi_env env, napi_callback_info info);
-  static napi_value Hint(napi_env env, napi_callback_info info);
-  static napi_value IsBuffer(napi_env env, napi_callback_info info);
   static napi_value IsContextLost(napi_env env, napi_callback_info info);
-  static napi_value IsEnabled(napi_env env, napi_callback_info info);
-  static napi_value IsFramebuffer(napi_env env, napi_callback_info info);
-  static napi_value IsProgram(napi_env env, napi_callback_info info);
-  static napi_value IsRenderbuffer(napi_env env, napi_callback_info info);
-  static napi_value IsShader(napi_env env, napi_callback_info info);
-  static napi_value IsTexture(napi_env env, napi_callback_info info);
-  static napi_value LineWidth(napi_env env, napi_callback_info info);
+  static napi_value IsSync(napi_env env, napi_callback_info info);
   static napi_value LinkProgram(napi_env env, napi_callback_info info);
-  static napi_value PixelStorei(napi_env env, napi_callback_info info);
-  static napi_value PolygonOffset(napi_env env, napi_callback_info info);
+  static napi_value LinkProgramAsync(napi_env env, napi_callback_info info);
+  static napi_value MapBufferRange(napi_env env, napi_callback_info info);
   static napi_value ReadPixels(napi_env env, napi_callback_info info);
-  static napi_value RenderbufferStorage(napi_env env, napi_callback_info info);
-  static napi_value SampleCoverage(napi_env env, napi_callback_info info);
-  static napi_value Scissor(napi_env env, napi_callback_info info);
+  static napi_value ReadPixelsAsync(napi_env env, napi_callback_info info);
+  static napi_value ReadPixelsToArrayBuffer(napi_env env,
+                                            napi_callback_info info);
+  static napi_value ReleaseTexture(napi_env env, napi_callback_info info);
+  static napi_value SetProgramBinaryCacheLimit(napi_env env,
+                                               napi_callback_info info);
+  static napi_value SetStateCacheEnabled(napi_env env,
+                                         napi_callback_info info);
+  static napi_value SetTexturePoolLimit(napi_env env, napi_callback_info info);
+  static napi_value SetUniforms(napi_env env, napi_callback_info info);
   static napi_value ShaderSource(napi_env env, napi_callback_info info);
-  static napi_value StencilFunc(napi_env env, napi_callback_info info);
-  static napi_value StencilFuncSeparate(napi_env env, napi_callback_info info);
-  static napi_value StencilMask(napi_env env, napi_callback_info info);
-  static napi_value StencilMaskSeparate(napi_env env, napi_callback_info info);
-  static napi_value StencilOp(napi_env env, napi_callback_info info);
-  static napi_value StencilOpSeparate(napi_env env, napi_callback_info info);
+  static napi_value SignalHandoff(napi_env env, napi_callback_info info);
+  static napi_value StreamWrite(napi_env env, napi_callback_info info);
   static napi_value TexImage2D(napi_env env, napi_callback_info info);
-  static napi_value TexParameteri(napi_env env, napi_callback_info info);
-  static napi_value TexParameterf(napi_env env, napi_callback_info info);
   static napi_value TexSubImage2D(napi_env env, napi_callback_info info);
-  static napi_value Uniform1i(napi_env env, napi_callback_info info);
   static napi_value Uniform1iv(napi_env env, napi_callback_info info);
-  static napi_value Uniform1f(napi_env env, napi_callback_info info);
   static napi_value Uniform1fv(napi_env env, napi_callback_info info);
-  static napi_value Uniform2i(napi_env env, napi_callback_info info);
-  static napi_value Uniform2f(napi_env env, napi_callback_info info);
   static napi_value Uniform2fv(napi_env env, napi_callback_info info);
   static napi_value Uniform2iv(napi_env env, napi_callback_info info);
-  static napi_value Uniform3i(napi_env env, napi_callback_info info);
   static napi_value Uniform3iv(napi_env env, napi_callback_info info);
-  static napi_value Uniform3f(napi_env env, napi_callback_info info);
   static napi_value Uniform3fv(napi_env env, napi_callback_info info);
   static napi_value Uniform4fv(napi_env env, napi_callback_info info);
-  static napi_value Uniform4i(napi_env env, napi_callback_info info);
   static napi_value Uniform4iv(napi_env env, napi_callback_info info);
-  static napi_value Uniform4f(napi_env env, napi_callback_info info);
   static napi_value UniformMatrix2fv(napi_env env, napi_callback_info info);
   static napi_value UniformMatrix3fv(napi_env env, napi_callback_info info);
   static napi_value UniformMatrix4fv(napi_env env, napi_callback_info info);
-  static napi_value UseProgram(napi_env env, napi_callback_info info);
-  static napi_value ValidateProgram(napi_env env, napi_callback_info info);
-  static napi_value VertexAttrib1f(napi_env env, napi_callback_info info);
+  static napi_value UnmapBuffer(napi_env env, napi_callback_info info);
   static napi_value VertexAttrib1fv(napi_env env, napi_callback_info info);
-  static napi_value VertexAttrib2f(napi_env env, napi_callback_info info);
   static napi_value VertexAttrib2fv(napi_env env, napi_callback_info info);
-  static napi_value VertexAttrib3f(napi_env env, napi_callback_info info);
   static napi_value VertexAttrib3fv(napi_env env, napi_callback_info info);
-  static napi_value VertexAttrib4f(napi_env env, napi_callback_info info);
   static napi_value VertexAttrib4fv(napi_env env, napi_callback_info info);
-  static napi_value VertexAttribPointer(napi_env env, napi_callback_info info);
-  static napi_value Viewport(napi_env env, napi_callback_info info);
+  static napi_value WaitHandoff(napi_env env, napi_callback_info info);
+  static napi_value WaitSyncAsync(napi_env env, napi_callback_info info);
 
-  static napi_ref constructor_ref_;
+  template <typename Callee, typename R, typename... Args>
+  friend struct NapiThunk;
+  template <typename T, T EGLContextWrapper::*Fn>
+  friend struct GLCall;
+  template <typename T, T Fn>
+  friend struct CacheCall;
+
+  static char constructor_key_;
 
   bool CheckForErrors();
 
+  // Returns a new object of |type| as a number, or as a WebGLObject wrapper
+  // if the context wraps objects. Fences are always wrapped.
+  napi_status CreateObjectValue(GLObjectType type, GLuint name,
+                                napi_value* result);
+
+  // Creates the fence poller on first use.
+  GLFencePoller* GetFencePoller();
+
+  // Returns the streamWrite() ring for |target|, creating it on first use, or
+  // nullptr if |target| can't be streamed to.
+  GLStreamBuffer* GetStreamBuffer(GLenum target);
+
+  // Returns the cache of type |T| used by CacheCall.
+  template <typename T>
+  T* GetCache();
+
+  // Reads the value of a getParameter() name from the cached limits, the
+  // state cache or the driver, depending on |param.source|.
+  void GetParameterValues(const ParameterInfo& param, GLboolean* values);
+  void GetParameterValues(const ParameterInfo& param, GLfloat* values);
+  void GetParameterValues(const ParameterInfo& param, GLint64* values);
+
   napi_env env_;
   napi_ref ref_;
   EGLContextWrapper* eglContextWrapper_;
+  GLStateCache* state_cache_;
+  GLProgramCache* program_cache_;
+  // Only set with the |programBinaryCacheDir| context option.
+  GLProgramBinaryCache* program_binary_cache_;
+  GLFencePoller* fence_poller_;
+  GLCommandThread* command_thread_;
+  GLSyncPool* sync_pool_;
+  ScratchArena* scratch_arena_;
+  GLMemoryTracker* memory_tracker_;
+  GLTexturePool* texture_pool_;
+  GLBufferMappings* buffer_mappings_;
+  // Indexed by StreamBufferIndex().
+  GLStreamBuffer* stream_buffers_[3];
+  std::shared_ptr<GLObjectRegistry> object_registry_;
+  std::shared_ptr<GLShareGroup> share_group_;
+  GLContextLimits limits_;
+  // GL errors read by the program binary cache, reported by getError() before
+  // those still pending in the driver.
+  std::vector<GLenum> pending_errors_;
 
-  std::atomic<size_t> alloc_count_;
+  // Whether create*() returns WebGLObject wrappers instead of numbers.
+  bool wrap_objects_;
 };
 
 }  // namespace nodejsgl
@@ -0,0 +1,107 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "webgl_scratch_arena.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace nodejsgl {
+
+ScratchArena::ScratchArena()
+    : block_(0),
+      offset_(0),
+      capacity_(0),
+      inline_allocations_(0),
+      arena_allocations_(0),
+      heap_allocations_(0) {}
+
+ScratchArena::~ScratchArena() { FreeBlocks(0); }
+
+ScratchArena::Mark ScratchArena::GetMark() const {
+  Mark mark;
+  mark.block = block_;
+  mark.offset = offset_;
+  return mark;
+}
+
+void* ScratchArena::Allocate(size_t size) {
+  size = (size + kAlignment - 1) & ~(kAlignment - 1);
+  arena_allocations_++;
+
+  if (!blocks_.empty() && size <= blocks_[block_].size - offset_) {
+    void* data = blocks_[block_].data + offset_;
+    offset_ += size;
+    return data;
+  }
+
+  // Move on to the next block. Blocks after |block_| are unused, so one that
+  // is too small is dropped and replaced by a larger one.
+  size_t next = blocks_.empty() ? 0 : block_ + 1;
+  if (next < blocks_.size() && blocks_[next].size < size) {
+    FreeBlocks(next);
+  }
+  if (next == blocks_.size() && !AddBlock(size)) {
+    return nullptr;
+  }
+
+  block_ = next;
+  offset_ = size;
+  return blocks_[block_].data;
+}
+
+void ScratchArena::Rewind(const Mark& mark) {
+  block_ = mark.block;
+  offset_ = mark.offset;
+  if (block_ != 0 || offset_ != 0) {
+    return;
+  }
+
+  // The arena is empty. Trim it, and merge blocks so the next call that
+  // needs the same amount of memory is served from a single block.
+  if (capacity_ > kMaxRetainedBytes) {
+    FreeBlocks(0);
+  } else if (blocks_.size() > 1) {
+    size_t total = capacity_;
+    FreeBlocks(0);
+    AddBlock(total);
+  }
+}
+
+bool ScratchArena::AddBlock(size_t size) {
+  size_t last_size = blocks_.empty() ? 0 : blocks_.back().size;
+  Block block;
+  block.size = std::max(size, std::max(kMinBlockSize, last_size * 2));
+  block.data = static_cast<uint8_t*>(malloc(block.size));
+  if (block.data == nullptr) {
+    return false;
+  }
+  blocks_.push_back(block);
+  capacity_ += block.size;
+  heap_allocations_++;
+  return true;
+}
+
+void ScratchArena::FreeBlocks(size_t first) {
+  for (size_t i = first; i < blocks_.size(); i++) {
+    free(blocks_[i].data);
+    capacity_ -= blocks_[i].size;
+  }
+  blocks_.resize(first);
+}
+
+}  // namespace nodejsgl
@@ -0,0 +1,95 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef NODEJS_GL_WEBGL_SCRATCH_ARENA_H_
+#define NODEJS_GL_WEBGL_SCRATCH_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nodejsgl {
+
+// Bump allocator for short-lived conversions of JS values, e.g. plain Arrays
+// passed to uniform*v() or bufferData(). Allocations are released in LIFO order
+// by rewinding to a Mark(). The arena keeps its blocks between calls, so once
+// it has grown to the working set, conversions no longer touch the heap. Each
+// context owns one arena and it is not thread-safe.
+class ScratchArena {
+ public:
+  struct Mark {
+    size_t block;
+    size_t offset;
+  };
+
+  ScratchArena();
+  ~ScratchArena();
+
+  Mark GetMark() const;
+
+  // Returns |size| bytes, 8-byte aligned, that stay valid until the arena is
+  // rewound to a mark taken before this call. Returns nullptr if out of
+  // memory.
+  void* Allocate(size_t size);
+
+  // Releases everything allocated after |mark|.
+  void Rewind(const Mark& mark);
+
+  // Counts a conversion that fit in the caller's inline storage, so it can be
+  // told apart from arena allocations in the stats.
+  void CountInlineAllocation() { inline_allocations_++; }
+
+  uint64_t inline_allocations() const { return inline_allocations_; }
+  uint64_t arena_allocations() const { return arena_allocations_; }
+  uint64_t heap_allocations() const { return heap_allocations_; }
+
+  // Bytes currently held by the arena.
+  size_t capacity() const { return capacity_; }
+
+ private:
+  static const size_t kAlignment = 8;
+  static const size_t kMinBlockSize = 4096;
+
+  // Memory kept once the arena is empty again. Anything above is freed so a
+  // single huge Array does not pin memory for the lifetime of the context.
+  static const size_t kMaxRetainedBytes = 1024 * 1024;
+
+  struct Block {
+    uint8_t* data;
+    size_t size;
+  };
+
+  // Adds a block of at least |size| bytes at the end of |blocks_|. Returns
+  // false if out of memory.
+  bool AddBlock(size_t size);
+
+  // Frees the blocks from |first| on.
+  void FreeBlocks(size_t first);
+
+  std::vector<Block> blocks_;
+  size_t block_;   // Block that is being bumped.
+  size_t offset_;  // Bytes used in |block_|.
+  size_t capacity_;
+
+  uint64_t inline_allocations_;
+  uint64_t arena_allocations_;
+  uint64_t heap_allocations_;
+};
+
+}  // namespace nodejsgl
+
+#endif  // NODEJS_GL_WEBGL_SCRATCH_ARENA_H_
@@ -0,0 +1,113 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "webgl_share_group.h"
+
+#include <algorithm>
+
+#include "angle/include/GLES3/gl3.h"
+
+namespace nodejsgl {
+
+GLShareGroup::GLShareGroup() : next_handle_(1) {}
+
+GLShareGroup::~GLShareGroup() {}
+
+void GLShareGroup::AddContext(GLObjectRegistry* registry) {
+  registries_.push_back(registry);
+  registry->set_share_group(this);
+  registry->program_cache()->set_share_group(this);
+  if (registries_.size() > 1) {
+    for (GLObjectRegistry* member : registries_) {
+      member->program_cache()->set_shared();
+    }
+  }
+}
+
+void GLShareGroup::RemoveContext(EGLContextWrapper* egl_context_wrapper,
+                                 GLObjectRegistry* registry) {
+  registries_.erase(
+      std::remove(registries_.begin(), registries_.end(), registry),
+      registries_.end());
+  if (!registries_.empty()) {
+    return;
+  }
+  for (auto& entry : fences_) {
+    if (entry.second) {
+      egl_context_wrapper->glDeleteSync(entry.second);
+    }
+  }
+  fences_.clear();
+}
+
+bool GLShareGroup::HasContext(EGLContextWrapper* egl_context_wrapper) const {
+  for (const GLObjectRegistry* registry : registries_) {
+    if (registry->egl_context_wrapper() == egl_context_wrapper) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void GLShareGroup::OnProgramChanged(GLuint program) {
+  for (GLObjectRegistry* registry : registries_) {
+    registry->ForgetProgram(program);
+  }
+}
+
+void GLShareGroup::OnObjectsDeleted(GLObjectRegistry* registry,
+                                    GLObjectType type, GLsizei count,
+                                    const GLuint* names) {
+  for (GLObjectRegistry* member : registries_) {
+    member->ForgetObjects(type, count, names, member == registry);
+  }
+}
+
+uint32_t GLShareGroup::Signal(EGLContextWrapper* egl_context_wrapper,
+                              bool use_fences) {
+  GLsync sync = nullptr;
+  if (use_fences) {
+    sync = egl_context_wrapper->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    // Other contexts can only wait for a fence that reached the GPU.
+    egl_context_wrapper->glFlush();
+  } else {
+    egl_context_wrapper->glFinish();
+  }
+
+  uint32_t handle = next_handle_++;
+  if (next_handle_ == 0) {
+    next_handle_ = 1;
+  }
+  fences_[handle] = sync;
+  return handle;
+}
+
+bool GLShareGroup::Wait(EGLContextWrapper* egl_context_wrapper,
+                        uint32_t handle) {
+  auto it = fences_.find(handle);
+  if (it == fences_.end()) {
+    return false;
+  }
+  if (it->second) {
+    egl_context_wrapper->glWaitSync(it->second, 0, GL_TIMEOUT_IGNORED);
+    egl_context_wrapper->glDeleteSync(it->second);
+  }
+  fences_.erase(it);
+  return true;
+}
+
+}  // namespace nodejsgl
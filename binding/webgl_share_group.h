@@ -0,0 +1,86 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef NODEJS_GL_WEBGL_SHARE_GROUP_H_
+#define NODEJS_GL_WEBGL_SHARE_GROUP_H_
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "egl_context_wrapper.h"
+#include "webgl_object_registry.h"
+
+namespace nodejsgl {
+
+// Contexts created with the |shareWith| option share textures, buffers,
+// renderbuffers, programs, shaders, samplers and fences with the context they
+// were created from, so object handles of one context are valid in the
+// others. Framebuffers, vertex arrays and transform feedbacks are not shared,
+// as in GL.
+//
+// Every context starts in a group of its own. The group keeps the caches of
+// its contexts coherent, through their object registries, and hands fences
+// from the context that produced a resource to the one that consumes it.
+class GLShareGroup {
+ public:
+  GLShareGroup();
+  ~GLShareGroup();
+
+  // Once a group has more than one context, its program caches stop eliding
+  // uniform uploads: uniform values are program state that another context
+  // may change.
+  void AddContext(GLObjectRegistry* registry);
+
+  // Deletes the fences that were never waited for when the last context
+  // leaves. |egl_context_wrapper| must be current.
+  void RemoveContext(EGLContextWrapper* egl_context_wrapper,
+                     GLObjectRegistry* registry);
+
+  // Returns true if |egl_context_wrapper| is the context of a member.
+  bool HasContext(EGLContextWrapper* egl_context_wrapper) const;
+
+  // Drops the reflection of |program| in every context of the group. Waits
+  // for the command thread of each context, which may be reading it.
+  void OnProgramChanged(GLuint program);
+
+  // Disowns the wrappers of |count| shared objects deleted through
+  // |registry| in every context of the group and updates their caches.
+  void OnObjectsDeleted(GLObjectRegistry* registry, GLObjectType type,
+                        GLsizei count, const GLuint* names);
+
+  // Inserts a fence after the commands issued so far by the current context,
+  // flushes them and returns the handle of the fence (never 0). Without
+  // |use_fences| (ES2 contexts) this waits for the commands to finish instead.
+  uint32_t Signal(EGLContextWrapper* egl_context_wrapper, bool use_fences);
+
+  // Makes the GPU wait for the fence of |handle| before it runs later
+  // commands of the current context, without blocking the calling thread.
+  // The fence is deleted, so a handle can be waited for once. Returns false if
+  // |handle| is unknown.
+  bool Wait(EGLContextWrapper* egl_context_wrapper, uint32_t handle);
+
+ private:
+  std::vector<GLObjectRegistry*> registries_;
+  // nullptr for handoffs signaled without fences.
+  std::unordered_map<uint32_t, GLsync> fences_;
+  uint32_t next_handle_;
+};
+
+}  // namespace nodejsgl
+
+#endif  // NODEJS_GL_WEBGL_SHARE_GROUP_H_
@@ -0,0 +1,873 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "webgl_state_cache.h"
+
+#include "utils.h"
+
+#include <cstring>
+
+namespace nodejsgl {
+
+GLStateCache::GLStateCache(EGLContextWrapper* egl_context_wrapper)
+    : egl_(egl_context_wrapper),
+      enabled_(true),
+      elided_calls_(0),
+      forwarded_calls_(0) {}
+
+void GLStateCache::Init() {
+  // Everything but the viewport and scissor box starts out with the defaults
+  // from the GLES spec, which avoids querying ES3-only state on ES2 contexts.
+  active_texture_ = GL_TEXTURE0;
+
+  GLint max_texture_units = 0;
+  egl_->glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &max_texture_units);
+  texture_units_.resize(max_texture_units);
+  memset(texture_units_.data(), 0, sizeof(TextureUnit) * texture_units_.size());
+
+  memset(buffer_bindings_, 0, sizeof(buffer_bindings_));
+  draw_framebuffer_ = 0;
+  read_framebuffer_ = 0;
+  renderbuffer_ = 0;
+  program_ = 0;
+
+  for (size_t i = 0; i < ARRAY_SIZE(capabilities_); ++i) {
+    capabilities_[i] = false;
+  }
+  capabilities_[CapabilityIndex(GL_DITHER)] = true;
+
+  for (size_t i = 0; i < 4; ++i) {
+    clear_color_[i] = 0.0f;
+    blend_color_[i] = 0.0f;
+    color_mask_[i] = GL_TRUE;
+  }
+  clear_depth_ = 1.0f;
+  clear_stencil_ = 0;
+
+  blend_equation_rgb_ = GL_FUNC_ADD;
+  blend_equation_alpha_ = GL_FUNC_ADD;
+  blend_src_rgb_ = GL_ONE;
+  blend_dst_rgb_ = GL_ZERO;
+  blend_src_alpha_ = GL_ONE;
+  blend_dst_alpha_ = GL_ZERO;
+
+  cull_face_mode_ = GL_BACK;
+  front_face_ = GL_CCW;
+  line_width_ = 1.0f;
+  polygon_offset_factor_ = 0.0f;
+  polygon_offset_units_ = 0.0f;
+  sample_coverage_value_ = 1.0f;
+  sample_coverage_invert_ = GL_FALSE;
+
+  generate_mipmap_hint_ = GL_DONT_CARE;
+  fragment_shader_derivative_hint_ = GL_DONT_CARE;
+  memset(pixel_store_, 0, sizeof(pixel_store_));
+  pixel_store_[PixelStoreIndex(GL_PACK_ALIGNMENT)] = 4;
+  pixel_store_[PixelStoreIndex(GL_UNPACK_ALIGNMENT)] = 4;
+
+  depth_func_ = GL_LESS;
+  depth_mask_ = GL_TRUE;
+  depth_range_[0] = 0.0f;
+  depth_range_[1] = 1.0f;
+
+  stencil_front_.func = GL_ALWAYS;
+  stencil_front_.ref = 0;
+  stencil_front_.value_mask = 0xFFFFFFFF;
+  stencil_front_.write_mask = 0xFFFFFFFF;
+  stencil_front_.fail = GL_KEEP;
+  stencil_front_.zfail = GL_KEEP;
+  stencil_front_.zpass = GL_KEEP;
+  stencil_back_ = stencil_front_;
+
+  egl_->glGetIntegerv(GL_VIEWPORT, viewport_);
+  egl_->glGetIntegerv(GL_SCISSOR_BOX, scissor_box_);
+}
+
+/* static */
+int GLStateCache::BufferTargetIndex(GLenum target) {
+  switch (target) {
+    case GL_ARRAY_BUFFER:
+      return 0;
+    case GL_ELEMENT_ARRAY_BUFFER:
+      return 1;
+    case GL_COPY_READ_BUFFER:
+      return 2;
+    case GL_COPY_WRITE_BUFFER:
+      return 3;
+    case GL_PIXEL_PACK_BUFFER:
+      return 4;
+    case GL_PIXEL_UNPACK_BUFFER:
+      return 5;
+    case GL_TRANSFORM_FEEDBACK_BUFFER:
+      return 6;
+    case GL_UNIFORM_BUFFER:
+      return 7;
+    default:
+      return -1;
+  }
+}
+
+/* static */
+int GLStateCache::CapabilityIndex(GLenum cap) {
+  switch (cap) {
+    case GL_BLEND:
+      return 0;
+    case GL_CULL_FACE:
+      return 1;
+    case GL_DEPTH_TEST:
+      return 2;
+    case GL_DITHER:
+      return 3;
+    case GL_POLYGON_OFFSET_FILL:
+      return 4;
+    case GL_SAMPLE_ALPHA_TO_COVERAGE:
+      return 5;
+    case GL_SAMPLE_COVERAGE:
+      return 6;
+    case GL_SCISSOR_TEST:
+      return 7;
+    case GL_STENCIL_TEST:
+      return 8;
+    case GL_RASTERIZER_DISCARD:
+      return 9;
+    case GL_PRIMITIVE_RESTART_FIXED_INDEX:
+      return 10;
+    default:
+      return -1;
+  }
+}
+
+/* static */
+int GLStateCache::PixelStoreIndex(GLenum pname) {
+  switch (pname) {
+    case GL_PACK_ALIGNMENT:
+      return 0;
+    case GL_UNPACK_ALIGNMENT:
+      return 1;
+    case GL_PACK_ROW_LENGTH:
+      return 2;
+    case GL_PACK_SKIP_PIXELS:
+      return 3;
+    case GL_PACK_SKIP_ROWS:
+      return 4;
+    case GL_UNPACK_ROW_LENGTH:
+      return 5;
+    case GL_UNPACK_IMAGE_HEIGHT:
+      return 6;
+    case GL_UNPACK_SKIP_PIXELS:
+      return 7;
+    case GL_UNPACK_SKIP_ROWS:
+      return 8;
+    case GL_UNPACK_SKIP_IMAGES:
+      return 9;
+    default:
+      return -1;
+  }
+}
+
+/* static */
+int GLStateCache::TextureTargetIndex(GLenum target) {
+  switch (target) {
+    case GL_TEXTURE_2D:
+      return 0;
+    case GL_TEXTURE_CUBE_MAP:
+      return 1;
+    case GL_TEXTURE_3D:
+      return 2;
+    case GL_TEXTURE_2D_ARRAY:
+      return 3;
+    default:
+      return -1;
+  }
+}
+
+bool GLStateCache::GetBooleanv(GLenum pname, GLboolean* params) const {
+  int index = CapabilityIndex(pname);
+  if (index >= 0) {
+    params[0] = capabilities_[index] ? GL_TRUE : GL_FALSE;
+    return true;
+  }
+
+  switch (pname) {
+    case GL_COLOR_WRITEMASK:
+      memcpy(params, color_mask_, sizeof(color_mask_));
+      return true;
+    case GL_DEPTH_WRITEMASK:
+      params[0] = depth_mask_;
+      return true;
+    case GL_SAMPLE_COVERAGE_INVERT:
+      params[0] = sample_coverage_invert_;
+      return true;
+    case GL_UNPACK_FLIP_Y_WEBGL:
+    case GL_UNPACK_PREMULTIPLY_ALPHA_WEBGL:
+      // TODO(kreeger): Support these in texImage2D().
+      params[0] = GL_FALSE;
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool GLStateCache::GetFloatv(GLenum pname, GLfloat* params) const {
+  switch (pname) {
+    case GL_BLEND_COLOR:
+      memcpy(params, blend_color_, sizeof(blend_color_));
+      return true;
+    case GL_COLOR_CLEAR_VALUE:
+      memcpy(params, clear_color_, sizeof(clear_color_));
+      return true;
+    case GL_DEPTH_CLEAR_VALUE:
+      params[0] = clear_depth_;
+      return true;
+    case GL_DEPTH_RANGE:
+      memcpy(params, depth_range_, sizeof(depth_range_));
+      return true;
+    case GL_LINE_WIDTH:
+      params[0] = line_width_;
+      return true;
+    case GL_POLYGON_OFFSET_FACTOR:
+      params[0] = polygon_offset_factor_;
+      return true;
+    case GL_POLYGON_OFFSET_UNITS:
+      params[0] = polygon_offset_units_;
+      return true;
+    case GL_SAMPLE_COVERAGE_VALUE:
+      params[0] = sample_coverage_value_;
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool GLStateCache::GetInteger64v(GLenum pname, GLint64* params) const {
+  int index = PixelStoreIndex(pname);
+  if (index >= 0) {
+    params[0] = pixel_store_[index];
+    return true;
+  }
+
+  const TextureUnit& unit = texture_units_[active_texture_ - GL_TEXTURE0];
+  switch (pname) {
+    case GL_ACTIVE_TEXTURE:
+      params[0] = active_texture_;
+      return true;
+    case GL_ARRAY_BUFFER_BINDING:
+      params[0] = buffer_bindings_[BufferTargetIndex(GL_ARRAY_BUFFER)];
+      return true;
+    case GL_ELEMENT_ARRAY_BUFFER_BINDING:
+      params[0] = buffer_bindings_[BufferTargetIndex(GL_ELEMENT_ARRAY_BUFFER)];
+      return true;
+    case GL_COPY_READ_BUFFER_BINDING:
+      params[0] = buffer_bindings_[BufferTargetIndex(GL_COPY_READ_BUFFER)];
+      return true;
+    case GL_COPY_WRITE_BUFFER_BINDING:
+      params[0] = buffer_bindings_[BufferTargetIndex(GL_COPY_WRITE_BUFFER)];
+      return true;
+    case GL_PIXEL_PACK_BUFFER_BINDING:
+      params[0] = buffer_bindings_[BufferTargetIndex(GL_PIXEL_PACK_BUFFER)];
+      return true;
+    case GL_PIXEL_UNPACK_BUFFER_BINDING:
+      params[0] = buffer_bindings_[BufferTargetIndex(GL_PIXEL_UNPACK_BUFFER)];
+      return true;
+    case GL_TRANSFORM_FEEDBACK_BUFFER_BINDING:
+      params[0] =
+          buffer_bindings_[BufferTargetIndex(GL_TRANSFORM_FEEDBACK_BUFFER)];
+      return true;
+    case GL_UNIFORM_BUFFER_BINDING:
+      params[0] = buffer_bindings_[BufferTargetIndex(GL_UNIFORM_BUFFER)];
+      return true;
+    // Same value as GL_FRAMEBUFFER_BINDING:
+    case GL_DRAW_FRAMEBUFFER_BINDING:
+      params[0] = draw_framebuffer_;
+      return true;
+    case GL_READ_FRAMEBUFFER_BINDING:
+      params[0] = read_framebuffer_;
+      return true;
+    case GL_RENDERBUFFER_BINDING:
+      params[0] = renderbuffer_;
+      return true;
+    case GL_CURRENT_PROGRAM:
+      params[0] = program_;
+      return true;
+    case GL_TEXTURE_BINDING_2D:
+      params[0] = unit.bindings[TextureTargetIndex(GL_TEXTURE_2D)];
+      return true;
+    case GL_TEXTURE_BINDING_CUBE_MAP:
+      params[0] = unit.bindings[TextureTargetIndex(GL_TEXTURE_CUBE_MAP)];
+      return true;
+    case GL_TEXTURE_BINDING_3D:
+      params[0] = unit.bindings[TextureTargetIndex(GL_TEXTURE_3D)];
+      return true;
+    case GL_TEXTURE_BINDING_2D_ARRAY:
+      params[0] = unit.bindings[TextureTargetIndex(GL_TEXTURE_2D_ARRAY)];
+      return true;
+    // Same value as GL_BLEND_EQUATION:
+    case GL_BLEND_EQUATION_RGB:
+      params[0] = blend_equation_rgb_;
+      return true;
+    case GL_BLEND_EQUATION_ALPHA:
+      params[0] = blend_equation_alpha_;
+      return true;
+    case GL_BLEND_SRC_RGB:
+      params[0] = blend_src_rgb_;
+      return true;
+    case GL_BLEND_DST_RGB:
+      params[0] = blend_dst_rgb_;
+      return true;
+    case GL_BLEND_SRC_ALPHA:
+      params[0] = blend_src_alpha_;
+      return true;
+    case GL_BLEND_DST_ALPHA:
+      params[0] = blend_dst_alpha_;
+      return true;
+    case GL_CULL_FACE_MODE:
+      params[0] = cull_face_mode_;
+      return true;
+    case GL_FRONT_FACE:
+      params[0] = front_face_;
+      return true;
+    case GL_DEPTH_FUNC:
+      params[0] = depth_func_;
+      return true;
+    case GL_STENCIL_CLEAR_VALUE:
+      params[0] = clear_stencil_;
+      return true;
+    case GL_STENCIL_FUNC:
+      params[0] = stencil_front_.func;
+      return true;
+    case GL_STENCIL_REF:
+      params[0] = stencil_front_.ref;
+      return true;
+    case GL_STENCIL_VALUE_MASK:
+      params[0] = stencil_front_.value_mask;
+      return true;
+    case GL_STENCIL_WRITEMASK:
+      params[0] = stencil_front_.write_mask;
+      return true;
+    case GL_STENCIL_FAIL:
+      params[0] = stencil_front_.fail;
+      return true;
+    case GL_STENCIL_PASS_DEPTH_FAIL:
+      params[0] = stencil_front_.zfail;
+      return true;
+    case GL_STENCIL_PASS_DEPTH_PASS:
+      params[0] = stencil_front_.zpass;
+      return true;
+    case GL_STENCIL_BACK_FUNC:
+      params[0] = stencil_back_.func;
+      return true;
+    case GL_STENCIL_BACK_REF:
+      params[0] = stencil_back_.ref;
+      return true;
+    case GL_STENCIL_BACK_VALUE_MASK:
+      params[0] = stencil_back_.value_mask;
+      return true;
+    case GL_STENCIL_BACK_WRITEMASK:
+      params[0] = stencil_back_.write_mask;
+      return true;
+    case GL_STENCIL_BACK_FAIL:
+      params[0] = stencil_back_.fail;
+      return true;
+    case GL_STENCIL_BACK_PASS_DEPTH_FAIL:
+      params[0] = stencil_back_.zfail;
+      return true;
+    case GL_STENCIL_BACK_PASS_DEPTH_PASS:
+      params[0] = stencil_back_.zpass;
+      return true;
+    case GL_GENERATE_MIPMAP_HINT:
+      params[0] = generate_mipmap_hint_;
+      return true;
+    case GL_FRAGMENT_SHADER_DERIVATIVE_HINT:
+      params[0] = fragment_shader_derivative_hint_;
+      return true;
+    case GL_VIEWPORT:
+      for (size_t i = 0; i < 4; ++i) {
+        params[i] = viewport_[i];
+      }
+      return true;
+    case GL_SCISSOR_BOX:
+      for (size_t i = 0; i < 4; ++i) {
+        params[i] = scissor_box_[i];
+      }
+      return true;
+    case GL_UNPACK_COLORSPACE_CONVERSION_WEBGL:
+      params[0] = GL_BROWSER_DEFAULT_WEBGL;
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool GLStateCache::ShouldForward(bool changed) {
+  if (enabled_ && !changed) {
+    elided_calls_++;
+    return false;
+  }
+  forwarded_calls_++;
+  return true;
+}
+
+void GLStateCache::ActiveTexture(GLenum texture) {
+  if (texture < GL_TEXTURE0 ||
+      texture - GL_TEXTURE0 >= texture_units_.size()) {
+    // Let GL report the error.
+    ShouldForward(true);
+    egl_->glActiveTexture(texture);
+    return;
+  }
+  if (ShouldForward(active_texture_ != texture)) {
+    active_texture_ = texture;
+    egl_->glActiveTexture(texture);
+  }
+}
+
+void GLStateCache::BindBuffer(GLenum target, GLuint buffer) {
+  int index = BufferTargetIndex(target);
+  if (index < 0) {
+    ShouldForward(true);
+    egl_->glBindBuffer(target, buffer);
+    return;
+  }
+  if (ShouldForward(buffer_bindings_[index] != buffer)) {
+    buffer_bindings_[index] = buffer;
+    egl_->glBindBuffer(target, buffer);
+  }
+}
+
+void GLStateCache::BindFramebuffer(GLenum target, GLuint framebuffer) {
+  bool changed;
+  switch (target) {
+    case GL_FRAMEBUFFER:
+      changed = draw_framebuffer_ != framebuffer ||
+                read_framebuffer_ != framebuffer;
+      if (ShouldForward(changed)) {
+        draw_framebuffer_ = framebuffer;
+        read_framebuffer_ = framebuffer;
+        egl_->glBindFramebuffer(target, framebuffer);
+      }
+      break;
+    case GL_DRAW_FRAMEBUFFER:
+      if (ShouldForward(draw_framebuffer_ != framebuffer)) {
+        draw_framebuffer_ = framebuffer;
+        egl_->glBindFramebuffer(target, framebuffer);
+      }
+      break;
+    case GL_READ_FRAMEBUFFER:
+      if (ShouldForward(read_framebuffer_ != framebuffer)) {
+        read_framebuffer_ = framebuffer;
+        egl_->glBindFramebuffer(target, framebuffer);
+      }
+      break;
+    default:
+      ShouldForward(true);
+      egl_->glBindFramebuffer(target, framebuffer);
+      break;
+  }
+}
+
+void GLStateCache::BindRenderbuffer(GLenum target, GLuint renderbuffer) {
+  if (target != GL_RENDERBUFFER) {
+    ShouldForward(true);
+    egl_->glBindRenderbuffer(target, renderbuffer);
+    return;
+  }
+  if (ShouldForward(renderbuffer_ != renderbuffer)) {
+    renderbuffer_ = renderbuffer;
+    egl_->glBindRenderbuffer(target, renderbuffer);
+  }
+}
+
+void GLStateCache::BindTexture(GLenum target, GLuint texture) {
+  int index = TextureTargetIndex(target);
+  if (index < 0) {
+    ShouldForward(true);
+    egl_->glBindTexture(target, texture);
+    return;
+  }
+  GLuint* binding =
+      &texture_units_[active_texture_ - GL_TEXTURE0].bindings[index];
+  if (ShouldForward(*binding != texture)) {
+    *binding = texture;
+    egl_->glBindTexture(target, texture);
+  }
+}
+
+void GLStateCache::BlendColor(GLfloat red, GLfloat green, GLfloat blue,
+                              GLfloat alpha) {
+  bool changed = blend_color_[0] != red || blend_color_[1] != green ||
+                 blend_color_[2] != blue || blend_color_[3] != alpha;
+  if (ShouldForward(changed)) {
+    blend_color_[0] = red;
+    blend_color_[1] = green;
+    blend_color_[2] = blue;
+    blend_color_[3] = alpha;
+    egl_->glBlendColor(red, green, blue, alpha);
+  }
+}
+
+void GLStateCache::BlendEquation(GLenum mode) {
+  bool changed = blend_equation_rgb_ != mode || blend_equation_alpha_ != mode;
+  if (ShouldForward(changed)) {
+    blend_equation_rgb_ = mode;
+    blend_equation_alpha_ = mode;
+    egl_->glBlendEquation(mode);
+  }
+}
+
+void GLStateCache::BlendEquationSeparate(GLenum mode_rgb, GLenum mode_alpha) {
+  bool changed =
+      blend_equation_rgb_ != mode_rgb || blend_equation_alpha_ != mode_alpha;
+  if (ShouldForward(changed)) {
+    blend_equation_rgb_ = mode_rgb;
+    blend_equation_alpha_ = mode_alpha;
+    egl_->glBlendEquationSeparate(mode_rgb, mode_alpha);
+  }
+}
+
+void GLStateCache::BlendFunc(GLenum sfactor, GLenum dfactor) {
+  bool changed = blend_src_rgb_ != sfactor || blend_dst_rgb_ != dfactor ||
+                 blend_src_alpha_ != sfactor || blend_dst_alpha_ != dfactor;
+  if (ShouldForward(changed)) {
+    blend_src_rgb_ = sfactor;
+    blend_dst_rgb_ = dfactor;
+    blend_src_alpha_ = sfactor;
+    blend_dst_alpha_ = dfactor;
+    egl_->glBlendFunc(sfactor, dfactor);
+  }
+}
+
+void GLStateCache::BlendFuncSeparate(GLenum src_rgb, GLenum dst_rgb,
+                                     GLenum src_alpha, GLenum dst_alpha) {
+  bool changed = blend_src_rgb_ != src_rgb || blend_dst_rgb_ != dst_rgb ||
+                 blend_src_alpha_ != src_alpha ||
+                 blend_dst_alpha_ != dst_alpha;
+  if (ShouldForward(changed)) {
+    blend_src_rgb_ = src_rgb;
+    blend_dst_rgb_ = dst_rgb;
+    blend_src_alpha_ = src_alpha;
+    blend_dst_alpha_ = dst_alpha;
+    egl_->glBlendFuncSeparate(src_rgb, dst_rgb, src_alpha, dst_alpha);
+  }
+}
+
+void GLStateCache::ClearColor(GLfloat red, GLfloat green, GLfloat blue,
+                              GLfloat alpha) {
+  bool changed = clear_color_[0] != red || clear_color_[1] != green ||
+                 clear_color_[2] != blue || clear_color_[3] != alpha;
+  if (ShouldForward(changed)) {
+    clear_color_[0] = red;
+    clear_color_[1] = green;
+    clear_color_[2] = blue;
+    clear_color_[3] = alpha;
+    egl_->glClearColor(red, green, blue, alpha);
+  }
+}
+
+void GLStateCache::ClearDepth(GLfloat depth) {
+  if (ShouldForward(clear_depth_ != depth)) {
+    clear_depth_ = depth;
+    egl_->glClearDepthf(depth);
+  }
+}
+
+void GLStateCache::ClearStencil(GLint s) {
+  if (ShouldForward(clear_stencil_ != s)) {
+    clear_stencil_ = s;
+    egl_->glClearStencil(s);
+  }
+}
+
+void GLStateCache::ColorMask(GLboolean red, GLboolean green, GLboolean blue,
+                             GLboolean alpha) {
+  bool changed = color_mask_[0] != red || color_mask_[1] != green ||
+                 color_mask_[2] != blue || color_mask_[3] != alpha;
+  if (ShouldForward(changed)) {
+    color_mask_[0] = red;
+    color_mask_[1] = green;
+    color_mask_[2] = blue;
+    color_mask_[3] = alpha;
+    egl_->glColorMask(red, green, blue, alpha);
+  }
+}
+
+void GLStateCache::CullFace(GLenum mode) {
+  if (ShouldForward(cull_face_mode_ != mode)) {
+    cull_face_mode_ = mode;
+    egl_->glCullFace(mode);
+  }
+}
+
+void GLStateCache::DepthFunc(GLenum func) {
+  if (ShouldForward(depth_func_ != func)) {
+    depth_func_ = func;
+    egl_->glDepthFunc(func);
+  }
+}
+
+void GLStateCache::DepthMask(GLboolean flag) {
+  if (ShouldForward(depth_mask_ != flag)) {
+    depth_mask_ = flag;
+    egl_->glDepthMask(flag);
+  }
+}
+
+void GLStateCache::DepthRange(GLfloat z_near, GLfloat z_far) {
+  bool changed = depth_range_[0] != z_near || depth_range_[1] != z_far;
+  if (ShouldForward(changed)) {
+    depth_range_[0] = z_near;
+    depth_range_[1] = z_far;
+    egl_->glDepthRangef(z_near, z_far);
+  }
+}
+
+void GLStateCache::Disable(GLenum cap) { SetCapability(cap, false); }
+
+void GLStateCache::Enable(GLenum cap) { SetCapability(cap, true); }
+
+void GLStateCache::SetCapability(GLenum cap, bool value) {
+  int index = CapabilityIndex(cap);
+  bool changed = index < 0 || capabilities_[index] != value;
+  if (ShouldForward(changed)) {
+    if (index >= 0) {
+      capabilities_[index] = value;
+    }
+    if (value) {
+      egl_->glEnable(cap);
+    } else {
+      egl_->glDisable(cap);
+    }
+  }
+}
+
+void GLStateCache::FrontFace(GLenum mode) {
+  if (ShouldForward(front_face_ != mode)) {
+    front_face_ = mode;
+    egl_->glFrontFace(mode);
+  }
+}
+
+void GLStateCache::Hint(GLenum target, GLenum mode) {
+  GLenum* hint = nullptr;
+  if (target == GL_GENERATE_MIPMAP_HINT) {
+    hint = &generate_mipmap_hint_;
+  } else if (target == GL_FRAGMENT_SHADER_DERIVATIVE_HINT) {
+    hint = &fragment_shader_derivative_hint_;
+  }
+  if (ShouldForward(!hint || *hint != mode)) {
+    if (hint) {
+      *hint = mode;
+    }
+    egl_->glHint(target, mode);
+  }
+}
+
+void GLStateCache::LineWidth(GLfloat width) {
+  if (ShouldForward(line_width_ != width)) {
+    line_width_ = width;
+    egl_->glLineWidth(width);
+  }
+}
+
+void GLStateCache::PixelStorei(GLenum pname, GLint param) {
+  int index = PixelStoreIndex(pname);
+  if (ShouldForward(index < 0 || pixel_store_[index] != param)) {
+    if (index >= 0) {
+      pixel_store_[index] = param;
+    }
+    egl_->glPixelStorei(pname, param);
+  }
+}
+
+void GLStateCache::PolygonOffset(GLfloat factor, GLfloat units) {
+  bool changed =
+      polygon_offset_factor_ != factor || polygon_offset_units_ != units;
+  if (ShouldForward(changed)) {
+    polygon_offset_factor_ = factor;
+    polygon_offset_units_ = units;
+    egl_->glPolygonOffset(factor, units);
+  }
+}
+
+void GLStateCache::SampleCoverage(GLfloat value, GLboolean invert) {
+  bool changed =
+      sample_coverage_value_ != value || sample_coverage_invert_ != invert;
+  if (ShouldForward(changed)) {
+    sample_coverage_value_ = value;
+    sample_coverage_invert_ = invert;
+    egl_->glSampleCoverage(value, invert);
+  }
+}
+
+void GLStateCache::Scissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+  bool changed = scissor_box_[0] != x || scissor_box_[1] != y ||
+                 scissor_box_[2] != width || scissor_box_[3] != height;
+  if (ShouldForward(changed)) {
+    scissor_box_[0] = x;
+    scissor_box_[1] = y;
+    scissor_box_[2] = width;
+    scissor_box_[3] = height;
+    egl_->glScissor(x, y, width, height);
+  }
+}
+
+void GLStateCache::SetStencilFunc(StencilFaceState* face, GLenum func,
+                                  GLint ref, GLuint mask) {
+  face->func = func;
+  face->ref = ref;
+  face->value_mask = mask;
+}
+
+void GLStateCache::SetStencilOp(StencilFaceState* face, GLenum fail,
+                                GLenum zfail, GLenum zpass) {
+  face->fail = fail;
+  face->zfail = zfail;
+  face->zpass = zpass;
+}
+
+void GLStateCache::StencilFunc(GLenum func, GLint ref, GLuint mask) {
+  StencilFuncSeparate(GL_FRONT_AND_BACK, func, ref, mask);
+}
+
+void GLStateCache::StencilFuncSeparate(GLenum face, GLenum func, GLint ref,
+                                       GLuint mask) {
+  bool front = face == GL_FRONT || face == GL_FRONT_AND_BACK;
+  bool back = face == GL_BACK || face == GL_FRONT_AND_BACK;
+  bool changed =
+      (!front && !back) ||
+      (front && (stencil_front_.func != func || stencil_front_.ref != ref ||
+                 stencil_front_.value_mask != mask)) ||
+      (back && (stencil_back_.func != func || stencil_back_.ref != ref ||
+                stencil_back_.value_mask != mask));
+  if (ShouldForward(changed)) {
+    if (front) {
+      SetStencilFunc(&stencil_front_, func, ref, mask);
+    }
+    if (back) {
+      SetStencilFunc(&stencil_back_, func, ref, mask);
+    }
+    egl_->glStencilFuncSeparate(face, func, ref, mask);
+  }
+}
+
+void GLStateCache::StencilMask(GLuint mask) {
+  StencilMaskSeparate(GL_FRONT_AND_BACK, mask);
+}
+
+void GLStateCache::StencilMaskSeparate(GLenum face, GLuint mask) {
+  bool front = face == GL_FRONT || face == GL_FRONT_AND_BACK;
+  bool back = face == GL_BACK || face == GL_FRONT_AND_BACK;
+  bool changed = (!front && !back) ||
+                 (front && stencil_front_.write_mask != mask) ||
+                 (back && stencil_back_.write_mask != mask);
+  if (ShouldForward(changed)) {
+    if (front) {
+      stencil_front_.write_mask = mask;
+    }
+    if (back) {
+      stencil_back_.write_mask = mask;
+    }
+    egl_->glStencilMaskSeparate(face, mask);
+  }
+}
+
+void GLStateCache::StencilOp(GLenum fail, GLenum zfail, GLenum zpass) {
+  StencilOpSeparate(GL_FRONT_AND_BACK, fail, zfail, zpass);
+}
+
+void GLStateCache::StencilOpSeparate(GLenum face, GLenum fail, GLenum zfail,
+                                     GLenum zpass) {
+  bool front = face == GL_FRONT || face == GL_FRONT_AND_BACK;
+  bool back = face == GL_BACK || face == GL_FRONT_AND_BACK;
+  bool changed =
+      (!front && !back) ||
+      (front && (stencil_front_.fail != fail || stencil_front_.zfail != zfail ||
+                 stencil_front_.zpass != zpass)) ||
+      (back && (stencil_back_.fail != fail || stencil_back_.zfail != zfail ||
+                stencil_back_.zpass != zpass));
+  if (ShouldForward(changed)) {
+    if (front) {
+      SetStencilOp(&stencil_front_, fail, zfail, zpass);
+    }
+    if (back) {
+      SetStencilOp(&stencil_back_, fail, zfail, zpass);
+    }
+    egl_->glStencilOpSeparate(face, fail, zfail, zpass);
+  }
+}
+
+void GLStateCache::UseProgram(GLuint program) {
+  if (ShouldForward(program_ != program)) {
+    program_ = program;
+    egl_->glUseProgram(program);
+  }
+}
+
+void GLStateCache::Viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+  bool changed = viewport_[0] != x || viewport_[1] != y ||
+                 viewport_[2] != width || viewport_[3] != height;
+  if (ShouldForward(changed)) {
+    viewport_[0] = x;
+    viewport_[1] = y;
+    viewport_[2] = width;
+    viewport_[3] = height;
+    egl_->glViewport(x, y, width, height);
+  }
+}
+
+void GLStateCache::OnDeleteBuffer(GLuint buffer) {
+  if (buffer == 0) {
+    return;
+  }
+  for (size_t i = 0; i < ARRAY_SIZE(buffer_bindings_); ++i) {
+    if (buffer_bindings_[i] == buffer) {
+      buffer_bindings_[i] = 0;
+    }
+  }
+}
+
+void GLStateCache::OnDeleteFramebuffer(GLuint framebuffer) {
+  if (framebuffer == 0) {
+    return;
+  }
+  if (draw_framebuffer_ == framebuffer) {
+    draw_framebuffer_ = 0;
+  }
+  if (read_framebuffer_ == framebuffer) {
+    read_framebuffer_ = 0;
+  }
+}
+
+void GLStateCache::OnDeleteRenderbuffer(GLuint renderbuffer) {
+  if (renderbuffer != 0 && renderbuffer_ == renderbuffer) {
+    renderbuffer_ = 0;
+  }
+}
+
+void GLStateCache::OnDeleteTexture(GLuint texture) {
+  if (texture == 0) {
+    return;
+  }
+  for (TextureUnit& unit : texture_units_) {
+    for (size_t i = 0; i < kTextureTargetCount; ++i) {
+      if (unit.bindings[i] == texture) {
+        unit.bindings[i] = 0;
+      }
+    }
+  }
+}
+
+}  // namespace nodejsgl
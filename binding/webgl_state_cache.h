@@ -0,0 +1,226 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef NODEJS_GL_WEBGL_STATE_CACHE_H_
+#define NODEJS_GL_WEBGL_STATE_CACHE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "egl_context_wrapper.h"
+
+// WebGL-only enums, not defined by the GLES headers.
+#define GL_BROWSER_DEFAULT_WEBGL 0x9244
+#define GL_CONTEXT_LOST_WEBGL 0x9242
+#define GL_MAX_CLIENT_WAIT_TIMEOUT_WEBGL 0x9247
+#define GL_UNPACK_COLORSPACE_CONVERSION_WEBGL 0x9243
+#define GL_UNPACK_FLIP_Y_WEBGL 0x9240
+#define GL_UNPACK_PREMULTIPLY_ALPHA_WEBGL 0x9241
+
+namespace nodejsgl {
+
+// Shadows mutable GL state (bindings, capabilities, the active texture unit,
+// blend/depth/stencil state, clear values, pixel store state, the viewport and
+// scissor box) and skips calls into ANGLE that would not change anything. The
+// shadow is always kept up to date; |enabled| only controls whether redundant
+// calls are elided. getParameter() is answered from the shadow as well.
+//
+// NOTE: All state changes for the context must go through this class once it
+// is in use. A call that GL rejects with an error still updates the shadow, so
+// disable the cache when tracking down GL errors.
+class GLStateCache {
+ public:
+  explicit GLStateCache(EGLContextWrapper* egl_context_wrapper);
+
+  // Reads the initial state from the driver. The context must be current.
+  void Init();
+
+  bool enabled() const { return enabled_; }
+  void set_enabled(bool enabled) { enabled_ = enabled; }
+
+  uint64_t elided_calls() const { return elided_calls_; }
+  uint64_t forwarded_calls() const { return forwarded_calls_; }
+
+  EGLContextWrapper* egl_context_wrapper() { return egl_; }
+
+  // Currently bound program.
+  GLuint program() const { return program_; }
+
+  // Buffer bound to |target|, or 0 if |target| is not tracked.
+  GLuint buffer_binding(GLenum target) const {
+    int index = BufferTargetIndex(target);
+    return index >= 0 ? buffer_bindings_[index] : 0;
+  }
+
+  // Texture bound to |target| on the active texture unit, or 0 if |target|
+  // is not tracked.
+  GLuint texture_binding(GLenum target) const {
+    int index = TextureTargetIndex(target);
+    return index >= 0
+               ? texture_units_[active_texture_ - GL_TEXTURE0].bindings[index]
+               : 0;
+  }
+
+  // Currently bound renderbuffer.
+  GLuint renderbuffer_binding() const { return renderbuffer_; }
+
+  // Current value of a PACK_*/UNPACK_* pixel store parameter.
+  GLint pixel_store(GLenum pname) const {
+    int index = PixelStoreIndex(pname);
+    return index >= 0 ? pixel_store_[index] : 0;
+  }
+
+  // Copies the shadowed value of |pname| into |params| and returns true, or
+  // returns false if |pname| is not shadowed.
+  bool GetBooleanv(GLenum pname, GLboolean* params) const;
+  bool GetFloatv(GLenum pname, GLfloat* params) const;
+  bool GetInteger64v(GLenum pname, GLint64* params) const;
+
+  // Cached GL entry points:
+  void ActiveTexture(GLenum texture);
+  void BindBuffer(GLenum target, GLuint buffer);
+  void BindFramebuffer(GLenum target, GLuint framebuffer);
+  void BindRenderbuffer(GLenum target, GLuint renderbuffer);
+  void BindTexture(GLenum target, GLuint texture);
+  void BlendColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+  void BlendEquation(GLenum mode);
+  void BlendEquationSeparate(GLenum mode_rgb, GLenum mode_alpha);
+  void BlendFunc(GLenum sfactor, GLenum dfactor);
+  void BlendFuncSeparate(GLenum src_rgb, GLenum dst_rgb, GLenum src_alpha,
+                         GLenum dst_alpha);
+  void ClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+  void ClearDepth(GLfloat depth);
+  void ClearStencil(GLint s);
+  void ColorMask(GLboolean red, GLboolean green, GLboolean blue,
+                 GLboolean alpha);
+  void CullFace(GLenum mode);
+  void DepthFunc(GLenum func);
+  void DepthMask(GLboolean flag);
+  void DepthRange(GLfloat z_near, GLfloat z_far);
+  void Disable(GLenum cap);
+  void Enable(GLenum cap);
+  void FrontFace(GLenum mode);
+  void Hint(GLenum target, GLenum mode);
+  void LineWidth(GLfloat width);
+  void PixelStorei(GLenum pname, GLint param);
+  void PolygonOffset(GLfloat factor, GLfloat units);
+  void SampleCoverage(GLfloat value, GLboolean invert);
+  void Scissor(GLint x, GLint y, GLsizei width, GLsizei height);
+  void StencilFunc(GLenum func, GLint ref, GLuint mask);
+  void StencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask);
+  void StencilMask(GLuint mask);
+  void StencilMaskSeparate(GLenum face, GLuint mask);
+  void StencilOp(GLenum fail, GLenum zfail, GLenum zpass);
+  void StencilOpSeparate(GLenum face, GLenum fail, GLenum zfail,
+                         GLenum zpass);
+  void UseProgram(GLuint program);
+  void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+  // GL implicitly unbinds deleted objects from the current context.
+  void OnDeleteBuffer(GLuint buffer);
+  void OnDeleteFramebuffer(GLuint framebuffer);
+  void OnDeleteRenderbuffer(GLuint renderbuffer);
+  void OnDeleteTexture(GLuint texture);
+
+ private:
+  // Number of tracked texture targets per unit, see TextureTargetIndex().
+  static const size_t kTextureTargetCount = 4;
+
+  struct TextureUnit {
+    GLuint bindings[kTextureTargetCount];
+  };
+
+  struct StencilFaceState {
+    GLenum func;
+    GLint ref;
+    GLuint value_mask;
+    GLuint write_mask;
+    GLenum fail;
+    GLenum zfail;
+    GLenum zpass;
+  };
+
+  // Returns the slot for a tracked target/capability or -1 if not tracked.
+  static int BufferTargetIndex(GLenum target);
+  static int CapabilityIndex(GLenum cap);
+  static int PixelStoreIndex(GLenum pname);
+  static int TextureTargetIndex(GLenum target);
+
+  // Returns true and counts a forwarded call if the call must go to GL.
+  bool ShouldForward(bool changed);
+
+  void SetCapability(GLenum cap, bool value);
+  void SetStencilFunc(StencilFaceState* face, GLenum func, GLint ref,
+                      GLuint mask);
+  void SetStencilOp(StencilFaceState* face, GLenum fail, GLenum zfail,
+                    GLenum zpass);
+
+  EGLContextWrapper* egl_;
+
+  bool enabled_;
+  uint64_t elided_calls_;
+  uint64_t forwarded_calls_;
+
+  GLenum active_texture_;
+  std::vector<TextureUnit> texture_units_;
+  GLuint buffer_bindings_[8];
+  GLuint draw_framebuffer_;
+  GLuint read_framebuffer_;
+  GLuint renderbuffer_;
+  GLuint program_;
+
+  bool capabilities_[11];
+
+  GLfloat clear_color_[4];
+  GLfloat clear_depth_;
+  GLint clear_stencil_;
+
+  GLfloat blend_color_[4];
+  GLenum blend_equation_rgb_;
+  GLenum blend_equation_alpha_;
+  GLenum blend_src_rgb_;
+  GLenum blend_dst_rgb_;
+  GLenum blend_src_alpha_;
+  GLenum blend_dst_alpha_;
+
+  GLboolean color_mask_[4];
+  GLenum cull_face_mode_;
+  GLenum front_face_;
+  GLfloat line_width_;
+  GLfloat polygon_offset_factor_;
+  GLfloat polygon_offset_units_;
+  GLfloat sample_coverage_value_;
+  GLboolean sample_coverage_invert_;
+
+  GLenum generate_mipmap_hint_;
+  GLenum fragment_shader_derivative_hint_;
+  GLint pixel_store_[10];
+
+  GLenum depth_func_;
+  GLboolean depth_mask_;
+  GLfloat depth_range_[2];
+
+  StencilFaceState stencil_front_;
+  StencilFaceState stencil_back_;
+
+  GLint viewport_[4];
+  GLint scissor_box_[4];
+};
+
+}  // namespace nodejsgl
+
+#endif  // NODEJS_GL_WEBGL_STATE_CACHE_H_
@@ -0,0 +1,177 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "webgl_stream_buffer.h"
+
+#include <cstring>
+
+namespace nodejsgl {
+
+GLStreamBuffer::GLStreamBuffer(EGLContextWrapper* egl_context_wrapper,
+                               GLStateCache* state_cache,
+                               GLMemoryTracker* memory_tracker, GLenum target,
+                               size_t alignment, bool use_fences)
+    : egl_(egl_context_wrapper),
+      state_cache_(state_cache),
+      memory_tracker_(memory_tracker),
+      target_(target),
+      write_target_(use_fences ? GL_COPY_WRITE_BUFFER : target),
+      alignment_(alignment > 0 ? alignment : 1),
+      use_fences_(use_fences),
+      buffer_(0),
+      capacity_(0),
+      head_(0),
+      used_(0),
+      pending_bytes_(0) {
+  egl_->glGenBuffers(1, &buffer_);
+  memory_tracker_->OnCreate(GLMemoryTracker::kBuffer, buffer_);
+  Allocate(kDefaultCapacity);
+}
+
+GLStreamBuffer::~GLStreamBuffer() {
+  DeleteFences();
+  retired_buffers_.push_back(buffer_);
+  DeleteBuffers(&retired_buffers_);
+}
+
+size_t GLStreamBuffer::Write(const void* data, size_t size, GLuint* buffer) {
+  size_t aligned_size = (size + alignment_ - 1) / alignment_ * alignment_;
+  if (aligned_size > capacity_ / kChunkCount) {
+    // Keep single writes well below the ring size so they can't starve it.
+    size_t capacity = capacity_;
+    while (aligned_size > capacity / kChunkCount) {
+      capacity *= 2;
+    }
+    Grow(capacity);
+  }
+
+  // Fence the data of the previous writes, and the draws that used it.
+  if (use_fences_ && pending_bytes_ >= capacity_ / kChunkCount) {
+    Chunk chunk;
+    chunk.fence = egl_->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    chunk.bytes = pending_bytes_;
+    chunk.retired_buffers.swap(retired_buffers_);
+    chunks_.push_back(chunk);
+    pending_bytes_ = 0;
+  }
+
+  // A write that doesn't fit before the end of the ring starts over at 0.
+  // The skipped tail is released along with the write.
+  size_t skipped = head_ + aligned_size > capacity_ ? capacity_ - head_ : 0;
+  Reclaim(skipped + aligned_size);
+  if (capacity_ - used_ < skipped + aligned_size) {
+    // The GPU still holds the ring. Orphaning gives the driver new storage
+    // and keeps the old one alive until its draws are done. A ring's worth of
+    // data was streamed since smaller rings were retired, so they go too.
+    DeleteBuffers(&retired_buffers_);
+    Allocate(capacity_);
+    skipped = 0;
+  }
+
+  if (skipped > 0) {
+    head_ = 0;
+  }
+  size_t offset = head_;
+  head_ += aligned_size;
+  used_ += skipped + aligned_size;
+  pending_bytes_ += skipped + aligned_size;
+
+  WithBufferBound([&]() {
+    if (use_fences_) {
+      // The range is known to be idle, so skip GL's own synchronization.
+      void* mapped = egl_->glMapBufferRange(
+          write_target_, offset, size,
+          GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+              GL_MAP_UNSYNCHRONIZED_BIT);
+      if (mapped) {
+        memcpy(mapped, data, size);
+        egl_->glUnmapBuffer(write_target_);
+        return;
+      }
+    }
+    egl_->glBufferSubData(write_target_, offset, size, data);
+  });
+
+  *buffer = buffer_;
+  return offset;
+}
+
+void GLStreamBuffer::Allocate(size_t capacity) {
+  DeleteFences();
+  capacity_ = capacity;
+  head_ = 0;
+  used_ = 0;
+  pending_bytes_ = 0;
+
+  WithBufferBound([&]() {
+    egl_->glBufferData(write_target_, capacity_, nullptr, GL_STREAM_DRAW);
+    memory_tracker_->OnBufferData(write_target_, capacity_);
+  });
+}
+
+void GLStreamBuffer::Grow(size_t capacity) {
+  retired_buffers_.push_back(buffer_);
+  egl_->glGenBuffers(1, &buffer_);
+  memory_tracker_->OnCreate(GLMemoryTracker::kBuffer, buffer_);
+  Allocate(capacity);
+}
+
+void GLStreamBuffer::Reclaim(size_t needed) {
+  while (capacity_ - used_ < needed && !chunks_.empty()) {
+    Chunk& chunk = chunks_.front();
+    GLenum status = egl_->glClientWaitSync(chunk.fence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+      return;
+    }
+    egl_->glDeleteSync(chunk.fence);
+    DeleteBuffers(&chunk.retired_buffers);
+    used_ -= chunk.bytes;
+    chunks_.pop_front();
+  }
+}
+
+void GLStreamBuffer::DeleteFences() {
+  // GL keeps the storage of deleted buffers alive for draws in flight.
+  for (Chunk& chunk : chunks_) {
+    egl_->glDeleteSync(chunk.fence);
+    DeleteBuffers(&chunk.retired_buffers);
+  }
+  chunks_.clear();
+}
+
+void GLStreamBuffer::DeleteBuffers(std::vector<GLuint>* buffers) {
+  if (buffers->empty()) {
+    return;
+  }
+  egl_->glDeleteBuffers(static_cast<GLsizei>(buffers->size()),
+                        buffers->data());
+  for (GLuint buffer : *buffers) {
+    state_cache_->OnDeleteBuffer(buffer);
+    memory_tracker_->OnDelete(GLMemoryTracker::kBuffer, buffer);
+  }
+  buffers->clear();
+}
+
+template <typename Fn>
+void GLStreamBuffer::WithBufferBound(Fn fn) {
+  GLuint previous = state_cache_->buffer_binding(write_target_);
+  state_cache_->BindBuffer(write_target_, buffer_);
+  fn();
+  state_cache_->BindBuffer(write_target_, previous);
+}
+
+}  // namespace nodejsgl
@@ -0,0 +1,112 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef NODEJS_GL_WEBGL_STREAM_BUFFER_H_
+#define NODEJS_GL_WEBGL_STREAM_BUFFER_H_
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include "egl_context_wrapper.h"
+#include "webgl_memory_tracker.h"
+#include "webgl_state_cache.h"
+
+namespace nodejsgl {
+
+// Ring allocator over one GL buffer for streamWrite(). Each write goes to the
+// next free, aligned offset instead of reallocating a buffer per draw.
+//
+// Written ranges are fenced in chunks of a quarter of the ring. A fence is
+// inserted at the start of the first write after a chunk fills up, so it
+// covers the draws issued with that chunk's data. A range is reused only after
+// its fence has signaled. If the GPU still holds the whole ring, the storage
+// is orphaned with glBufferData() instead of stalling. ES2 contexts have no
+// fences and always orphan.
+//
+// A write larger than a chunk moves the ring to a new, larger GL buffer, so
+// earlier writes that no draw used yet stay intact. The old buffer is deleted
+// once the fence of the next chunk signals.
+//
+// Data must be consumed by draw calls before another ring's worth of data is
+// streamed.
+class GLStreamBuffer {
+ public:
+  GLStreamBuffer(EGLContextWrapper* egl_context_wrapper,
+                 GLStateCache* state_cache, GLMemoryTracker* memory_tracker,
+                 GLenum target, size_t alignment, bool use_fences);
+  ~GLStreamBuffer();
+
+  // Copies |size| bytes of |data| into the ring and returns the offset they
+  // were written at. |*buffer| is set to the GL buffer, which changes if the
+  // ring has to grow for a large write. Earlier buffers stay valid until a
+  // chunk of the new one is fenced and done.
+  size_t Write(const void* data, size_t size, GLuint* buffer);
+
+ private:
+  static const size_t kDefaultCapacity = 4 * 1024 * 1024;
+  static const size_t kChunkCount = 4;
+
+  struct Chunk {
+    GLsync fence;
+    size_t bytes;  // Ring bytes released when |fence| signals.
+    // Buffers of smaller rings, deleted when |fence| signals.
+    std::vector<GLuint> retired_buffers;
+  };
+
+  // (Re)allocates storage of |capacity| bytes and resets the ring.
+  void Allocate(size_t capacity);
+
+  // Moves the ring to a new buffer of |capacity| bytes.
+  void Grow(size_t capacity);
+
+  void DeleteBuffers(std::vector<GLuint>* buffers);
+
+  // Releases chunks whose fences have signaled until |needed| bytes are free.
+  void Reclaim(size_t needed);
+
+  void DeleteFences();
+
+  // Runs |fn| with |buffer_| bound to the target used for writes, restoring
+  // the previous binding afterwards.
+  template <typename Fn>
+  void WithBufferBound(Fn fn);
+
+  EGLContextWrapper* egl_;
+  GLStateCache* state_cache_;
+  GLMemoryTracker* memory_tracker_;
+
+  GLenum target_;
+  // ES3 writes through COPY_WRITE_BUFFER so that element array buffer
+  // writes don't change the vertex array state.
+  GLenum write_target_;
+  size_t alignment_;
+  bool use_fences_;
+
+  GLuint buffer_;
+  size_t capacity_;
+  size_t head_;           // Next write offset.
+  size_t used_;           // Bytes in flight, fenced or not.
+  size_t pending_bytes_;  // Bytes written since the last fence.
+  std::deque<Chunk> chunks_;
+  // Buffers of smaller rings, handed to the next chunk.
+  std::vector<GLuint> retired_buffers_;
+};
+
+}  // namespace nodejsgl
+
+#endif  // NODEJS_GL_WEBGL_STREAM_BUFFER_H_
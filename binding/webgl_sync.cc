@@ -1,4 +1,5 @@
-/** * @license
+/**
+ * @license
  * Copyright 2019 Google Inc. All Rights Reserved.
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -16,35 +17,70 @@
 
 #include "webgl_sync.h"
 
-#include "utils.h"
+#include "webgl_fence_poller.h"
 
 namespace nodejsgl {
 
-void Cleanup(napi_env env, void* native, void* hint) {
-  GLsync sync = static_cast<GLsync>(native);
-  EGLContextWrapper* egl_context_wrapper =
-      static_cast<EGLContextWrapper*>(hint);
+GLSyncPool::GLSyncPool(EGLContextWrapper* egl_context_wrapper)
+    : egl_(egl_context_wrapper), fence_poller_(nullptr) {}
 
-  egl_context_wrapper->glDeleteSync(sync);
-#if DEBUG
-  // TODO(kreeger): Fix this.
-  /* context->CheckForErrors(); */
-#endif
+GLSyncPool::~GLSyncPool() {
+  for (const Slot& slot : slots_) {
+    if (slot.sync) {
+      egl_->glDeleteSync(slot.sync);
+    }
+  }
 }
 
-napi_status WrapGLsync(napi_env env, GLsync& sync,
-                       EGLContextWrapper* egl_context_wrapper,
-                       napi_value* wrapped_value) {
-  napi_status nstatus;
+uint32_t GLSyncPool::Add(GLsync sync) {
+  uint32_t index;
+  if (!free_slots_.empty()) {
+    index = free_slots_.back();
+    free_slots_.pop_back();
+  } else {
+    if (slots_.size() > kSlotMask) {
+      // Out of handles - this many live fences is a leak in the caller.
+      egl_->glDeleteSync(sync);
+      return 0;
+    }
+    index = static_cast<uint32_t>(slots_.size());
+    slots_.push_back({nullptr, 1});
+  }
 
-  nstatus = napi_create_object(env, wrapped_value);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  Slot& slot = slots_[index];
+  slot.sync = sync;
+  return (slot.generation << kSlotBits) | index;
+}
+
+GLsync GLSyncPool::Get(uint32_t handle) const {
+  uint32_t index = handle & kSlotMask;
+  if (index >= slots_.size()) {
+    return nullptr;
+  }
+
+  const Slot& slot = slots_[index];
+  return slot.generation == handle >> kSlotBits ? slot.sync : nullptr;
+}
+
+bool GLSyncPool::Delete(uint32_t handle) {
+  GLsync sync = Get(handle);
+  if (!sync) {
+    return false;
+  }
 
-  nstatus = napi_wrap(env, *wrapped_value, sync, Cleanup, egl_context_wrapper,
-                      nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nstatus);
+  if (fence_poller_) {
+    fence_poller_->Cancel(sync);
+  }
+  egl_->glDeleteSync(sync);
 
-  return napi_ok;
+  Slot& slot = slots_[handle & kSlotMask];
+  slot.sync = nullptr;
+  slot.generation = (slot.generation + 1) & (UINT32_MAX >> kSlotBits);
+  if (slot.generation == 0) {
+    slot.generation = 1;
+  }
+  free_slots_.push_back(handle & kSlotMask);
+  return true;
 }
 
 }  // namespace nodejsgl
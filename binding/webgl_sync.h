@@ -18,7 +18,8 @@
 #ifndef NODEJS_GL_WEBGL_SYNC_H_
 #define NODEJS_GL_WEBGL_SYNC_H_
 
-#include <node_api.h>
+#include <cstdint>
+#include <vector>
 
 #include "angle/include/GLES2/gl2.h"
 
@@ -26,10 +27,50 @@
 
 namespace nodejsgl {
 
-// Creates and wraps a JS object with a GLsync instance.
-napi_status WrapGLsync(napi_env env, GLsync &sync,
-                       EGLContextWrapper *egl_context_wrapper,
-                       napi_value *wrapped_value);
+class GLFencePoller;
+
+// Owns the fences of a context behind integer handles. fenceSync() returns a
+// WebGLSync wrapper of the handle (see GLObjectRegistry) whose finalizer
+// deletes the fence, since callers may rely on the garbage collector instead
+// of deleteSync(). Slots of deleted fences are reused. A handle carries the
+// generation of its slot so that a stale handle does not resolve to a newer
+// fence. Fences that are still alive are deleted with the pool.
+class GLSyncPool {
+ public:
+  explicit GLSyncPool(EGLContextWrapper* egl_context_wrapper);
+  ~GLSyncPool();
+
+  // Takes ownership of |sync| and returns its handle (never 0).
+  uint32_t Add(GLsync sync);
+
+  // Returns the fence of |handle| or nullptr if |handle| is unknown.
+  GLsync Get(uint32_t handle) const;
+
+  // Deletes the fence of |handle|. Pending waitSyncAsync() calls on it fail.
+  // Returns false if |handle| is unknown.
+  bool Delete(uint32_t handle);
+
+  // |fence_poller| is created on the first async wait.
+  void set_fence_poller(GLFencePoller* fence_poller) {
+    fence_poller_ = fence_poller;
+  }
+
+  size_t size() const { return slots_.size() - free_slots_.size(); }
+
+ private:
+  static const uint32_t kSlotBits = 20;
+  static const uint32_t kSlotMask = (1u << kSlotBits) - 1;
+
+  struct Slot {
+    GLsync sync;
+    uint32_t generation;  // Never 0, so no handle is 0.
+  };
+
+  EGLContextWrapper* egl_;
+  GLFencePoller* fence_poller_;
+  std::vector<Slot> slots_;
+  std::vector<uint32_t> free_slots_;
+};
 
 }  // namespace nodejsgl
 
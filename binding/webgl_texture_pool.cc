@@ -0,0 +1,207 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "webgl_texture_pool.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace nodejsgl {
+
+bool GLTexturePool::Desc::operator==(const Desc& other) const {
+  return target == other.target && internal_format == other.internal_format &&
+         format == other.format && type == other.type &&
+         width == other.width && height == other.height &&
+         levels == other.levels;
+}
+
+size_t GLTexturePool::DescHash::operator()(const Desc& desc) const {
+  size_t hash = desc.target;
+  const uint32_t fields[] = {
+      desc.internal_format,
+      desc.format,
+      desc.type,
+      static_cast<uint32_t>(desc.width),
+      static_cast<uint32_t>(desc.height),
+      static_cast<uint32_t>(desc.levels),
+  };
+  for (uint32_t field : fields) {
+    hash = hash * 31 + field;
+  }
+  return hash;
+}
+
+GLTexturePool::GLTexturePool(EGLContextWrapper* egl_context_wrapper,
+                             GLStateCache* state_cache,
+                             GLMemoryTracker* memory_tracker)
+    : egl_(egl_context_wrapper),
+      state_cache_(state_cache),
+      memory_tracker_(memory_tracker),
+      max_bytes_(kDefaultMaxBytes),
+      free_bytes_(0),
+      hits_(0),
+      misses_(0),
+      evictions_(0) {}
+
+GLuint GLTexturePool::Acquire(const Desc& desc) {
+  if (desc.target != GL_TEXTURE_2D && desc.target != GL_TEXTURE_CUBE_MAP) {
+    return 0;
+  }
+  if (desc.width <= 0 || desc.height <= 0 || desc.levels <= 0) {
+    return 0;
+  }
+  if (desc.target == GL_TEXTURE_CUBE_MAP && desc.width != desc.height) {
+    return 0;
+  }
+  GLsizei max_levels = 1;
+  for (GLsizei size = std::max(desc.width, desc.height); size > 1; size /= 2) {
+    max_levels++;
+  }
+  if (desc.levels > max_levels) {
+    return 0;
+  }
+
+  GLuint texture;
+  auto it = free_by_desc_.find(desc);
+  if (it != free_by_desc_.end()) {
+    texture = it->second.back();
+    RemoveFree(free_by_name_[texture]);
+    hits_++;
+  } else {
+    texture = CreateTexture(desc);
+    misses_++;
+  }
+
+  acquired_[texture] = desc;
+  return texture;
+}
+
+bool GLTexturePool::Release(GLuint texture) {
+  auto it = acquired_.find(texture);
+  if (it == acquired_.end()) {
+    return false;
+  }
+
+  FreeTexture free_texture;
+  free_texture.texture = texture;
+  free_texture.desc = it->second;
+  free_texture.bytes = DescBytes(it->second);
+  acquired_.erase(it);
+
+  lru_.push_front(free_texture);
+  free_by_name_[texture] = lru_.begin();
+  free_by_desc_[free_texture.desc].push_back(texture);
+  free_bytes_ += free_texture.bytes;
+
+  Trim();
+  return true;
+}
+
+void GLTexturePool::OnDeleteTexture(GLuint texture) {
+  acquired_.erase(texture);
+
+  auto it = free_by_name_.find(texture);
+  if (it != free_by_name_.end()) {
+    RemoveFree(it->second);
+  }
+}
+
+void GLTexturePool::set_max_bytes(size_t max_bytes) {
+  max_bytes_ = max_bytes;
+  Trim();
+}
+
+/* static */
+size_t GLTexturePool::DescBytes(const Desc& desc) {
+  size_t pixels = 0;
+  for (GLsizei level = 0; level < desc.levels; level++) {
+    pixels += static_cast<size_t>(std::max(desc.width >> level, 1)) *
+              std::max(desc.height >> level, 1);
+  }
+  size_t faces = desc.target == GL_TEXTURE_CUBE_MAP ? 6 : 1;
+  return pixels * faces *
+         GLMemoryTracker::InternalFormatBytesPerPixel(desc.internal_format);
+}
+
+GLuint GLTexturePool::CreateTexture(const Desc& desc) {
+  GLuint texture;
+  egl_->glGenTextures(1, &texture);
+  memory_tracker_->OnCreate(GLMemoryTracker::kTexture, texture);
+
+  // Allocate with the texture bound, leaving the user's bindings as they
+  // were. A bound unpack buffer would be read from instead of null data.
+  GLuint previous_texture = state_cache_->texture_binding(desc.target);
+  GLuint unpack_buffer = state_cache_->buffer_binding(GL_PIXEL_UNPACK_BUFFER);
+  if (unpack_buffer != 0) {
+    state_cache_->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  }
+  state_cache_->BindTexture(desc.target, texture);
+
+  size_t bytes_per_pixel =
+      GLMemoryTracker::InternalFormatBytesPerPixel(desc.internal_format);
+  GLenum faces = desc.target == GL_TEXTURE_CUBE_MAP ? 6 : 1;
+  for (GLsizei level = 0; level < desc.levels; level++) {
+    GLsizei width = std::max(desc.width >> level, 1);
+    GLsizei height = std::max(desc.height >> level, 1);
+    for (GLenum face = 0; face < faces; face++) {
+      GLenum target = desc.target == GL_TEXTURE_CUBE_MAP
+                          ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face
+                          : desc.target;
+      egl_->glTexImage2D(target, level, desc.internal_format, width, height,
+                         0, desc.format, desc.type, nullptr);
+      memory_tracker_->OnTexImage(
+          target, level, width, height,
+          static_cast<size_t>(width) * height * bytes_per_pixel);
+    }
+  }
+
+  state_cache_->BindTexture(desc.target, previous_texture);
+  if (unpack_buffer != 0) {
+    state_cache_->BindBuffer(GL_PIXEL_UNPACK_BUFFER, unpack_buffer);
+  }
+  return texture;
+}
+
+void GLTexturePool::DeleteTexture(GLuint texture) {
+  egl_->glDeleteTextures(1, &texture);
+  state_cache_->OnDeleteTexture(texture);
+  memory_tracker_->OnDelete(GLMemoryTracker::kTexture, texture);
+}
+
+void GLTexturePool::RemoveFree(std::list<FreeTexture>::iterator it) {
+  auto desc_it = free_by_desc_.find(it->desc);
+  std::vector<GLuint>& textures = desc_it->second;
+  textures.erase(std::find(textures.begin(), textures.end(), it->texture));
+  if (textures.empty()) {
+    free_by_desc_.erase(desc_it);
+  }
+
+  free_by_name_.erase(it->texture);
+  free_bytes_ -= it->bytes;
+  lru_.erase(it);
+}
+
+void GLTexturePool::Trim() {
+  while (free_bytes_ > max_bytes_ && !lru_.empty()) {
+    GLuint texture = lru_.back().texture;
+    RemoveFree(std::prev(lru_.end()));
+    DeleteTexture(texture);
+    evictions_++;
+  }
+}
+
+}  // namespace nodejsgl
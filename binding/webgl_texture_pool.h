@@ -0,0 +1,124 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef NODEJS_GL_WEBGL_TEXTURE_POOL_H_
+#define NODEJS_GL_WEBGL_TEXTURE_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "egl_context_wrapper.h"
+#include "webgl_memory_tracker.h"
+#include "webgl_state_cache.h"
+
+namespace nodejsgl {
+
+// Recycles textures of recurring shapes for acquireTexture()/
+// releaseTexture(). A released texture keeps its storage and goes on a free
+// list for its shape. The next acquire of that shape reuses it and skips
+// the driver allocation. Free textures beyond |max_bytes| are deleted in
+// least-recently-released order.
+//
+// Reused textures keep their contents and texture parameters.
+class GLTexturePool {
+ public:
+  struct Desc {
+    GLenum target;  // TEXTURE_2D or TEXTURE_CUBE_MAP.
+    GLenum internal_format;
+    GLenum format;
+    GLenum type;
+    GLsizei width;
+    GLsizei height;
+    GLsizei levels;
+
+    bool operator==(const Desc& other) const;
+  };
+
+  GLTexturePool(EGLContextWrapper* egl_context_wrapper,
+                GLStateCache* state_cache, GLMemoryTracker* memory_tracker);
+
+  // Returns a texture with storage for |desc|, reusing a free one if
+  // possible. Returns 0 if |desc| is invalid.
+  GLuint Acquire(const Desc& desc);
+
+  // Puts a texture returned by Acquire() back on the free list. Returns false
+  // if |texture| is not an acquired texture.
+  bool Release(GLuint texture);
+
+  // Forgets a texture deleted by the user.
+  void OnDeleteTexture(GLuint texture);
+
+  size_t max_bytes() const { return max_bytes_; }
+  void set_max_bytes(size_t max_bytes);
+
+  uint64_t hits() const { return hits_; }
+  uint64_t misses() const { return misses_; }
+  uint64_t evictions() const { return evictions_; }
+  size_t free_textures() const { return lru_.size(); }
+  size_t free_bytes() const { return free_bytes_; }
+  size_t acquired_textures() const { return acquired_.size(); }
+
+ private:
+  static const size_t kDefaultMaxBytes = 256 * 1024 * 1024;
+
+  struct DescHash {
+    size_t operator()(const Desc& desc) const;
+  };
+
+  struct FreeTexture {
+    GLuint texture;
+    Desc desc;
+    size_t bytes;
+  };
+
+  // Estimated size of a texture with storage for |desc|.
+  static size_t DescBytes(const Desc& desc);
+
+  // Creates a texture and allocates all levels (and faces) of |desc|.
+  GLuint CreateTexture(const Desc& desc);
+  void DeleteTexture(GLuint texture);
+
+  // Takes a texture off the free lists, without deleting it.
+  void RemoveFree(std::list<FreeTexture>::iterator it);
+
+  // Deletes free textures until |free_bytes_| <= |max_bytes_|.
+  void Trim();
+
+  EGLContextWrapper* egl_;
+  GLStateCache* state_cache_;
+  GLMemoryTracker* memory_tracker_;
+
+  // Free textures, most recently released first.
+  std::list<FreeTexture> lru_;
+  std::unordered_map<GLuint, std::list<FreeTexture>::iterator> free_by_name_;
+  std::unordered_map<Desc, std::vector<GLuint>, DescHash> free_by_desc_;
+
+  std::unordered_map<GLuint, Desc> acquired_;
+
+  size_t max_bytes_;
+  size_t free_bytes_;
+  uint64_t hits_;
+  uint64_t misses_;
+  uint64_t evictions_;
+};
+
+}  // namespace nodejsgl
+
+#endif  // NODEJS_GL_WEBGL_TEXTURE_POOL_H_
@@ -15,12 +15,236 @@
  * =============================================================================
  */
 
+/** Number and estimated size in bytes of GL objects of one type. */
+export interface MemoryUsage {
+  count: number;
+  bytes: number;
+}
+
+/**
+ * Estimated GPU memory of a context, as reported by getMemoryInfo(). The same
+ * totals are reported to V8 as external memory.
+ */
+export interface MemoryInfo {
+  buffers: MemoryUsage;
+  textures: MemoryUsage;
+  renderbuffers: MemoryUsage;
+  totalBytes: number;
+}
+
+/**
+ * Counters reported by getScratchArenaStats(). Plain JS Arrays passed to the
+ * binding are converted inline (up to 16 elements) or into a per-context
+ * scratch arena; |heapAllocations| only grows while the arena grows.
+ */
+export interface ScratchArenaStats {
+  inlineAllocations: number;
+  arenaAllocations: number;
+  heapAllocations: number;
+  capacity: number;
+}
+
+/** Counters reported by getStateCacheStats(). */
+export interface StateCacheStats {
+  enabled: boolean;
+  elidedCalls: number;
+  forwardedCalls: number;
+  uniformHits: number;
+  uniformMisses: number;
+}
+
+/** Uniform of a UniformLayout, at |offset| bytes into the packed values. */
+export interface UniformLayoutEntry extends WebGLActiveInfo {
+  offset: number;
+}
+
+/**
+ * Packing of a program's uniforms for setUniforms(). Values are 4 bytes per
+ * component (float32, or int32 for ints, bools and samplers), matrices are
+ * column-major and array elements follow each other.
+ */
+export interface UniformLayout {
+  handle: number;
+  byteLength: number;
+  uniforms: UniformLayoutEntry[];
+}
+
+/**
+ * Shape of a texture from acquireTexture(). |target| defaults to TEXTURE_2D,
+ * |format| to |internalFormat|, |type| to UNSIGNED_BYTE and |levels| to 1.
+ */
+export interface TextureDesc {
+  target?: number;
+  internalFormat: number;
+  format?: number;
+  type?: number;
+  width: number;
+  height: number;
+  levels?: number;
+}
+
+/** Counters reported by getTexturePoolStats(). */
+export interface TexturePoolStats {
+  hits: number;
+  misses: number;
+  evictions: number;
+  freeTextures: number;
+  freeBytes: number;
+  acquiredTextures: number;
+  maxBytes: number;
+}
+
+/** Counters reported by getProgramBinaryCacheStats(). */
+export interface ProgramBinaryCacheStats {
+  hits: number;
+  misses: number;
+  stores: number;
+  evictions: number;
+  entries: number;
+  bytes: number;
+  maxBytes: number;
+}
+
+/** Location of data written by streamWrite(). */
+export interface StreamAllocation {
+  buffer: WebGLBuffer;
+  offset: number;
+}
+
+/** Methods provided by this binding on top of the WebGL API. */
+export interface NodeJsGlContextExtensions {
+  /**
+   * Returns a texture with storage allocated for |desc|. The storage of a
+   * released texture of the same shape is reused when available. Contents
+   * and texture parameters of reused textures are undefined.
+   */
+  acquireTexture(desc: TextureDesc): WebGLTexture;
+  createUniformLayout(program: WebGLProgram, names?: string[]):
+      UniformLayout|null;
+  executeCommands(buffer: ArrayBuffer|ArrayBufferView, count: number): void;
+  /**
+   * Queues a command stream on the command thread (see the commandThread
+   * context option) and resolves once it was executed. Any other call on the
+   * context waits for queued streams first.
+   */
+  executeCommandsAsync(buffer: ArrayBuffer|ArrayBufferView, count: number):
+      Promise<void>;
+  /** Queues a finish() on the command thread and resolves once it returned. */
+  finishAsync(): Promise<void>;
+  /**
+   * Like getBufferSubData() but returns a new ArrayBuffer of |length| bytes
+   * backed by pooled memory.
+   */
+  getBufferSubDataToArrayBuffer(
+      target: number, srcByteOffset: number, length: number): ArrayBuffer;
+  getMemoryInfo(): MemoryInfo;
+  /**
+   * Returns null unless the programBinaryCacheDir context option is set and
+   * the driver supports program binaries.
+   */
+  getProgramBinaryCacheStats(): ProgramBinaryCacheStats|null;
+  getScratchArenaStats(): ScratchArenaStats;
+  getStateCacheStats(): StateCacheStats;
+  getTexturePoolStats(): TexturePoolStats;
+  /**
+   * Like linkProgram() but resolves with LINK_STATUS once the driver finished
+   * compiling and linking in the background (KHR_parallel_shader_compile),
+   * instead of blocking the event loop. Links synchronously if the extension
+   * is not available.
+   */
+  linkProgramAsync(program: WebGLProgram): Promise<boolean>;
+  /**
+   * Maps a range of the buffer bound to |target| and returns an ArrayBuffer
+   * that aliases the mapped memory, or null if GL could not map it. The
+   * ArrayBuffer is detached once the buffer is unmapped, deleted or
+   * re-specified with bufferData(). Requires WebGL2.
+   */
+  mapBufferRange(
+      target: number, offset: number, length: number,
+      access: number): ArrayBuffer|null;
+  /**
+   * Like readPixels() but resolves once the GPU has written the pixels to
+   * |dst| instead of blocking the event loop.
+   */
+  readPixelsAsync<T extends ArrayBufferView>(
+      x: number, y: number, width: number, height: number, format: number,
+      type: number, dst: T): Promise<T>;
+  /**
+   * Like readPixels() but GL writes into pooled, page-aligned memory that is
+   * returned as an ArrayBuffer without a copy. The memory goes back to the
+   * pool once the ArrayBuffer is collected.
+   */
+  readPixelsToArrayBuffer(
+      x: number, y: number, width: number, height: number, format: number,
+      type: number): ArrayBuffer;
+  /**
+   * Puts a texture from acquireTexture() back into the pool. The texture
+   * must not be used afterwards.
+   */
+  releaseTexture(texture: WebGLTexture): void;
+  /**
+   * Binaries beyond |maxBytes| are deleted from the cache directory, least
+   * recently used first.
+   */
+  setProgramBinaryCacheLimit(maxBytes: number): void;
+  setStateCacheEnabled(enabled: boolean): void;
+  /** Free pooled textures beyond |maxBytes| are deleted, oldest first. */
+  setTexturePoolLimit(maxBytes: number): void;
+  setUniforms(
+      program: WebGLProgram, layoutHandle: number,
+      values: ArrayBuffer|ArrayBufferView): void;
+  /**
+   * Hands the results of the commands issued so far to another context of
+   * the share group (see the |shareWith| option): flushes them and returns a
+   * handle to pass to waitHandoff() on the consuming context.
+   */
+  signalHandoff(): number;
+  /**
+   * Copies |data| into a buffer shared by all streamed data of |target|
+   * (ARRAY_BUFFER, ELEMENT_ARRAY_BUFFER or, in WebGL2, UNIFORM_BUFFER) and
+   * returns where it was written. Use the data in draw calls right away: its
+   * range is reused after a few megabytes of further streamWrite() calls.
+   * The buffer is owned by the context and must not be deleted.
+   */
+  streamWrite(target: number, data: ArrayBuffer|ArrayBufferView|number[]):
+      StreamAllocation;
+  /**
+   * Unmaps the buffer bound to |target| and detaches the ArrayBuffer returned
+   * by mapBufferRange(). Returns false if the buffer contents were lost.
+   */
+  unmapBuffer(target: number): boolean;
+  /**
+   * Makes later commands of this context wait on the GPU for the commands
+   * before signalHandoff() in another context of the share group. Doesn't
+   * block the event loop. Each handle can be waited for once.
+   */
+  waitHandoff(handle: number): void;
+  /**
+   * Resolves with the status of |sync| (ALREADY_SIGNALED,
+   * CONDITION_SATISFIED, TIMEOUT_EXPIRED or WAIT_FAILED) once it is signaled
+   * or |timeout| nanoseconds passed, without blocking the event loop. Waits
+   * forever by default.
+   */
+  waitSyncAsync(sync: WebGLSync, timeout?: number|bigint): Promise<number>;
+}
+
+export type NodeJsGlContext =
+    (WebGLRenderingContext|WebGL2RenderingContext)&NodeJsGlContextExtensions;
+
 export interface NodeJsGlBinding {
   createWebGLRenderingContext(
     width: number, 
     height: number,
     client_major_es_version: number,
     client_minor_es_version: number,
-    webgl_compatbility: boolean
-    ): WebGLRenderingContext | WebGL2RenderingContext;
+    webgl_compatbility: boolean,
+    wrap_objects?: boolean,
+    command_thread?: boolean,
+    share_with?: NodeJsGlContext|null,
+    max_shader_compiler_threads?: number,
+    program_binary_cache_dir?: string,
+    blob_cache_file?: string,
+    blob_cache_max_bytes?: number,
+    surfaceless?: boolean
+    ): NodeJsGlContext;
 }
@@ -0,0 +1,469 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import {NodeJsGlContext} from './binding';
+
+/**
+ * Opcodes understood by `executeCommands()`. This must be kept in sync with
+ * `CommandOpcode` in binding/webgl_command_buffer.h.
+ */
+export enum CommandOpcode {
+  ACTIVE_TEXTURE = 0,
+  BIND_BUFFER = 1,
+  BIND_FRAMEBUFFER = 2,
+  BIND_RENDERBUFFER = 3,
+  BIND_TEXTURE = 4,
+  BLEND_COLOR = 5,
+  BLEND_EQUATION = 6,
+  BLEND_FUNC = 7,
+  CLEAR = 8,
+  CLEAR_COLOR = 9,
+  COLOR_MASK = 10,
+  CULL_FACE = 11,
+  DEPTH_FUNC = 12,
+  DEPTH_MASK = 13,
+  DISABLE = 14,
+  DISABLE_VERTEX_ATTRIB_ARRAY = 15,
+  DRAW_ARRAYS = 16,
+  DRAW_ELEMENTS = 17,
+  ENABLE = 18,
+  ENABLE_VERTEX_ATTRIB_ARRAY = 19,
+  FLUSH = 20,
+  FRAMEBUFFER_RENDERBUFFER = 21,
+  FRAMEBUFFER_TEXTURE_2D = 22,
+  PIXEL_STOREI = 23,
+  SCISSOR = 24,
+  TEX_PARAMETERF = 25,
+  TEX_PARAMETERI = 26,
+  UNIFORM_1F = 27,
+  UNIFORM_1I = 28,
+  UNIFORM_2F = 29,
+  UNIFORM_2I = 30,
+  UNIFORM_3F = 31,
+  UNIFORM_3I = 32,
+  UNIFORM_4F = 33,
+  UNIFORM_4I = 34,
+  USE_PROGRAM = 35,
+  VERTEX_ATTRIB_POINTER = 36,
+  VIEWPORT = 37,
+}
+
+// Commands record the numeric handles returned without wrapObjects, null maps
+// to 0. Wrappers can't be packed into the stream and are rejected rather than
+// silently recorded as 0.
+// tslint:disable-next-line:no-any
+function handle(value: any): number {
+  if (value == null) {
+    return 0;
+  }
+  if (typeof value !== 'number') {
+    throw new TypeError(
+        'CommandBuffer requires numeric WebGL object handles; ' +
+        'contexts created with wrapObjects cannot record commands.');
+  }
+  return value;
+}
+
+/**
+ * Records WebGL calls into a packed command stream that is decoded and
+ * executed natively with a single `executeCommands()` call. Method names and
+ * signatures mirror WebGLRenderingContext.
+ */
+export class CommandBuffer {
+  private u32: Uint32Array;
+  private i32: Int32Array;
+  private f32: Float32Array;
+  private offset = 0;
+  private count = 0;
+
+  constructor(private gl: NodeJsGlContext, initialCapacity = 4096) {
+    this.allocate(initialCapacity);
+  }
+
+  /** Number of commands recorded since the last flush. */
+  get commandCount(): number {
+    return this.count;
+  }
+
+  /** Executes all recorded commands and resets the buffer. */
+  flushCommands(): void {
+    if (this.count === 0) {
+      return;
+    }
+    this.gl.executeCommands(this.u32.subarray(0, this.offset), this.count);
+    this.offset = 0;
+    this.count = 0;
+  }
+
+  /**
+   * Queues all recorded commands on the context's command thread and resets
+   * the buffer. Resolves once the commands were executed.
+   */
+  flushCommandsAsync(): Promise<void> {
+    if (this.count === 0) {
+      return Promise.resolve();
+    }
+    const done = this.gl.executeCommandsAsync(
+        this.u32.subarray(0, this.offset), this.count);
+    this.offset = 0;
+    this.count = 0;
+    return done;
+  }
+
+  activeTexture(texture: number): void {
+    this.begin(CommandOpcode.ACTIVE_TEXTURE, 1);
+    this.u32[this.offset++] = texture;
+  }
+
+  bindBuffer(target: number, buffer: WebGLBuffer|null): void {
+    this.begin(CommandOpcode.BIND_BUFFER, 2);
+    this.u32[this.offset++] = target;
+    this.u32[this.offset++] = handle(buffer);
+  }
+
+  bindFramebuffer(target: number, framebuffer: WebGLFramebuffer|null): void {
+    this.begin(CommandOpcode.BIND_FRAMEBUFFER, 2);
+    this.u32[this.offset++] = target;
+    this.u32[this.offset++] = handle(framebuffer);
+  }
+
+  bindRenderbuffer(target: number, renderbuffer: WebGLRenderbuffer|null):
+      void {
+    this.begin(CommandOpcode.BIND_RENDERBUFFER, 2);
+    this.u32[this.offset++] = target;
+    this.u32[this.offset++] = handle(renderbuffer);
+  }
+
+  bindTexture(target: number, texture: WebGLTexture|null): void {
+    this.begin(CommandOpcode.BIND_TEXTURE, 2);
+    this.u32[this.offset++] = target;
+    this.u32[this.offset++] = handle(texture);
+  }
+
+  blendColor(red: number, green: number, blue: number, alpha: number): void {
+    this.begin(CommandOpcode.BLEND_COLOR, 4);
+    this.f32[this.offset++] = red;
+    this.f32[this.offset++] = green;
+    this.f32[this.offset++] = blue;
+    this.f32[this.offset++] = alpha;
+  }
+
+  blendEquation(mode: number): void {
+    this.begin(CommandOpcode.BLEND_EQUATION, 1);
+    this.u32[this.offset++] = mode;
+  }
+
+  blendFunc(sfactor: number, dfactor: number): void {
+    this.begin(CommandOpcode.BLEND_FUNC, 2);
+    this.u32[this.offset++] = sfactor;
+    this.u32[this.offset++] = dfactor;
+  }
+
+  clear(mask: number): void {
+    this.begin(CommandOpcode.CLEAR, 1);
+    this.u32[this.offset++] = mask;
+  }
+
+  clearColor(red: number, green: number, blue: number, alpha: number): void {
+    this.begin(CommandOpcode.CLEAR_COLOR, 4);
+    this.f32[this.offset++] = red;
+    this.f32[this.offset++] = green;
+    this.f32[this.offset++] = blue;
+    this.f32[this.offset++] = alpha;
+  }
+
+  colorMask(red: boolean, green: boolean, blue: boolean, alpha: boolean):
+      void {
+    this.begin(CommandOpcode.COLOR_MASK, 4);
+    this.u32[this.offset++] = red ? 1 : 0;
+    this.u32[this.offset++] = green ? 1 : 0;
+    this.u32[this.offset++] = blue ? 1 : 0;
+    this.u32[this.offset++] = alpha ? 1 : 0;
+  }
+
+  cullFace(mode: number): void {
+    this.begin(CommandOpcode.CULL_FACE, 1);
+    this.u32[this.offset++] = mode;
+  }
+
+  depthFunc(func: number): void {
+    this.begin(CommandOpcode.DEPTH_FUNC, 1);
+    this.u32[this.offset++] = func;
+  }
+
+  depthMask(flag: boolean): void {
+    this.begin(CommandOpcode.DEPTH_MASK, 1);
+    this.u32[this.offset++] = flag ? 1 : 0;
+  }
+
+  disable(cap: number): void {
+    this.begin(CommandOpcode.DISABLE, 1);
+    this.u32[this.offset++] = cap;
+  }
+
+  disableVertexAttribArray(index: number): void {
+    this.begin(CommandOpcode.DISABLE_VERTEX_ATTRIB_ARRAY, 1);
+    this.u32[this.offset++] = index;
+  }
+
+  drawArrays(mode: number, first: number, count: number): void {
+    this.begin(CommandOpcode.DRAW_ARRAYS, 3);
+    this.u32[this.offset++] = mode;
+    this.i32[this.offset++] = first;
+    this.i32[this.offset++] = count;
+  }
+
+  drawElements(mode: number, count: number, type: number, offset: number):
+      void {
+    this.begin(CommandOpcode.DRAW_ELEMENTS, 4);
+    this.u32[this.offset++] = mode;
+    this.i32[this.offset++] = count;
+    this.u32[this.offset++] = type;
+    this.u32[this.offset++] = offset;
+  }
+
+  enable(cap: number): void {
+    this.begin(CommandOpcode.ENABLE, 1);
+    this.u32[this.offset++] = cap;
+  }
+
+  enableVertexAttribArray(index: number): void {
+    this.begin(CommandOpcode.ENABLE_VERTEX_ATTRIB_ARRAY, 1);
+    this.u32[this.offset++] = index;
+  }
+
+  flush(): void {
+    this.begin(CommandOpcode.FLUSH, 0);
+  }
+
+  framebufferRenderbuffer(
+      target: number, attachment: number, renderbuffertarget: number,
+      renderbuffer: WebGLRenderbuffer|null): void {
+    this.begin(CommandOpcode.FRAMEBUFFER_RENDERBUFFER, 4);
+    this.u32[this.offset++] = target;
+    this.u32[this.offset++] = attachment;
+    this.u32[this.offset++] = renderbuffertarget;
+    this.u32[this.offset++] = handle(renderbuffer);
+  }
+
+  framebufferTexture2D(
+      target: number, attachment: number, textarget: number,
+      texture: WebGLTexture|null, level: number): void {
+    this.begin(CommandOpcode.FRAMEBUFFER_TEXTURE_2D, 5);
+    this.u32[this.offset++] = target;
+    this.u32[this.offset++] = attachment;
+    this.u32[this.offset++] = textarget;
+    this.u32[this.offset++] = handle(texture);
+    this.i32[this.offset++] = level;
+  }
+
+  pixelStorei(pname: number, param: number|boolean): void {
+    this.begin(CommandOpcode.PIXEL_STOREI, 2);
+    this.u32[this.offset++] = pname;
+    this.i32[this.offset++] = +param;
+  }
+
+  scissor(x: number, y: number, width: number, height: number): void {
+    this.begin(CommandOpcode.SCISSOR, 4);
+    this.i32[this.offset++] = x;
+    this.i32[this.offset++] = y;
+    this.i32[this.offset++] = width;
+    this.i32[this.offset++] = height;
+  }
+
+  texParameterf(target: number, pname: number, param: number): void {
+    this.begin(CommandOpcode.TEX_PARAMETERF, 3);
+    this.u32[this.offset++] = target;
+    this.u32[this.offset++] = pname;
+    this.f32[this.offset++] = param;
+  }
+
+  texParameteri(target: number, pname: number, param: number): void {
+    this.begin(CommandOpcode.TEX_PARAMETERI, 3);
+    this.u32[this.offset++] = target;
+    this.u32[this.offset++] = pname;
+    this.i32[this.offset++] = param;
+  }
+
+  uniform1f(location: WebGLUniformLocation|null, x: number): void {
+    this.begin(CommandOpcode.UNIFORM_1F, 2);
+    this.i32[this.offset++] = this.location(location);
+    this.f32[this.offset++] = x;
+  }
+
+  uniform1i(location: WebGLUniformLocation|null, x: number): void {
+    this.begin(CommandOpcode.UNIFORM_1I, 2);
+    this.i32[this.offset++] = this.location(location);
+    this.i32[this.offset++] = x;
+  }
+
+  uniform2f(location: WebGLUniformLocation|null, x: number, y: number): void {
+    this.begin(CommandOpcode.UNIFORM_2F, 3);
+    this.i32[this.offset++] = this.location(location);
+    this.f32[this.offset++] = x;
+    this.f32[this.offset++] = y;
+  }
+
+  uniform2i(location: WebGLUniformLocation|null, x: number, y: number): void {
+    this.begin(CommandOpcode.UNIFORM_2I, 3);
+    this.i32[this.offset++] = this.location(location);
+    this.i32[this.offset++] = x;
+    this.i32[this.offset++] = y;
+  }
+
+  uniform3f(
+      location: WebGLUniformLocation|null, x: number, y: number,
+      z: number): void {
+    this.begin(CommandOpcode.UNIFORM_3F, 4);
+    this.i32[this.offset++] = this.location(location);
+    this.f32[this.offset++] = x;
+    this.f32[this.offset++] = y;
+    this.f32[this.offset++] = z;
+  }
+
+  uniform3i(
+      location: WebGLUniformLocation|null, x: number, y: number,
+      z: number): void {
+    this.begin(CommandOpcode.UNIFORM_3I, 4);
+    this.i32[this.offset++] = this.location(location);
+    this.i32[this.offset++] = x;
+    this.i32[this.offset++] = y;
+    this.i32[this.offset++] = z;
+  }
+
+  uniform4f(
+      location: WebGLUniformLocation|null, x: number, y: number, z: number,
+      w: number): void {
+    this.begin(CommandOpcode.UNIFORM_4F, 5);
+    this.i32[this.offset++] = this.location(location);
+    this.f32[this.offset++] = x;
+    this.f32[this.offset++] = y;
+    this.f32[this.offset++] = z;
+    this.f32[this.offset++] = w;
+  }
+
+  uniform4i(
+      location: WebGLUniformLocation|null, x: number, y: number, z: number,
+      w: number): void {
+    this.begin(CommandOpcode.UNIFORM_4I, 5);
+    this.i32[this.offset++] = this.location(location);
+    this.i32[this.offset++] = x;
+    this.i32[this.offset++] = y;
+    this.i32[this.offset++] = z;
+    this.i32[this.offset++] = w;
+  }
+
+  useProgram(program: WebGLProgram|null): void {
+    this.begin(CommandOpcode.USE_PROGRAM, 1);
+    this.u32[this.offset++] = handle(program);
+  }
+
+  vertexAttribPointer(
+      index: number, size: number, type: number, normalized: boolean,
+      stride: number, offset: number): void {
+    this.begin(CommandOpcode.VERTEX_ATTRIB_POINTER, 6);
+    this.u32[this.offset++] = index;
+    this.i32[this.offset++] = size;
+    this.u32[this.offset++] = type;
+    this.u32[this.offset++] = normalized ? 1 : 0;
+    this.i32[this.offset++] = stride;
+    this.u32[this.offset++] = offset;
+  }
+
+  viewport(x: number, y: number, width: number, height: number): void {
+    this.begin(CommandOpcode.VIEWPORT, 4);
+    this.i32[this.offset++] = x;
+    this.i32[this.offset++] = y;
+    this.i32[this.offset++] = width;
+    this.i32[this.offset++] = height;
+  }
+
+  private begin(opcode: CommandOpcode, argCount: number): void {
+    if (this.offset + 1 + argCount > this.u32.length) {
+      this.allocate(this.u32.length * 2);
+    }
+    this.u32[this.offset++] = opcode;
+    this.count++;
+  }
+
+  // Locations are -1 when a uniform is inactive, which GL ignores.
+  private location(location: WebGLUniformLocation|null): number {
+    return location == null ? -1 : location as number;
+  }
+
+  private allocate(capacity: number): void {
+    const buffer = new ArrayBuffer(capacity * 4);
+    const u32 = new Uint32Array(buffer);
+    if (this.u32 != null) {
+      u32.set(this.u32.subarray(0, this.offset));
+    }
+    this.u32 = u32;
+    this.i32 = new Int32Array(buffer);
+    this.f32 = new Float32Array(buffer);
+  }
+}
+
+// CommandBuffer methods that record a command, as opposed to bookkeeping.
+const RECORDED_METHODS = Object.getOwnPropertyNames(CommandBuffer.prototype)
+                             .filter(
+                                 name => name !== 'constructor' &&
+                                     name !== 'commandCount' &&
+                                     name !== 'begin' && name !== 'location' &&
+                                     name !== 'allocate');
+
+/**
+ * Wraps a context so that all calls with a command-buffer opcode are recorded
+ * and executed in batches. Any other method (queries, uploads, object
+ * creation, ...) first flushes pending commands so ordering is preserved.
+ * Existing WebGL code can use the returned object in place of `gl` unchanged.
+ * Contexts created with `wrapObjects` are not supported, recorded calls taking
+ * object wrappers throw.
+ */
+export function createBatchingContext<T extends NodeJsGlContext>(
+    gl: T, initialCapacity?: number): T&{flushCommands(): void} {
+  const commands = new CommandBuffer(gl, initialCapacity);
+  // tslint:disable-next-line:no-any
+  const cache: {[name: string]: any} = {};
+  // tslint:disable-next-line:no-any
+  return new Proxy(gl as any, {
+    get(target, property) {
+      const name = property as string;
+      if (cache[name] !== undefined) {
+        return cache[name];
+      }
+      // tslint:disable-next-line:no-any
+      let value: any;
+      if (RECORDED_METHODS.indexOf(name) !== -1) {
+        // tslint:disable-next-line:no-any
+        value = (commands as any)[name].bind(commands);
+      } else {
+        value = target[name];
+        if (typeof value !== 'function') {
+          return value;
+        }
+        const method = value;
+        // tslint:disable-next-line:no-any
+        value = (...args: any[]) => {
+          commands.flushCommands();
+          return method.apply(target, args);
+        };
+      }
+      cache[name] = value;
+      return value;
+    }
+  });
+}
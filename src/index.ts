@@ -17,7 +17,9 @@
 
 // tslint:disable-next-line:no-require-imports
 import bindings = require('bindings');
-import {NodeJsGlBinding} from './binding';
+import {NodeJsGlBinding, NodeJsGlContext} from './binding';
+import {CommandBuffer, CommandOpcode, createBatchingContext} from
+    './command_buffer';
 
 const binding = bindings('nodejs_gl_binding') as NodeJsGlBinding;
 
@@ -28,6 +30,41 @@ interface ContextArguments {
     webGLCompability?: boolean,
     majorVersion?: number,
     minorVersion?: number,
+    // Return GC-finalized WebGLObject wrappers from create*() instead of
+    // numbers. Objects that are never deleted are released once collected.
+    // fenceSync() always returns such wrappers. getParameter() returns the
+    // same wrappers for bindings such as TEXTURE_BINDING_2D or
+    // CURRENT_PROGRAM, as do getAttachedShaders() and
+    // FRAMEBUFFER_ATTACHMENT_OBJECT_NAME. CommandBuffer only records numeric handles and throws
+    // when given wrappers.
+    wrapObjects?: boolean,
+    // Run executeCommandsAsync()/finishAsync() work on a dedicated native
+    // thread that owns the GL context while work is queued.
+    commandThread?: boolean,
+    // Create the context in the share group of an existing context, so
+    // textures, buffers, programs, ... are usable from both. See
+    // signalHandoff()/waitHandoff().
+    shareWith?: NodeJsGlContext,
+    // Threads the driver may use to compile shaders in the background
+    // (KHR_parallel_shader_compile). Leaves the driver default if unset.
+    maxShaderCompilerThreads?: number,
+    // Directory where linked program binaries are kept across processes.
+    // linkProgram() of a program with the same shaders loads the binary
+    // instead of linking again. Disabled if unset.
+    programBinaryCacheDir?: string,
+    // File where ANGLE keeps its internal shader and pipeline caches across
+    // runs (EGL_ANDROID_blob_cache). Processes may share the file. Only one
+    // file can be used per process, and it must be passed to the first context
+    // created. Not supported on Windows.
+    blobCacheFile?: string,
+    // Size of the blob cache file when it is created. Once full, the cache
+    // starts over. Defaults to 64MB.
+    blobCacheMaxBytes?: number,
+    // Don't allocate a default framebuffer (EGL_KHR_surfaceless_context), for
+    // contexts that only render to framebuffer objects. width and height are
+    // ignored and framebuffer 0 is incomplete. Falls back to a 1x1 default
+    // framebuffer if the extension is not available.
+    surfaceless?: boolean,
 };
 
 const createWebGLRenderingContext = function(args: ContextArguments = {}) {
@@ -36,12 +73,28 @@ const createWebGLRenderingContext = function(args: ContextArguments = {}) {
     const webGLCompability = args.webGLCompability || false;
     const majorVersion =  args.majorVersion || 3;
     const minorVersion =  args.minorVersion || 0;
+    const wrapObjects = args.wrapObjects || false;
+    const commandThread = args.commandThread || false;
+    const shareWith = args.shareWith || null;
+    const maxShaderCompilerThreads = args.maxShaderCompilerThreads;
+    const programBinaryCacheDir = args.programBinaryCacheDir;
+    const blobCacheFile = args.blobCacheFile;
+    const blobCacheMaxBytes = args.blobCacheMaxBytes;
+    const surfaceless = args.surfaceless || false;
     return binding.createWebGLRenderingContext(
         width,
         height,
         majorVersion,
         minorVersion,
         webGLCompability,
+        wrapObjects,
+        commandThread,
+        shareWith,
+        maxShaderCompilerThreads,
+        programBinaryCacheDir,
+        blobCacheFile,
+        blobCacheMaxBytes,
+        surfaceless,
     );
 
 
@@ -49,3 +102,4 @@ const createWebGLRenderingContext = function(args: ContextArguments = {}) {
 
 
 export { createWebGLRenderingContext };
+export { CommandBuffer, CommandOpcode, createBatchingContext };
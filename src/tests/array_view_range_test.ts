@@ -0,0 +1,34 @@
+import * as gles from '../.';
+
+// Uploads sub-ranges of one large arena, both as subarray() views and through
+// the WebGL2 srcOffset/length overloads, and reads them back.
+
+const gl = gles.createWebGLRenderingContext({});
+const gl2 = gl as WebGL2RenderingContext;
+
+const arena = new Float32Array(1024);
+for (let i = 0; i < arena.length; i++) {
+  arena[i] = i;
+}
+
+const buffer = gl.createBuffer();
+gl.bindBuffer(gl.ARRAY_BUFFER, buffer);
+
+// Only the 4 floats of the view are uploaded, not the whole arena.
+gl.bufferData(gl.ARRAY_BUFFER, arena.subarray(100, 104), gl.STATIC_DRAW);
+console.log('size:', gl.getBufferParameter(gl.ARRAY_BUFFER, gl.BUFFER_SIZE));
+
+const result = new Float32Array(4);
+gl2.getBufferSubData(gl.ARRAY_BUFFER, 0, result);
+console.log('subarray(100, 104):', result);
+
+// Same range with srcOffset/length.
+gl2.bufferSubData(gl.ARRAY_BUFFER, 0, arena, 200, 4);
+gl2.getBufferSubData(gl.ARRAY_BUFFER, 0, result);
+console.log('srcOffset 200, length 4:', result);
+
+// Read into the second half of the destination with dstOffset/length.
+gl2.getBufferSubData(gl.ARRAY_BUFFER, 0, result, 2, 2);
+console.log('dstOffset 2, length 2:', result);
+
+gl.deleteBuffer(buffer);
@@ -0,0 +1,81 @@
+import {execFileSync} from 'child_process';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+
+import * as gles from '../.';
+
+// Compiles and links the same programs in two processes that share a blob
+// cache file, so that the second process can reuse what ANGLE cached in the
+// first one:
+//
+//   $ yarn ts-node src/tests/blob_cache_benchmark.ts
+
+const PROGRAMS = 50;
+
+function createProgram(gl: WebGLRenderingContext, id: number): WebGLProgram {
+  const vertexShader = gl.createShader(gl.VERTEX_SHADER);
+  gl.shaderSource(vertexShader, `
+    attribute vec4 position;
+    void main() {
+      gl_Position = position * ${id}.0;
+    }`);
+  gl.compileShader(vertexShader);
+
+  const fragmentShader = gl.createShader(gl.FRAGMENT_SHADER);
+  gl.shaderSource(fragmentShader, `
+    precision highp float;
+    uniform sampler2D image;
+    void main() {
+      vec4 sum = vec4(0);
+      for (int i = 0; i < 16; i++) {
+        sum += texture2D(image, vec2(float(i) / ${id + 16}.0, 0.5));
+      }
+      gl_FragColor = sum;
+    }`);
+  gl.compileShader(fragmentShader);
+
+  const program = gl.createProgram();
+  gl.attachShader(program, vertexShader);
+  gl.attachShader(program, fragmentShader);
+  return program;
+}
+
+// Runs in the child processes, prints the time spent compiling and linking.
+function runChild(blobCacheFile: string): void {
+  const start = process.hrtime();
+  const gl = gles.createWebGLRenderingContext({blobCacheFile});
+  for (let i = 0; i < PROGRAMS; i++) {
+    const program = createProgram(gl, i);
+    gl.linkProgram(program);
+    if (!gl.getProgramParameter(program, gl.LINK_STATUS)) {
+      throw new Error(gl.getProgramInfoLog(program));
+    }
+  }
+  const elapsed = process.hrtime(start);
+  console.log((elapsed[0] * 1e3 + elapsed[1] / 1e6).toFixed(1));
+}
+
+function runParent(): void {
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'node-gles-'));
+  const blobCacheFile = path.join(dir, 'blob_cache');
+  try {
+    for (const label of ['cold cache', 'warm cache']) {
+      const millis = execFileSync(
+          process.execPath,
+          ['-r', 'ts-node/register', __filename, blobCacheFile]);
+      console.log(`${label}: ${millis.toString().trim()} ms`);
+    }
+  } finally {
+    if (fs.existsSync(blobCacheFile)) {
+      fs.unlinkSync(blobCacheFile);
+    }
+    fs.rmdirSync(dir);
+  }
+}
+
+if (process.argv.length > 2) {
+  runChild(process.argv[2]);
+} else {
+  runParent();
+}
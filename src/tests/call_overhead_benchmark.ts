@@ -0,0 +1,39 @@
+import * as gles from '../.';
+
+// Measures the per-call cost of crossing into the binding for simple GL entry
+// points. Run on two revisions to compare argument decoding overhead:
+//
+//   $ yarn ts-node src/tests/call_overhead_benchmark.ts
+
+const gl = gles.createWebGLRenderingContext({});
+
+const ITERATIONS = 1000000;
+const WARMUP_ITERATIONS = 10000;
+
+function bench(name: string, fn: (i: number) => void): void {
+  for (let i = 0; i < WARMUP_ITERATIONS; i++) {
+    fn(i);
+  }
+  const start = process.hrtime();
+  for (let i = 0; i < ITERATIONS; i++) {
+    fn(i);
+  }
+  const elapsed = process.hrtime(start);
+  const nanos = elapsed[0] * 1e9 + elapsed[1];
+  console.log(`${name}: ${(nanos / ITERATIONS).toFixed(1)} ns/call`);
+}
+
+const texture = gl.createTexture();
+const program = gl.createProgram();
+
+bench('getError()', () => gl.getError());
+bench('activeTexture(GLenum)', () => gl.activeTexture(gl.TEXTURE0));
+bench(
+    'bindTexture(GLenum, GLuint)',
+    () => gl.bindTexture(gl.TEXTURE_2D, texture));
+bench('bindTexture(GLenum, null)', () => gl.bindTexture(gl.TEXTURE_2D, null));
+bench('enable(GLenum)', () => gl.enable(gl.SCISSOR_TEST));
+bench('viewport(GLint x4)', (i) => gl.viewport(0, 0, 1, (i & 1) + 1));
+bench('uniform2f(GLint, GLfloat x2)', (i) => gl.uniform2f(-1, i, 0.5));
+bench('colorMask(GLboolean x4)', () => gl.colorMask(true, true, true, true));
+bench('isProgram(GLuint)', () => gl.isProgram(program));
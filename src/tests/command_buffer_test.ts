@@ -0,0 +1,28 @@
+import * as gles from '../.';
+
+import {createTexture2D, ensureFramebufferAttachment, initEnvGL} from './test_utils';
+
+const gl = gles.createWebGLRenderingContext({});
+const gl2 = gl as WebGL2RenderingContext;
+
+initEnvGL(gl);  // Don't worry about buffers in this demo
+
+const texture = createTexture2D(gl, gl2.RGBA8, gl.RGBA, gl.UNSIGNED_BYTE);
+const framebuffer = gl.createFramebuffer();
+
+// Record state changes and the clear into a single native call:
+const batched = gles.createBatchingContext(gl);
+batched.bindFramebuffer(gl.FRAMEBUFFER, framebuffer);
+batched.framebufferTexture2D(
+    gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, gl.TEXTURE_2D, texture, 0);
+batched.viewport(0, 0, 1, 1);
+batched.scissor(0, 0, 1, 1);
+batched.clearColor(0.25, 0.5, 0.75, 1.0);
+batched.clear(gl.COLOR_BUFFER_BIT);
+
+// Non-recorded calls flush pending commands first:
+ensureFramebufferAttachment(batched);
+
+const buffer = new Uint8Array(4);
+batched.readPixels(0, 0, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, buffer);
+console.log('buffer: ', buffer);
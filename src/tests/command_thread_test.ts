@@ -0,0 +1,41 @@
+import * as gles from '../.';
+
+// Queues GPU work on the context's command thread and checks that the event
+// loop keeps ticking while it runs. The synchronous readPixels() at the end
+// waits for the queued work.
+
+const gl = gles.createWebGLRenderingContext(
+    {width: 512, height: 512, commandThread: true});
+
+const BATCHES = 100;
+const CLEARS_PER_BATCH = 100;
+
+async function main() {
+  let ticks = 0;
+  const timer = setInterval(() => ticks++, 1);
+
+  const start = process.hrtime();
+  const commands = new gles.CommandBuffer(gl);
+  const batches: Array<Promise<void>> = [];
+  for (let i = 0; i < BATCHES; i++) {
+    for (let j = 0; j < CLEARS_PER_BATCH; j++) {
+      commands.clearColor(i / BATCHES, j / CLEARS_PER_BATCH, 0, 1);
+      commands.clear(gl.COLOR_BUFFER_BIT);
+    }
+    batches.push(commands.flushCommandsAsync());
+  }
+  await Promise.all(batches);
+  await gl.finishAsync();
+  const [seconds, nanoseconds] = process.hrtime(start);
+  clearInterval(timer);
+
+  const ms = seconds * 1e3 + nanoseconds / 1e6;
+  console.log(`${BATCHES * CLEARS_PER_BATCH} clears: ${ms.toFixed(1)}ms`);
+  console.log('event loop ticks meanwhile:', ticks);
+
+  const pixel = new Uint8Array(4);
+  gl.readPixels(0, 0, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixel);
+  console.log('last clear color:', pixel);
+}
+
+main();
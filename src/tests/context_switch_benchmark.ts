@@ -0,0 +1,42 @@
+import * as gles from '../.';
+
+// Checks that several contexts in one process keep independent GL state and
+// measures the cost of switching between them. Calls on the context that is
+// already current skip eglMakeCurrent():
+//
+//   $ yarn ts-node src/tests/context_switch_benchmark.ts
+
+const CONTEXTS = 4;
+const ITERATIONS = 100000;
+
+const contexts = [];
+for (let i = 0; i < CONTEXTS; i++) {
+  contexts.push(gles.createWebGLRenderingContext({}));
+}
+
+// Each context clears to its own color, interleaved with the others.
+contexts.forEach((gl, i) => gl.clearColor(i / CONTEXTS, 0, 0, 1));
+contexts.forEach((gl) => gl.clear(gl.COLOR_BUFFER_BIT));
+contexts.forEach((gl, i) => {
+  const pixel = new Uint8Array(4);
+  gl.readPixels(0, 0, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixel);
+  console.log(`context ${i} red:`, pixel[0]);
+});
+
+function bench(name: string, fn: (i: number) => void): void {
+  const start = process.hrtime();
+  for (let i = 0; i < ITERATIONS; i++) {
+    fn(i);
+  }
+  const elapsed = process.hrtime(start);
+  const nanos = elapsed[0] * 1e9 + elapsed[1];
+  console.log(`${name}: ${(nanos / ITERATIONS).toFixed(1)} ns/call`);
+}
+
+bench('getError(), same context', () => contexts[0].getError());
+bench(
+    'getError(), switching contexts',
+    (i) => contexts[i % CONTEXTS].getError());
+bench(
+    'getError(), switching every 100 calls',
+    (i) => contexts[Math.floor(i / 100) % CONTEXTS].getError());
@@ -0,0 +1,27 @@
+import * as gles from '../.';
+
+// Prints limits (cached at context creation) and state (served from the state
+// cache) through getParameter().
+
+const gl = gles.createWebGLRenderingContext({});
+const gl2 = gl as WebGL2RenderingContext;
+
+console.log('RENDERER:', gl.getParameter(gl.RENDERER));
+console.log('MAX_TEXTURE_SIZE:', gl.getParameter(gl.MAX_TEXTURE_SIZE));
+console.log('MAX_VIEWPORT_DIMS:', gl.getParameter(gl.MAX_VIEWPORT_DIMS));
+console.log('MAX_SAMPLES:', gl.getParameter(gl2.MAX_SAMPLES));
+
+const buffer = gl.createBuffer();
+gl.bindBuffer(gl.ARRAY_BUFFER, buffer);
+gl.viewport(0, 0, 1, 1);
+gl.colorMask(true, false, true, false);
+gl.clearColor(0.25, 0.5, 0.75, 1.0);
+gl.pixelStorei(gl.UNPACK_ALIGNMENT, 1);
+
+console.log(
+    'ARRAY_BUFFER_BINDING:', gl.getParameter(gl.ARRAY_BUFFER_BINDING),
+    'expected:', buffer);
+console.log('VIEWPORT:', gl.getParameter(gl.VIEWPORT));
+console.log('COLOR_WRITEMASK:', gl.getParameter(gl.COLOR_WRITEMASK));
+console.log('COLOR_CLEAR_VALUE:', gl.getParameter(gl.COLOR_CLEAR_VALUE));
+console.log('UNPACK_ALIGNMENT:', gl.getParameter(gl.UNPACK_ALIGNMENT));
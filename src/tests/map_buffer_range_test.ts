@@ -0,0 +1,31 @@
+import * as gles from '../.';
+
+// Fills a buffer in place through mapBufferRange(), reads it back the same
+// way, and checks that the mapped ArrayBuffer is detached after unmapping.
+
+const gl = gles.createWebGLRenderingContext({});
+
+const COUNT = 1024 * 1024;
+const buffer = gl.createBuffer();
+gl.bindBuffer(gl.ARRAY_BUFFER, buffer);
+gl.bufferData(gl.ARRAY_BUFFER, COUNT * 4, gl.STATIC_DRAW);
+
+const writable = gl.mapBufferRange(
+    gl.ARRAY_BUFFER, 0, COUNT * 4,
+    gl.MAP_WRITE_BIT | gl.MAP_INVALIDATE_BUFFER_BIT);
+const floats = new Float32Array(writable);
+for (let i = 0; i < COUNT; i++) {
+  floats[i] = i;
+}
+console.log('unmapped:', gl.unmapBuffer(gl.ARRAY_BUFFER));
+console.log('detached after unmap:', writable.byteLength === 0);
+
+const readable =
+    gl.mapBufferRange(gl.ARRAY_BUFFER, 4 * 10, 4 * 4, gl.MAP_READ_BIT);
+console.log('values 10..13:', new Float32Array(readable));
+gl.unmapBuffer(gl.ARRAY_BUFFER);
+
+// Deleting a mapped buffer unmaps it as well.
+const lost = gl.mapBufferRange(gl.ARRAY_BUFFER, 0, 16, gl.MAP_READ_BIT);
+gl.deleteBuffer(buffer);
+console.log('detached after delete:', lost.byteLength === 0);
@@ -0,0 +1,29 @@
+import * as gles from '../.';
+
+// Creates a few GL objects and prints the GPU memory estimate that is also
+// reported to V8 as external memory.
+
+const gl = gles.createWebGLRenderingContext({});
+
+const buffer = gl.createBuffer();
+gl.bindBuffer(gl.ARRAY_BUFFER, buffer);
+gl.bufferData(gl.ARRAY_BUFFER, 1024 * 1024, gl.STATIC_DRAW);
+
+const texture = gl.createTexture();
+gl.bindTexture(gl.TEXTURE_2D, texture);
+gl.texImage2D(
+    gl.TEXTURE_2D, 0, gl.RGBA, 256, 256, 0, gl.RGBA, gl.UNSIGNED_BYTE, null);
+gl.generateMipmap(gl.TEXTURE_2D);
+
+const renderbuffer = gl.createRenderbuffer();
+gl.bindRenderbuffer(gl.RENDERBUFFER, renderbuffer);
+gl.renderbufferStorage(gl.RENDERBUFFER, gl.DEPTH_COMPONENT16, 256, 256);
+
+console.log('allocated:', gl.getMemoryInfo());
+console.log('external memory:', process.memoryUsage().external);
+
+gl.deleteBuffer(buffer);
+gl.deleteTexture(texture);
+gl.deleteRenderbuffer(renderbuffer);
+
+console.log('deleted:', gl.getMemoryInfo());
@@ -0,0 +1,39 @@
+import * as gles from '../.';
+
+// Creates textures without deleting them. With wrapObjects the textures are
+// released once their wrappers are collected (run with --expose-gc).
+
+const gl = gles.createWebGLRenderingContext({wrapObjects: true});
+
+function leakTextures(count: number) {
+  for (let i = 0; i < count; i++) {
+    const texture = gl.createTexture();
+    gl.bindTexture(gl.TEXTURE_2D, texture);
+    gl.texImage2D(
+        gl.TEXTURE_2D, 0, gl.RGBA, 256, 256, 0, gl.RGBA, gl.UNSIGNED_BYTE,
+        null);
+  }
+  gl.bindTexture(gl.TEXTURE_2D, null);
+}
+
+leakTextures(256);
+console.log('before GC:', gl.getMemoryInfo().textures);
+
+// tslint:disable-next-line:no-any
+const gc = (global as any).gc;
+if (gc) {
+  gc();
+}
+
+setImmediate(() => {
+  // Queued deletions run with the next create*() call.
+  const texture = gl.createTexture();
+  console.log('after GC: ', gl.getMemoryInfo().textures);
+
+  gl.bindTexture(gl.TEXTURE_2D, texture);
+  console.log(
+      'TEXTURE_BINDING_2D returns the wrapper:',
+      gl.getParameter(gl.TEXTURE_BINDING_2D) === texture);
+  gl.bindTexture(gl.TEXTURE_2D, null);
+  gl.deleteTexture(texture);
+});
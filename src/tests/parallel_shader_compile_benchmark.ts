@@ -0,0 +1,87 @@
+import * as os from 'os';
+
+import * as gles from '../.';
+
+// Compiles and links a batch of distinct programs, once with linkProgram() and
+// once with linkProgramAsync(), and reports the time the event loop was
+// blocked and the total time of each:
+//
+//   $ yarn ts-node src/tests/parallel_shader_compile_benchmark.ts
+
+const PROGRAMS = 100;
+
+const gl = gles.createWebGLRenderingContext(
+    {maxShaderCompilerThreads: os.cpus().length});
+const extension = gl.getExtension('KHR_parallel_shader_compile');
+console.log('KHR_parallel_shader_compile:', extension !== null);
+
+let variant = 0;
+
+function createProgram(): WebGLProgram {
+  // Distinct sources so that no compile is served from a cache.
+  const id = variant++;
+  const vertexShader = gl.createShader(gl.VERTEX_SHADER);
+  gl.shaderSource(vertexShader, `
+    attribute vec4 position;
+    void main() {
+      gl_Position = position * ${id}.0;
+    }`);
+  gl.compileShader(vertexShader);
+
+  const fragmentShader = gl.createShader(gl.FRAGMENT_SHADER);
+  gl.shaderSource(fragmentShader, `
+    precision highp float;
+    uniform sampler2D image;
+    void main() {
+      vec4 sum = vec4(0);
+      for (int i = 0; i < 16; i++) {
+        sum += texture2D(image, vec2(float(i) / ${id + 16}.0, 0.5));
+      }
+      gl_FragColor = sum;
+    }`);
+  gl.compileShader(fragmentShader);
+
+  const program = gl.createProgram();
+  gl.attachShader(program, vertexShader);
+  gl.attachShader(program, fragmentShader);
+  return program;
+}
+
+function millis(start: [number, number]): string {
+  const elapsed = process.hrtime(start);
+  return (elapsed[0] * 1e3 + elapsed[1] / 1e6).toFixed(1);
+}
+
+function benchSync(): void {
+  const start = process.hrtime();
+  for (let i = 0; i < PROGRAMS; i++) {
+    const program = createProgram();
+    gl.linkProgram(program);
+    if (!gl.getProgramParameter(program, gl.LINK_STATUS)) {
+      throw new Error(gl.getProgramInfoLog(program));
+    }
+  }
+  console.log(`linkProgram(): ${millis(start)} ms, all blocking`);
+}
+
+async function benchAsync(): Promise<void> {
+  const start = process.hrtime();
+  const pending = [];
+  for (let i = 0; i < PROGRAMS; i++) {
+    pending.push(gl.linkProgramAsync(createProgram()));
+  }
+  const blocking = millis(start);
+
+  const linked = await Promise.all(pending);
+  if (linked.some((ok) => !ok)) {
+    throw new Error('Link failed');
+  }
+  console.log(
+      `linkProgramAsync(): ${millis(start)} ms, ${blocking} ms blocking`);
+}
+
+benchSync();
+benchAsync().catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
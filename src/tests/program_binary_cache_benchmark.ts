@@ -0,0 +1,69 @@
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+
+import * as gles from '../.';
+
+// Links the same batch of programs in two contexts that use one program binary
+// cache directory and compares the link times. The second context stands in
+// for a later process, it starts with an empty in-memory index:
+//
+//   $ yarn ts-node src/tests/program_binary_cache_benchmark.ts
+
+const PROGRAMS = 50;
+
+const cacheDir = fs.mkdtempSync(path.join(os.tmpdir(), 'node-gles-'));
+
+function createProgram(gl: WebGLRenderingContext, id: number): WebGLProgram {
+  const vertexShader = gl.createShader(gl.VERTEX_SHADER);
+  gl.shaderSource(vertexShader, `
+    attribute vec4 position;
+    void main() {
+      gl_Position = position * ${id}.0;
+    }`);
+  gl.compileShader(vertexShader);
+
+  const fragmentShader = gl.createShader(gl.FRAGMENT_SHADER);
+  gl.shaderSource(fragmentShader, `
+    precision highp float;
+    uniform sampler2D image;
+    void main() {
+      vec4 sum = vec4(0);
+      for (int i = 0; i < 16; i++) {
+        sum += texture2D(image, vec2(float(i) / ${id + 16}.0, 0.5));
+      }
+      gl_FragColor = sum;
+    }`);
+  gl.compileShader(fragmentShader);
+
+  const program = gl.createProgram();
+  gl.attachShader(program, vertexShader);
+  gl.attachShader(program, fragmentShader);
+  return program;
+}
+
+function bench(label: string): void {
+  const gl = gles.createWebGLRenderingContext(
+      {programBinaryCacheDir: cacheDir});
+  const start = process.hrtime();
+  for (let i = 0; i < PROGRAMS; i++) {
+    const program = createProgram(gl, i);
+    gl.linkProgram(program);
+    if (!gl.getProgramParameter(program, gl.LINK_STATUS)) {
+      throw new Error(gl.getProgramInfoLog(program));
+    }
+  }
+  const elapsed = process.hrtime(start);
+  const millis = (elapsed[0] * 1e3 + elapsed[1] / 1e6).toFixed(1);
+  console.log(`${label}: ${millis} ms`, gl.getProgramBinaryCacheStats());
+}
+
+try {
+  bench('cold cache');
+  bench('warm cache');
+} finally {
+  for (const file of fs.readdirSync(cacheDir)) {
+    fs.unlinkSync(path.join(cacheDir, file));
+  }
+  fs.rmdirSync(cacheDir);
+}
@@ -0,0 +1,23 @@
+import * as gles from '../.';
+
+// Reads back a cleared framebuffer with readPixelsAsync() while a timer keeps
+// running on the event loop.
+
+const gl = gles.createWebGLRenderingContext({width: 256, height: 256});
+
+let ticks = 0;
+const interval = setInterval(() => ticks++, 0);
+
+gl.clearColor(1, 0.5, 0.25, 1);
+gl.clear(gl.COLOR_BUFFER_BIT);
+
+const pixels = new Uint8Array(256 * 256 * 4);
+const start = process.hrtime();
+gl.readPixelsAsync(0, 0, 256, 256, gl.RGBA, gl.UNSIGNED_BYTE, pixels)
+    .then((result) => {
+      const elapsed = process.hrtime(start);
+      clearInterval(interval);
+      console.log('first pixel:', result.slice(0, 4));
+      console.log(
+          `resolved after ${elapsed[1] / 1e6} ms, ${ticks} timer ticks`);
+    });
@@ -0,0 +1,40 @@
+import * as gles from '../.';
+
+// Reads back a large float framebuffer into binding-owned memory and reports
+// the time per readback. Collected ArrayBuffers return their memory to the
+// readback pool, so repeated reads don't allocate.
+
+const SIZE = 1024;
+const ITERATIONS = 10;
+
+const gl = gles.createWebGLRenderingContext({});
+const gl2 = gl as WebGL2RenderingContext;
+
+gl.getExtension('EXT_color_buffer_float');
+
+const texture = gl.createTexture();
+gl.bindTexture(gl.TEXTURE_2D, texture);
+gl.texImage2D(
+    gl.TEXTURE_2D, 0, gl2.RGBA32F, SIZE, SIZE, 0, gl.RGBA, gl.FLOAT, null);
+
+const framebuffer = gl.createFramebuffer();
+gl.bindFramebuffer(gl.FRAMEBUFFER, framebuffer);
+gl.framebufferTexture2D(
+    gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, gl.TEXTURE_2D, texture, 0);
+
+gl.clearColor(0.25, 0.5, 0.75, 1);
+gl.clear(gl.COLOR_BUFFER_BIT);
+
+for (let i = 0; i < ITERATIONS; i++) {
+  const start = process.hrtime();
+  const buffer =
+      gl.readPixelsToArrayBuffer(0, 0, SIZE, SIZE, gl.RGBA, gl.FLOAT);
+  const elapsed = process.hrtime(start);
+  const pixels = new Float32Array(buffer);
+  console.log(
+      `${buffer.byteLength} bytes in ${elapsed[1] / 1e6} ms, first pixel:`,
+      pixels.slice(0, 4));
+}
+
+gl.deleteFramebuffer(framebuffer);
+gl.deleteTexture(texture);
@@ -0,0 +1,65 @@
+import * as gles from '../.';
+
+// Passes plain JS Arrays to uniform and buffer calls every "frame" and checks
+// that the conversions stop allocating once the scratch arena has warmed up.
+
+const gl = gles.createWebGLRenderingContext({});
+
+const FRAMES = 1000;
+
+const vertexShader = gl.createShader(gl.VERTEX_SHADER);
+gl.shaderSource(vertexShader, `
+  attribute vec4 position;
+  uniform mat4 transform;
+  void main() {
+    gl_Position = transform * position;
+  }`);
+gl.compileShader(vertexShader);
+
+const fragmentShader = gl.createShader(gl.FRAGMENT_SHADER);
+gl.shaderSource(fragmentShader, `
+  precision mediump float;
+  uniform vec4 color;
+  void main() {
+    gl_FragColor = color;
+  }`);
+gl.compileShader(fragmentShader);
+
+const program = gl.createProgram();
+gl.attachShader(program, vertexShader);
+gl.attachShader(program, fragmentShader);
+gl.linkProgram(program);
+gl.useProgram(program);
+
+const transform = gl.getUniformLocation(program, 'transform');
+const color = gl.getUniformLocation(program, 'color');
+
+const buffer = gl.createBuffer();
+gl.bindBuffer(gl.ARRAY_BUFFER, buffer);
+
+const vertices: number[] = [];
+for (let i = 0; i < 1024; i++) {
+  vertices.push(i);
+}
+
+function frame(i: number) {
+  gl.uniformMatrix4fv(
+      transform, false, [1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, i, 0, 0, 1]);
+  gl.uniform4fv(color, [i / FRAMES, 0, 0, 1]);
+  gl.vertexAttrib4fv(0, [0, 0, 0, 1]);
+  gl.bufferData(gl.ARRAY_BUFFER, vertices, gl.DYNAMIC_DRAW);
+}
+
+// Warm up so the arena grows to the working set.
+frame(0);
+const before = gl.getScratchArenaStats();
+
+for (let i = 1; i <= FRAMES; i++) {
+  frame(i);
+}
+
+const after = gl.getScratchArenaStats();
+console.log('scratch arena stats:', after);
+console.log(
+    'heap allocations in steady state:',
+    after.heapAllocations - before.heapAllocations);
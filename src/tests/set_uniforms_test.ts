@@ -0,0 +1,67 @@
+import * as gles from '../.';
+
+// Packs the uniforms of a program into one buffer using the layout reported by
+// createUniformLayout() and uploads them with a single setUniforms() call.
+
+const gl = gles.createWebGLRenderingContext({});
+
+const vertexShader = gl.createShader(gl.VERTEX_SHADER);
+gl.shaderSource(vertexShader, `
+  attribute vec4 position;
+  uniform mat4 transform;
+  uniform vec2 offsets[2];
+  void main() {
+    gl_Position = transform * position + vec4(offsets[0] + offsets[1], 0, 0);
+  }`);
+gl.compileShader(vertexShader);
+
+const fragmentShader = gl.createShader(gl.FRAGMENT_SHADER);
+gl.shaderSource(fragmentShader, `
+  precision mediump float;
+  uniform vec4 color;
+  uniform sampler2D image;
+  void main() {
+    gl_FragColor = color * texture2D(image, vec2(0.5));
+  }`);
+gl.compileShader(fragmentShader);
+
+const program = gl.createProgram();
+gl.attachShader(program, vertexShader);
+gl.attachShader(program, fragmentShader);
+gl.linkProgram(program);
+
+const layout = gl.createUniformLayout(program);
+console.log('layout:', layout);
+
+const values = new ArrayBuffer(layout.byteLength);
+const floats = new Float32Array(values);
+const ints = new Int32Array(values);
+for (const uniform of layout.uniforms) {
+  const index = uniform.offset / 4;
+  switch (uniform.name) {
+    case 'transform':
+      floats.set([1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1], index);
+      break;
+    case 'offsets[0]':
+      floats.set([0.25, 0, 0, 0.25], index);
+      break;
+    case 'color':
+      floats.set([1, 0, 0, 1], index);
+      break;
+    case 'image':
+      ints[index] = 0;
+      break;
+    default:
+      break;
+  }
+}
+
+gl.setUniforms(program, layout.handle, values);
+
+// Unchanged values are skipped by the uniform value shadow.
+gl.setUniforms(program, layout.handle, values);
+console.log('stats:', gl.getStateCacheStats());
+
+gl.deleteProgram(program);
+gl.deleteShader(vertexShader);
+gl.deleteShader(fragmentShader);
@@ -0,0 +1,56 @@
+import * as gles from '../.';
+
+// Renders into a texture in one context and reads it from a second context of
+// the same share group, with a fence handoff instead of a readback:
+//
+//   $ yarn ts-node src/tests/share_group_test.ts
+
+const SIZE = 16;
+
+const producer = gles.createWebGLRenderingContext({});
+const consumer = gles.createWebGLRenderingContext({shareWith: producer});
+
+function attach(gl: WebGLRenderingContext, texture: WebGLTexture) {
+  // Framebuffers are not shared, each context needs its own.
+  const framebuffer = gl.createFramebuffer();
+  gl.bindFramebuffer(gl.FRAMEBUFFER, framebuffer);
+  gl.framebufferTexture2D(
+      gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, gl.TEXTURE_2D, texture, 0);
+  return framebuffer;
+}
+
+const texture = producer.createTexture();
+producer.bindTexture(producer.TEXTURE_2D, texture);
+producer.texImage2D(
+    producer.TEXTURE_2D, 0, producer.RGBA, SIZE, SIZE, 0, producer.RGBA,
+    producer.UNSIGNED_BYTE, null);
+attach(producer, texture);
+producer.clearColor(1, 0.5, 0, 1);
+producer.clear(producer.COLOR_BUFFER_BIT);
+const handle = producer.signalHandoff();
+
+consumer.waitHandoff(handle);
+attach(consumer, texture);
+const pixel = new Uint8Array(4);
+consumer.readPixels(0, 0, 1, 1, consumer.RGBA, consumer.UNSIGNED_BYTE, pixel);
+console.log('pixel read by the consumer:', pixel);
+if (pixel[0] !== 255 || pixel[1] < 127 || pixel[1] > 128 || pixel[2] !== 0) {
+  throw new Error('Consumer did not see the producer\'s rendering');
+}
+
+let threw = false;
+try {
+  consumer.waitHandoff(handle);
+} catch (e) {
+  threw = true;
+}
+console.log('second waitHandoff() throws:', threw);
+
+// Deleting a shared texture through the consumer releases the producer's
+// memory charge and binding as well.
+consumer.deleteTexture(texture);
+console.log(
+    'producer textures after delete:', producer.getMemoryInfo().textures);
+console.log(
+    'producer TEXTURE_BINDING_2D after delete:',
+    producer.getParameter(producer.TEXTURE_BINDING_2D));
@@ -0,0 +1,31 @@
+import * as gles from '../.';
+
+// Rebinds the same state repeatedly and reports how many calls were elided by
+// the state cache, with and without the cache enabled.
+
+const gl = gles.createWebGLRenderingContext({});
+
+const ITERATIONS = 1000;
+
+const texture = gl.createTexture();
+const framebuffer = gl.createFramebuffer();
+
+function rebindState(): void {
+  for (let i = 0; i < ITERATIONS; i++) {
+    gl.bindFramebuffer(gl.FRAMEBUFFER, framebuffer);
+    gl.activeTexture(gl.TEXTURE0);
+    gl.bindTexture(gl.TEXTURE_2D, texture);
+    gl.disable(gl.DEPTH_TEST);
+    gl.viewport(0, 0, 1, 1);
+  }
+}
+
+rebindState();
+console.log('enabled: ', gl.getStateCacheStats());
+
+gl.setStateCacheEnabled(false);
+rebindState();
+console.log('disabled:', gl.getStateCacheStats());
+
+gl.deleteFramebuffer(framebuffer);
+gl.deleteTexture(texture);
@@ -0,0 +1,55 @@
+import * as gles from '../.';
+
+// Streams fresh vertex data for every draw through streamWrite() instead of
+// creating or re-specifying a buffer per draw, and reports the buffer memory
+// used by the stream ring.
+
+const gl = gles.createWebGLRenderingContext({width: 64, height: 64});
+
+const vertexShader = gl.createShader(gl.VERTEX_SHADER);
+gl.shaderSource(vertexShader, `
+  attribute vec2 position;
+  void main() {
+    gl_Position = vec4(position, 0, 1);
+  }`);
+gl.compileShader(vertexShader);
+
+const fragmentShader = gl.createShader(gl.FRAGMENT_SHADER);
+gl.shaderSource(fragmentShader, `
+  precision mediump float;
+  void main() {
+    gl_FragColor = vec4(1, 0, 0, 1);
+  }`);
+gl.compileShader(fragmentShader);
+
+const program = gl.createProgram();
+gl.attachShader(program, vertexShader);
+gl.attachShader(program, fragmentShader);
+gl.linkProgram(program);
+gl.useProgram(program);
+const position = gl.getAttribLocation(program, 'position');
+gl.enableVertexAttribArray(position);
+
+const DRAWS = 100000;
+const TRIANGLES_PER_DRAW = 16;
+const vertices = new Float32Array(TRIANGLES_PER_DRAW * 6);
+
+const start = process.hrtime();
+for (let i = 0; i < DRAWS; i++) {
+  for (let j = 0; j < vertices.length; j++) {
+    vertices[j] = Math.sin(i + j);
+  }
+  const {buffer, offset} = gl.streamWrite(gl.ARRAY_BUFFER, vertices);
+  gl.bindBuffer(gl.ARRAY_BUFFER, buffer);
+  gl.vertexAttribPointer(position, 2, gl.FLOAT, false, 0, offset);
+  gl.drawArrays(gl.TRIANGLES, 0, TRIANGLES_PER_DRAW * 3);
+}
+gl.finish();
+const [seconds, nanoseconds] = process.hrtime(start);
+const ms = seconds * 1e3 + nanoseconds / 1e6;
+console.log(`${DRAWS} streamed draws: ${ms.toFixed(1)}ms`);
+console.log('memory info:', gl.getMemoryInfo());
+
+gl.deleteProgram(program);
+gl.deleteShader(vertexShader);
+gl.deleteShader(fragmentShader);
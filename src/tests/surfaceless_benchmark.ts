@@ -0,0 +1,48 @@
+import * as gles from '../.';
+
+// Creates contexts with and without a default framebuffer and checks that a
+// surfaceless context renders to a framebuffer object:
+//
+//   $ yarn ts-node src/tests/surfaceless_benchmark.ts
+
+const SIZE = 1024;
+const CONTEXTS = 50;
+
+function bench(surfaceless: boolean): void {
+  const start = process.hrtime();
+  for (let i = 0; i < CONTEXTS; i++) {
+    const gl = gles.createWebGLRenderingContext(
+        {width: SIZE, height: SIZE, surfaceless});
+    gl.clear(gl.COLOR_BUFFER_BIT);
+    gl.finish();
+  }
+  const elapsed = process.hrtime(start);
+  const millis = (elapsed[0] * 1e3 + elapsed[1] / 1e6) / CONTEXTS;
+  console.log(`surfaceless: ${surfaceless}: ${millis.toFixed(2)} ms/context`);
+}
+
+function checkRender(): void {
+  const gl = gles.createWebGLRenderingContext({surfaceless: true});
+  const texture = gl.createTexture();
+  gl.bindTexture(gl.TEXTURE_2D, texture);
+  gl.texImage2D(
+      gl.TEXTURE_2D, 0, gl.RGBA, 4, 4, 0, gl.RGBA, gl.UNSIGNED_BYTE, null);
+  const framebuffer = gl.createFramebuffer();
+  gl.bindFramebuffer(gl.FRAMEBUFFER, framebuffer);
+  gl.framebufferTexture2D(
+      gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, gl.TEXTURE_2D, texture, 0);
+  gl.viewport(0, 0, 4, 4);
+  gl.clearColor(0, 1, 0, 1);
+  gl.clear(gl.COLOR_BUFFER_BIT);
+
+  const pixel = new Uint8Array(4);
+  gl.readPixels(0, 0, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixel);
+  if (pixel[0] !== 0 || pixel[1] !== 255 || pixel[3] !== 255) {
+    throw new Error(`Unexpected pixel ${pixel}`);
+  }
+  console.log('framebuffer object rendering works without a surface');
+}
+
+bench(false);
+bench(true);
+checkRender();
@@ -0,0 +1,30 @@
+import * as gles from '../.';
+
+// Acquires and releases textures of a few recurring shapes, like a tensor
+// library would, and reports how often the pool could reuse storage.
+
+const gl = gles.createWebGLRenderingContext({});
+
+const ITERATIONS = 1000;
+const SHAPES = [[256, 256], [512, 128], [1024, 1]];
+
+gl.setTexturePoolLimit(64 * 1024 * 1024);
+
+for (let i = 0; i < ITERATIONS; i++) {
+  const [width, height] = SHAPES[i % SHAPES.length];
+  const texture = gl.acquireTexture({
+    internalFormat: gl.RGBA,
+    width,
+    height,
+  });
+  gl.bindTexture(gl.TEXTURE_2D, texture);
+  gl.texSubImage2D(
+      gl.TEXTURE_2D, 0, 0, 0, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE,
+      new Uint8Array([i % 256, 0, 0, 255]));
+  gl.bindTexture(gl.TEXTURE_2D, null);
+  gl.releaseTexture(texture);
+}
+
+const stats = gl.getTexturePoolStats();
+console.log('texture pool stats:', stats);
+console.log('hit rate:', stats.hits / (stats.hits + stats.misses));
@@ -0,0 +1,59 @@
+import * as gles from '../.';
+
+// Uploads the same uniform values repeatedly and reports how many uploads were
+// skipped by the uniform value shadow.
+
+const gl = gles.createWebGLRenderingContext({});
+
+const ITERATIONS = 1000;
+
+const vertexShader = gl.createShader(gl.VERTEX_SHADER);
+gl.shaderSource(vertexShader, `
+  attribute vec4 position;
+  uniform mat4 transform;
+  void main() {
+    gl_Position = transform * position;
+  }`);
+gl.compileShader(vertexShader);
+
+const fragmentShader = gl.createShader(gl.FRAGMENT_SHADER);
+gl.shaderSource(fragmentShader, `
+  precision mediump float;
+  uniform vec4 color;
+  uniform float scale;
+  void main() {
+    gl_FragColor = color * scale;
+  }`);
+gl.compileShader(fragmentShader);
+
+const program = gl.createProgram();
+gl.attachShader(program, vertexShader);
+gl.attachShader(program, fragmentShader);
+gl.linkProgram(program);
+gl.useProgram(program);
+
+const transform = gl.getUniformLocation(program, 'transform');
+const color = gl.getUniformLocation(program, 'color');
+const scale = gl.getUniformLocation(program, 'scale');
+
+const identity =
+    new Float32Array([1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1]);
+
+function uploadUniforms(): void {
+  for (let i = 0; i < ITERATIONS; i++) {
+    gl.uniformMatrix4fv(transform, false, identity);
+    gl.uniform4f(color, 1, 0, 0, 1);
+    gl.uniform1f(scale, 0.5);
+  }
+}
+
+uploadUniforms();
+console.log('enabled: ', gl.getStateCacheStats());
+
+gl.setStateCacheEnabled(false);
+uploadUniforms();
+console.log('disabled:', gl.getStateCacheStats());
+
+gl.deleteProgram(program);
+gl.deleteShader(vertexShader);
+gl.deleteShader(fragmentShader);
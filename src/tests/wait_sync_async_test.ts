@@ -0,0 +1,37 @@
+import * as gles from '../.';
+
+// Waits for a fence without blocking the event loop and checks that BigInt
+// timeouts are accepted by clientWaitSync() and that bad ones are rejected.
+
+const gl = gles.createWebGLRenderingContext({});
+const gl2 = gl as WebGL2RenderingContext;
+
+gl.clearColor(0, 0, 1, 1);
+gl.clear(gl.COLOR_BUFFER_BIT);
+
+const sync = gl2.fenceSync(gl2.SYNC_GPU_COMMANDS_COMPLETE, 0);
+const start = process.hrtime();
+gl.waitSyncAsync(sync).then((status) => {
+  const elapsed = process.hrtime(start);
+  console.log(
+      `waitSyncAsync() resolved with 0x${status.toString(16)} after ${
+          elapsed[1] / 1e6} ms`);
+
+  // One second as a BigInt; the fence is already signaled.
+  const timeout = BigInt(1e9) as {} as number;
+  console.log('clientWaitSync():', gl2.clientWaitSync(sync, 0, timeout));
+  console.log(
+      'MAX_CLIENT_WAIT_TIMEOUT_WEBGL:',
+      gl2.getParameter(gl2.MAX_CLIENT_WAIT_TIMEOUT_WEBGL));
+  for (const bad of [-1, NaN]) {
+    try {
+      gl2.clientWaitSync(sync, 0, bad);
+      console.log(`clientWaitSync(${bad}) did not throw`);
+    } catch (e) {
+      console.log(`clientWaitSync(${bad}) threw:`, e.message);
+    }
+  }
+
+  gl2.deleteSync(sync);
+  console.log('isSync() after delete:', gl2.isSync(sync));
+});
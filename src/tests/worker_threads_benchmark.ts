@@ -0,0 +1,76 @@
+import * as os from 'os';
+import {isMainThread, parentPort, Worker, workerData} from 'worker_threads';
+
+import * as gles from '../.';
+
+// Loads the binding in several worker threads at once, each with its own
+// context, and measures the combined throughput of clear() + readPixels() as
+// workers are added:
+//
+//   $ yarn ts-node src/tests/worker_threads_benchmark.ts
+
+const SIZE = 256;
+const ITERATIONS = 500;
+
+interface WorkerResult {
+  frames: number;
+  pixel: number;
+}
+
+function runWorker(index: number): WorkerResult {
+  const gl = gles.createWebGLRenderingContext({width: SIZE, height: SIZE});
+  const pixels = new Uint8Array(SIZE * SIZE * 4);
+  for (let i = 0; i < ITERATIONS; i++) {
+    gl.clearColor((index + 1) / 255, i / ITERATIONS, 0, 1);
+    gl.clear(gl.COLOR_BUFFER_BIT);
+    gl.readPixels(0, 0, SIZE, SIZE, gl.RGBA, gl.UNSIGNED_BYTE, pixels);
+  }
+  return {frames: ITERATIONS, pixel: pixels[0]};
+}
+
+function startWorker(index: number): Promise<WorkerResult> {
+  // Workers don't inherit the ts-node hook of the main thread.
+  const source = `require('ts-node/register'); require(${
+      JSON.stringify(__filename)});`;
+  return new Promise((resolve, reject) => {
+    const worker = new Worker(source, {eval: true, workerData: index});
+    worker.on('message', resolve);
+    worker.on('error', reject);
+  });
+}
+
+async function bench(workers: number): Promise<void> {
+  const start = process.hrtime();
+  const pending = [];
+  for (let i = 0; i < workers; i++) {
+    pending.push(startWorker(i));
+  }
+  const results = await Promise.all(pending);
+  const elapsed = process.hrtime(start);
+  const seconds = elapsed[0] + elapsed[1] / 1e9;
+
+  results.forEach((result, i) => {
+    if (result.pixel !== i + 1) {
+      throw new Error(`worker ${i} read ${result.pixel}, expected ${i + 1}`);
+    }
+  });
+  const frames = results.reduce((sum, result) => sum + result.frames, 0);
+  const rate = (frames / seconds).toFixed(1);
+  console.log(`${workers} worker(s): ${rate} frames/s`);
+}
+
+async function main(): Promise<void> {
+  const maxWorkers = Math.min(os.cpus().length, 8);
+  for (let workers = 1; workers <= maxWorkers; workers *= 2) {
+    await bench(workers);
+  }
+}
+
+if (isMainThread) {
+  main().catch((error) => {
+    console.error(error);
+    process.exit(1);
+  });
+} else {
+  parentPort.postMessage(runWorker(workerData));
+}